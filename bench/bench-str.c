@@ -0,0 +1,249 @@
+/**
+ * @file bench-str.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 문자열 B+-Tree의 접두사 압축 효과를 측정한다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details URL과 비슷하게 앞부분을 많이 공유하는 키를 만들어서, 같은 키를
+ * 접두사 압축을 한 트리와 키를 그대로 저장한 트리(B_TREE_STR_F_FULL_KEYS)에
+ * 넣고 적재 시간, 검색 시간, 키 하나당 메모리와 높이를 비교한다.
+ *
+ * 사용법: ./bench-str.out [-n records] [-o lookups] [--seed seed] [--json]
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "btree.h"
+#include "btree-str.h"
+#include "workload.h"
+#include "latency.h"
+
+#define BENCH_STR_DEFAULT_RECORDS 1000000
+#define BENCH_STR_DEFAULT_LOOKUPS 1000000
+#define BENCH_STR_DEFAULT_SEED 42
+#define BENCH_STR_KEY_STRIDE 128 /**< 키 하나가 차지하는 버퍼의 크기 */
+
+static const char *bench_str_section[] = { "articles", "products", "users",
+                                           "images",   "search",   "static" };
+
+/**
+ * @brief 벤치마크의 설정에 해당한다.
+ */
+struct bench_str_config {
+        long records;
+        long lookups;
+        uint64_t seed;
+        bool json;
+};
+
+/**
+ * @brief 한 가지 방식의 측정 결과에 해당한다.
+ */
+struct bench_str_result {
+        const char *mode;
+        double load_sec;
+        double lookup_ns;
+        double bytes_per_key;
+        int height;
+        unsigned long nr_nodes;
+};
+
+static void bench_str_usage(const char *prog)
+{
+        fprintf(stderr,
+                "usage: %s [-n records] [-o lookups] [--seed seed] [--json]\n",
+                prog);
+}
+
+static int bench_str_parse(struct bench_str_config *config, int argc,
+                           char *argv[])
+{
+        for (int i = 1; i < argc; i++) {
+                const char *arg = argv[i];
+
+                if (!strcmp(arg, "--json")) {
+                        config->json = true;
+                        continue;
+                }
+                if (i + 1 >= argc) {
+                        return -EINVAL;
+                }
+                if (!strcmp(arg, "-n") || !strcmp(arg, "--records")) {
+                        config->records = atol(argv[++i]);
+                } else if (!strcmp(arg, "-o") || !strcmp(arg, "--lookups")) {
+                        config->lookups = atol(argv[++i]);
+                } else if (!strcmp(arg, "--seed")) {
+                        config->seed = strtoull(argv[++i], NULL, 10);
+                } else {
+                        return -EINVAL;
+                }
+        }
+        if (config->records <= 0 || config->lookups < 0) {
+                return -EINVAL;
+        }
+        return 0;
+}
+
+/**
+ * @brief URL과 비슷한 키를 records개 만든다. 중복된 키는 만들지 않는다.
+ *
+ * @param lens 키의 길이가 저장될 배열에 해당한다.
+ * @return char* 키가 BENCH_STR_KEY_STRIDE 간격으로 놓인 버퍼를 반환한다.
+ */
+static char *bench_str_keys(const struct bench_str_config *config, int *lens)
+{
+        char *keys = (char *)malloc((size_t)config->records *
+                                    BENCH_STR_KEY_STRIDE);
+        const int nr_sections =
+                sizeof(bench_str_section) / sizeof(bench_str_section[0]);
+        struct workload_rng rng;
+
+        if (!keys) {
+                return NULL;
+        }
+        workload_rng_seed(&rng, config->seed);
+        for (long i = 0; i < config->records; i++) {
+                const uint64_t r = workload_rng_next(&rng);
+
+                /* 마지막의 i가 키를 서로 다르게 만든다. */
+                lens[i] = snprintf(keys + i * BENCH_STR_KEY_STRIDE,
+                                   BENCH_STR_KEY_STRIDE,
+                                   "https://www.shop%02u.example.com/%s/"
+                                   "category-%03u/item-%08lx?ref=%ld",
+                                   (unsigned)(r % 16),
+                                   bench_str_section[(r >> 8) % nr_sections],
+                                   (unsigned)((r >> 16) % 200),
+                                   (unsigned long)((r >> 24) & 0xffffffff), i);
+        }
+        return keys;
+}
+
+static int bench_str_run(const struct bench_str_config *config,
+                         const char *keys, const int *lens, unsigned int flags,
+                         struct bench_str_result *result)
+{
+        struct btree_str *tree = btree_str_alloc(flags);
+        struct workload_rng rng;
+        uint64_t start = 0;
+        long hits = 0;
+        int ret = 0;
+
+        if (!tree) {
+                return -ENOMEM;
+        }
+
+        start = bench_now();
+        for (long i = 0; i < config->records; i++) {
+                ret = btree_str_insert(tree, keys + i * BENCH_STR_KEY_STRIDE,
+                                       (size_t)lens[i], (void *)(intptr_t)i);
+                if (ret) {
+                        goto exception;
+                }
+        }
+        result->load_sec = (double)(bench_now() - start) / 1e9;
+
+        workload_rng_seed(&rng, config->seed + 1);
+        start = bench_now();
+        for (long i = 0; i < config->lookups; i++) {
+                const long k = (long)(workload_rng_next(&rng) %
+                                      (uint64_t)config->records);
+                hits += !btree_str_search(tree,
+                                          keys + k * BENCH_STR_KEY_STRIDE,
+                                          (size_t)lens[k], NULL);
+        }
+        result->lookup_ns = config->lookups ?
+                                    (double)(bench_now() - start) /
+                                            (double)config->lookups :
+                                    0;
+        if (hits != config->lookups) {
+                ret = -EINVAL;
+                goto exception;
+        }
+
+        result->mode = (flags & B_TREE_STR_F_FULL_KEYS) ? "full" : "prefix";
+        result->height = tree->height;
+        result->nr_nodes = tree->nr_nodes;
+        result->bytes_per_key = (double)tree->nr_nodes * B_TREE_STR_NODE_SIZE /
+                                (double)tree->nr_keys;
+exception:
+        btree_str_free(tree);
+        return ret;
+}
+
+int main(int argc, char *argv[])
+{
+        struct bench_str_config config = {
+                .records = BENCH_STR_DEFAULT_RECORDS,
+                .lookups = BENCH_STR_DEFAULT_LOOKUPS,
+                .seed = BENCH_STR_DEFAULT_SEED,
+        };
+        const unsigned int flags[] = { 0, B_TREE_STR_F_FULL_KEYS };
+        struct bench_str_result result[2];
+        double key_bytes = 0;
+        char *keys = NULL;
+        int *lens = NULL;
+        int ret = 0;
+
+        if (bench_str_parse(&config, argc, argv)) {
+                bench_str_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        lens = (int *)malloc((size_t)config.records * sizeof(int));
+        keys = lens ? bench_str_keys(&config, lens) : NULL;
+        if (!keys) {
+                pr_info("Cannot generate keys\n");
+                ret = -ENOMEM;
+                goto exception;
+        }
+        for (long i = 0; i < config.records; i++) {
+                key_bytes += lens[i];
+        }
+        key_bytes /= (double)config.records;
+
+        for (int i = 0; i < 2; i++) {
+                ret = bench_str_run(&config, keys, lens, flags[i], &result[i]);
+                if (ret) {
+                        pr_info("String tree benchmark failed(%d)\n", ret);
+                        goto exception;
+                }
+        }
+
+        if (config.json) {
+                printf("{\"records\":%ld,\"lookups\":%ld,\"key_bytes\":%.1f,"
+                       "\"modes\":[",
+                       config.records, config.lookups, key_bytes);
+                for (int i = 0; i < 2; i++) {
+                        printf("%s{\"mode\":\"%s\",\"load_sec\":%.6f,"
+                               "\"lookup_ns\":%.1f,\"bytes_per_key\":%.1f,"
+                               "\"height\":%d,\"nodes\":%lu}",
+                               i ? "," : "", result[i].mode,
+                               result[i].load_sec, result[i].lookup_ns,
+                               result[i].bytes_per_key, result[i].height,
+                               result[i].nr_nodes);
+                }
+                printf("]}\n");
+                goto exception;
+        }
+
+        printf("string keys: %ld records, %.1lf bytes per key on average\n",
+               config.records, key_bytes);
+        for (int i = 0; i < 2; i++) {
+                printf("%-6s load =======> %lfs, lookup %.1lf ns/op, "
+                       "%.1lf bytes/key, height %d, %lu nodes\n",
+                       result[i].mode, result[i].load_sec, result[i].lookup_ns,
+                       result[i].bytes_per_key, result[i].height,
+                       result[i].nr_nodes);
+        }
+exception:
+        free(keys);
+        free(lens);
+        return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
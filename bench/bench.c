@@ -0,0 +1,766 @@
+/**
+ * @file bench.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief YCSB 형태의 작업 부하로 B-Tree의 처리량과 지연 시간을 측정한다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 미리 records개의 항목을 넣은 뒤 ops개의 연산을 주어진 비율로
+ * 수행하며, 연산마다 걸린 시간을 기록하여 백분위 지연 시간을 구한다.
+ * 결과는 사람이 읽는 표 또는 --json으로 JSON 한 줄을 출력한다.
+ *
+ * 사용법: ./bench.out [-w A-F] [-r records] [-n ops]
+ *                     [-t degree|auto|calibrate]
+ *                     [--read p] [--update p] [--insert p] [--scan p]
+ *                     [--delete p] [--scan-length n] [--seed s] [--json]
+ *                     [--dist name[:param[:param]]] [--trace path]
+ *                     [--perf] [--index btree|btree-arena|rbtree|bst|sorted-array|csb-tree|all]
+ *                     [--compact bfs|veb]
+ *                     [--search linear|binary|interpolation|adaptive]
+ *
+ * --index로 같은 작업 부하를 비교 대상 자료 구조에 대해 수행할 수 있으며,
+ * all은 모두를 차례로 수행한다. 노드 통계와 메모리 분석, 기록은 B-Tree에서만
+ * 출력된다. sorted-array는 삽입이 O(n)이므로 적재는 한꺼번에 정렬하여 넣는다.
+ *
+ * --perf를 주면 하드웨어 성능 카운터를 구간(phase)마다 세어 연산 하나당의
+ * 값으로 출력한다. insert는 적재 구간이며, run 구간은 연산마다의 시간 측정
+ * 비용을 포함한다. search와 delete 구간은 run이 끝난 뒤에 적재한 키 전체에
+ * 대해 따로 수행한다. 카운터를 열 수 없는 환경에서는 카운터 없이 진행한다.
+ *
+ * --compact를 주면 적재가 끝난 뒤에 B-Tree를 주어진 순서로 압축하고 나서
+ * 연산을 수행한다.
+ *
+ * --search는 B-Tree가 노드 안에서 키를 찾는 방법을 정한다(기본값은 linear).
+ *
+ * make bench DEGREE=n으로 빌드하면 차수가 n으로 고정되며, -t는 n만 받는다.
+ *
+ * --trace는 make bench TRACE=1로 빌드한 경우에만 연산을 기록하며, 기록은
+ * replay.out으로 다시 수행할 수 있다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "btree.h"
+#include "btree-trace.h"
+#include "index.h"
+#include "workload.h"
+#include "latency.h"
+#include "perf.h"
+
+#define BENCH_DEFAULT_RECORDS 1000000
+#define BENCH_DEFAULT_OPS 1000000
+#ifdef B_TREE_FIXED_DEGREE
+#define BENCH_DEFAULT_DEGREE B_TREE_FIXED_DEGREE
+#define BENCH_FIXED_DEGREE 1 /**< make bench DEGREE=n으로 빌드한 경우 */
+#else
+#define BENCH_DEFAULT_DEGREE 32
+#define BENCH_FIXED_DEGREE 0
+#endif
+#define BENCH_DEFAULT_SCAN_LENGTH 100
+
+/**
+ * @brief 벤치마크가 수행하는 연산의 종류에 해당한다.
+ */
+enum bench_op {
+        BENCH_READ = 0,
+        BENCH_UPDATE, /**< 탐색 후에 값을 덮어쓴다(read-modify-write). */
+        BENCH_INSERT,
+        BENCH_SCAN,
+        BENCH_DELETE,
+        NR_BENCH_OPS,
+};
+
+static const char *bench_op_name[NR_BENCH_OPS] = { "read", "update", "insert",
+                                                   "scan", "delete" };
+
+/**
+ * @brief YCSB의 핵심 작업 부하(A-F)의 연산 비율에 해당한다.
+ * @note F의 read-modify-write는 update로 대신한다. 키 분포는 YCSB와 같이 D는
+ * latest를, 나머지는 zipfian을 기본으로 한다.
+ */
+static const double bench_workload[6][NR_BENCH_OPS] = {
+        /*  read, update, insert, scan, delete */
+        { 0.50, 0.50, 0.00, 0.00, 0.00 }, /**< A: update heavy */
+        { 0.95, 0.05, 0.00, 0.00, 0.00 }, /**< B: read mostly */
+        { 1.00, 0.00, 0.00, 0.00, 0.00 }, /**< C: read only */
+        { 0.95, 0.00, 0.05, 0.00, 0.00 }, /**< D: read latest */
+        { 0.00, 0.00, 0.05, 0.95, 0.00 }, /**< E: short ranges */
+        { 0.50, 0.50, 0.00, 0.00, 0.00 }, /**< F: read-modify-write */
+};
+
+/**
+ * @brief 성능 카운터를 세는 구간에 해당한다.
+ */
+enum bench_phase {
+        BENCH_PHASE_INSERT = 0,
+        BENCH_PHASE_RUN,
+        BENCH_PHASE_SEARCH,
+        BENCH_PHASE_DELETE,
+        NR_BENCH_PHASES,
+};
+
+static const char *bench_phase_name[NR_BENCH_PHASES] = { "insert", "run",
+                                                         "search", "delete" };
+
+/**
+ * @brief 벤치마크의 설정에 해당한다.
+ */
+struct bench_config {
+        char workload; /**< 'A'-'F' 또는 비율을 직접 준 경우 'X' */
+        double ratio[NR_BENCH_OPS];
+        long records;
+        long ops;
+        int degree;
+        int scan_length;
+        uint64_t seed;
+        bool json;
+        struct workload_config dist; /**< 연산 대상 키의 분포 */
+        bool dist_set; /**< --dist로 분포를 직접 준 경우 */
+        const char *trace; /**< 연산을 기록할 파일의 경로 */
+        bool perf; /**< 하드웨어 성능 카운터를 세는 경우 */
+        const char *index; /**< 측정할 색인의 이름 또는 "all" */
+        int compact; /**< 적재 후에 압축할 순서로 압축하지 않으면 -1 */
+        enum btree_node_search node_search; /**< B-Tree의 노드 안 탐색 방법 */
+};
+
+/**
+ * @brief 벤치마크의 결과에 해당한다.
+ */
+struct bench_result {
+        const char *index;
+        double load_sec;
+        double run_sec;
+        double compact_sec; /**< 압축하지 않은 경우에는 음수이다. */
+        bool has_stats; /**< B_TREE_STATS로 빌드되어 stats가 유효한 경우 */
+        struct btree_stats stats;
+        bool has_footprint; /**< B-Tree인 경우에만 footprint가 유효하다. */
+        struct btree_report footprint; /**< 실행이 끝난 뒤의 트리 분석 결과 */
+        bool has_perf; /**< 카운터를 하나 이상 열어 perf가 유효한 경우 */
+        long perf_ops[NR_BENCH_PHASES];
+        uint64_t perf[NR_BENCH_PHASES][NR_BENCH_PERF_EVENTS];
+};
+
+/**
+ * @brief 순번을 키로 바꾼다. 홀수 곱은 2^32에서 전단사이므로 키가 겹치지 않는다.
+ */
+static inline key_t bench_key(long i)
+{
+        return (key_t)((uint32_t)i * 2654435761u);
+}
+
+static int bench_scan_visit(struct btree_item *item, void *private)
+{
+        uintptr_t *sum = (uintptr_t *)private;
+        *sum += (uintptr_t)item->data;
+        return 0;
+}
+
+static void bench_usage(const char *prog)
+{
+        fprintf(stderr,
+                "usage: %s [-w A-F] [-r records] [-n ops]\n"
+                "       [-t degree|auto|calibrate]\n"
+                "       [--read p] [--update p] [--insert p] [--scan p]\n"
+                "       [--delete p] [--scan-length n] [--seed s] [--json]\n"
+                "       [--dist name[:param[:param]]] [--trace path]\n"
+                "       [--perf] [--index btree|btree-arena|rbtree|bst|sorted-array|csb-tree|all]\n"
+                "       [--compact bfs|veb]\n"
+                "       [--search linear|binary|interpolation|adaptive]\n",
+                prog);
+}
+
+/**
+ * @brief 명령행 인자를 해석하도록 한다.
+ *
+ * @return int 성공 시에 0을, 잘못된 인자가 있으면 -EINVAL을 반환한다.
+ */
+static int bench_parse(struct bench_config *config, int argc, char *argv[])
+{
+        bool custom = false;
+        double sum = 0;
+
+        for (int i = 1; i < argc; i++) {
+                const char *arg = argv[i];
+                const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+                int op = -1;
+
+                if (!strcmp(arg, "--json")) {
+                        config->json = true;
+                        continue;
+                }
+                if (!strcmp(arg, "--perf")) {
+                        config->perf = true;
+                        continue;
+                }
+                if (!val) {
+                        return -EINVAL;
+                }
+                i++;
+
+                if (!strcmp(arg, "-w") || !strcmp(arg, "--workload")) {
+                        if (val[0] < 'A' || val[0] > 'F' || val[1]) {
+                                return -EINVAL;
+                        }
+                        config->workload = val[0];
+                        memcpy(config->ratio, bench_workload[val[0] - 'A'],
+                               sizeof(config->ratio));
+                } else if (!strcmp(arg, "-r") || !strcmp(arg, "--records")) {
+                        config->records = atol(val);
+                } else if (!strcmp(arg, "-n") || !strcmp(arg, "--ops")) {
+                        config->ops = atol(val);
+                } else if (!strcmp(arg, "-t") || !strcmp(arg, "--degree")) {
+                        if (!strcmp(val, "auto")) {
+                                config->degree = btree_auto_degree(0);
+                        } else if (!strcmp(val, "calibrate")) {
+                                config->degree = btree_auto_degree(
+                                        B_TREE_AUTO_CALIBRATE);
+                        } else {
+                                config->degree = atoi(val);
+                        }
+                } else if (!strcmp(arg, "--scan-length")) {
+                        config->scan_length = atoi(val);
+                } else if (!strcmp(arg, "--dist")) {
+                        if (workload_parse(val, &config->dist)) {
+                                return -EINVAL;
+                        }
+                        config->dist_set = true;
+                } else if (!strcmp(arg, "--index")) {
+                        if (strcmp(val, "all") && !index_find(val)) {
+                                return -EINVAL;
+                        }
+                        config->index = val;
+                } else if (!strcmp(arg, "--compact")) {
+                        if (!strcmp(val, "bfs")) {
+                                config->compact = B_TREE_LAYOUT_BFS;
+                        } else if (!strcmp(val, "veb")) {
+                                config->compact = B_TREE_LAYOUT_VEB;
+                        } else {
+                                return -EINVAL;
+                        }
+                } else if (!strcmp(arg, "--search")) {
+                        if (!strcmp(val, "linear")) {
+                                config->node_search = B_TREE_SEARCH_LINEAR;
+                        } else if (!strcmp(val, "binary")) {
+                                config->node_search = B_TREE_SEARCH_BINARY;
+                        } else if (!strcmp(val, "interpolation")) {
+                                config->node_search =
+                                        B_TREE_SEARCH_INTERPOLATION;
+                        } else if (!strcmp(val, "adaptive")) {
+                                config->node_search = B_TREE_SEARCH_ADAPTIVE;
+                        } else {
+                                return -EINVAL;
+                        }
+                } else if (!strcmp(arg, "--trace")) {
+                        config->trace = val;
+                } else if (!strcmp(arg, "--seed")) {
+                        config->seed = strtoull(val, NULL, 0);
+                } else {
+                        for (int j = 0; j < NR_BENCH_OPS; j++) {
+                                if (!strncmp(arg, "--", 2) &&
+                                    !strcmp(arg + 2, bench_op_name[j])) {
+                                        op = j;
+                                }
+                        }
+                        if (op < 0) {
+                                return -EINVAL;
+                        }
+                        if (!custom) {
+                                memset(config->ratio, 0, sizeof(config->ratio));
+                                custom = true;
+                        }
+                        config->workload = 'X';
+                        config->ratio[op] = atof(val);
+                }
+        }
+
+        for (int op = 0; op < NR_BENCH_OPS; op++) {
+                sum += config->ratio[op];
+        }
+        if (sum <= 0 || config->records < 1 || config->ops < 1 ||
+            config->degree < B_TREE_MIN_DEGREE || config->scan_length < 1) {
+                return -EINVAL;
+        }
+        for (int op = 0; op < NR_BENCH_OPS; op++) { /**< 합이 1이 되도록 한다. */
+                config->ratio[op] /= sum;
+        }
+        if (!config->dist_set) {
+                config->dist.dist = (config->workload == 'D') ? WORKLOAD_LATEST :
+                                                                 WORKLOAD_ZIPFIAN;
+        }
+        config->dist.n = (uint64_t)config->records;
+        config->dist.seed = config->seed;
+        return 0;
+}
+
+/**
+ * @brief 설정된 비율에 따라 연산을 고른다.
+ */
+static enum bench_op bench_choose(const struct bench_config *config,
+                                  struct workload_rng *rng)
+{
+        const double r = workload_rng_double(rng);
+        double acc = 0;
+
+        for (int op = 0; op < NR_BENCH_OPS; op++) {
+                acc += config->ratio[op];
+                if (r < acc) {
+                        return (enum bench_op)op;
+                }
+        }
+        return BENCH_READ;
+}
+
+/**
+ * @brief 통계를 출력한다. 노드 방문과 키 비교는 search, insert, delete
+ * 한 번당 평균으로 나타낸다.
+ */
+static void bench_report_stats(const struct btree_stats *stats, bool json)
+{
+        const unsigned long ops = stats->searches + stats->inserts +
+                                  stats->deletes;
+        const double div = ops ? (double)ops : 1.0;
+
+        if (json) {
+                printf(",\"stats\":{\"nodes_per_op\":%.3f,"
+                       "\"compares_per_op\":%.3f,\"splits\":%lu,"
+                       "\"merges\":%lu,\"borrow_left\":%lu,"
+                       "\"borrow_right\":%lu,\"root_splits\":%lu,"
+                       "\"root_collapses\":%lu}",
+                       (double)stats->node_visits / div,
+                       (double)stats->key_compares / div, stats->splits,
+                       stats->merges, stats->borrow_left, stats->borrow_right,
+                       stats->root_splits, stats->root_collapses);
+                return;
+        }
+        printf("nodes/op %.3f, compares/op %.3f, splits %lu, merges %lu, "
+               "borrows %lu/%lu(left/right), root splits %lu, "
+               "root collapses %lu\n",
+               (double)stats->node_visits / div,
+               (double)stats->key_compares / div, stats->splits, stats->merges,
+               stats->borrow_left, stats->borrow_right, stats->root_splits,
+               stats->root_collapses);
+}
+
+/**
+ * @brief 실행이 끝난 뒤의 트리 모양과 메모리 사용량을 출력한다.
+ */
+static void bench_report_footprint(const struct bench_config *config,
+                                   const struct btree_report *report, bool json)
+{
+        const double slots = (double)report->nr_nodes *
+                             B_TREE_NR_KEYS(config->degree);
+        const double fill = slots > 0 ? (double)report->nr_keys / slots : 0.0;
+
+        if (json) {
+                printf(",\"footprint\":{\"height\":%d,\"nodes\":%lu,"
+                       "\"leaves\":%lu,\"keys\":%lu,\"bytes\":%zu,"
+                       "\"allocated_bytes\":%zu,\"bytes_per_key\":%.2f,"
+                       "\"fill\":%.4f,\"wasted_slots\":%lu}",
+                       report->height, report->nr_nodes, report->nr_leaves,
+                       report->nr_keys, report->bytes, report->allocated_bytes,
+                       report->bytes_per_key, fill, report->wasted_slots);
+                return;
+        }
+        printf("footprint: height %d, %lu nodes(%lu leaves), %lu keys, "
+               "%zu bytes(%.2f bytes/key), fill %.1f%%, %lu wasted slots\n",
+               report->height, report->nr_nodes, report->nr_leaves,
+               report->nr_keys, report->allocated_bytes, report->bytes_per_key,
+               fill * 100.0, report->wasted_slots);
+}
+
+static void bench_phase_begin(struct bench_result *result,
+                              struct bench_perf *perf)
+{
+        if (result->has_perf) {
+                bench_perf_start(perf);
+        }
+}
+
+static void bench_phase_end(struct bench_result *result,
+                            struct bench_perf *perf, enum bench_phase phase,
+                            long ops)
+{
+        if (result->has_perf) {
+                bench_perf_stop(perf, result->perf[phase]);
+                result->perf_ops[phase] = ops;
+        }
+}
+
+/**
+ * @brief 구간마다의 성능 카운터를 연산 하나당의 값으로 출력한다.
+ */
+static void bench_report_perf(const struct bench_result *result, bool json)
+{
+        if (json) {
+                printf(",\"perf\":{");
+                for (int phase = 0, first = 1; phase < NR_BENCH_PHASES; phase++) {
+                        const long ops = result->perf_ops[phase];
+
+                        if (ops == 0) {
+                                continue;
+                        }
+                        printf("%s\"%s\":{\"ops\":%ld", first ? "" : ",",
+                               bench_phase_name[phase], ops);
+                        for (int ev = 0; ev < NR_BENCH_PERF_EVENTS; ev++) {
+                                const uint64_t value = result->perf[phase][ev];
+
+                                printf(",\"%s\":", bench_perf_name(ev));
+                                if (value == BENCH_PERF_UNAVAILABLE) {
+                                        printf("null");
+                                } else {
+                                        printf("%.3f", (double)value / (double)ops);
+                                }
+                        }
+                        printf("}");
+                        first = 0;
+                }
+                printf("}");
+                return;
+        }
+
+        printf("%-8s", "perf/op");
+        for (int ev = 0; ev < NR_BENCH_PERF_EVENTS; ev++) {
+                printf(" %13s", bench_perf_name(ev));
+        }
+        printf("\n");
+        for (int phase = 0; phase < NR_BENCH_PHASES; phase++) {
+                const long ops = result->perf_ops[phase];
+
+                if (ops == 0) {
+                        continue;
+                }
+                printf("%-8s", bench_phase_name[phase]);
+                for (int ev = 0; ev < NR_BENCH_PERF_EVENTS; ev++) {
+                        const uint64_t value = result->perf[phase][ev];
+
+                        if (value == BENCH_PERF_UNAVAILABLE) {
+                                printf(" %13s", "-");
+                        } else {
+                                printf(" %13.2f", (double)value / (double)ops);
+                        }
+                }
+                printf("\n");
+        }
+}
+
+/**
+ * @brief 결과를 출력하도록 한다.
+ */
+static void bench_report(const struct bench_config *config,
+                         struct bench_latency *lat,
+                         const struct bench_result *result)
+{
+        const double ops_per_sec = (double)config->ops / result->run_sec;
+
+        for (int op = 0; op < NR_BENCH_OPS; op++) {
+                bench_latency_sort(&lat[op]);
+        }
+
+        if (config->json) {
+                printf("{\"index\":\"%s\",\"workload\":\"%c\",\"dist\":\"%s\","
+                       "\"records\":%ld,\"ops\":%ld,\"degree\":%d,"
+                       "\"fixed_degree\":%s,\"scan_length\":%d,\"seed\":%llu,",
+                       result->index, config->workload,
+                       workload_name(config->dist.dist),
+                       config->records, config->ops, config->degree,
+                       BENCH_FIXED_DEGREE ? "true" : "false",
+                       config->scan_length, (unsigned long long)config->seed);
+                if (result->compact_sec >= 0) {
+                        printf("\"compact_sec\":%.6f,", result->compact_sec);
+                }
+                printf("\"load_sec\":%.6f,\"run_sec\":%.6f,"
+                       "\"ops_per_sec\":%.1f,\"latency_ns\":{",
+                       result->load_sec, result->run_sec, ops_per_sec);
+                for (int op = 0, first = 1; op < NR_BENCH_OPS; op++) {
+                        if (lat[op].n == 0) {
+                                continue;
+                        }
+                        printf("%s\"%s\":{\"count\":%ld,\"hits\":%ld,"
+                               "\"p50\":%llu,\"p99\":%llu,\"p999\":%llu}",
+                               first ? "" : ",", bench_op_name[op], lat[op].n,
+                               lat[op].hits,
+                               (unsigned long long)bench_percentile(&lat[op], 50),
+                               (unsigned long long)bench_percentile(&lat[op], 99),
+                               (unsigned long long)bench_percentile(&lat[op], 99.9));
+                        first = 0;
+                }
+                printf("}");
+                if (result->has_footprint) {
+                        bench_report_footprint(config, &result->footprint, true);
+                }
+                if (result->has_stats) {
+                        bench_report_stats(&result->stats, true);
+                }
+                if (result->has_perf) {
+                        bench_report_perf(result, true);
+                }
+                printf("}\n");
+                return;
+        }
+
+        printf("%s workload %c(%s): %ld records, %ld ops, degree %d%s\n",
+               result->index, config->workload,
+               workload_name(config->dist.dist), config->records, config->ops,
+               config->degree, BENCH_FIXED_DEGREE ? "(fixed)" : "");
+        printf("load =======> %lfs\n", result->load_sec);
+        if (result->compact_sec >= 0) {
+                printf("compact =======> %lfs\n", result->compact_sec);
+        }
+        printf("run =======> %lfs (%.1lf ops/s)\n", result->run_sec,
+               ops_per_sec);
+        printf("%-8s %10s %10s %10s %10s %10s\n", "op", "count", "hits",
+               "p50(ns)", "p99(ns)", "p99.9(ns)");
+        for (int op = 0; op < NR_BENCH_OPS; op++) {
+                if (lat[op].n == 0) {
+                        continue;
+                }
+                printf("%-8s %10ld %10ld %10llu %10llu %10llu\n",
+                       bench_op_name[op], lat[op].n, lat[op].hits,
+                       (unsigned long long)bench_percentile(&lat[op], 50),
+                       (unsigned long long)bench_percentile(&lat[op], 99),
+                       (unsigned long long)bench_percentile(&lat[op], 99.9));
+        }
+        if (result->has_footprint) {
+                bench_report_footprint(config, &result->footprint, false);
+        }
+        if (result->has_stats) {
+                bench_report_stats(&result->stats, false);
+        }
+        if (result->has_perf) {
+                bench_report_perf(result, false);
+        }
+}
+
+/**
+ * @brief 하나의 색인에 대해 적재와 실행을 한 번 수행하고 결과를 출력한다.
+ * @details 같은 설정으로 여러 색인을 돌려도 같은 연산 순서가 되도록
+ * 난수 생성기와 키 생성기를 매번 새로 초기화한다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+static int bench_run(const struct bench_config *config,
+                     const struct index_ops *ops, struct bench_perf *perf)
+{
+        const bool is_btree = (ops == &index_btree_ops ||
+                               ops == &index_btree_arena_ops);
+        struct bench_latency lat[NR_BENCH_OPS];
+        struct btree_item *items = NULL;
+        void *index = NULL;
+        struct bench_result result;
+        struct workload_rng rng;
+        struct workload wl;
+        uint64_t start = 0, end = 0;
+        long nr_keys = 0;
+        uintptr_t sink = 0;
+        int ret = 0;
+
+        memset(lat, 0, sizeof(lat));
+        memset(&result, 0, sizeof(result));
+        result.index = ops->name;
+        result.compact_sec = -1;
+        result.has_perf = perf->nr_open > 0;
+        workload_rng_seed(&rng, config->seed);
+        ret = workload_init(&wl, &config->dist);
+        if (ret) {
+                return ret;
+        }
+
+        for (int op = 0; op < NR_BENCH_OPS; op++) {
+                lat[op].ns = (uint64_t *)malloc(config->ops * sizeof(uint64_t));
+                if (!lat[op].ns) {
+                        pr_info("Allocation latency buffer failed\n");
+                        ret = -ENOMEM;
+                        goto exception;
+                }
+        }
+
+        index = ops->alloc(config->degree);
+        if (!index) {
+                ret = -ENOMEM;
+                goto exception;
+        }
+        if (is_btree) {
+                btree_set_node_search((struct btree *)index,
+                                      config->node_search);
+        }
+        if (ops->load) { /**< 한꺼번에 넣을 항목을 미리 만들어 둔다. */
+                items = (struct btree_item *)malloc(config->records *
+                                                    sizeof(struct btree_item));
+                if (!items) {
+                        ret = -ENOMEM;
+                        goto exception;
+                }
+                for (long i = 0; i < config->records; i++) {
+                        items[i].key = bench_key(i);
+                        items[i].data = (void *)(uintptr_t)i;
+                }
+        }
+        if (config->trace && is_btree) {
+                ret = btree_trace_open(config->trace);
+                if (ret) {
+                        goto exception;
+                }
+        }
+
+        bench_phase_begin(&result, perf);
+        start = bench_now();
+        if (ops->load) {
+                ret = ops->load(index, items, config->records);
+                nr_keys = config->records;
+        } else {
+                for (nr_keys = 0; nr_keys < config->records && !ret; nr_keys++) {
+                        ret = ops->insert(index, bench_key(nr_keys),
+                                          (void *)(uintptr_t)nr_keys);
+                }
+        }
+        end = bench_now();
+        bench_phase_end(&result, perf, BENCH_PHASE_INSERT, config->records);
+        result.load_sec = (double)(end - start) / 1e9;
+        if (ret) {
+                goto exception;
+        }
+        if (is_btree && config->compact >= 0) {
+                start = bench_now();
+                ret = btree_compact((struct btree *)index,
+                                    (enum btree_layout)config->compact);
+                result.compact_sec = (double)(bench_now() - start) / 1e9;
+                if (ret) {
+                        goto exception;
+                }
+        }
+        if (is_btree) {
+                btree_stats_reset((struct btree *)index);
+        }
+
+        bench_phase_begin(&result, perf);
+        start = bench_now();
+        for (long i = 0; i < config->ops; i++) {
+                const enum bench_op op = bench_choose(config, &rng);
+                const key_t key = bench_key((long)workload_next(&wl));
+                struct btree_item *item = NULL;
+                bool hit = true;
+                uint64_t t0 = bench_now();
+
+                switch (op) {
+                case BENCH_READ:
+                        item = ops->search(index, key);
+                        hit = item != NULL;
+                        if (hit) {
+                                sink += (uintptr_t)item->data;
+                        }
+                        break;
+                case BENCH_UPDATE:
+                        item = ops->search(index, key);
+                        hit = item != NULL;
+                        if (hit) {
+                                item->data = (void *)(uintptr_t)i;
+                        }
+                        break;
+                case BENCH_INSERT:
+                        hit = ops->insert(index, bench_key(nr_keys),
+                                          (void *)(uintptr_t)nr_keys) == 0;
+                        nr_keys = (long)workload_insert(&wl) + 1;
+                        break;
+                case BENCH_SCAN:
+                        hit = ops->scan(index, key, config->scan_length,
+                                        bench_scan_visit, &sink) > 0;
+                        break;
+                case BENCH_DELETE:
+                        hit = ops->remove(index, key) == 0;
+                        break;
+                default:
+                        break;
+                }
+
+                lat[op].ns[lat[op].n++] = bench_now() - t0;
+                lat[op].hits += hit;
+        }
+        end = bench_now();
+        bench_phase_end(&result, perf, BENCH_PHASE_RUN, config->ops);
+        result.run_sec = (double)(end - start) / 1e9;
+        btree_trace_close();
+
+        if (is_btree) {
+                struct btree *tree = (struct btree *)index;
+
+                result.has_stats = btree_stats_get(tree, &result.stats) == 0;
+                result.has_footprint = true;
+                btree_analyze(tree, &result.footprint);
+        }
+
+        if (result.has_perf) { /**< 연산의 종류마다 따로 센다. */
+                bench_phase_begin(&result, perf);
+                for (long i = 0; i < config->records; i++) {
+                        sink += (uintptr_t)ops->search(index, bench_key(i));
+                }
+                bench_phase_end(&result, perf, BENCH_PHASE_SEARCH,
+                                config->records);
+
+                bench_phase_begin(&result, perf);
+                for (long i = 0; i < config->records; i++) {
+                        ops->remove(index, bench_key(i));
+                }
+                bench_phase_end(&result, perf, BENCH_PHASE_DELETE,
+                                config->records);
+        }
+
+        bench_report(config, lat, &result);
+        if (sink == 1) { /**< 탐색 결과가 최적화로 사라지지 않도록 한다. */
+                fprintf(stderr, "\n");
+        }
+
+exception:
+        if (index) {
+                ops->free(index);
+        }
+        free(items);
+        for (int op = 0; op < NR_BENCH_OPS; op++) {
+                free(lat[op].ns);
+        }
+        return ret;
+}
+
+int main(int argc, char *argv[])
+{
+        struct bench_config config = {
+                .workload = 'A',
+                .records = BENCH_DEFAULT_RECORDS,
+                .ops = BENCH_DEFAULT_OPS,
+                .degree = BENCH_DEFAULT_DEGREE,
+                .scan_length = BENCH_DEFAULT_SCAN_LENGTH,
+                .seed = 0x5eed,
+                .json = false,
+                .index = "btree",
+                .compact = -1,
+                .node_search = B_TREE_SEARCH_LINEAR,
+        };
+        struct bench_perf perf = { .nr_open = 0 };
+        int ret = 0;
+
+        memcpy(config.ratio, bench_workload[0], sizeof(config.ratio));
+        if (bench_parse(&config, argc, argv)) {
+                bench_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+        if (config.perf && bench_perf_open(&perf)) {
+                pr_info("Perf events are unavailable, continuing without counters\n");
+        }
+
+        for (int i = 0; index_list[i] && !ret; i++) {
+                if (strcmp(config.index, "all") &&
+                    strcmp(config.index, index_list[i]->name)) {
+                        continue;
+                }
+                ret = bench_run(&config, index_list[i], &perf);
+        }
+
+        if (config.perf) {
+                bench_perf_close(&perf);
+        }
+        return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
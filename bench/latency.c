@@ -0,0 +1,54 @@
+/**
+ * @file latency.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 벤치마크 도구들이 함께 쓰는 시간 측정과 백분위 계산의 구현이다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <time.h>
+#include "latency.h"
+
+/**
+ * @brief 단조 증가하는 현재 시각(ns)을 반환한다.
+ */
+uint64_t bench_now(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+        const uint64_t x = *(const uint64_t *)a;
+        const uint64_t y = *(const uint64_t *)b;
+        return (x > y) - (x < y);
+}
+
+/**
+ * @brief 백분위를 구할 수 있도록 지연 시간을 정렬한다.
+ */
+void bench_latency_sort(struct bench_latency *lat)
+{
+        qsort(lat->ns, lat->n, sizeof(uint64_t), bench_compare);
+}
+
+/**
+ * @brief 정렬된 지연 시간에서 백분위 값을 구한다.
+ */
+uint64_t bench_percentile(const struct bench_latency *lat, double p)
+{
+        long i = 0;
+
+        if (lat->n == 0) {
+                return 0;
+        }
+        i = (long)(p / 100.0 * (double)lat->n);
+        return lat->ns[i < lat->n ? i : lat->n - 1];
+}
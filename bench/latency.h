@@ -0,0 +1,29 @@
+/**
+ * @file latency.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 벤치마크 도구들이 함께 쓰는 시간 측정과 백분위 계산에 대한 선언이다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _BENCH_LATENCY_H
+#define _BENCH_LATENCY_H
+
+#include <stdint.h>
+
+/**
+ * @brief 연산의 종류마다 모은 지연 시간(ns)에 해당한다.
+ */
+struct bench_latency {
+        uint64_t *ns;
+        long n;
+        long hits; /**< 키를 찾은 연산의 수 */
+};
+
+uint64_t bench_now(void);
+void bench_latency_sort(struct bench_latency *lat);
+uint64_t bench_percentile(const struct bench_latency *lat, double p);
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * @file perf.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief perf_event_open(2)을 이용한 하드웨어 성능 카운터 측정의 구현이다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 사용자 영역만 세므로(exclude_kernel) perf_event_paranoid가 2인
+ * 환경에서도 열 수 있다. 리눅스가 아니거나 가상 머신처럼 PMU가 없는 경우에는
+ * 열리는 카운터가 없으며, 벤치마크는 카운터 없이 그대로 진행한다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _GNU_SOURCE
+
+#include <string.h>
+#include <errno.h>
+#include "perf.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#define BENCH_PERF_CACHE(cache, op, result)                                    \
+        ((cache) | ((op) << 8) | ((result) << 16))
+
+static const struct {
+        uint32_t type;
+        uint64_t config;
+} bench_perf_attr[NR_BENCH_PERF_EVENTS] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE,
+          BENCH_PERF_CACHE(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                           PERF_COUNT_HW_CACHE_RESULT_MISS) },
+        { PERF_TYPE_HW_CACHE,
+          BENCH_PERF_CACHE(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ,
+                           PERF_COUNT_HW_CACHE_RESULT_MISS) },
+        { PERF_TYPE_HW_CACHE,
+          BENCH_PERF_CACHE(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                           PERF_COUNT_HW_CACHE_RESULT_MISS) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+#endif
+
+static const char *bench_perf_names[NR_BENCH_PERF_EVENTS] = {
+        "cycles",   "instructions", "l1d_misses",
+        "llc_misses", "dtlb_misses", "branch_misses",
+};
+
+/**
+ * @brief 이벤트의 이름을 반환한다.
+ */
+const char *bench_perf_name(enum bench_perf_event event)
+{
+        return (event < NR_BENCH_PERF_EVENTS) ? bench_perf_names[event] :
+                                                "unknown";
+}
+
+/**
+ * @brief 호출한 스레드에 대한 카운터를 열도록 한다.
+ *
+ * @param perf 열린 카운터가 저장될 위치에 해당한다.
+ * @return int 하나 이상 열린 경우에는 0을, 하나도 열지 못한 경우에는
+ * 음수의 errno를 반환한다. 실패하더라도 perf는 안전하게 사용할 수 있다.
+ */
+int bench_perf_open(struct bench_perf *perf)
+{
+        int ret = -ENOTSUP;
+
+        perf->nr_open = 0;
+        for (int i = 0; i < NR_BENCH_PERF_EVENTS; i++) {
+                perf->fd[i] = -1;
+        }
+#ifdef __linux__
+        for (int i = 0; i < NR_BENCH_PERF_EVENTS; i++) {
+                struct perf_event_attr attr;
+
+                memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = bench_perf_attr[i].type;
+                attr.config = bench_perf_attr[i].config;
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                                   PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                perf->fd[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1,
+                                           -1, 0);
+                if (perf->fd[i] < 0) {
+                        ret = -errno;
+                        perf->fd[i] = -1;
+                        continue;
+                }
+                perf->nr_open++;
+        }
+#endif
+        return perf->nr_open > 0 ? 0 : ret;
+}
+
+/**
+ * @brief 열린 카운터를 0으로 만들고 세기 시작한다.
+ */
+void bench_perf_start(struct bench_perf *perf)
+{
+#ifdef __linux__
+        for (int i = 0; i < NR_BENCH_PERF_EVENTS; i++) {
+                if (perf->fd[i] >= 0) {
+                        ioctl(perf->fd[i], PERF_EVENT_IOC_RESET, 0);
+                        ioctl(perf->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+                }
+        }
+#else
+        (void)perf;
+#endif
+}
+
+/**
+ * @brief 카운터를 멈추고 값을 읽는다.
+ *
+ * @param perf 열린 카운터의 모음에 해당한다.
+ * @param value 이벤트마다의 값으로 열지 못한 이벤트는
+ * BENCH_PERF_UNAVAILABLE이 된다.
+ */
+void bench_perf_stop(struct bench_perf *perf,
+                     uint64_t value[NR_BENCH_PERF_EVENTS])
+{
+        for (int i = 0; i < NR_BENCH_PERF_EVENTS; i++) {
+                value[i] = BENCH_PERF_UNAVAILABLE;
+        }
+#ifdef __linux__
+        for (int i = 0; i < NR_BENCH_PERF_EVENTS; i++) {
+                if (perf->fd[i] >= 0) {
+                        ioctl(perf->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+                }
+        }
+        for (int i = 0; i < NR_BENCH_PERF_EVENTS; i++) {
+                uint64_t data[3]; /**< value, time_enabled, time_running */
+
+                if (perf->fd[i] < 0 ||
+                    read(perf->fd[i], data, sizeof(data)) != sizeof(data) ||
+                    data[2] == 0) {
+                        continue;
+                }
+                value[i] = data[0];
+                if (data[2] < data[1]) { /**< 멀티플렉싱된 경우 */
+                        value[i] = (uint64_t)((double)data[0] *
+                                              ((double)data[1] /
+                                               (double)data[2]));
+                }
+        }
+#else
+        (void)perf;
+#endif
+}
+
+/**
+ * @brief 열린 카운터를 모두 닫는다.
+ */
+void bench_perf_close(struct bench_perf *perf)
+{
+#ifdef __linux__
+        for (int i = 0; i < NR_BENCH_PERF_EVENTS; i++) {
+                if (perf->fd[i] >= 0) {
+                        close(perf->fd[i]);
+                        perf->fd[i] = -1;
+                }
+        }
+#endif
+        perf->nr_open = 0;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file perf.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 벤치마크 구간의 하드웨어 성능 카운터 측정에 대한 선언이다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _BENCH_PERF_H
+#define _BENCH_PERF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BENCH_PERF_UNAVAILABLE UINT64_MAX /**< 열지 못한 카운터의 값 */
+
+/**
+ * @brief 측정하는 하드웨어 이벤트의 종류에 해당한다.
+ */
+enum bench_perf_event {
+        BENCH_PERF_CYCLES = 0,
+        BENCH_PERF_INSTRUCTIONS,
+        BENCH_PERF_L1D_MISSES,
+        BENCH_PERF_LLC_MISSES,
+        BENCH_PERF_DTLB_MISSES,
+        BENCH_PERF_BRANCH_MISSES,
+        NR_BENCH_PERF_EVENTS,
+};
+
+/**
+ * @brief 이벤트마다 따로 연 카운터의 모음에 해당한다.
+ * @details 이벤트를 하나의 그룹으로 묶으면 하나라도 지원되지 않을 때 모두
+ * 열 수 없으므로, 각각 열고 멀티플렉싱된 경우에는 실행 시간의 비율로 보정한다.
+ */
+struct bench_perf {
+        int fd[NR_BENCH_PERF_EVENTS]; /**< 열지 못한 이벤트는 -1이다. */
+        int nr_open;
+};
+
+const char *bench_perf_name(enum bench_perf_event event);
+int bench_perf_open(struct bench_perf *perf);
+void bench_perf_start(struct bench_perf *perf);
+void bench_perf_stop(struct bench_perf *perf,
+                     uint64_t value[NR_BENCH_PERF_EVENTS]);
+void bench_perf_close(struct bench_perf *perf);
+
+#endif
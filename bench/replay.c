@@ -0,0 +1,300 @@
+/**
+ * @file replay.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 기록된 연산을 새로운 B-Tree에 그대로 다시 수행하여 성능을 측정한다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 기록은 B_TREE_TRACE로 빌드한 프로그램에서 btree_trace_open()으로
+ * 남긴다(예: make bench TRACE=1 후 ./bench.out --trace out.trace).
+ * 기본적으로는 연산을 쉬지 않고 수행하며, --timing을 주면 기록된 시간
+ * 간격을 지켜서 수행하므로 원래의 부하를 그대로 재현할 수 있다.
+ *
+ * 사용법: ./replay.out <trace> [--timing] [-t degree] [--json]
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include "btree.h"
+#include "btree-trace.h"
+#include "latency.h"
+
+#ifdef B_TREE_FIXED_DEGREE
+#define REPLAY_DEFAULT_DEGREE B_TREE_FIXED_DEGREE
+#else
+#define REPLAY_DEFAULT_DEGREE 32
+#endif
+#define REPLAY_INIT_CAPACITY 4096
+#define REPLAY_SPIN_NS 50000 /**< 이보다 짧게 남으면 잠들지 않고 기다린다. */
+
+#define NR_REPLAY_OPS (B_TREE_TRACE_DELETE + 1)
+
+static const char *replay_op_name[NR_REPLAY_OPS] = { NULL, "search", "insert",
+                                                     "delete" };
+
+/**
+ * @brief 재생기의 설정에 해당한다.
+ */
+struct replay_config {
+        const char *path;
+        int degree;
+        bool timing; /**< 기록된 시간 간격을 지키는 경우 */
+        bool json;
+};
+
+static void replay_usage(const char *prog)
+{
+        fprintf(stderr, "usage: %s <trace> [--timing] [-t degree] [--json]\n",
+                prog);
+}
+
+static int replay_parse(struct replay_config *config, int argc, char *argv[])
+{
+        for (int i = 1; i < argc; i++) {
+                const char *arg = argv[i];
+
+                if (!strcmp(arg, "--timing")) {
+                        config->timing = true;
+                } else if (!strcmp(arg, "--json")) {
+                        config->json = true;
+                } else if (!strcmp(arg, "-t") || !strcmp(arg, "--degree")) {
+                        if (i + 1 >= argc) {
+                                return -EINVAL;
+                        }
+                        config->degree = atoi(argv[++i]);
+                } else if (arg[0] != '-' && !config->path) {
+                        config->path = arg;
+                } else {
+                        return -EINVAL;
+                }
+        }
+        if (!config->path || config->degree < B_TREE_MIN_DEGREE) {
+                return -EINVAL;
+        }
+        return 0;
+}
+
+/**
+ * @brief 기록을 모두 메모리로 읽어온다.
+ * @details 파일을 읽는 시간이 측정에 섞이지 않도록 미리 읽어둔다.
+ *
+ * @param path 기록 파일의 경로에 해당한다.
+ * @param nr_records 읽은 레코드의 수가 저장될 위치에 해당한다.
+ * @return struct btree_trace_record* 레코드 배열을, 실패 시에는 NULL을 반환한다.
+ */
+static struct btree_trace_record *replay_load(const char *path,
+                                              long *nr_records)
+{
+        struct btree_trace_reader reader;
+        struct btree_trace_record *records = NULL;
+        long capacity = REPLAY_INIT_CAPACITY;
+        long n = 0;
+
+        if (btree_trace_reader_open(&reader, path)) {
+                return NULL;
+        }
+        records = (struct btree_trace_record *)malloc(
+                capacity * sizeof(struct btree_trace_record));
+        if (!records) {
+                goto exception;
+        }
+        while (btree_trace_next(&reader, &records[n])) {
+                if (++n < capacity) {
+                        continue;
+                }
+                struct btree_trace_record *grown =
+                        (struct btree_trace_record *)realloc(
+                                records, 2 * capacity *
+                                                 sizeof(struct btree_trace_record));
+                if (!grown) {
+                        free(records);
+                        records = NULL;
+                        goto exception;
+                }
+                records = grown;
+                capacity *= 2;
+        }
+        *nr_records = n;
+exception:
+        btree_trace_reader_close(&reader);
+        return records;
+}
+
+/**
+ * @brief 단조 시각 deadline(ns)까지 기다린다.
+ */
+static void replay_wait(uint64_t deadline)
+{
+        uint64_t now = bench_now();
+
+        if (now + REPLAY_SPIN_NS < deadline) {
+                const uint64_t sleep_ns = deadline - now - REPLAY_SPIN_NS;
+                struct timespec ts = {
+                        .tv_sec = (time_t)(sleep_ns / 1000000000ull),
+                        .tv_nsec = (long)(sleep_ns % 1000000000ull),
+                };
+                nanosleep(&ts, NULL);
+        }
+        while (bench_now() < deadline) {
+                /* busy wait */
+        }
+}
+
+static void replay_report(const struct replay_config *config,
+                          struct bench_latency *lat, long nr_records,
+                          double run_sec, double lag_sec)
+{
+        const double ops_per_sec = (double)nr_records / run_sec;
+
+        for (int op = 1; op < NR_REPLAY_OPS; op++) {
+                bench_latency_sort(&lat[op]);
+        }
+
+        if (config->json) {
+                printf("{\"trace\":\"%s\",\"records\":%ld,\"degree\":%d,"
+                       "\"timing\":%s,\"run_sec\":%.6f,\"ops_per_sec\":%.1f,"
+                       "\"max_lag_sec\":%.6f,\"latency_ns\":{",
+                       config->path, nr_records, config->degree,
+                       config->timing ? "true" : "false", run_sec, ops_per_sec,
+                       lag_sec);
+                for (int op = 1, first = 1; op < NR_REPLAY_OPS; op++) {
+                        if (lat[op].n == 0) {
+                                continue;
+                        }
+                        printf("%s\"%s\":{\"count\":%ld,\"hits\":%ld,"
+                               "\"p50\":%llu,\"p99\":%llu,\"p999\":%llu}",
+                               first ? "" : ",", replay_op_name[op], lat[op].n,
+                               lat[op].hits,
+                               (unsigned long long)bench_percentile(&lat[op], 50),
+                               (unsigned long long)bench_percentile(&lat[op], 99),
+                               (unsigned long long)bench_percentile(&lat[op], 99.9));
+                        first = 0;
+                }
+                printf("}}\n");
+                return;
+        }
+
+        printf("replay %s: %ld records, degree %d%s\n", config->path,
+               nr_records, config->degree,
+               config->timing ? ", original timing" : "");
+        printf("run =======> %lfs (%.1lf ops/s)\n", run_sec, ops_per_sec);
+        if (config->timing) {
+                printf("max lag =======> %lfs\n", lag_sec);
+        }
+        printf("%-8s %10s %10s %10s %10s %10s\n", "op", "count", "hits",
+               "p50(ns)", "p99(ns)", "p99.9(ns)");
+        for (int op = 1; op < NR_REPLAY_OPS; op++) {
+                if (lat[op].n == 0) {
+                        continue;
+                }
+                printf("%-8s %10ld %10ld %10llu %10llu %10llu\n",
+                       replay_op_name[op], lat[op].n, lat[op].hits,
+                       (unsigned long long)bench_percentile(&lat[op], 50),
+                       (unsigned long long)bench_percentile(&lat[op], 99),
+                       (unsigned long long)bench_percentile(&lat[op], 99.9));
+        }
+}
+
+int main(int argc, char *argv[])
+{
+        struct replay_config config = {
+                .path = NULL,
+                .degree = REPLAY_DEFAULT_DEGREE,
+                .timing = false,
+                .json = false,
+        };
+        struct bench_latency lat[NR_REPLAY_OPS];
+        struct btree_trace_record *records = NULL;
+        struct btree *tree = NULL;
+        long nr_records = 0;
+        uint64_t start = 0, offset = 0, lag = 0;
+        uintptr_t sink = 0;
+        int ret = 0;
+
+        memset(lat, 0, sizeof(lat));
+        if (replay_parse(&config, argc, argv)) {
+                replay_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        records = replay_load(config.path, &nr_records);
+        if (!records) {
+                return EXIT_FAILURE;
+        }
+        for (int op = 1; op < NR_REPLAY_OPS; op++) {
+                lat[op].ns = (uint64_t *)malloc((nr_records + 1) *
+                                                sizeof(uint64_t));
+                if (!lat[op].ns) {
+                        pr_info("Allocation latency buffer failed\n");
+                        ret = -ENOMEM;
+                        goto exception;
+                }
+        }
+
+        tree = btree_alloc(config.degree);
+        if (!tree) {
+                ret = -ENOMEM;
+                goto exception;
+        }
+
+        start = bench_now();
+        for (long i = 0; i < nr_records; i++) {
+                const struct btree_trace_record *record = &records[i];
+                struct btree_search_result result;
+                bool hit = true;
+                uint64_t t0 = 0;
+
+                if (config.timing) {
+                        offset += record->delta_ns;
+                        replay_wait(start + offset);
+                }
+
+                t0 = bench_now();
+                if (config.timing && t0 - start > offset + lag) {
+                        lag = t0 - start - offset;
+                }
+                switch (record->op) {
+                case B_TREE_TRACE_SEARCH:
+                        result = btree_search(tree, record->key);
+                        hit = result.node != NULL;
+                        if (hit) {
+                                sink += (uintptr_t)result.node->items[result.index].data;
+                        }
+                        break;
+                case B_TREE_TRACE_INSERT:
+                        btree_insert(tree, record->key,
+                                     (void *)(uintptr_t)record->key);
+                        break;
+                case B_TREE_TRACE_DELETE:
+                        hit = btree_delete_quiet(tree, record->key) == 0;
+                        break;
+                default:
+                        pr_info("Unknown operation(%d) at record %ld\n",
+                                record->op, i);
+                        ret = -EINVAL;
+                        goto exception;
+                }
+                lat[record->op].ns[lat[record->op].n++] = bench_now() - t0;
+                lat[record->op].hits += hit;
+        }
+
+        replay_report(&config, lat, nr_records,
+                      (double)(bench_now() - start) / 1e9, (double)lag / 1e9);
+        if (sink == 1) { /**< 탐색 결과가 최적화로 사라지지 않도록 한다. */
+                fprintf(stderr, "\n");
+        }
+
+exception:
+        btree_free(tree);
+        for (int op = 1; op < NR_REPLAY_OPS; op++) {
+                free(lat[op].ns);
+        }
+        free(records);
+        return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
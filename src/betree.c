@@ -0,0 +1,878 @@
+/**
+ * @file betree.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 파일 기반 B^epsilon-Tree에 대한 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 삽입, 삭제, upsert는 루트 버퍼에 메시지로 들어가므로 대부분의 연산은
+ * 페이지 하나만 수정한다. 버퍼가 넘치면 노드를 메모리로 읽어들여(decode) 가장
+ * 많은 메시지를 받을 자식으로 한꺼번에 내려보내고, 페이지에 다시 쓸 때(encode)
+ * 용량을 넘은 노드는 여러 페이지로 나뉜다. leaf는 병합하지 않는다.
+ *
+ * 탐색은 루트에서 내려가며 경로에 있는 메시지를 합친다. 위쪽 노드의 메시지가
+ * 항상 더 최근의 것이므로 PUT이나 DELETE를 만나면 바로 끝난다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "betree.h"
+
+#define BNODE(page) ((struct betree_node *)(page))
+
+/**
+ * @brief 메모리로 읽어들인 노드에 해당한다. 배열은 용량 제한 없이 늘어난다.
+ */
+struct betree_mem {
+        bool is_leaf;
+        int n; /**< leaf는 항목의 수를, 내부 노드는 pivot의 수를 가진다. */
+        key_t *keys; /**< leaf의 키 또는 내부 노드의 pivot */
+        uint64_t *values;
+        pgno_t *child;
+        int cap;
+
+        int nr_msgs;
+        struct betree_msg *msgs;
+        int cap_msgs;
+};
+
+/**
+ * @brief 노드가 나뉘면서 부모에 추가되어야 하는 (pivot, 자식)의 목록이다.
+ */
+struct betree_splits {
+        int n;
+        int cap;
+        key_t *keys;
+        pgno_t *child;
+};
+
+static inline key_t *betree_keys(void *x)
+{
+        return (key_t *)((char *)x + sizeof(struct betree_node));
+}
+
+static inline uint64_t *betree_values(struct betree *T, void *x)
+{
+        return (uint64_t *)((char *)x + T->off_values);
+}
+
+static inline pgno_t *betree_child(struct betree *T, void *x)
+{
+        return (pgno_t *)((char *)x + T->off_child);
+}
+
+static inline struct betree_msg *betree_msgs(struct betree *T, void *x)
+{
+        return (struct betree_msg *)((char *)x + T->off_msgs);
+}
+
+/**
+ * @brief 정렬된 키 배열에서 key 이상인 첫 번째 위치를 찾는다.
+ */
+static int betree_lower_bound(const key_t *keys, int n, key_t key)
+{
+        int lo = 0;
+        int hi = n;
+
+        while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (keys[mid] < key) {
+                        lo = mid + 1;
+                } else {
+                        hi = mid;
+                }
+        }
+        return lo;
+}
+
+/**
+ * @brief 키가 내려갈 자식의 위치를 찾는다. 자식 i는 [pivot[i-1], pivot[i])를 맡는다.
+ */
+static int betree_route(const key_t *pivots, int n, key_t key)
+{
+        int lo = 0;
+        int hi = n;
+
+        while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (pivots[mid] <= key) {
+                        lo = mid + 1;
+                } else {
+                        hi = mid;
+                }
+        }
+        return lo;
+}
+
+/**
+ * @brief 메시지 배열에서 key 이상인 첫 번째 메시지의 위치를 찾는다.
+ */
+static int betree_msg_lower_bound(const struct betree_msg *msgs, int n,
+                                  key_t key)
+{
+        int lo = 0;
+        int hi = n;
+
+        while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (msgs[mid].key < key) {
+                        lo = mid + 1;
+                } else {
+                        hi = mid;
+                }
+        }
+        return lo;
+}
+
+/**
+ * @brief 메시지 배열에서 key의 메시지를 찾는다.
+ *
+ * @return int 메시지의 위치를, 없으면 B_TREE_NOT_FOUND를 반환한다.
+ */
+static int betree_find_msg(const struct betree_msg *msgs, int n, key_t key)
+{
+        const int i = betree_msg_lower_bound(msgs, n, key);
+        return (i < n && msgs[i].key == key) ? i : B_TREE_NOT_FOUND;
+}
+
+/**
+ * @brief 같은 키의 오래된 메시지 위에 새로운 메시지를 합친다.
+ */
+static void betree_combine(struct betree_msg *old, const struct betree_msg *new)
+{
+        if (new->type != BE_TREE_UPSERT) {
+                *old = *new;
+        } else if (old->type == BE_TREE_DELETE) {
+                old->type = BE_TREE_PUT;
+                old->value = new->value;
+        } else { /**< PUT 또는 UPSERT 위의 UPSERT */
+                old->value += new->value;
+        }
+}
+
+/**
+ * @brief 메모리 노드의 배열이 주어진 크기를 담을 수 있도록 늘린다.
+ */
+static int betree_mem_reserve(struct betree_mem *mem, int n, int nr_msgs)
+{
+        if (n > mem->cap || !mem->keys) {
+                int cap = n > 2 * mem->cap ? n : 2 * mem->cap;
+                cap = cap > 8 ? cap : 8;
+                key_t *keys = realloc(mem->keys, cap * sizeof(key_t));
+                uint64_t *values = NULL;
+                pgno_t *child = NULL;
+
+                if (keys) {
+                        mem->keys = keys;
+                }
+                values = realloc(mem->values, cap * sizeof(uint64_t));
+                if (values) {
+                        mem->values = values;
+                }
+                child = realloc(mem->child, (cap + 1) * sizeof(pgno_t));
+                if (child) {
+                        mem->child = child;
+                }
+                if (!keys || !values || !child) {
+                        return -ENOMEM;
+                }
+                mem->cap = cap;
+        }
+        if (nr_msgs > mem->cap_msgs || !mem->msgs) {
+                int cap = nr_msgs > 2 * mem->cap_msgs ? nr_msgs :
+                                                        2 * mem->cap_msgs;
+                cap = cap > 8 ? cap : 8;
+                struct betree_msg *msgs =
+                        realloc(mem->msgs, cap * sizeof(struct betree_msg));
+                if (!msgs) {
+                        return -ENOMEM;
+                }
+                mem->msgs = msgs;
+                mem->cap_msgs = cap;
+        }
+        return 0;
+}
+
+static void betree_mem_free(struct betree_mem *mem)
+{
+        free(mem->keys);
+        free(mem->values);
+        free(mem->child);
+        free(mem->msgs);
+}
+
+/**
+ * @brief 나뉜 노드를 목록에 추가한다.
+ */
+static int betree_splits_push(struct betree_splits *splits, key_t key,
+                              pgno_t child)
+{
+        if (splits->n == splits->cap) {
+                int cap = splits->cap ? 2 * splits->cap : 8;
+                key_t *keys = realloc(splits->keys, cap * sizeof(key_t));
+                pgno_t *children = NULL;
+
+                if (keys) {
+                        splits->keys = keys;
+                }
+                children = realloc(splits->child, cap * sizeof(pgno_t));
+                if (children) {
+                        splits->child = children;
+                }
+                if (!keys || !children) {
+                        return -ENOMEM;
+                }
+                splits->cap = cap;
+        }
+        splits->keys[splits->n] = key;
+        splits->child[splits->n] = child;
+        splits->n++;
+        return 0;
+}
+
+/**
+ * @brief 페이지의 노드를 메모리로 읽어들이도록 한다.
+ */
+static int betree_decode(struct betree *T, pgno_t pgno, struct betree_mem *mem)
+{
+        void *x = pager_pin(T->pager, pgno);
+        int ret = 0;
+
+        if (!x) {
+                return -EIO;
+        }
+        mem->is_leaf = BNODE(x)->is_leaf;
+        mem->n = BNODE(x)->n;
+        mem->nr_msgs = mem->is_leaf ? 0 : BNODE(x)->nr_msgs;
+        ret = betree_mem_reserve(mem, mem->n, mem->nr_msgs);
+        if (!ret) {
+                memcpy(mem->keys, betree_keys(x), mem->n * sizeof(key_t));
+                if (mem->is_leaf) {
+                        memcpy(mem->values, betree_values(T, x),
+                               mem->n * sizeof(uint64_t));
+                } else {
+                        memcpy(mem->child, betree_child(T, x),
+                               (mem->n + 1) * sizeof(pgno_t));
+                        memcpy(mem->msgs, betree_msgs(T, x),
+                               mem->nr_msgs * sizeof(struct betree_msg));
+                }
+        }
+        pager_unpin(T->pager, pgno, false);
+        return ret;
+}
+
+/**
+ * @brief 메모리 노드의 일부를 페이지 하나에 기록한다.
+ *
+ * @param key_begin leaf는 항목의, 내부 노드는 자식의 시작 위치에 해당한다.
+ * @param key_end leaf는 항목의, 내부 노드는 자식의 끝 위치(미포함)에 해당한다.
+ * @param msg_begin 기록할 메시지의 시작 위치에 해당한다.
+ * @param msg_end 기록할 메시지의 끝 위치(미포함)에 해당한다.
+ */
+static int betree_write(struct betree *T, pgno_t pgno,
+                        const struct betree_mem *mem, int key_begin,
+                        int key_end, int msg_begin, int msg_end)
+{
+        void *x = pager_pin(T->pager, pgno);
+
+        if (!x) {
+                return -EIO;
+        }
+        BNODE(x)->is_leaf = mem->is_leaf;
+        if (mem->is_leaf) {
+                BNODE(x)->n = (uint16_t)(key_end - key_begin);
+                BNODE(x)->nr_msgs = 0;
+                memcpy(betree_keys(x), mem->keys + key_begin,
+                       (key_end - key_begin) * sizeof(key_t));
+                memcpy(betree_values(T, x), mem->values + key_begin,
+                       (key_end - key_begin) * sizeof(uint64_t));
+        } else {
+                BNODE(x)->n = (uint16_t)(key_end - key_begin - 1);
+                BNODE(x)->nr_msgs = (uint16_t)(msg_end - msg_begin);
+                memcpy(betree_keys(x), mem->keys + key_begin,
+                       (key_end - key_begin - 1) * sizeof(key_t));
+                memcpy(betree_child(T, x), mem->child + key_begin,
+                       (key_end - key_begin) * sizeof(pgno_t));
+                memcpy(betree_msgs(T, x), mem->msgs + msg_begin,
+                       (msg_end - msg_begin) * sizeof(struct betree_msg));
+        }
+        pager_unpin(T->pager, pgno, true);
+        return 0;
+}
+
+/**
+ * @brief 메모리 노드를 페이지에 기록하도록 한다.
+ * @details 용량을 넘은 경우에는 고르게 나누어 새로운 페이지에 기록하고,
+ * 새로운 페이지와 그 시작 키를 splits에 추가한다.
+ *
+ * @param T B^epsilon-Tree를 가리키는 포인터에 해당한다.
+ * @param pgno 첫 번째 부분이 기록될 원래의 페이지 번호에 해당한다.
+ * @param mem 기록할 메모리 노드로 메시지의 수는 용량 이하여야 한다.
+ * @param splits 부모에 추가되어야 할 목록으로 비어있어야 한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+static int betree_encode(struct betree *T, pgno_t pgno,
+                         const struct betree_mem *mem,
+                         struct betree_splits *splits)
+{
+        const int total = mem->is_leaf ? mem->n : mem->n + 1;
+        const int cap = mem->is_leaf ? T->leaf_cap : T->fanout;
+        const int parts = total > cap ? (total + cap - 1) / cap : 1;
+        int msg_begin = 0;
+        int ret = 0;
+
+        for (int p = 0; !ret && p < parts; p++) {
+                const int begin = (int)((long)total * p / parts);
+                const int end = (int)((long)total * (p + 1) / parts);
+                int msg_end = mem->nr_msgs;
+                pgno_t target = pgno;
+
+                if (!mem->is_leaf && p + 1 < parts) {
+                        msg_end = msg_begin;
+                        while (msg_end < mem->nr_msgs &&
+                               mem->msgs[msg_end].key < mem->keys[end - 1]) {
+                                msg_end++;
+                        }
+                }
+                if (p > 0) {
+                        void *x = pager_pin_new(T->pager, &target);
+                        if (!x) {
+                                return -EIO;
+                        }
+                        pager_unpin(T->pager, target, true);
+                        ret = betree_splits_push(
+                                splits,
+                                mem->is_leaf ? mem->keys[begin] :
+                                               mem->keys[begin - 1],
+                                target);
+                        T->stats.splits++;
+                }
+                ret = ret ? ret :
+                            betree_write(T, target, mem, begin, end, msg_begin,
+                                         msg_end);
+                msg_begin = msg_end;
+        }
+        return ret;
+}
+
+/**
+ * @brief 정렬된 메시지를 메모리 노드의 버퍼에 합친다.
+ * @note 들어오는 메시지가 버퍼에 있는 메시지보다 최근의 것이다.
+ */
+static int betree_merge_msgs(struct betree_mem *mem,
+                             const struct betree_msg *msgs, int nr)
+{
+        struct betree_msg *merged = NULL;
+        int i = 0, j = 0, k = 0;
+
+        merged = malloc((mem->nr_msgs + nr) * sizeof(struct betree_msg));
+        if (!merged) {
+                return -ENOMEM;
+        }
+        while (i < mem->nr_msgs || j < nr) {
+                if (j == nr ||
+                    (i < mem->nr_msgs && mem->msgs[i].key < msgs[j].key)) {
+                        merged[k++] = mem->msgs[i++];
+                } else if (i == mem->nr_msgs ||
+                           msgs[j].key < mem->msgs[i].key) {
+                        merged[k++] = msgs[j++];
+                } else {
+                        merged[k] = mem->msgs[i++];
+                        betree_combine(&merged[k++], &msgs[j++]);
+                }
+        }
+        free(mem->msgs);
+        mem->msgs = merged;
+        mem->nr_msgs = k;
+        mem->cap_msgs = mem->nr_msgs + nr;
+        return 0;
+}
+
+/**
+ * @brief 정렬된 메시지를 메모리로 읽어들인 leaf에 적용한다.
+ */
+static int betree_apply_leaf(struct betree_mem *mem,
+                             const struct betree_msg *msgs, int nr)
+{
+        struct betree_mem out;
+        int i = 0, j = 0;
+        int ret = 0;
+
+        memset(&out, 0, sizeof(struct betree_mem));
+        ret = betree_mem_reserve(&out, mem->n + nr, 0);
+        if (ret) {
+                betree_mem_free(&out);
+                return ret;
+        }
+        while (i < mem->n || j < nr) {
+                if (j == nr || (i < mem->n && mem->keys[i] < msgs[j].key)) {
+                        out.keys[out.n] = mem->keys[i];
+                        out.values[out.n++] = mem->values[i++];
+                        continue;
+                }
+
+                const bool exist = i < mem->n && mem->keys[i] == msgs[j].key;
+                const uint64_t base = exist ? mem->values[i] : 0;
+
+                if (msgs[j].type != BE_TREE_DELETE) {
+                        out.keys[out.n] = msgs[j].key;
+                        out.values[out.n++] = msgs[j].type == BE_TREE_UPSERT ?
+                                                      base + msgs[j].value :
+                                                      msgs[j].value;
+                }
+                i += exist;
+                j++;
+        }
+
+        free(mem->keys);
+        free(mem->values);
+        free(mem->child);
+        free(out.msgs);
+        mem->keys = out.keys;
+        mem->values = out.values;
+        mem->child = out.child;
+        mem->cap = out.cap;
+        mem->n = out.n;
+        return 0;
+}
+
+/**
+ * @brief 정렬된 메시지를 pgno를 루트로 하는 부트리에 밀어넣는다.
+ * @details 내부 노드는 버퍼에 메시지를 합친 뒤, 버퍼가 넘치는 동안 가장 많은
+ * 메시지를 받을 자식으로 그 메시지들을 재귀적으로 내려보낸다.
+ *
+ * @param T B^epsilon-Tree를 가리키는 포인터에 해당한다.
+ * @param pgno 부트리의 루트 페이지 번호에 해당한다.
+ * @param msgs 키 순서로 정렬되고 키가 유일한 메시지 배열에 해당한다.
+ * @param nr 메시지의 수에 해당한다.
+ * @param splits 노드가 나뉜 경우에 부모에 추가되어야 할 목록이다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+static int betree_push(struct betree *T, pgno_t pgno,
+                       const struct betree_msg *msgs, int nr,
+                       struct betree_splits *splits)
+{
+        struct betree_mem mem;
+        struct betree_splits sub;
+        int ret = 0;
+
+        memset(&mem, 0, sizeof(struct betree_mem));
+        memset(&sub, 0, sizeof(struct betree_splits));
+
+        ret = betree_decode(T, pgno, &mem);
+        if (ret) {
+                goto exception;
+        }
+        if (mem.is_leaf) {
+                ret = betree_apply_leaf(&mem, msgs, nr);
+                ret = ret ? ret : betree_encode(T, pgno, &mem, splits);
+                goto exception;
+        }
+
+        ret = betree_merge_msgs(&mem, msgs, nr);
+        while (!ret && mem.nr_msgs > T->msg_cap) {
+                int best = 0, best_begin = 0, best_nr = 0;
+                int begin = 0;
+                struct betree_msg *moved = NULL;
+
+                for (int c = 0; c <= mem.n; c++) { /**< 가장 많이 받을 자식 */
+                        int end = begin;
+                        while (end < mem.nr_msgs &&
+                               (c == mem.n || mem.msgs[end].key < mem.keys[c])) {
+                                end++;
+                        }
+                        if (end - begin > best_nr) {
+                                best = c;
+                                best_begin = begin;
+                                best_nr = end - begin;
+                        }
+                        begin = end;
+                }
+
+                moved = malloc(best_nr * sizeof(struct betree_msg));
+                if (!moved) {
+                        ret = -ENOMEM;
+                        break;
+                }
+                memcpy(moved, &mem.msgs[best_begin],
+                       best_nr * sizeof(struct betree_msg));
+                memmove(&mem.msgs[best_begin], &mem.msgs[best_begin + best_nr],
+                        (mem.nr_msgs - best_begin - best_nr) *
+                                sizeof(struct betree_msg));
+                mem.nr_msgs -= best_nr;
+                T->stats.flushes++;
+                T->stats.flushed += best_nr;
+
+                sub.n = 0;
+                ret = betree_push(T, mem.child[best], moved, best_nr, &sub);
+                free(moved);
+                if (ret || !sub.n) {
+                        continue;
+                }
+
+                ret = betree_mem_reserve(&mem, mem.n + sub.n, 0);
+                if (ret) {
+                        break;
+                }
+                memmove(&mem.keys[best + sub.n], &mem.keys[best],
+                        (mem.n - best) * sizeof(key_t));
+                memmove(&mem.child[best + 1 + sub.n], &mem.child[best + 1],
+                        (mem.n - best) * sizeof(pgno_t));
+                memcpy(&mem.keys[best], sub.keys, sub.n * sizeof(key_t));
+                memcpy(&mem.child[best + 1], sub.child, sub.n * sizeof(pgno_t));
+                mem.n += sub.n;
+        }
+        ret = ret ? ret : betree_encode(T, pgno, &mem, splits);
+
+exception:
+        free(sub.keys);
+        free(sub.child);
+        betree_mem_free(&mem);
+        return ret;
+}
+
+/**
+ * @brief 루트가 나뉜 경우에 새로운 루트를 만들어 트리의 높이를 높인다.
+ */
+static int betree_grow(struct betree *T, struct betree_splits *splits)
+{
+        struct betree_mem mem;
+        pgno_t pgno = 0;
+        void *x = NULL;
+        int ret = 0;
+
+        while (!ret && splits->n) {
+                memset(&mem, 0, sizeof(struct betree_mem));
+                ret = betree_mem_reserve(&mem, splits->n, 0);
+                if (ret) {
+                        break;
+                }
+                mem.is_leaf = false;
+                mem.n = splits->n;
+                mem.child[0] = T->meta.root;
+                memcpy(mem.keys, splits->keys, splits->n * sizeof(key_t));
+                memcpy(&mem.child[1], splits->child, splits->n * sizeof(pgno_t));
+
+                x = pager_pin_new(T->pager, &pgno);
+                if (x) {
+                        pager_unpin(T->pager, pgno, true);
+                        splits->n = 0;
+                        ret = betree_encode(T, pgno, &mem, splits);
+                        T->meta.root = pgno;
+                } else {
+                        ret = -EIO;
+                }
+                betree_mem_free(&mem);
+        }
+        return ret;
+}
+
+/**
+ * @brief 메시지를 트리에 넣도록 한다.
+ * @details 루트 버퍼에 자리가 있으면 페이지 안에서 바로 넣고, 그렇지 않으면
+ * 버퍼를 비우는 경로를 거친다.
+ */
+static int betree_put_msg(struct betree *T, const struct betree_msg *msg)
+{
+        struct betree_splits splits;
+        void *x = pager_pin(T->pager, T->meta.root);
+        int ret = 0;
+
+        if (!x) {
+                return -EIO;
+        }
+        if (!BNODE(x)->is_leaf) {
+                struct betree_msg *msgs = betree_msgs(T, x);
+                const int n = BNODE(x)->nr_msgs;
+                const int i = betree_msg_lower_bound(msgs, n, msg->key);
+
+                if (i < n && msgs[i].key == msg->key) {
+                        betree_combine(&msgs[i], msg);
+                        pager_unpin(T->pager, T->meta.root, true);
+                        return 0;
+                }
+                if (n < T->msg_cap) {
+                        memmove(&msgs[i + 1], &msgs[i],
+                                (n - i) * sizeof(struct betree_msg));
+                        msgs[i] = *msg;
+                        BNODE(x)->nr_msgs++;
+                        pager_unpin(T->pager, T->meta.root, true);
+                        return 0;
+                }
+        }
+        pager_unpin(T->pager, T->meta.root, false);
+
+        memset(&splits, 0, sizeof(struct betree_splits));
+        ret = betree_push(T, T->meta.root, msg, 1, &splits);
+        ret = ret ? ret : betree_grow(T, &splits);
+        free(splits.keys);
+        free(splits.child);
+        return ret;
+}
+
+/**
+ * @brief 키에 값을 넣도록 한다. 이미 있는 키라면 값을 덮어쓴다.
+ *
+ * @param tree B^epsilon-Tree를 가리키는 포인터에 해당한다.
+ * @param key 입력하고자 하는 키에 해당한다.
+ * @param value 키와 함께 입력되고자 하는 값에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int betree_put(struct betree *tree, key_t key, uint64_t value)
+{
+        const struct betree_msg msg = { .value = value,
+                                        .key = key,
+                                        .type = BE_TREE_PUT };
+        return betree_put_msg(tree, &msg);
+}
+
+/**
+ * @brief 키를 지우도록 한다.
+ *
+ * @param tree B^epsilon-Tree를 가리키는 포인터에 해당한다.
+ * @param key 지우고자 하는 키에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ *
+ * @note 삭제는 메시지로만 기록되므로 키가 없더라도 0을 반환한다.
+ */
+int betree_delete(struct betree *tree, key_t key)
+{
+        const struct betree_msg msg = { .value = 0,
+                                        .key = key,
+                                        .type = BE_TREE_DELETE };
+        return betree_put_msg(tree, &msg);
+}
+
+/**
+ * @brief 키의 값에 delta를 더하도록 한다. 키가 없으면 delta가 값이 된다.
+ *
+ * @param tree B^epsilon-Tree를 가리키는 포인터에 해당한다.
+ * @param key 갱신하고자 하는 키에 해당한다.
+ * @param delta 더할 값에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int betree_upsert(struct betree *tree, key_t key, uint64_t delta)
+{
+        const struct betree_msg msg = { .value = delta,
+                                        .key = key,
+                                        .type = BE_TREE_UPSERT };
+        return betree_put_msg(tree, &msg);
+}
+
+/**
+ * @brief B^epsilon-Tree에 대한 탐색을 수행하도록 한다.
+ * @details 경로에 있는 UPSERT 메시지는 모아두었다가 아래쪽에서 찾은 값에 더한다.
+ *
+ * @param tree B^epsilon-Tree를 가리키는 포인터에 해당한다.
+ * @param key 찾고자 하는 키에 해당한다.
+ * @param value 찾은 값을 받을 위치로 NULL이면 무시한다.
+ * @return int 찾은 경우에는 0을, 없는 경우에는 -ENOENT를 반환한다.
+ */
+int betree_search(struct betree *tree, key_t key, uint64_t *value)
+{
+        pgno_t pgno = tree->meta.root;
+        uint64_t delta = 0;
+        bool upserted = false;
+
+        for (;;) {
+                void *x = pager_pin(tree->pager, pgno);
+                const key_t *keys = NULL;
+                int i = 0;
+
+                if (!x) {
+                        return -EIO;
+                }
+                keys = betree_keys(x);
+                if (BNODE(x)->is_leaf) {
+                        i = betree_lower_bound(keys, BNODE(x)->n, key);
+                        const bool found = i < BNODE(x)->n && keys[i] == key;
+                        const uint64_t base =
+                                found ? betree_values(tree, x)[i] : 0;
+
+                        pager_unpin(tree->pager, pgno, false);
+                        if (!found && !upserted) {
+                                return -ENOENT;
+                        }
+                        if (value) {
+                                *value = base + delta;
+                        }
+                        return 0;
+                }
+
+                i = betree_find_msg(betree_msgs(tree, x), BNODE(x)->nr_msgs,
+                                    key);
+                if (i != B_TREE_NOT_FOUND) {
+                        const struct betree_msg msg = betree_msgs(tree, x)[i];
+
+                        if (msg.type != BE_TREE_UPSERT) {
+                                pager_unpin(tree->pager, pgno, false);
+                                if (msg.type == BE_TREE_DELETE && !upserted) {
+                                        return -ENOENT;
+                                }
+                                if (value) {
+                                        *value = delta + (msg.type == BE_TREE_PUT ?
+                                                                  msg.value :
+                                                                  0);
+                                }
+                                return 0;
+                        }
+                        delta += msg.value;
+                        upserted = true;
+                }
+
+                i = betree_route(keys, BNODE(x)->n, key);
+                const pgno_t next = betree_child(tree, x)[i];
+                pager_unpin(tree->pager, pgno, false);
+                pgno = next;
+        }
+}
+
+/**
+ * @brief 메모리에 있는 메타 데이터를 0번 페이지에 반영한다.
+ */
+static int betree_write_meta(struct betree *T)
+{
+        void *page = pager_pin(T->pager, BE_TREE_META_PGNO);
+        if (!page) {
+                return -EIO;
+        }
+        memcpy(page, &T->meta, sizeof(struct betree_meta));
+        pager_unpin(T->pager, BE_TREE_META_PGNO, true);
+        return 0;
+}
+
+/**
+ * @brief 페이지 크기와 fanout에 맞추어 노드의 배치를 정한다.
+ */
+static void betree_layout(struct betree *T, size_t page_size, int fanout)
+{
+        const size_t header = sizeof(struct betree_node);
+
+        T->fanout = fanout;
+        T->leaf_cap = (int)((page_size - header - sizeof(key_t)) /
+                            (sizeof(key_t) + sizeof(uint64_t)));
+        T->off_values = header + T->leaf_cap * sizeof(key_t);
+        T->off_values = (T->off_values + 7) & ~(size_t)7;
+
+        T->off_child = header + (fanout - 1) * sizeof(key_t);
+        T->off_msgs = T->off_child + fanout * sizeof(pgno_t);
+        T->off_msgs = (T->off_msgs + 7) & ~(size_t)7;
+        T->msg_cap = (int)((page_size - T->off_msgs) / sizeof(struct betree_msg));
+}
+
+/**
+ * @brief B^epsilon-Tree를 열도록 한다. 파일이 비어있으면 새로 만든다.
+ *
+ * @param path 트리가 저장될 파일의 경로에 해당한다.
+ * @param config 페이지 크기, 버퍼 풀의 크기, fanout에 해당한다.
+ * NULL이면 기본값을 사용한다.
+ * @return struct betree* 정상적으로 열린 경우에는 트리의 주소가 반환된다.
+ * @exception 파일이 손상되었거나 설정이 올바르지 않은 경우에는 NULL이 반환된다.
+ *
+ * @warning 이미 있는 파일을 열 때는 만들 때와 같은 페이지 크기를 주어야 한다.
+ * fanout은 파일에 저장된 값을 따른다.
+ */
+struct betree *betree_open(const char *path, const struct betree_config *config)
+{
+        struct betree *tree = NULL;
+        size_t page_size = BE_TREE_DEFAULT_PAGE_SIZE;
+        int pool_pages = BE_TREE_DEFAULT_POOL_PAGES;
+        int fanout = BE_TREE_DEFAULT_FANOUT;
+        void *page = NULL;
+        pgno_t pgno = 0;
+
+        if (config && config->page_size) {
+                page_size = config->page_size;
+        }
+        if (config && config->pool_pages) {
+                pool_pages = config->pool_pages;
+        }
+        if (config && config->fanout) {
+                fanout = config->fanout;
+        }
+
+        tree = (struct betree *)calloc(1, sizeof(struct betree));
+        if (!tree) {
+                pr_info("Allocation tree failed\n");
+                return NULL;
+        }
+        tree->pager = pager_open(path, page_size, pool_pages);
+        if (!tree->pager) {
+                goto exception;
+        }
+
+        if (tree->pager->nr_pages == 0) { /**< 새로운 파일 */
+                page = pager_pin_new(tree->pager, &pgno); /**< meta */
+                if (!page) {
+                        goto exception;
+                }
+                pager_unpin(tree->pager, pgno, true);
+
+                page = pager_pin_new(tree->pager, &pgno); /**< root */
+                if (!page) {
+                        goto exception;
+                }
+                BNODE(page)->is_leaf = true;
+                pager_unpin(tree->pager, pgno, true);
+
+                tree->meta.magic = BE_TREE_MAGIC;
+                tree->meta.page_size = (uint32_t)page_size;
+                tree->meta.root = pgno;
+                tree->meta.fanout = (uint32_t)fanout;
+        } else {
+                page = pager_pin(tree->pager, BE_TREE_META_PGNO);
+                if (!page) {
+                        goto exception;
+                }
+                memcpy(&tree->meta, page, sizeof(struct betree_meta));
+                pager_unpin(tree->pager, BE_TREE_META_PGNO, false);
+                if (tree->meta.magic != BE_TREE_MAGIC ||
+                    tree->meta.page_size != page_size) {
+                        pr_info("Invalid B^e-Tree file(%s)\n", path);
+                        goto exception;
+                }
+        }
+
+        betree_layout(tree, page_size, (int)tree->meta.fanout);
+        if (tree->fanout < BE_TREE_MIN_FANOUT || tree->msg_cap < tree->fanout) {
+                pr_info("Invalid fanout(%d)\n", tree->fanout);
+                goto exception;
+        }
+        if (betree_write_meta(tree)) {
+                goto exception;
+        }
+        return tree;
+
+exception:
+        pager_close(tree->pager);
+        free(tree);
+        return NULL;
+}
+
+/**
+ * @brief 수정된 모든 페이지를 기록하고 파일을 동기화하도록 한다.
+ *
+ * @param tree B^epsilon-Tree를 가리키는 포인터에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int betree_sync(struct betree *tree)
+{
+        int ret = betree_write_meta(tree);
+        return ret ? ret : pager_sync(tree->pager);
+}
+
+/**
+ * @brief B^epsilon-Tree를 닫고 할당된 메모리를 해제한다.
+ *
+ * @param tree B^epsilon-Tree를 가리키는 포인터에 해당한다.
+ */
+void betree_close(struct betree *tree)
+{
+        if (tree) {
+                betree_sync(tree);
+                pager_close(tree->pager);
+                free(tree);
+        }
+}
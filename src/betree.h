@@ -0,0 +1,113 @@
+/**
+ * @file betree.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 쓰기에 최적화된 파일 기반 B^epsilon-Tree에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _BE_TREE_H
+#define _BE_TREE_H
+
+#include <stdint.h>
+#include "btree.h"
+#include "pager.h"
+
+#define BE_TREE_MAGIC 0x52544542u /**< "BETR" */
+#define BE_TREE_META_PGNO 0
+#define BE_TREE_DEFAULT_PAGE_SIZE (4 * 1024)
+#define BE_TREE_DEFAULT_POOL_PAGES 1024
+#define BE_TREE_DEFAULT_FANOUT 16 /**< 4KiB 페이지에서 약 B^0.5에 해당한다. */
+#define BE_TREE_MIN_FANOUT 4
+
+/**
+ * @brief 내부 노드의 버퍼에 쌓이는 메시지의 종류에 해당한다.
+ */
+enum betree_msg_type {
+        BE_TREE_PUT = 1, /**< 값을 덮어쓴다. */
+        BE_TREE_DELETE, /**< 키를 지운다. */
+        BE_TREE_UPSERT, /**< 값에 더한다. 키가 없으면 0에 더한 것으로 본다. */
+};
+
+/**
+ * @brief 버퍼에 저장되는 메시지에 해당한다.
+ * @note 한 버퍼 안에서 키는 유일하며, 같은 키의 메시지는 합쳐진다.
+ */
+struct betree_msg {
+        uint64_t value;
+        key_t key;
+        uint32_t type; /**< enum betree_msg_type */
+};
+
+/**
+ * @brief B^epsilon-Tree를 열 때 사용하는 설정에 해당한다.
+ * @note 0으로 둔 항목은 기본값이 사용된다.
+ */
+struct betree_config {
+        size_t page_size;
+        int pool_pages;
+        int fanout; /**< 내부 노드가 가지는 최대 자식의 수에 해당한다. */
+};
+
+/**
+ * @brief 0번 페이지에 저장되는 메타 데이터에 해당한다.
+ */
+struct betree_meta {
+        uint32_t magic;
+        uint32_t page_size;
+        pgno_t root;
+        uint32_t fanout;
+};
+
+/**
+ * @brief 페이지에 저장되는 노드의 머리 부분에 해당한다.
+ * @details leaf는 머리 뒤에 키와 값의 배열을, 내부 노드는 pivot 키, 자식 페이지
+ * 번호, 메시지의 배열을 차례대로 가진다.
+ */
+struct betree_node {
+        uint16_t n; /**< leaf는 항목의 수를, 내부 노드는 pivot의 수를 가진다. */
+        uint16_t nr_msgs;
+        uint8_t is_leaf;
+        uint8_t reserved[3];
+};
+
+/**
+ * @brief 버퍼를 비우는(flush) 동작에 대한 통계를 가진다.
+ */
+struct betree_stats {
+        unsigned long flushes; /**< 버퍼를 자식으로 내려보낸 횟수 */
+        unsigned long flushed; /**< 내려보낸 메시지의 수 */
+        unsigned long splits; /**< 새로 만들어진 노드의 수 */
+};
+
+/**
+ * @brief B^epsilon-Tree 전체를 관리하는 구조체에 해당한다.
+ * @details 항목은 leaf에만 있으며(B+-Tree), 갱신은 루트의 버퍼에 메시지로
+ * 쌓였다가 버퍼가 차면 가장 많은 메시지를 받을 자식으로 한꺼번에 내려간다.
+ */
+struct betree {
+        struct pager *pager;
+        struct betree_meta meta;
+
+        int fanout;
+        int leaf_cap; /**< leaf가 가질 수 있는 최대 항목의 수 */
+        int msg_cap; /**< 내부 노드가 가질 수 있는 최대 메시지의 수 */
+        size_t off_values; /**< leaf에서 값 배열이 시작하는 위치 */
+        size_t off_child; /**< 내부 노드에서 자식 배열이 시작하는 위치 */
+        size_t off_msgs; /**< 내부 노드에서 메시지 배열이 시작하는 위치 */
+
+        struct betree_stats stats;
+};
+
+struct betree *betree_open(const char *path,
+                           const struct betree_config *config);
+int betree_put(struct betree *tree, key_t key, uint64_t value);
+int betree_delete(struct betree *tree, key_t key);
+int betree_upsert(struct betree *tree, key_t key, uint64_t delta);
+int betree_search(struct betree *tree, key_t key, uint64_t *value);
+int betree_sync(struct betree *tree);
+void betree_close(struct betree *tree);
+
+#endif
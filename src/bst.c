@@ -0,0 +1,237 @@
+/**
+ * @file bst.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 비교를 위한 균형을 맞추지 않는 이진 탐색 트리의 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details CLRS 12장의 의사 코드(TREE-INSERT, TREE-DELETE)를 기반으로 작성하였다.
+ * 정렬된 순서로 삽입하면 높이가 n이 되므로 재귀 없이 구현하였다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#include <stdlib.h>
+#include <errno.h>
+#include "bst.h"
+
+/**
+ * @brief 새로운 이진 탐색 트리를 할당하도록 한다.
+ *
+ * @return struct bst* 할당된 트리를, 동적 할당을 실패한 경우에는 NULL을 반환한다.
+ */
+struct bst *bst_alloc(void)
+{
+        struct bst *tree = (struct bst *)malloc(sizeof(struct bst));
+
+        if (!tree) {
+                pr_info("Allocation tree failed\n");
+                return NULL;
+        }
+        tree->root = NULL;
+        tree->size = 0;
+        return tree;
+}
+
+/**
+ * @brief 트리에 항목을 삽입하도록 한다.
+ *
+ * @return int 성공 시에 0을, 동적 할당을 실패한 경우에는 -ENOMEM을 반환한다.
+ */
+int bst_insert(struct bst *tree, key_t key, void *data)
+{
+        struct bst_node *z = NULL;
+        struct bst_node *y = NULL;
+        struct bst_node *x = tree->root;
+
+        z = (struct bst_node *)malloc(sizeof(struct bst_node));
+        if (!z) {
+                pr_info("Node allocation failed...\n");
+                return -ENOMEM;
+        }
+        z->item.key = key;
+        z->item.data = data;
+        z->left = z->right = NULL;
+
+        while (x) {
+                y = x;
+                x = (key < x->item.key) ? x->left : x->right;
+        }
+        z->parent = y;
+        if (!y) {
+                tree->root = z;
+        } else if (key < y->item.key) {
+                y->left = z;
+        } else {
+                y->right = z;
+        }
+        tree->size++;
+        return 0;
+}
+
+/**
+ * @brief 키에 해당하는 노드를 찾는다.
+ *
+ * @return struct bst_node* 찾은 노드를, 없는 경우에는 NULL을 반환한다.
+ */
+struct bst_node *bst_search(struct bst *tree, key_t key)
+{
+        struct bst_node *x = tree->root;
+
+        while (x && key != x->item.key) {
+                x = (key < x->item.key) ? x->left : x->right;
+        }
+        return x;
+}
+
+static struct bst_node *bst_minimum(struct bst_node *x)
+{
+        while (x->left) {
+                x = x->left;
+        }
+        return x;
+}
+
+static struct bst_node *bst_successor(struct bst_node *x)
+{
+        if (x->right) {
+                return bst_minimum(x->right);
+        }
+        while (x->parent && x == x->parent->right) {
+                x = x->parent;
+        }
+        return x->parent;
+}
+
+static void bst_transplant(struct bst *T, struct bst_node *u,
+                           struct bst_node *v)
+{
+        if (!u->parent) {
+                T->root = v;
+        } else if (u == u->parent->left) {
+                u->parent->left = v;
+        } else {
+                u->parent->right = v;
+        }
+        if (v) {
+                v->parent = u->parent;
+        }
+}
+
+/**
+ * @brief 키에 해당하는 항목 하나를 삭제하도록 한다.
+ *
+ * @return int 성공 시에 0을, 키가 없는 경우에는 -EINVAL을 반환한다.
+ */
+int bst_delete(struct bst *tree, key_t key)
+{
+        struct bst_node *z = bst_search(tree, key);
+
+        if (!z) {
+                return -EINVAL;
+        }
+        if (!z->left) {
+                bst_transplant(tree, z, z->right);
+        } else if (!z->right) {
+                bst_transplant(tree, z, z->left);
+        } else {
+                struct bst_node *y = bst_minimum(z->right);
+                if (y->parent != z) {
+                        bst_transplant(tree, y, y->right);
+                        y->right = z->right;
+                        y->right->parent = y;
+                }
+                bst_transplant(tree, z, y);
+                y->left = z->left;
+                y->left->parent = y;
+        }
+        free(z);
+        tree->size--;
+        return 0;
+}
+
+/**
+ * @brief start 이상인 항목을 키 순서대로 최대 count개 방문한다.
+ *
+ * @return int 방문한 항목의 수를 반환한다. fn이 0이 아닌 값을 반환하면
+ * 그 항목까지 세고 방문을 멈춘다.
+ */
+int bst_scan(struct bst *tree, key_t start, int count, btree_visit_fn fn,
+             void *private)
+{
+        struct bst_node *x = tree->root;
+        struct bst_node *next = NULL;
+        int visited = 0;
+
+        while (x) {
+                if (x->item.key >= start) {
+                        next = x;
+                        x = x->left;
+                } else {
+                        x = x->right;
+                }
+        }
+        for (x = next; x && visited < count; x = bst_successor(x)) {
+                visited++;
+                if (fn(&x->item, private)) {
+                        break;
+                }
+        }
+        return visited;
+}
+
+/**
+ * @brief 트리 전체를 해제한다.
+ */
+void bst_free(struct bst *tree)
+{
+        struct bst_node *x = NULL;
+
+        if (!tree) {
+                return;
+        }
+        x = tree->root;
+        while (x) { /**< 재귀 없이 leaf부터 차례로 해제한다. */
+                struct bst_node *parent = x->parent;
+
+                if (x->left) {
+                        x = x->left;
+                        continue;
+                }
+                if (x->right) {
+                        x = x->right;
+                        continue;
+                }
+                if (parent) {
+                        if (parent->left == x) {
+                                parent->left = NULL;
+                        } else {
+                                parent->right = NULL;
+                        }
+                }
+                free(x);
+                x = parent;
+        }
+        free(tree);
+}
+
+#ifdef TG_BST_TREE_DEBUG
+/**
+ * @brief 중위 순회의 순서가 정렬되어 있는 지 검사한다.
+ *
+ * @return int 정렬되어 있으면 항목의 수를, 그렇지 않으면 -EINVAL을 반환한다.
+ */
+int bst_validate(struct bst *tree)
+{
+        struct bst_node *x = tree->root ? bst_minimum(tree->root) : NULL;
+        long n = 0;
+
+        for (; x; x = bst_successor(x), n++) {
+                struct bst_node *next = bst_successor(x);
+                if (next && next->item.key < x->item.key) {
+                        pr_info("Order violated at node(%u)\n", x->item.key);
+                        return -EINVAL;
+                }
+        }
+        return (n == tree->size) ? (int)n : -EINVAL;
+}
+#endif
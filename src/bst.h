@@ -0,0 +1,45 @@
+/**
+ * @file bst.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 비교를 위한 균형을 맞추지 않는 이진 탐색 트리에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _BST_TREE_H
+#define _BST_TREE_H
+
+#include "btree.h"
+
+/**
+ * @brief 이진 탐색 트리의 노드에 해당한다.
+ */
+struct bst_node {
+        struct btree_item item;
+        struct bst_node *parent;
+        struct bst_node *left;
+        struct bst_node *right;
+};
+
+/**
+ * @brief 이진 탐색 트리 전체를 관리하는 구조체에 해당한다.
+ */
+struct bst {
+        struct bst_node *root;
+        long size;
+};
+
+struct bst *bst_alloc(void);
+int bst_insert(struct bst *tree, key_t key, void *data);
+struct bst_node *bst_search(struct bst *tree, key_t key);
+int bst_delete(struct bst *tree, key_t key);
+int bst_scan(struct bst *tree, key_t start, int count, btree_visit_fn fn,
+             void *private);
+void bst_free(struct bst *tree);
+#ifdef TG_BST_TREE_DEBUG
+int bst_validate(struct bst *tree);
+#endif
+
+#endif
@@ -0,0 +1,142 @@
+/**
+ * @file btree-arena.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 같은 크기의 노드를 huge page 영역에서 잘라 쓰는 할당기의 구현이다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 영역은 2 MiB 경계에 맞추어 mmap한 뒤에 MADV_HUGEPAGE를 요청한다.
+ * 커널이 transparent huge page를 지원하지 않거나 꺼둔 경우에는 요청이
+ * 실패하거나 무시되며, 그대로 4 KiB 페이지로 사용한다. 노드가 한 영역에
+ * 모이므로 huge page가 없더라도 malloc보다 적은 페이지에 걸치게 된다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _DEFAULT_SOURCE
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include "btree-arena.h"
+
+#define B_TREE_ARENA_ROUND_UP(x, align) (((x) + (align)-1) & ~((align)-1))
+
+/**
+ * @brief 객체의 크기에 맞추어 아레나를 초기화한다. 영역은 처음 할당할 때 만든다.
+ *
+ * @param arena 초기화할 아레나에 해당한다.
+ * @param object_size 객체 하나의 크기에 해당한다.
+ * @return int 성공 시에 0을, 크기가 0이면 -EINVAL을 반환한다.
+ */
+int btree_arena_init(struct btree_arena *arena, size_t object_size)
+{
+        const size_t header = B_TREE_ARENA_ROUND_UP(
+                sizeof(struct btree_arena_region), B_TREE_ARENA_ALIGN);
+
+        if (object_size == 0) {
+                return -EINVAL;
+        }
+        memset(arena, 0, sizeof(struct btree_arena));
+        arena->object_size =
+                B_TREE_ARENA_ROUND_UP(object_size, B_TREE_ARENA_ALIGN);
+        arena->region_size = B_TREE_ARENA_ROUND_UP(header + arena->object_size,
+                                                   B_TREE_ARENA_REGION_SIZE);
+        return 0;
+}
+
+/**
+ * @brief 2 MiB 경계에 맞춘 영역을 새로 만든다.
+ * @details 크기보다 2 MiB 더 크게 mmap한 뒤에 경계 앞뒤의 남는 부분을 돌려준다.
+ *
+ * @return int 성공 시에 0을, mmap이 실패하면 -ENOMEM을 반환한다.
+ */
+static int btree_arena_grow(struct btree_arena *arena)
+{
+        const size_t size = arena->region_size;
+        const size_t map_size = size + B_TREE_ARENA_REGION_SIZE;
+        struct btree_arena_region *region = NULL;
+        uintptr_t base = 0, aligned = 0;
+        void *map = NULL;
+
+        map = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (map == MAP_FAILED) {
+                return -ENOMEM;
+        }
+        base = (uintptr_t)map;
+        aligned = B_TREE_ARENA_ROUND_UP(base, B_TREE_ARENA_REGION_SIZE);
+        if (aligned > base) {
+                munmap(map, aligned - base);
+        }
+        if (aligned + size < base + map_size) {
+                munmap((void *)(aligned + size), base + map_size - aligned - size);
+        }
+#ifdef MADV_HUGEPAGE
+        if (!madvise((void *)aligned, size, MADV_HUGEPAGE)) {
+                arena->nr_huge++;
+        }
+#endif
+
+        region = (struct btree_arena_region *)aligned;
+        region->next = arena->regions;
+        region->size = size;
+        arena->regions = region;
+        arena->nr_regions++;
+        arena->cursor = (char *)aligned +
+                        B_TREE_ARENA_ROUND_UP(sizeof(struct btree_arena_region),
+                                              B_TREE_ARENA_ALIGN);
+        arena->end = (char *)aligned + size;
+        return 0;
+}
+
+/**
+ * @brief 64바이트 경계에서 시작하는 객체 하나를 할당한다.
+ *
+ * @return void* 0으로 채워진 객체를, 실패 시에는 NULL을 반환한다.
+ */
+void *btree_arena_alloc(struct btree_arena *arena)
+{
+        void *ptr = arena->free_list;
+
+        if (ptr) {
+                arena->free_list = *(void **)ptr;
+        } else {
+                if (arena->cursor + arena->object_size > arena->end &&
+                    btree_arena_grow(arena)) {
+                        return NULL;
+                }
+                ptr = arena->cursor;
+                arena->cursor += arena->object_size;
+        }
+        memset(ptr, 0, arena->object_size);
+        arena->nr_objects++;
+        return ptr;
+}
+
+/**
+ * @brief 객체를 free list로 돌려준다.
+ */
+void btree_arena_free(struct btree_arena *arena, void *ptr)
+{
+        if (ptr) {
+                *(void **)ptr = arena->free_list;
+                arena->free_list = ptr;
+                arena->nr_objects--;
+        }
+}
+
+/**
+ * @brief 모든 영역을 운영체제에 돌려준다. 나누어 준 객체도 모두 사라진다.
+ */
+void btree_arena_destroy(struct btree_arena *arena)
+{
+        struct btree_arena_region *region = arena->regions;
+
+        while (region) {
+                struct btree_arena_region *next = region->next;
+                munmap(region, region->size);
+                region = next;
+        }
+        memset(arena, 0, sizeof(struct btree_arena));
+}
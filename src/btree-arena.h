@@ -0,0 +1,57 @@
+/**
+ * @file btree-arena.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 같은 크기의 노드를 huge page 영역에서 잘라 쓰는 할당기에 대한 선언이다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _B_TREE_ARENA_H
+#define _B_TREE_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define B_TREE_ARENA_REGION_SIZE (2UL << 20) /**< x86-64의 huge page 크기 */
+#define B_TREE_ARENA_ALIGN 64 /**< 객체는 캐시 라인 경계에서 시작한다. */
+
+/**
+ * @brief 아레나가 mmap으로 얻은 영역 하나에 해당한다. 영역의 맨 앞에 놓인다.
+ */
+struct btree_arena_region {
+        struct btree_arena_region *next;
+        size_t size;
+};
+
+/**
+ * @brief 같은 크기의 객체를 나누어 주는 아레나에 해당한다.
+ * @details 해제된 객체는 free list로 모았다가 다음 할당에 다시 사용하며,
+ * 영역은 아레나를 없앨 때에만 운영체제에 돌려준다.
+ */
+struct btree_arena {
+        size_t object_size; /**< B_TREE_ARENA_ALIGN의 배수로 올림된 크기 */
+        size_t region_size;
+        struct btree_arena_region *regions;
+        char *cursor; /**< 현재 영역에서 아직 나누어 주지 않은 위치 */
+        char *end;
+        void *free_list;
+
+        size_t nr_regions;
+        size_t nr_huge; /**< MADV_HUGEPAGE가 받아들여진 영역의 수 */
+        size_t nr_objects; /**< 사용 중인 객체의 수 */
+};
+
+int btree_arena_init(struct btree_arena *arena, size_t object_size);
+void *btree_arena_alloc(struct btree_arena *arena);
+void btree_arena_free(struct btree_arena *arena, void *ptr);
+void btree_arena_destroy(struct btree_arena *arena);
+
+/* B-Tree 노드를 [struct btree_node][items][child]의 한 덩어리로 담는다. */
+struct btree_node;
+void btree_arena_init_node(struct btree_arena *arena, int min_degree);
+struct btree_node *btree_arena_alloc_node(struct btree_arena *arena,
+                                          int min_degree);
+
+#endif
@@ -0,0 +1,287 @@
+/**
+ * @file btree-auto.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief CPU 캐시의 모양으로부터 B-Tree의 차수를 고르는 기능이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 노드의 items 배열이 캐시 라인의 정수 배(또는 페이지 하나)를
+ * 넘지 않으면서 가장 가득 차도록 차수를 고른다. 몇 개의 라인을 쓸 지는
+ * L1 데이터 캐시에 노드 64개가 들어가도록 정하며, 탐색이 노드 안에서 선형으로
+ * 이루어지므로 4에서 16 라인 사이로 제한한다.
+ *
+ * B_TREE_AUTO_CALIBRATE를 주면 1, 2, 4, ..., 32 라인에 해당하는 후보 차수마다
+ * L2 캐시 정도 크기의 트리를 만들어 임의 탐색의 시간을 재고 가장 빠른
+ * 차수를 고른다.
+ * 측정 결과는 프로세스 안에서 재사용한다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "btree.h"
+
+#define B_TREE_AUTO_LINE_SIZE 64 /**< 캐시의 모양을 읽지 못한 경우의 기본값 */
+#define B_TREE_AUTO_L1D_SIZE (32 * 1024)
+#define B_TREE_AUTO_L2_SIZE (256 * 1024)
+#define B_TREE_AUTO_PAGE_SIZE 4096
+
+#define B_TREE_AUTO_NODES_IN_L1 64
+#define B_TREE_AUTO_MIN_LINES 4
+#define B_TREE_AUTO_MAX_LINES 16
+
+#define B_TREE_CALIBRATE_MAX_LINES 32
+#define B_TREE_CALIBRATE_MIN_KEYS (1 << 15)
+#define B_TREE_CALIBRATE_MAX_KEYS (1 << 18)
+#define B_TREE_CALIBRATE_SEARCHES (1 << 16)
+
+#define B_TREE_CACHE_SYSFS "/sys/devices/system/cpu/cpu0/cache"
+
+static atomic_int btree_calibrated_degree;
+
+/**
+ * @brief sysfs의 캐시 정보 파일에서 숫자를 읽는다. "48K"와 같은 단위도 처리한다.
+ *
+ * @return long 읽은 값을, 읽지 못한 경우에는 0을 반환한다.
+ */
+static long btree_sysfs_read(int index, const char *name)
+{
+        char path[128];
+        char buf[32];
+        char *end = NULL;
+        FILE *fp = NULL;
+        long value = 0;
+
+        snprintf(path, sizeof(path), B_TREE_CACHE_SYSFS "/index%d/%s", index,
+                 name);
+        fp = fopen(path, "r");
+        if (!fp) {
+                return 0;
+        }
+        if (fgets(buf, sizeof(buf), fp)) {
+                value = strtol(buf, &end, 10);
+                if (*end == 'K') {
+                        value *= 1024;
+                } else if (*end == 'M') {
+                        value *= 1024 * 1024;
+                }
+        }
+        fclose(fp);
+        return value;
+}
+
+/**
+ * @brief sysfs에서 level과 종류(Data, Unified)가 맞는 캐시를 찾아 값을 채운다.
+ */
+static void btree_sysfs_cache(struct btree_cache_info *info)
+{
+        for (int index = 0; index < 8; index++) {
+                char path[128];
+                char type[16] = { 0 };
+                FILE *fp = NULL;
+                long level = btree_sysfs_read(index, "level");
+
+                if (level == 0) {
+                        break;
+                }
+                snprintf(path, sizeof(path), B_TREE_CACHE_SYSFS "/index%d/type",
+                         index);
+                fp = fopen(path, "r");
+                if (!fp) {
+                        continue;
+                }
+                if (!fgets(type, sizeof(type), fp)) {
+                        type[0] = '\0';
+                }
+                fclose(fp);
+                if (type[0] == 'I') { /**< Instruction 캐시는 무시한다. */
+                        continue;
+                }
+                if (level == 1) {
+                        info->l1d_size = btree_sysfs_read(index, "size");
+                        info->line_size =
+                                btree_sysfs_read(index, "coherency_line_size");
+                } else if (level == 2) {
+                        info->l2_size = btree_sysfs_read(index, "size");
+                }
+        }
+}
+
+/**
+ * @brief 현재 CPU의 캐시 라인, L1 데이터 캐시, L2 캐시와 페이지의 크기를 구한다.
+ * @details sysfs를 먼저 읽고, 읽지 못한 항목은 sysconf로, 그것도 안 되면
+ * 일반적인 x86-64의 값으로 채운다.
+ *
+ * @param info 캐시의 모양이 채워질 위치에 해당한다.
+ */
+void btree_cache_info(struct btree_cache_info *info)
+{
+        info->line_size = 0;
+        info->l1d_size = 0;
+        info->l2_size = 0;
+        info->page_size = sysconf(_SC_PAGESIZE);
+
+        btree_sysfs_cache(info);
+#ifdef _SC_LEVEL1_DCACHE_LINESIZE
+        if (info->line_size <= 0) {
+                info->line_size = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+        }
+        if (info->l1d_size <= 0) {
+                info->l1d_size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+        }
+        if (info->l2_size <= 0) {
+                info->l2_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        }
+#endif
+        if (info->line_size <= 0) {
+                info->line_size = B_TREE_AUTO_LINE_SIZE;
+        }
+        if (info->l1d_size <= 0) {
+                info->l1d_size = B_TREE_AUTO_L1D_SIZE;
+        }
+        if (info->l2_size <= 0) {
+                info->l2_size = B_TREE_AUTO_L2_SIZE;
+        }
+        if (info->page_size <= 0) {
+                info->page_size = B_TREE_AUTO_PAGE_SIZE;
+        }
+}
+
+/**
+ * @brief items 배열이 bytes를 넘지 않는 가장 큰 차수를 구한다.
+ */
+static int btree_degree_for(long bytes)
+{
+        const long nr_keys = bytes / (long)sizeof(struct btree_item);
+        const int degree = (int)((nr_keys + 1) / 2);
+
+        return (degree < B_TREE_MIN_DEGREE) ? B_TREE_MIN_DEGREE : degree;
+}
+
+static uint64_t btree_auto_now(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 차수 하나에 대해 임의 탐색에 걸린 시간(ns)을 잰다.
+ *
+ * @param degree 측정할 차수에 해당한다.
+ * @param nr_keys 측정에 사용할 트리의 키의 수에 해당한다.
+ * @return uint64_t 걸린 시간을, 트리를 만들지 못한 경우에는 UINT64_MAX를 반환한다.
+ */
+static uint64_t btree_calibrate_degree(int degree, uint32_t nr_keys)
+{
+        struct btree *tree = btree_alloc(degree);
+        uint64_t start = 0, elapsed = 0;
+        uint32_t x = 0x9e3779b9u;
+        uintptr_t sink = 0;
+
+        if (!tree) {
+                return UINT64_MAX;
+        }
+        for (uint32_t i = 0; i < nr_keys; i++) {
+                btree_insert(tree, (key_t)(i * 2654435761u), NULL);
+        }
+        start = btree_auto_now();
+        for (int i = 0; i < B_TREE_CALIBRATE_SEARCHES; i++) {
+                x ^= x << 13; /**< xorshift32로 임의의 키를 고른다. */
+                x ^= x >> 17;
+                x ^= x << 5;
+                sink += (uintptr_t)btree_search(
+                                tree, (key_t)((x % nr_keys) *
+                                              2654435761u))
+                                .node;
+        }
+        elapsed = btree_auto_now() - start;
+        btree_free(tree);
+        return elapsed + (sink & 1); /**< 탐색이 최적화로 사라지지 않도록 한다. */
+}
+
+/**
+ * @brief 후보 차수를 모두 측정하여 가장 빠른 차수를 구한다.
+ */
+static int btree_calibrate(const struct btree_cache_info *info)
+{
+        long nr_keys = info->l2_size / (long)sizeof(struct btree_item);
+        int best_degree = B_TREE_MIN_DEGREE;
+        uint64_t best = UINT64_MAX;
+
+        if (nr_keys < B_TREE_CALIBRATE_MIN_KEYS) {
+                nr_keys = B_TREE_CALIBRATE_MIN_KEYS;
+        } else if (nr_keys > B_TREE_CALIBRATE_MAX_KEYS) {
+                nr_keys = B_TREE_CALIBRATE_MAX_KEYS;
+        }
+
+        for (int lines = 1; lines <= B_TREE_CALIBRATE_MAX_LINES; lines *= 2) {
+                const int degree = btree_degree_for(lines * info->line_size);
+                const uint64_t elapsed =
+                        btree_calibrate_degree(degree, (uint32_t)nr_keys);
+
+                if (elapsed < best) {
+                        best = elapsed;
+                        best_degree = degree;
+                }
+        }
+        return best_degree;
+}
+
+/**
+ * @brief 현재 CPU에 맞는 차수를 구하도록 한다.
+ *
+ * @param flags B_TREE_AUTO_CALIBRATE를 주면 측정으로, B_TREE_AUTO_PAGE를 주면
+ * 노드가 페이지 하나를 채우도록, 둘 다 없으면 캐시 라인을 기준으로 고른다.
+ * @return int 고른 차수로 항상 B_TREE_MIN_DEGREE 이상이다.
+ *
+ * @note 처음 B_TREE_AUTO_CALIBRATE로 호출하면 수십 ms가 걸리며,
+ * 이후의 호출은 처음의 결과를 그대로 반환한다.
+ * B_TREE_FIXED_DEGREE로 빌드한 경우에는 항상 그 차수를 반환한다.
+ */
+int btree_auto_degree(unsigned int flags)
+{
+        struct btree_cache_info info;
+        long lines = 0;
+        int degree = 0;
+
+#ifdef B_TREE_FIXED_DEGREE
+        return B_TREE_FIXED_DEGREE; /**< 다른 차수로는 트리를 만들 수 없다. */
+#endif
+        btree_cache_info(&info);
+        if (flags & B_TREE_AUTO_CALIBRATE) {
+                degree = atomic_load(&btree_calibrated_degree);
+                if (!degree) {
+                        degree = btree_calibrate(&info);
+                        atomic_store(&btree_calibrated_degree, degree);
+                }
+                return degree;
+        }
+        if (flags & B_TREE_AUTO_PAGE) {
+                return btree_degree_for(info.page_size);
+        }
+
+        lines = info.l1d_size / (info.line_size * B_TREE_AUTO_NODES_IN_L1);
+        if (lines < B_TREE_AUTO_MIN_LINES) {
+                lines = B_TREE_AUTO_MIN_LINES;
+        } else if (lines > B_TREE_AUTO_MAX_LINES) {
+                lines = B_TREE_AUTO_MAX_LINES;
+        }
+        return btree_degree_for(lines * info.line_size);
+}
+
+/**
+ * @brief 현재 CPU에 맞는 차수로 새로운 B-Tree를 할당하도록 한다.
+ *
+ * @param flags btree_auto_degree()의 flags와 같다.
+ * @return struct btree* 정상 할당이 된 경우에는 B-Tree 주소가 반환된다.
+ * @exception 동적 할당을 실패한 경우에는 NULL이 반환된다.
+ */
+struct btree *btree_alloc_auto(unsigned int flags)
+{
+        return btree_alloc(btree_auto_degree(flags));
+}
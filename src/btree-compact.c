@@ -0,0 +1,577 @@
+/**
+ * @file btree-compact.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief B-Tree를 새 아레나에 다시 써서 노드를 연속된 순서로 모으는 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 삽입과 삭제가 반복되면 노드가 힙 여기저기에 흩어지고 덜 찬 노드가
+ * 늘어난다. 압축(compaction)은 다음 순서로 진행된다.
+ *
+ * 1. 모든 항목을 키 순서대로 배열에 모은다.
+ * 2. 목표 채움 비율로 층마다의 노드 수를 정하고, BFS 또는 van Emde Boas
+ *    순서로 노드를 놓을 순서를 정한다.
+ * 3. 정한 순서대로 새 아레나에서 노드를 받는다.
+ * 4. 잎(leaf) 층부터 노드를 채우며, 노드 사이의 구분 키는 윗 층의 항목이 된다.
+ * 5. 루트와 아레나를 바꾸고 이전 노드를 해제한다.
+ *
+ * 각 단계는 나누어 수행할 수 있으므로 요청 사이의 빈 시간에 조금씩 진행할 수
+ * 있다. 단계 사이에 트리가 바뀌면 처음부터 다시 시작한다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include "btree.h"
+#include "btree-arena.h"
+
+#define B_TREE_COMPACT_BATCH 256 /**< 시간 예산을 확인하는 작업의 단위 */
+
+/**
+ * @brief 압축의 진행 단계에 해당한다.
+ */
+enum btree_compact_phase {
+        B_TREE_COMPACT_PHASE_COLLECT = 0, /**< 항목을 키 순서대로 모은다. */
+        B_TREE_COMPACT_PHASE_PLAN, /**< 층마다의 노드 수와 놓을 순서를 정한다. */
+        B_TREE_COMPACT_PHASE_ALLOC, /**< 정한 순서대로 새 아레나에서 노드를 받는다. */
+        B_TREE_COMPACT_PHASE_FILL, /**< 잎 층부터 노드를 채운다. */
+        B_TREE_COMPACT_PHASE_SWAP, /**< 루트를 바꾸고 이전 노드를 해제한다. */
+        B_TREE_COMPACT_PHASE_DONE,
+};
+
+/**
+ * @brief 새 트리의 한 층에 해당한다. 0이 잎 층이다.
+ */
+struct btree_compact_level {
+        size_t nr_nodes;
+        size_t q; /**< 노드마다 q개의 키를, 앞쪽 r개의 노드는 q + 1개를 가진다. */
+        size_t r;
+        size_t offset; /**< nodes에서 이 층이 시작하는 위치 */
+};
+
+/**
+ * @brief 항목을 모을 때 사용하는 순회 스택의 한 칸에 해당한다.
+ */
+struct btree_compact_frame {
+        struct btree_node *node;
+        int next; /**< 짝수이면 next / 2번째 자식을, 홀수이면 항목을 방문한다. */
+};
+
+/**
+ * @brief 진행 중인 압축의 상태에 해당한다.
+ */
+struct btree_compact {
+        struct btree *tree;
+        enum btree_layout layout;
+        double fill;
+        enum btree_compact_phase phase;
+        unsigned long version; /**< 모으기를 시작할 때의 tree->version */
+        unsigned long restarts;
+
+        struct btree_item *items; /**< 키 순서대로 모은 항목 */
+        size_t nr_items;
+        size_t capacity;
+        struct btree_compact_frame stack[B_TREE_MAX_HEIGHT];
+        int depth;
+
+        struct btree_compact_level level[B_TREE_MAX_HEIGHT];
+        int nr_levels;
+        struct btree_node **nodes; /**< 층 순서로 매긴 번호마다의 새 노드 */
+        size_t *order; /**< 아레나에 놓을 순서대로 나열한 노드 번호 */
+        size_t nr_nodes;
+        struct btree_arena *arena;
+
+        size_t cursor; /**< ALLOC에서는 order의, FILL에서는 현재 층의 위치 */
+        int fill_level;
+        size_t rd; /**< FILL에서 items를 읽는 위치 */
+        size_t wr; /**< FILL에서 윗 층의 항목(구분 키)을 쓰는 위치 */
+};
+
+static uint64_t btree_compact_now(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 작업을 B_TREE_COMPACT_BATCH번 할 때마다 시간 예산을 넘었는 지 확인한다.
+ *
+ * @param deadline 끝내야 하는 시각으로 0이면 제한이 없다.
+ * @param work 지금까지 한 작업의 수로 호출할 때마다 1씩 늘어난다.
+ */
+static bool btree_compact_expired(uint64_t deadline, unsigned long *work)
+{
+        return deadline && ++(*work) % B_TREE_COMPACT_BATCH == 0 &&
+               btree_compact_now() >= deadline;
+}
+
+/**
+ * @brief 층 level의 j번째 노드의 첫 번째 자식이 아래 층에서 몇 번째인 지를 구한다.
+ * @note j가 층의 노드 수와 같으면 아래 층의 노드 수가 나온다.
+ */
+static size_t btree_compact_first_child(const struct btree_compact *c,
+                                        int level, size_t j)
+{
+        const struct btree_compact_level *l = &c->level[level];
+        return j * (l->q + 1) + (j < l->r ? j : l->r);
+}
+
+/**
+ * @brief 새로 만들던 노드를 모두 버린다.
+ */
+static void btree_compact_discard(struct btree_compact *c)
+{
+        if (c->arena) {
+                btree_arena_destroy(c->arena);
+                free(c->arena);
+                c->arena = NULL;
+        }
+        free(c->nodes);
+        free(c->order);
+        c->nodes = NULL;
+        c->order = NULL;
+}
+
+/**
+ * @brief 현재의 트리를 대상으로 압축을 처음부터 다시 시작한다.
+ */
+static void btree_compact_reset(struct btree_compact *c)
+{
+        btree_compact_discard(c);
+        c->phase = B_TREE_COMPACT_PHASE_COLLECT;
+        c->version = c->tree->version;
+        c->nr_items = 0;
+        c->stack[0].node = c->tree->root;
+        c->stack[0].next = 0;
+        c->depth = 1;
+        c->cursor = 0;
+}
+
+static int btree_compact_push(struct btree_compact *c,
+                              const struct btree_item *items, int n)
+{
+        if (c->nr_items + n > c->capacity) {
+                size_t capacity = c->capacity ? c->capacity * 2 : 1024;
+                struct btree_item *grown = NULL;
+
+                while (capacity < c->nr_items + n) {
+                        capacity *= 2;
+                }
+                grown = (struct btree_item *)realloc(
+                        c->items, capacity * sizeof(struct btree_item));
+                if (!grown) {
+                        pr_info("Allocation compaction buffer failed\n");
+                        return -ENOMEM;
+                }
+                c->items = grown;
+                c->capacity = capacity;
+        }
+        memcpy(&c->items[c->nr_items], items, n * sizeof(struct btree_item));
+        c->nr_items += n;
+        return 0;
+}
+
+/**
+ * @brief 트리를 중위 순회하여 항목을 키 순서대로 모은다.
+ *
+ * @return int 다 모은 경우에는 0을, 시간 예산을 넘은 경우에는 1을,
+ * 실패 시에는 음수의 errno를 반환한다.
+ */
+static int btree_compact_collect(struct btree_compact *c, uint64_t deadline)
+{
+        unsigned long work = 0;
+        int ret = 0;
+
+        while (c->depth > 0) {
+                struct btree_compact_frame *f = &c->stack[c->depth - 1];
+                struct btree_node *x = f->node;
+                int step = 0;
+
+                if (btree_compact_expired(deadline, &work)) {
+                        return 1;
+                }
+                if (x->is_leaf) {
+                        ret = btree_compact_push(c, x->items, x->n);
+                        if (ret) {
+                                return ret;
+                        }
+                        c->depth--;
+                        continue;
+                }
+
+                step = f->next++;
+                if (step > 2 * x->n) {
+                        c->depth--;
+                } else if (step % 2 == 0) {
+                        if (c->depth == B_TREE_MAX_HEIGHT) {
+                                return -ERANGE;
+                        }
+                        c->stack[c->depth].node = x->child[step / 2];
+                        c->stack[c->depth].next = 0;
+                        c->depth++;
+                } else {
+                        ret = btree_compact_push(c, &x->items[step / 2], 1);
+                        if (ret) {
+                                return ret;
+                        }
+                }
+        }
+        return 0;
+}
+
+/**
+ * @brief 노드 (top, j)를 루트로 하는 높이 height의 서브 트리를 van Emde Boas
+ * 순서로 order에 나열한다.
+ * @details 위쪽 height / 2 층의 서브 트리를 먼저 놓고, 그 아래에 매달린
+ * 서브 트리들을 왼쪽부터 차례로 놓는다. 두 부분 모두 같은 방법으로 나눈다.
+ */
+static void btree_compact_veb(struct btree_compact *c, int top, size_t j,
+                              int height, size_t *w)
+{
+        const int upper = height / 2;
+        size_t lo = j, hi = j + 1;
+
+        if (height == 1) {
+                c->order[(*w)++] = c->level[top].offset + j;
+                return;
+        }
+        btree_compact_veb(c, top, j, upper, w);
+        for (int level = top; level > top - upper; level--) {
+                lo = btree_compact_first_child(c, level, lo);
+                hi = btree_compact_first_child(c, level, hi);
+        }
+        for (size_t k = lo; k < hi; k++) {
+                btree_compact_veb(c, top - upper, k, height - upper, w);
+        }
+}
+
+/**
+ * @brief 모은 항목의 수와 채움 비율로 새 트리의 모양과 노드를 놓을 순서를 정한다.
+ * @details 층마다 노드 수를 목표 키 수로 나누어 정하되, 모든 노드가
+ * 최소 차수 - 1개 이상의 키를 가지도록 노드 수를 줄인다. 키는 노드에 고르게
+ * 나누며, 노드 사이마다 구분 키 하나가 윗 층으로 올라간다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+static int btree_compact_plan(struct btree_compact *c)
+{
+        const size_t t = (size_t)c->tree->min_degree;
+        const size_t max_keys = B_TREE_NR_KEYS(t);
+        size_t target = (size_t)(c->fill * (double)max_keys + 0.5);
+        size_t n = c->nr_items, nodes = 0, w = 0;
+
+        if (target < t - 1) {
+                target = t - 1;
+        }
+        if (target > max_keys) {
+                target = max_keys;
+        }
+
+        c->nr_levels = 0;
+        c->nr_nodes = 0;
+        do {
+                struct btree_compact_level *l = &c->level[c->nr_levels];
+
+                if (c->nr_levels == B_TREE_MAX_HEIGHT) {
+                        return -ERANGE;
+                }
+                nodes = (n + 1 + target) / (target + 1);
+                if (nodes > (n + 1) / t) {
+                        nodes = (n + 1) / t;
+                }
+                if (nodes == 0) {
+                        nodes = 1;
+                }
+                l->nr_nodes = nodes;
+                l->q = (n + 1 - nodes) / nodes;
+                l->r = (n + 1 - nodes) % nodes;
+                l->offset = c->nr_nodes;
+                c->nr_nodes += nodes;
+                c->nr_levels++;
+                n = nodes - 1;
+        } while (nodes > 1);
+
+        c->nodes = (struct btree_node **)malloc(c->nr_nodes *
+                                                sizeof(struct btree_node *));
+        c->order = (size_t *)malloc(c->nr_nodes * sizeof(size_t));
+        c->arena = (struct btree_arena *)malloc(sizeof(struct btree_arena));
+        if (!c->nodes || !c->order || !c->arena) {
+                pr_info("Allocation compaction plan failed\n");
+                free(c->arena);
+                c->arena = NULL;
+                return -ENOMEM;
+        }
+        btree_arena_init_node(c->arena, c->tree->min_degree);
+
+        if (c->layout == B_TREE_LAYOUT_VEB) {
+                btree_compact_veb(c, c->nr_levels - 1, 0, c->nr_levels, &w);
+        } else {
+                for (int level = c->nr_levels - 1; level >= 0; level--) {
+                        for (size_t j = 0; j < c->level[level].nr_nodes; j++) {
+                                c->order[w++] = c->level[level].offset + j;
+                        }
+                }
+        }
+        c->cursor = 0;
+        return 0;
+}
+
+/**
+ * @brief 정한 순서대로 새 아레나에서 노드를 받는다.
+ *
+ * @return int 다 받은 경우에는 0을, 시간 예산을 넘은 경우에는 1을,
+ * 실패 시에는 음수의 errno를 반환한다.
+ */
+static int btree_compact_alloc(struct btree_compact *c, uint64_t deadline)
+{
+        unsigned long work = 0;
+
+        while (c->cursor < c->nr_nodes) {
+                struct btree_node *node = NULL;
+
+                if (btree_compact_expired(deadline, &work)) {
+                        return 1;
+                }
+                node = btree_arena_alloc_node(c->arena, c->tree->min_degree);
+                if (!node) {
+                        return -ENOMEM;
+                }
+                c->nodes[c->order[c->cursor++]] = node;
+        }
+        c->cursor = 0;
+        c->fill_level = 0;
+        c->rd = 0;
+        c->wr = 0;
+        return 0;
+}
+
+/**
+ * @brief 잎 층부터 노드를 채운다.
+ * @details 각 층은 items의 앞쪽에서 키를 읽고, 구분 키는 items의 앞쪽에
+ * 다시 써서 윗 층의 항목으로 삼는다. 쓰는 위치는 항상 읽는 위치보다 앞에 있다.
+ *
+ * @return int 다 채운 경우에는 0을, 시간 예산을 넘은 경우에는 1을 반환한다.
+ */
+static int btree_compact_fill(struct btree_compact *c, uint64_t deadline)
+{
+        unsigned long work = 0;
+
+        while (c->fill_level < c->nr_levels) {
+                const int level = c->fill_level;
+                const struct btree_compact_level *l = &c->level[level];
+
+                while (c->cursor < l->nr_nodes) {
+                        const size_t j = c->cursor;
+                        const size_t keys = l->q + (j < l->r);
+                        struct btree_node *x = c->nodes[l->offset + j];
+
+                        if (btree_compact_expired(deadline, &work)) {
+                                return 1;
+                        }
+                        memcpy(x->items, &c->items[c->rd],
+                               keys * sizeof(struct btree_item));
+                        c->rd += keys;
+                        x->n = (int)keys;
+                        x->is_leaf = (level == 0);
+                        if (level > 0) {
+                                const size_t first =
+                                        btree_compact_first_child(c, level, j);
+                                const size_t below = c->level[level - 1].offset;
+
+                                for (size_t i = 0; i <= keys; i++) {
+                                        x->child[i] =
+                                                c->nodes[below + first + i];
+                                }
+                        }
+                        if (j + 1 < l->nr_nodes) {
+                                c->items[c->wr++] = c->items[c->rd++];
+                        }
+                        c->cursor++;
+                }
+                c->fill_level++;
+                c->cursor = 0;
+                c->rd = 0;
+                c->wr = 0;
+        }
+        return 0;
+}
+
+/**
+ * @brief malloc으로 할당한 노드를 모두 해제한다. 항목의 data는 새 트리로
+ * 옮겨갔으므로 해제하지 않는다.
+ */
+static void btree_compact_release(struct btree_node *node)
+{
+        if (!node->is_leaf) {
+                for (int i = 0; i <= node->n; i++) {
+                        btree_compact_release(node->child[i]);
+                }
+        }
+#ifndef B_TREE_FIXED_DEGREE
+        free(node->child);
+        free(node->items);
+#endif
+        free(node);
+}
+
+/**
+ * @brief 새 루트와 아레나로 바꾸고 이전 노드를 해제한다.
+ */
+static int btree_compact_swap(struct btree_compact *c)
+{
+        struct btree *tree = c->tree;
+        struct btree_node *old_root = tree->root;
+        struct btree_arena *old_arena = tree->arena;
+
+        tree->root = c->nodes[c->level[c->nr_levels - 1].offset];
+        tree->arena = c->arena;
+        tree->version++; /**< 다른 압축이 이전 노드를 보고 있다면 다시 시작한다. */
+        c->arena = NULL;
+
+        if (old_arena) {
+                btree_arena_destroy(old_arena);
+                free(old_arena);
+        } else {
+                btree_compact_release(old_root);
+        }
+        btree_compact_discard(c);
+        free(c->items);
+        c->items = NULL;
+        c->capacity = 0;
+        return 0;
+}
+
+/**
+ * @brief 나누어 수행하는 압축을 시작한다. 실제 작업은 btree_compact_step에서 한다.
+ *
+ * @param tree 압축할 B-Tree에 해당한다.
+ * @param layout 새 아레나에 노드를 놓을 순서에 해당한다.
+ * @param fill 노드를 채울 목표 비율로 (0, 1] 사이여야 한다. 최소 차수를
+ * 지키기 위해 실제로는 이보다 더 채워질 수 있다.
+ * @return struct btree_compact* 압축의 상태를, 인자가 잘못되었거나 할당에
+ * 실패한 경우에는 NULL을 반환한다.
+ */
+struct btree_compact *btree_compact_begin(struct btree *tree,
+                                          enum btree_layout layout, double fill)
+{
+        struct btree_compact *c = NULL;
+
+        if (!tree || fill <= 0 || fill > 1) {
+                return NULL;
+        }
+        c = (struct btree_compact *)calloc(1, sizeof(struct btree_compact));
+        if (!c) {
+                pr_info("Allocation compaction failed\n");
+                return NULL;
+        }
+        c->tree = tree;
+        c->layout = layout;
+        c->fill = fill;
+        btree_compact_reset(c);
+        return c;
+}
+
+/**
+ * @brief 시간 예산 안에서 압축을 진행한다.
+ *
+ * @param compact btree_compact_begin으로 시작한 압축에 해당한다.
+ * @param budget_ns 이번에 사용할 수 있는 시간으로 0이면 끝날 때까지 진행한다.
+ * @return int 압축이 끝난 경우에는 0을, 남은 작업이 있는 경우에는 1을,
+ * 실패 시에는 음수의 errno를 반환한다. 실패한 경우에도 트리는 그대로 남는다.
+ *
+ * @warning 호출과 호출 사이에는 트리를 바꾸어도 되지만(그러면 처음부터 다시
+ * 시작한다), 호출하는 동안에는 다른 스레드가 트리를 바꾸어서는 안된다.
+ * 바뀌는 간격보다 예산이 너무 작으면 압축이 끝나지 않을 수 있다.
+ */
+int btree_compact_step(struct btree_compact *compact, unsigned long budget_ns)
+{
+        const uint64_t deadline = budget_ns ? btree_compact_now() + budget_ns :
+                                              0;
+        int ret = 0;
+
+        if (compact->phase == B_TREE_COMPACT_PHASE_DONE) {
+                return 0;
+        }
+        if (compact->tree->version != compact->version) {
+                compact->restarts++;
+                btree_compact_reset(compact);
+        }
+
+        while (compact->phase != B_TREE_COMPACT_PHASE_DONE) {
+                switch (compact->phase) {
+                case B_TREE_COMPACT_PHASE_COLLECT:
+                        ret = btree_compact_collect(compact, deadline);
+                        break;
+                case B_TREE_COMPACT_PHASE_PLAN:
+                        ret = btree_compact_plan(compact);
+                        break;
+                case B_TREE_COMPACT_PHASE_ALLOC:
+                        ret = btree_compact_alloc(compact, deadline);
+                        break;
+                case B_TREE_COMPACT_PHASE_FILL:
+                        ret = btree_compact_fill(compact, deadline);
+                        break;
+                case B_TREE_COMPACT_PHASE_SWAP:
+                        ret = btree_compact_swap(compact);
+                        break;
+                default:
+                        break;
+                }
+                if (ret < 0) {
+                        btree_compact_reset(compact);
+                        return ret;
+                }
+                if (ret > 0) {
+                        return 1;
+                }
+                compact->phase++;
+        }
+        return 0;
+}
+
+/**
+ * @brief 트리가 바뀌어 압축을 처음부터 다시 시작한 횟수를 반환한다.
+ */
+unsigned long btree_compact_restarts(const struct btree_compact *compact)
+{
+        return compact->restarts;
+}
+
+/**
+ * @brief 압축을 끝낸다. 아직 끝나지 않았다면 새로 만들던 노드는 버린다.
+ */
+void btree_compact_end(struct btree_compact *compact)
+{
+        if (compact) {
+                btree_compact_discard(compact);
+                free(compact->items);
+                free(compact);
+        }
+}
+
+/**
+ * @brief 트리 전체를 새 아레나에 한 번에 다시 쓴다.
+ * @details 노드는 B_TREE_COMPACT_FILL만큼 채워지며, 이후의 노드 할당도
+ * 새 아레나에서 이루어진다.
+ *
+ * @param tree 압축할 B-Tree에 해당한다.
+ * @param layout 새 아레나에 노드를 놓을 순서에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int btree_compact(struct btree *tree, enum btree_layout layout)
+{
+        struct btree_compact *compact =
+                btree_compact_begin(tree, layout, B_TREE_COMPACT_FILL);
+        int ret = 0;
+
+        if (!compact) {
+                return -ENOMEM;
+        }
+        ret = btree_compact_step(compact, 0);
+        btree_compact_end(compact);
+        return ret;
+}
@@ -0,0 +1,1205 @@
+/**
+ * @file btree-disk.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 파일에 저장되는 페이지 기반 B-Tree에 대한 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 알고리즘 자체는 btree.c와 동일하게 CLRS를 따른다. 다만 노드는
+ * pager를 통해서 고정(pin)한 동안에만 접근하며, 자식은 페이지 번호로 가리킨다.
+ * 메모리 B-Tree와 달리 이미 있는 키를 삽입하면 값을 갱신한다.
+ *
+ * WAL을 사용하는 경우 버퍼 풀은 no-steal로 동작하여 수정된 페이지는
+ * 체크포인트에서만 파일에 기록된다. 체크포인트는 수정된 페이지의 이미지를
+ * 먼저 로그에 남기고(fsync) 파일에 기록한 후에 로그를 비운다. 따라서 복구는
+ * 마지막으로 완료된 체크포인트의 이미지를 되살린 뒤, 그 뒤의 논리적 연산을
+ * 다시 수행하는 것으로 끝난다. 구조 변경(split, merge, borrow) 레코드는
+ * 다시 수행하는 동안 똑같이 일어나는 지를 대조하는 데에만 사용된다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "btree-disk.h"
+
+#define DNODE(page) ((struct btree_disk_node *)(page))
+
+/**
+ * @brief 복구 중에 다시 수행하는 로그에 대한 상태를 가진다.
+ */
+struct btree_disk_replay {
+        struct wal_iter it;
+        size_t valid_end; /**< 마지막으로 온전한 레코드의 끝 위치 */
+
+        struct wal_record **expect; /**< 다음 연산에서 일어나야 할 구조 변경 */
+        int nr_expect;
+        int cap_expect;
+        int cursor;
+};
+
+static int btree_disk_checkpoint_pages(struct btree_disk *T);
+static int btree_disk_recover(struct btree_disk *T, const char *path,
+                              const struct btree_disk_config *config);
+
+/**
+ * @brief 페이지에 놓인 값 배열의 주소를 구한다.
+ */
+static inline uint64_t *btree_disk_values(struct btree_disk *T, void *page)
+{
+        return (uint64_t *)((char *)page + T->off_values);
+}
+
+/**
+ * @brief 페이지에 놓인 키 배열의 주소를 구한다.
+ */
+static inline key_t *btree_disk_keys(struct btree_disk *T, void *page)
+{
+        return (key_t *)((char *)page + T->off_keys);
+}
+
+/**
+ * @brief 페이지에 놓인 자식 페이지 번호 배열의 주소를 구한다.
+ */
+static inline pgno_t *btree_disk_child(struct btree_disk *T, void *page)
+{
+        return (pgno_t *)((char *)page + T->off_child);
+}
+
+/**
+ * @brief src 노드의 si 번째 항목을 dst 노드의 di 번째 위치로 복사한다.
+ */
+static inline void btree_disk_move_item(struct btree_disk *T, void *dst,
+                                        int di, void *src, int si)
+{
+        btree_disk_keys(T, dst)[di] = btree_disk_keys(T, src)[si];
+        btree_disk_values(T, dst)[di] = btree_disk_values(T, src)[si];
+}
+
+/**
+ * @brief 노드에서 key 이상인 첫 번째 키의 위치를 이진 탐색으로 찾는다.
+ */
+static int btree_disk_lower_bound(struct btree_disk *T, void *x, key_t key)
+{
+        const key_t *keys = btree_disk_keys(T, x);
+        int lo = 0;
+        int hi = DNODE(x)->n;
+
+        while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (keys[mid] < key) {
+                        lo = mid + 1;
+                } else {
+                        hi = mid;
+                }
+        }
+        return lo;
+}
+
+/**
+ * @brief 메모리에 있는 메타 데이터를 0번 페이지에 반영한다.
+ */
+static int btree_disk_write_meta(struct btree_disk *T)
+{
+        void *page = pager_pin(T->pager, B_TREE_DISK_META_PGNO);
+        if (!page) {
+                return -EIO;
+        }
+        memcpy(page, &T->meta, sizeof(struct btree_disk_meta));
+        pager_unpin(T->pager, B_TREE_DISK_META_PGNO, true);
+        return 0;
+}
+
+/**
+ * @brief 구조 변경을 로그에 남기도록 한다.
+ * @details 복구 중에는 로그에 남아있던 구조 변경과 순서대로 대조한다.
+ *
+ * @param T 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param type WAL_SPLIT, WAL_MERGE, WAL_BORROW 중 하나에 해당한다.
+ * @param parent 구조가 바뀐 부모 노드의 페이지 번호에 해당한다.
+ * @param child 구조가 바뀐 자식 노드의 페이지 번호에 해당한다.
+ * @param index 부모 노드에서의 위치에 해당한다.
+ */
+static void btree_disk_log_smo(struct btree_disk *T, enum wal_type type,
+                               pgno_t parent, pgno_t child, int index)
+{
+        const struct wal_smo smo = {
+                .parent = parent,
+                .child = child,
+                .index = index,
+                .reserved = 0,
+        };
+
+        if (T->replaying) {
+                struct btree_disk_replay *rp = T->replay;
+                struct wal_record *rec = NULL;
+
+                if (rp->cursor < rp->nr_expect) {
+                        rec = rp->expect[rp->cursor];
+                }
+                if (rec && rec->type == type &&
+                    !memcmp(rec + 1, &smo, sizeof(struct wal_smo))) {
+                        T->recovery.smo++;
+                } else {
+                        T->recovery.mismatch++;
+                }
+                rp->cursor++;
+        } else if (T->wal) {
+                if (wal_append(T->wal, type, &smo, sizeof(struct wal_smo))) {
+                        pr_info("Cannot log structure change\n");
+                }
+        }
+}
+
+/**
+ * @brief 논리적 연산을 로그에 남기고 commit 정책에 따라 반영한다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+static int btree_disk_log_op(struct btree_disk *T, enum wal_type type,
+                             key_t key, uint64_t value)
+{
+        const struct btree_disk_wal_op op = {
+                .value = value,
+                .key = key,
+                .reserved = 0,
+        };
+        int ret = 0;
+
+        if (!T->wal || T->replaying) {
+                return 0;
+        }
+        ret = wal_append(T->wal, type, &op, sizeof(struct btree_disk_wal_op));
+        return ret ? ret : wal_commit(T->wal);
+}
+
+/**
+ * @brief 연산을 시작하기 전에 버퍼 풀과 로그에 여유가 있는 지를 확인한다.
+ * @details no-steal로 동작하므로 수정된 페이지가 버퍼 풀을 채우기 전에,
+ * 그리고 로그가 너무 길어지기 전에 체크포인트를 수행한다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+static int btree_disk_reserve(struct btree_disk *T)
+{
+        const struct pager *pager = T->pager;
+
+        if (!T->wal) {
+                return 0;
+        }
+        if (pager->nr_dirty + B_TREE_DISK_WAL_RESERVE <= pager->nr_frames &&
+            T->wal->offset + (int64_t)T->wal->buf_len <=
+                    B_TREE_DISK_WAL_MAX_BYTES) {
+                return 0;
+        }
+        return btree_disk_checkpoint_pages(T);
+}
+
+/**
+ * @brief 파일 B-Tree에 들어갈 노드 페이지를 할당하고 고정하도록 한다.
+ * @details 해제된 페이지가 있으면 재사용하고, 없으면 파일 끝에 새로 만든다.
+ *
+ * @param T 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param pgno 할당된 페이지의 번호가 반환된다.
+ * @return void* 0으로 초기화된 페이지 내용을 반환한다.
+ * @exception 페이지를 고정할 수 없는 경우에는 NULL이 반환된다.
+ */
+static void *btree_disk_alloc_node(struct btree_disk *T, pgno_t *pgno)
+{
+        void *page = NULL;
+
+        if (T->meta.free_head == B_TREE_DISK_META_PGNO) {
+                return pager_pin_new(T->pager, pgno);
+        }
+
+        *pgno = T->meta.free_head;
+        page = pager_pin(T->pager, *pgno);
+        if (!page) {
+                return NULL;
+        }
+        T->meta.free_head = *(pgno_t *)((char *)page + T->off_values);
+        memset(page, 0, T->pager->page_size);
+        if (btree_disk_write_meta(T)) {
+                pager_unpin(T->pager, *pgno, true);
+                return NULL;
+        }
+        return page;
+}
+
+/**
+ * @brief 노드 페이지를 해제된 페이지 목록에 넣도록 한다.
+ *
+ * @param T 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param pgno 해제하고자 하는 페이지 번호에 해당한다.
+ */
+static int btree_disk_free_node(struct btree_disk *T, pgno_t pgno)
+{
+        void *page = pager_pin(T->pager, pgno);
+        if (!page) {
+                return -EIO;
+        }
+        DNODE(page)->n = 0;
+        *(pgno_t *)((char *)page + T->off_values) = T->meta.free_head;
+        pager_unpin(T->pager, pgno, true);
+
+        T->meta.free_head = pgno;
+        return btree_disk_write_meta(T);
+}
+
+/**
+ * @brief 페이지 크기에 맞추어 최소 차수와 배열의 위치를 정한다.
+ * @details 항목 하나에 값 8, 키 4, 자식 4 바이트가 필요하고 자식은 하나 더
+ * 필요하다. 따라서 (2t - 1) * 12 + 2t * 4 + 머리 <= 페이지 크기를 만족해야 한다.
+ */
+static void btree_disk_layout(struct btree_disk *T, size_t page_size)
+{
+        const size_t header = sizeof(struct btree_disk_node);
+        const int t = (int)((page_size - header + 12) / 32);
+        const int nr_keys = B_TREE_NR_KEYS(t);
+
+        T->min_degree = t;
+        T->off_values = header;
+        T->off_keys = T->off_values + nr_keys * sizeof(uint64_t);
+        T->off_child = T->off_keys + nr_keys * sizeof(key_t);
+}
+
+/**
+ * @brief 0번 페이지에서 메타 데이터를 읽는다. 파일이 비어있으면 새로 만든다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+static int btree_disk_load(struct btree_disk *tree, const char *path)
+{
+        void *page = NULL;
+        pgno_t pgno = 0;
+
+        if (tree->pager->nr_pages == 0) { /**< 새로운 파일 */
+                page = pager_pin_new(tree->pager, &pgno); /**< meta */
+                if (!page) {
+                        return -EIO;
+                }
+                pager_unpin(tree->pager, pgno, true);
+
+                page = pager_pin_new(tree->pager, &pgno); /**< root */
+                if (!page) {
+                        return -EIO;
+                }
+                DNODE(page)->is_leaf = true;
+                pager_unpin(tree->pager, pgno, true);
+
+                tree->meta.magic = B_TREE_DISK_MAGIC;
+                tree->meta.page_size = (uint32_t)tree->pager->page_size;
+                tree->meta.root = pgno;
+                tree->meta.free_head = B_TREE_DISK_META_PGNO;
+                return btree_disk_write_meta(tree);
+        }
+
+        page = pager_pin(tree->pager, B_TREE_DISK_META_PGNO);
+        if (!page) {
+                return -EIO;
+        }
+        memcpy(&tree->meta, page, sizeof(struct btree_disk_meta));
+        pager_unpin(tree->pager, B_TREE_DISK_META_PGNO, false);
+
+        if (tree->meta.magic != B_TREE_DISK_MAGIC ||
+            tree->meta.page_size != tree->pager->page_size) {
+                pr_info("Invalid B-Tree file(%s)\n", path);
+                return -EINVAL;
+        }
+        return 0;
+}
+
+/**
+ * @brief 파일 B-Tree를 열도록 한다. 파일이 비어있으면 새로 만든다.
+ *
+ * @param path B-Tree가 저장될 파일의 경로에 해당한다.
+ * @param config 페이지 크기, 버퍼 풀의 크기, WAL 사용 여부에 해당한다.
+ * NULL이면 기본값을 쓰고 WAL은 사용하지 않는다.
+ * @return struct btree_disk* 정상적으로 열린 경우에는 B-Tree 주소가 반환된다.
+ * @exception 파일이 손상되었거나 설정과 다른 경우에는 NULL이 반환된다.
+ *
+ * @warning 이미 있는 파일을 열 때는 만들 때와 같은 페이지 크기를 주어야 한다.
+ * 또한 WAL을 사용하는 경우에는 버퍼 풀이 B_TREE_DISK_WAL_RESERVE의 2배 이상의
+ * 프레임을 가져야 한다.
+ */
+struct btree_disk *btree_disk_open(const char *path,
+                                   const struct btree_disk_config *config)
+{
+        struct btree_disk *tree = NULL;
+        size_t page_size = B_TREE_DISK_DEFAULT_PAGE_SIZE;
+        int pool_pages = B_TREE_DISK_DEFAULT_POOL_PAGES;
+        int ret = 0;
+
+        if (config && config->page_size) {
+                page_size = config->page_size;
+        }
+        if (config && config->pool_pages) {
+                pool_pages = config->pool_pages;
+        }
+        if (config && config->wal && pool_pages < 2 * B_TREE_DISK_WAL_RESERVE) {
+                pr_info("WAL needs at least %d pool pages\n",
+                        2 * B_TREE_DISK_WAL_RESERVE);
+                return NULL;
+        }
+
+        tree = (struct btree_disk *)calloc(1, sizeof(struct btree_disk));
+        if (!tree) {
+                pr_info("Allocation tree failed\n");
+                return NULL;
+        }
+        btree_disk_layout(tree, page_size);
+
+        tree->pager = pager_open(path, page_size, pool_pages);
+        if (!tree->pager) {
+                goto exception;
+        }
+
+        if (config && config->wal) {
+                ret = btree_disk_recover(tree, path, config);
+        } else {
+                ret = btree_disk_load(tree, path);
+        }
+        if (ret) {
+                goto exception;
+        }
+        return tree;
+
+exception:
+        wal_close(tree->wal);
+        pager_close(tree->pager);
+        free(tree);
+        return NULL;
+}
+
+/**
+ * @brief 파일 B-Tree에 대한 탐색을 수행하도록 한다.
+ *
+ * @param tree 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param key 찾고자 하는 키에 해당한다.
+ * @param value 찾은 경우에 값이 반환된다. NULL이어도 된다.
+ * @return int 찾은 경우에는 0을, 없는 경우에는 -ENOENT를 반환한다.
+ */
+int btree_disk_search(struct btree_disk *tree, key_t key, uint64_t *value)
+{
+        pgno_t pgno = tree->meta.root;
+
+        for (;;) {
+                void *x = pager_pin(tree->pager, pgno);
+                pgno_t child = 0;
+                int i = 0;
+
+                if (!x) {
+                        return -EIO;
+                }
+                i = btree_disk_lower_bound(tree, x, key);
+                if (i < DNODE(x)->n && btree_disk_keys(tree, x)[i] == key) {
+                        if (value) {
+                                *value = btree_disk_values(tree, x)[i];
+                        }
+                        pager_unpin(tree->pager, pgno, false);
+                        return 0;
+                }
+                if (DNODE(x)->is_leaf) {
+                        pager_unpin(tree->pager, pgno, false);
+                        return -ENOENT;
+                }
+                child = btree_disk_child(tree, x)[i];
+                pager_unpin(tree->pager, pgno, false);
+                pgno = child;
+        }
+}
+
+/**
+ * @brief 임의의 노드 x에 대해서 2개의 노드로 분할하는 작업을 한다.
+ *
+ * @param T 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param xpg 분할이 발생하는 노드의 페이지 번호에 해당한다.
+ * @param x 분할이 발생하는 노드로 고정되어 있어야 한다.
+ * @param i 분할의 위치에 해당한다.
+ */
+static int btree_disk_split_child(struct btree_disk *T, pgno_t xpg, void *x,
+                                  int i)
+{
+        const int t = T->min_degree;
+        const pgno_t ypg = btree_disk_child(T, x)[i - 1];
+        pgno_t zpg = 0;
+        void *y = NULL;
+        void *z = NULL;
+
+        z = btree_disk_alloc_node(T, &zpg);
+        if (!z) {
+                return -EIO;
+        }
+        y = pager_pin(T->pager, ypg);
+        if (!y) {
+                pager_unpin(T->pager, zpg, true);
+                return -EIO;
+        }
+
+        DNODE(z)->is_leaf = DNODE(y)->is_leaf;
+        DNODE(z)->n = t - 1;
+
+        for (int j = 0; j < t - 1; j++) {
+                btree_disk_move_item(T, z, j, y, j + t);
+        }
+
+        if (!DNODE(y)->is_leaf) {
+                for (int j = 0; j < t; j++) {
+                        btree_disk_child(T, z)[j] = btree_disk_child(T, y)[j + t];
+                }
+        }
+
+        DNODE(y)->n = t - 1;
+
+        for (int j = DNODE(x)->n; j >= i; j--) {
+                btree_disk_child(T, x)[j + 1] = btree_disk_child(T, x)[j];
+        }
+        btree_disk_child(T, x)[i] = zpg;
+
+        for (int j = DNODE(x)->n; j >= i; j--) {
+                btree_disk_move_item(T, x, j, x, j - 1);
+        }
+        btree_disk_move_item(T, x, i - 1, y, t - 1);
+        DNODE(x)->n = DNODE(x)->n + 1;
+
+        pager_unpin(T->pager, ypg, true);
+        pager_unpin(T->pager, zpg, true);
+        btree_disk_log_smo(T, WAL_SPLIT, xpg, ypg, i);
+        return 0;
+}
+
+/**
+ * @brief 노드가 꽉 차지 않은 경우에 데이터의 삽입을 수행한다.
+ *
+ * @param T 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param xpg 꽉 차지 않은 노드의 페이지 번호이다.
+ * @param key 삽입 하고자 하는 키에 해당한다.
+ * @param value 삽입 하고자 하는 값에 해당한다.
+ */
+static int btree_disk_insert_non_full(struct btree_disk *T, pgno_t xpg,
+                                      key_t key, uint64_t value)
+{
+        void *x = NULL;
+        void *c = NULL;
+        pgno_t cpg = 0;
+        bool full = false;
+        int ret = 0;
+        int i = 0;
+
+        x = pager_pin(T->pager, xpg);
+        if (!x) {
+                return -EIO;
+        }
+
+        i = btree_disk_lower_bound(T, x, key);
+        if (i < DNODE(x)->n && btree_disk_keys(T, x)[i] == key) {
+                btree_disk_values(T, x)[i] = value;
+                pager_unpin(T->pager, xpg, true);
+                return 0;
+        }
+
+        if (DNODE(x)->is_leaf) {
+                for (int j = DNODE(x)->n; j > i; j--) {
+                        btree_disk_move_item(T, x, j, x, j - 1);
+                }
+                btree_disk_keys(T, x)[i] = key;
+                btree_disk_values(T, x)[i] = value;
+                DNODE(x)->n = DNODE(x)->n + 1;
+                pager_unpin(T->pager, xpg, true);
+                return 0;
+        }
+
+        cpg = btree_disk_child(T, x)[i];
+        c = pager_pin(T->pager, cpg);
+        if (!c) {
+                pager_unpin(T->pager, xpg, false);
+                return -EIO;
+        }
+        full = (DNODE(c)->n == B_TREE_NR_KEYS(T->min_degree));
+        pager_unpin(T->pager, cpg, false);
+
+        if (full) {
+                ret = btree_disk_split_child(T, xpg, x, i + 1);
+                if (ret) {
+                        pager_unpin(T->pager, xpg, false);
+                        return ret;
+                }
+                if (key == btree_disk_keys(T, x)[i]) {
+                        btree_disk_values(T, x)[i] = value;
+                        pager_unpin(T->pager, xpg, true);
+                        return 0;
+                }
+                if (key > btree_disk_keys(T, x)[i]) {
+                        i = i + 1;
+                }
+        }
+        cpg = btree_disk_child(T, x)[i];
+        pager_unpin(T->pager, xpg, full);
+
+        return btree_disk_insert_non_full(T, cpg, key, value);
+}
+
+/**
+ * @brief 파일 B-Tree에 대한 데이터의 삽입을 수행하도록 한다.
+ *
+ * @param tree 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param key 입력하고자 하는 데이터의 키에 해당한다.
+ * @param value 키와 함께 입력되고자 하는 값에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+static int __btree_disk_insert(struct btree_disk *tree, key_t key,
+                               uint64_t value)
+{
+        const pgno_t rpg = tree->meta.root;
+        pgno_t spg = 0;
+        void *r = NULL;
+        void *s = NULL;
+        int ret = 0;
+
+        r = pager_pin(tree->pager, rpg);
+        if (!r) {
+                return -EIO;
+        }
+        if (DNODE(r)->n < B_TREE_NR_KEYS(tree->min_degree)) {
+                pager_unpin(tree->pager, rpg, false);
+                return btree_disk_insert_non_full(tree, rpg, key, value);
+        }
+
+        s = btree_disk_alloc_node(tree, &spg);
+        if (!s) {
+                pager_unpin(tree->pager, rpg, false);
+                return -EIO;
+        }
+        DNODE(s)->is_leaf = false;
+        DNODE(s)->n = 0;
+        btree_disk_child(tree, s)[0] = rpg;
+
+        ret = btree_disk_split_child(tree, spg, s, 1);
+        pager_unpin(tree->pager, spg, true);
+        pager_unpin(tree->pager, rpg, false);
+        if (ret) {
+                return ret;
+        }
+
+        tree->meta.root = spg;
+        ret = btree_disk_write_meta(tree);
+        if (ret) {
+                return ret;
+        }
+        return btree_disk_insert_non_full(tree, spg, key, value);
+}
+
+/**
+ * @brief 임의의 노드에서의 전위 또는 후위 항목을 찾는 역할을 한다.
+ *
+ * @param T 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param pgno 찾기 시작하는 노드의 페이지 번호를 의미한다.
+ * @param rightmost true이면 전위를, false이면 후위를 찾는다.
+ * @param key 찾은 항목의 키가 반환된다.
+ * @param value 찾은 항목의 값이 반환된다.
+ */
+static int btree_disk_get_neighbor(struct btree_disk *T, pgno_t pgno,
+                                   bool rightmost, key_t *key, uint64_t *value)
+{
+        for (;;) {
+                void *x = pager_pin(T->pager, pgno);
+                pgno_t child = 0;
+                int i = 0;
+
+                if (!x) {
+                        return -EIO;
+                }
+                if (DNODE(x)->is_leaf) {
+                        i = rightmost ? DNODE(x)->n - 1 : 0;
+                        *key = btree_disk_keys(T, x)[i];
+                        *value = btree_disk_values(T, x)[i];
+                        pager_unpin(T->pager, pgno, false);
+                        return 0;
+                }
+                i = rightmost ? DNODE(x)->n : 0;
+                child = btree_disk_child(T, x)[i];
+                pager_unpin(T->pager, pgno, false);
+                pgno = child;
+        }
+}
+
+/**
+ * @brief 임의의 노드에 대해서 병합을 실시하도록 한다.
+ * @details i 위치의 왼쪽 자식에 부모의 i 내용과 오른쪽 자식의 내용을 병합을 하도록 한다.
+ *
+ * @param T 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param ppg 부모 노드의 페이지 번호에 해당한다.
+ * @param p 고정된 부모 노드에 해당한다.
+ * @param i 부모 노드의 병합 위치에 해당한다.
+ */
+static int btree_disk_merge_child(struct btree_disk *T, pgno_t ppg, void *p,
+                                  int i)
+{
+        const int t = T->min_degree;
+        const pgno_t cpg[] = {
+                btree_disk_child(T, p)[i],
+                btree_disk_child(T, p)[i + 1],
+        };
+        void *child[2] = { NULL, NULL };
+        int ret = 0;
+
+        child[0] = pager_pin(T->pager, cpg[0]);
+        child[1] = pager_pin(T->pager, cpg[1]);
+        if (!child[0] || !child[1]) {
+                if (child[0]) {
+                        pager_unpin(T->pager, cpg[0], false);
+                }
+                if (child[1]) {
+                        pager_unpin(T->pager, cpg[1], false);
+                }
+                return -EIO;
+        }
+
+        DNODE(child[0])->n = B_TREE_NR_KEYS(t);
+        btree_disk_move_item(T, child[0], t - 1, p, i);
+
+        for (int j = 0; j < t - 1; j++) {
+                btree_disk_move_item(T, child[0], j + t, child[1], j);
+        }
+
+        if (!DNODE(child[0])->is_leaf) {
+                for (int j = 0; j < t; j++) {
+                        btree_disk_child(T, child[0])[j + t] =
+                                btree_disk_child(T, child[1])[j];
+                }
+        }
+
+        DNODE(p)->n -= 1;
+
+        for (int j = i; j < DNODE(p)->n; j++) {
+                btree_disk_move_item(T, p, j, p, j + 1);
+                btree_disk_child(T, p)[j + 1] = btree_disk_child(T, p)[j + 2];
+        }
+
+        pager_unpin(T->pager, cpg[0], true);
+        pager_unpin(T->pager, cpg[1], false);
+        btree_disk_log_smo(T, WAL_MERGE, ppg, cpg[0], i);
+
+        ret = btree_disk_free_node(T, cpg[1]);
+        if (!ret && DNODE(p)->n == 0) {
+                if (ppg == T->meta.root) {
+                        T->meta.root = cpg[0];
+                }
+                ret = btree_disk_free_node(T, ppg);
+        }
+        return ret;
+}
+
+/**
+ * @brief 자식이 t - 1개의 키만 가질 때 형제에게서 하나를 빌려오거나 병합한다.
+ * @details btree.c의 __btree_delete() case 3의 앞부분과 동일하다.
+ *
+ * @param T 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param xpg 고정된 부모 노드의 페이지 번호에 해당한다.
+ * @param x 고정된 부모 노드에 해당한다.
+ * @param i 삭제를 위해서 내려갈 자식의 위치에 해당한다.
+ * @param next 다음으로 내려갈 자식의 페이지 번호가 반환된다.
+ */
+static int btree_disk_fill_child(struct btree_disk *T, pgno_t xpg, void *x,
+                                 int i, pgno_t *next)
+{
+        const int t = T->min_degree;
+        pgno_t cpg = btree_disk_child(T, x)[i];
+        pgno_t lpg = (i > 0) ? btree_disk_child(T, x)[i - 1] : 0;
+        pgno_t rpg = (i < DNODE(x)->n) ? btree_disk_child(T, x)[i + 1] : 0;
+        void *child = NULL;
+        void *left = NULL;
+        void *right = NULL;
+        int ret = 0;
+        int j = 0;
+
+        *next = cpg;
+        child = pager_pin(T->pager, cpg);
+        if (!child) {
+                return -EIO;
+        }
+        if (DNODE(child)->n != t - 1) {
+                pager_unpin(T->pager, cpg, false);
+                return 0;
+        }
+
+        left = lpg ? pager_pin(T->pager, lpg) : NULL;
+        right = rpg ? pager_pin(T->pager, rpg) : NULL;
+        if ((lpg && !left) || (rpg && !right)) {
+                ret = -EIO;
+                goto out;
+        }
+
+        if (left && DNODE(left)->n >= t) {
+                for (j = DNODE(child)->n; j > 0; --j) {
+                        btree_disk_move_item(T, child, j, child, j - 1);
+                }
+                btree_disk_move_item(T, child, 0, x, i - 1);
+
+                if (!DNODE(left)->is_leaf) {
+                        for (j = DNODE(child)->n + 1; j > 0; j--) {
+                                btree_disk_child(T, child)[j] =
+                                        btree_disk_child(T, child)[j - 1];
+                        }
+                        btree_disk_child(T, child)[0] =
+                                btree_disk_child(T, left)[DNODE(left)->n];
+                }
+
+                DNODE(child)->n += 1;
+                btree_disk_move_item(T, x, i - 1, left, DNODE(left)->n - 1);
+                DNODE(left)->n -= 1;
+                btree_disk_log_smo(T, WAL_BORROW, xpg, lpg, i);
+        } else if (right && DNODE(right)->n >= t) {
+                btree_disk_move_item(T, child, DNODE(child)->n, x, i);
+                DNODE(child)->n += 1;
+
+                btree_disk_move_item(T, x, i, right, 0);
+                DNODE(right)->n -= 1;
+
+                for (j = 0; j < DNODE(right)->n; j++) {
+                        btree_disk_move_item(T, right, j, right, j + 1);
+                }
+
+                if (!DNODE(right)->is_leaf) {
+                        btree_disk_child(T, child)[DNODE(child)->n] =
+                                btree_disk_child(T, right)[0];
+                        for (j = 0; j <= DNODE(right)->n; j++) {
+                                btree_disk_child(T, right)[j] =
+                                        btree_disk_child(T, right)[j + 1];
+                        }
+                }
+                btree_disk_log_smo(T, WAL_BORROW, xpg, rpg, i);
+        } else if (left) {
+                ret = btree_disk_merge_child(T, xpg, x, i - 1);
+                *next = lpg;
+        } else if (right) {
+                ret = btree_disk_merge_child(T, xpg, x, i);
+        }
+
+out:
+        if (right) {
+                pager_unpin(T->pager, rpg, true);
+        }
+        if (left) {
+                pager_unpin(T->pager, lpg, true);
+        }
+        pager_unpin(T->pager, cpg, true);
+        return ret;
+}
+
+/**
+ * @brief key에 해당하는 것에 대해서 재귀적으로 제거를 진행하도록 한다.
+ * @details 각 case는 btree.c의 __btree_delete()와 동일하다.
+ *
+ * @param T 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param xpg 현재 삭제를 수행하는 노드의 페이지 번호에 해당한다.
+ * @param key 제거하고자 하는 위치의 키에 해당한다.
+ * @return int 성공 시에 0을 반환한다.
+ */
+static int __btree_disk_delete(struct btree_disk *T, pgno_t xpg, key_t key)
+{
+        const int t = T->min_degree;
+        void *x = NULL;
+        void *prev = NULL;
+        void *next = NULL;
+        pgno_t prevpg = 0;
+        pgno_t nextpg = 0;
+        pgno_t cpg = 0;
+        bool prev_rich = false;
+        bool next_rich = false;
+        key_t nkey = 0;
+        uint64_t nvalue = 0;
+        int ret = 0;
+        int i = 0;
+
+        x = pager_pin(T->pager, xpg);
+        if (!x) {
+                return -EIO;
+        }
+
+        i = btree_disk_lower_bound(T, x, key);
+
+        if (i < DNODE(x)->n && btree_disk_keys(T, x)[i] == key) {
+                if (DNODE(x)->is_leaf) { /**< case 1 */
+                        DNODE(x)->n -= 1;
+                        for (; i < DNODE(x)->n; i++) {
+                                btree_disk_move_item(T, x, i, x, i + 1);
+                        }
+                        pager_unpin(T->pager, xpg, true);
+                        return 0;
+                }
+
+                prevpg = btree_disk_child(T, x)[i]; /**< case 2 */
+                nextpg = btree_disk_child(T, x)[i + 1];
+                prev = pager_pin(T->pager, prevpg);
+                next = pager_pin(T->pager, nextpg);
+                if (prev && next) {
+                        prev_rich = (DNODE(prev)->n >= t);
+                        next_rich = (DNODE(next)->n >= t);
+                } else {
+                        ret = -EIO;
+                }
+                if (next) {
+                        pager_unpin(T->pager, nextpg, false);
+                }
+                if (prev) {
+                        pager_unpin(T->pager, prevpg, false);
+                }
+
+                if (ret) {
+                        pager_unpin(T->pager, xpg, false);
+                        return ret;
+                } else if (prev_rich) { /**< case 2a */
+                        ret = btree_disk_get_neighbor(T, prevpg, true, &nkey,
+                                                      &nvalue);
+                        ret = ret ? ret : __btree_disk_delete(T, prevpg, nkey);
+                } else if (next_rich) { /**< case 2b */
+                        ret = btree_disk_get_neighbor(T, nextpg, false, &nkey,
+                                                      &nvalue);
+                        ret = ret ? ret : __btree_disk_delete(T, nextpg, nkey);
+                } else { /**< case 2c */
+                        ret = btree_disk_merge_child(T, xpg, x, i);
+                        pager_unpin(T->pager, xpg, true);
+                        return ret ? ret : __btree_disk_delete(T, prevpg, key);
+                }
+
+                if (!ret) {
+                        btree_disk_keys(T, x)[i] = nkey;
+                        btree_disk_values(T, x)[i] = nvalue;
+                }
+                pager_unpin(T->pager, xpg, !ret);
+                return ret;
+        }
+
+        if (DNODE(x)->is_leaf) {
+                pager_unpin(T->pager, xpg, false);
+                return -EINVAL;
+        }
+
+        ret = btree_disk_fill_child(T, xpg, x, i, &cpg); /**< case 3 */
+        pager_unpin(T->pager, xpg, true);
+        return ret ? ret : __btree_disk_delete(T, cpg, key);
+}
+
+/**
+ * @brief 파일 B-Tree에 대한 데이터의 삽입을 수행하도록 한다.
+ *
+ * @param tree 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param key 입력하고자 하는 데이터의 키에 해당한다.
+ * @param value 키와 함께 입력되고자 하는 값에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ *
+ * @note WAL을 사용하는 경우에는 commit 정책에 따라 반영된 후에 영속된다.
+ */
+int btree_disk_insert(struct btree_disk *tree, key_t key, uint64_t value)
+{
+        int ret = btree_disk_reserve(tree);
+
+        ret = ret ? ret : __btree_disk_insert(tree, key, value);
+        return ret ? ret : btree_disk_log_op(tree, WAL_INSERT, key, value);
+}
+
+/**
+ * @brief 로그를 남기지 않고 삭제를 수행하도록 한다.
+ */
+static int btree_disk_delete_nolog(struct btree_disk *tree, key_t key)
+{
+        int ret = btree_disk_search(tree, key, NULL);
+        if (ret == -ENOENT) {
+                pr_info("Cannot find specific node\n");
+                return -EINVAL;
+        }
+        if (ret) {
+                return ret;
+        }
+        return __btree_disk_delete(tree, tree->meta.root, key);
+}
+
+/**
+ * @brief 파일 B-Tree에서 삭제를 수행하도록 한다.
+ *
+ * @param tree 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param key 삭제를 하고자 하는 키에 해당한다.
+ * @return int 삭제를 성공한 경우에는 0을, 키가 없으면 -EINVAL을 반환한다.
+ */
+int btree_disk_delete(struct btree_disk *tree, key_t key)
+{
+        int ret = btree_disk_reserve(tree);
+
+        ret = ret ? ret : btree_disk_delete_nolog(tree, key);
+        return ret ? ret : btree_disk_log_op(tree, WAL_DELETE, key, 0);
+}
+
+/**
+ * @brief 체크포인트에서 수정된 페이지의 이미지를 로그에 남긴다.
+ */
+static int btree_disk_log_page(pgno_t pgno, void *data, void *private)
+{
+        struct btree_disk *T = (struct btree_disk *)private;
+        const uint64_t head = pgno;
+
+        return wal_append2(T->wal, WAL_PAGE, &head, sizeof(head), data,
+                           T->pager->page_size);
+}
+
+/**
+ * @brief 체크포인트를 수행하도록 한다.
+ * @details 수정된 페이지의 이미지를 BEGIN, END 레코드 사이에 남기고 fsync 한
+ * 후에 파일에 기록한다. 복구 중이라면 아직 다시 수행하지 않은 레코드를
+ * END 뒤에 옮겨 적고 로그를 비우지 않는다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+static int btree_disk_checkpoint_pages(struct btree_disk *T)
+{
+        struct btree_disk_replay *rp = T->replay;
+        int ret = 0;
+
+        ret = btree_disk_write_meta(T);
+        ret = ret ? ret : wal_append(T->wal, WAL_CHECKPOINT_BEGIN, NULL, 0);
+        ret = ret ? ret : pager_for_each_dirty(T->pager, btree_disk_log_page, T);
+        ret = ret ? ret : wal_append(T->wal, WAL_CHECKPOINT_END, NULL, 0);
+        if (!ret && T->replaying) {
+                ret = wal_write_raw(T->wal, rp->it.data + rp->it.pos,
+                                    rp->valid_end - rp->it.pos);
+        }
+        ret = ret ? ret : wal_sync(T->wal);
+        ret = ret ? ret : pager_sync(T->pager);
+        if (!ret && !T->replaying) {
+                ret = wal_truncate(T->wal, 0);
+        }
+        if (!ret) {
+                T->nr_checkpoints++;
+        }
+        return ret;
+}
+
+/**
+ * @brief 로그에서 마지막으로 완료된 체크포인트의 페이지 이미지를 되살린다.
+ *
+ * @param T 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @param rp 로그 전체를 읽어둔 복구 상태에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ * 반환 후에 rp->it.pos는 다시 수행할 첫 레코드를 가리킨다.
+ */
+static int btree_disk_redo_pages(struct btree_disk *T,
+                                 struct btree_disk_replay *rp)
+{
+        struct wal_record *rec = NULL;
+        void *payload = NULL;
+        size_t begin = 0;
+        size_t ckpt_begin = 0;
+        size_t ckpt_end = 0;
+        bool found = false;
+
+        for (;;) {
+                size_t pos = rp->it.pos;
+                if (!wal_iter_next(&rp->it, &rec, &payload)) {
+                        break;
+                }
+                if (rec->type == WAL_CHECKPOINT_BEGIN) {
+                        begin = pos;
+                } else if (rec->type == WAL_CHECKPOINT_END) {
+                        ckpt_begin = begin;
+                        ckpt_end = rp->it.pos;
+                        found = true;
+                }
+        }
+        rp->valid_end = rp->it.pos;
+
+        rp->it.pos = ckpt_begin;
+        while (found && rp->it.pos < ckpt_end &&
+               wal_iter_next(&rp->it, &rec, &payload)) {
+                const pgno_t pgno = (pgno_t)*(uint64_t *)payload;
+                void *page = NULL;
+
+                if (rec->type != WAL_PAGE) {
+                        continue;
+                }
+                if (pgno >= T->pager->nr_pages) {
+                        T->pager->nr_pages = pgno + 1;
+                }
+                page = pager_pin(T->pager, pgno);
+                if (!page) {
+                        return -EIO;
+                }
+                memcpy(page, (char *)payload + sizeof(uint64_t),
+                       T->pager->page_size);
+                pager_unpin(T->pager, pgno, true);
+                T->recovery.pages++;
+        }
+        rp->it.pos = ckpt_end;
+
+        return found ? pager_sync(T->pager) : 0;
+}
+
+/**
+ * @brief 체크포인트 뒤에 남은 논리적 연산을 다시 수행한다.
+ * @details 연산보다 먼저 기록된 구조 변경 레코드를 모아두었다가 연산을
+ * 다시 수행하면서 똑같이 일어나는 지를 btree_disk_log_smo()에서 대조한다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+static int btree_disk_replay_log(struct btree_disk *T,
+                                 struct btree_disk_replay *rp)
+{
+        struct wal_record *rec = NULL;
+        void *payload = NULL;
+        int ret = 0;
+
+        T->replaying = true;
+        T->replay = rp;
+        while (!ret && wal_iter_next(&rp->it, &rec, &payload)) {
+                const struct btree_disk_wal_op *op = payload;
+
+                switch (rec->type) {
+                case WAL_SPLIT:
+                case WAL_MERGE:
+                case WAL_BORROW:
+                        if (rp->nr_expect == rp->cap_expect) {
+                                int cap = rp->cap_expect ? 2 * rp->cap_expect : 16;
+                                struct wal_record **expect = realloc(
+                                        rp->expect,
+                                        cap * sizeof(struct wal_record *));
+                                if (!expect) {
+                                        ret = -ENOMEM;
+                                        break;
+                                }
+                                rp->expect = expect;
+                                rp->cap_expect = cap;
+                        }
+                        rp->expect[rp->nr_expect++] = rec;
+                        break;
+                case WAL_INSERT:
+                case WAL_DELETE:
+                        rp->cursor = 0;
+                        if (rec->type == WAL_INSERT) {
+                                ret = __btree_disk_insert(T, op->key, op->value);
+                        } else {
+                                ret = btree_disk_delete_nolog(T, op->key);
+                        }
+                        if (ret == -EINVAL || rp->cursor != rp->nr_expect) {
+                                T->recovery.mismatch++;
+                                ret = (ret == -EINVAL) ? 0 : ret;
+                        }
+                        rp->nr_expect = 0;
+                        T->recovery.ops++;
+                        ret = ret ? ret : btree_disk_reserve(T);
+                        break;
+                default: /**< 완료되지 못한 체크포인트는 무시한다. */
+                        break;
+                }
+        }
+        T->replaying = false;
+        T->replay = NULL;
+
+        if (T->recovery.mismatch) {
+                pr_info("Replay diverged from the log(%lu)\n",
+                        T->recovery.mismatch);
+        }
+        return ret;
+}
+
+/**
+ * @brief "<path>-wal" 형태의 로그 파일 경로를 만든다.
+ */
+static char *btree_disk_wal_path(const char *path)
+{
+        const char *suffix = "-wal";
+        char *wal_path = (char *)malloc(strlen(path) + strlen(suffix) + 1);
+
+        if (wal_path) {
+                strcpy(wal_path, path);
+                strcat(wal_path, suffix);
+        }
+        return wal_path;
+}
+
+/**
+ * @brief WAL을 열고 필요하면 복구를 수행하도록 한다.
+ * @details 복구가 끝나면 체크포인트를 수행하여 로그를 비운다.
+ *
+ * @param T 메타 데이터를 읽기 전의 파일 B-Tree에 해당한다.
+ * @param path B-Tree 파일의 경로에 해당한다.
+ * @param config WAL의 설정에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+static int btree_disk_recover(struct btree_disk *T, const char *path,
+                              const struct btree_disk_config *config)
+{
+        struct btree_disk_replay rp;
+        char *wal_path = btree_disk_wal_path(path);
+        int ret = 0;
+
+        memset(&rp, 0, sizeof(struct btree_disk_replay));
+        if (!wal_path) {
+                return -ENOMEM;
+        }
+
+        ret = wal_iter_open(&rp.it, wal_path);
+        ret = ret ? ret : btree_disk_redo_pages(T, &rp);
+        ret = ret ? ret : btree_disk_load(T, path);
+        if (!ret) {
+                T->wal = wal_open(wal_path, &config->wal_config);
+                ret = T->wal ? 0 : -EIO;
+        }
+        ret = ret ? ret : wal_truncate(T->wal, (int64_t)rp.valid_end);
+        if (!ret) {
+                T->pager->no_steal = true;
+                ret = btree_disk_replay_log(T, &rp);
+        }
+        ret = ret ? ret : btree_disk_checkpoint_pages(T);
+
+        wal_iter_close(&rp.it);
+        free(rp.expect);
+        free(wal_path);
+        return ret;
+}
+
+/**
+ * @brief 버퍼에 남은 연산을 영속시키도록 한다.
+ * @details WAL을 사용하면 로그만 fsync 하고, 그렇지 않으면 수정된 페이지를
+ * 모두 기록하고 파일을 동기화한다.
+ *
+ * @param tree 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int btree_disk_sync(struct btree_disk *tree)
+{
+        int ret = 0;
+
+        if (tree->wal) {
+                return wal_sync(tree->wal);
+        }
+        ret = btree_disk_write_meta(tree);
+        return ret ? ret : pager_sync(tree->pager);
+}
+
+/**
+ * @brief 체크포인트를 수행하여 로그를 비우도록 한다.
+ *
+ * @param tree 파일 B-Tree를 가리키는 포인터에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int btree_disk_checkpoint(struct btree_disk *tree)
+{
+        if (!tree->wal) {
+                return btree_disk_sync(tree);
+        }
+        return btree_disk_checkpoint_pages(tree);
+}
+
+/**
+ * @brief 파일 B-Tree를 닫고 할당된 메모리를 해제한다.
+ *
+ * @param tree 파일 B-Tree를 가리키는 포인터에 해당한다.
+ */
+void btree_disk_close(struct btree_disk *tree)
+{
+        if (tree) {
+                btree_disk_checkpoint(tree);
+                wal_close(tree->wal);
+                pager_close(tree->pager);
+                free(tree);
+        }
+}
@@ -0,0 +1,107 @@
+/**
+ * @file btree-disk.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 파일에 저장되는 페이지 기반 B-Tree에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _B_TREE_DISK_H
+#define _B_TREE_DISK_H
+
+#include <stdint.h>
+#include "btree.h"
+#include "pager.h"
+#include "wal.h"
+
+#define B_TREE_DISK_MAGIC 0x42545244u /**< "BTRD" */
+#define B_TREE_DISK_META_PGNO 0 /**< 메타 페이지의 번호로 자식 번호로는 쓰이지 않는다. */
+#define B_TREE_DISK_DEFAULT_PAGE_SIZE (4 * 1024)
+#define B_TREE_DISK_DEFAULT_POOL_PAGES 1024
+#define B_TREE_DISK_WAL_RESERVE 48 /**< 연산 하나가 수정하거나 고정할 수 있는 페이지 수 */
+#define B_TREE_DISK_WAL_MAX_BYTES (64L * 1024 * 1024) /**< 넘으면 체크포인트 한다. */
+
+/**
+ * @brief 파일 B-Tree를 열 때 사용하는 설정에 해당한다.
+ * @note 0으로 둔 항목은 기본값이 사용된다.
+ */
+struct btree_disk_config {
+        size_t page_size; /**< 노드 하나의 크기로 4KiB ~ 64KiB 사이여야 한다. */
+        int pool_pages; /**< 버퍼 풀이 가지는 프레임의 수에 해당한다. */
+        bool wal; /**< 설정되면 "<path>-wal"에 WAL을 남기고 열 때 복구한다. */
+        struct wal_config wal_config; /**< WAL의 commit 정책에 해당한다. */
+};
+
+/**
+ * @brief 0번 페이지에 저장되는 파일 B-Tree의 메타 데이터에 해당한다.
+ */
+struct btree_disk_meta {
+        uint32_t magic;
+        uint32_t page_size;
+        pgno_t root; /**< 루트 노드의 페이지 번호를 가진다. */
+        pgno_t free_head; /**< 재사용할 수 있는 페이지 목록의 시작이다. */
+};
+
+/**
+ * @brief 페이지에 저장되는 노드의 머리 부분에 해당한다.
+ * @details 머리 뒤에는 값(uint64_t), 키(key_t), 자식 페이지 번호(pgno_t)의
+ * 배열이 차례대로 놓인다.
+ */
+struct btree_disk_node {
+        uint16_t n; /**< 노드가 현재 사용 중인 항목의 갯수를 가진다. */
+        uint8_t is_leaf; /**< 노드가 leaf 위치에 있는 지에 대한 정보를 가진다. */
+        uint8_t reserved[5];
+};
+
+/**
+ * @brief WAL 레코드로 남기는 논리적 연산의 payload에 해당한다.
+ */
+struct btree_disk_wal_op {
+        uint64_t value;
+        key_t key;
+        uint32_t reserved;
+};
+
+/**
+ * @brief 마지막 복구에서 수행한 작업의 통계에 해당한다.
+ */
+struct btree_disk_recovery {
+        unsigned long pages; /**< 체크포인트에서 되살린 페이지 이미지의 수 */
+        unsigned long ops; /**< 다시 수행한 논리적 연산의 수 */
+        unsigned long smo; /**< 로그와 일치함을 확인한 구조 변경의 수 */
+        unsigned long mismatch; /**< 로그와 다르게 일어난 구조 변경의 수 */
+};
+
+/**
+ * @brief 파일 B-Tree 전체를 관리하는 구조체에 해당한다.
+ * @details 노드는 페이지 하나에 저장되고, 자식은 포인터 대신 페이지 번호로
+ * 가리킨다. 최소 차수는 페이지 크기에 맞추어 정해진다.
+ */
+struct btree_disk {
+        int min_degree;
+        struct pager *pager;
+        struct btree_disk_meta meta; /**< 0번 페이지 내용의 사본이다. */
+
+        size_t off_values; /**< 페이지에서 값 배열이 시작하는 위치 */
+        size_t off_keys; /**< 페이지에서 키 배열이 시작하는 위치 */
+        size_t off_child; /**< 페이지에서 자식 배열이 시작하는 위치 */
+
+        struct wal *wal; /**< WAL을 사용하지 않으면 NULL이다. */
+        bool replaying; /**< 복구 중에는 로그를 남기지 않고 대조만 한다. */
+        struct btree_disk_replay *replay;
+        struct btree_disk_recovery recovery;
+        unsigned long nr_checkpoints;
+};
+
+struct btree_disk *btree_disk_open(const char *path,
+                                   const struct btree_disk_config *config);
+int btree_disk_search(struct btree_disk *tree, key_t key, uint64_t *value);
+int btree_disk_insert(struct btree_disk *tree, key_t key, uint64_t value);
+int btree_disk_delete(struct btree_disk *tree, key_t key);
+int btree_disk_sync(struct btree_disk *tree);
+int btree_disk_checkpoint(struct btree_disk *tree);
+void btree_disk_close(struct btree_disk *tree);
+
+#endif
@@ -0,0 +1,927 @@
+/**
+ * @file btree-generic.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 키와 값의 타입을 정해서 B-Tree를 찍어내는 매크로가 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details BTREE_DEFINE(name, key_type, value_type, cmp)는 다음을 만든다.
+ *
+ * - struct name, struct name_node
+ * - struct name *name_alloc(int min_degree)
+ * - void name_free(struct name *T)
+ * - value_type *name_search(struct name *T, key_type key)
+ * - int name_insert(struct name *T, key_type key, value_type value)
+ * - int name_delete(struct name *T, key_type key)
+ * - int name_scan(struct name *T, key_type start, int count,
+ *                 name_visit_fn fn, void *private)
+ * - int name_for_each(struct name *T, name_visit_fn fn, void *private)
+ * - size_t name_bytes(const struct name *T)
+ *
+ * BTREE_SET_DEFINE(name, key_type, cmp)는 값 없이 키만 저장하는 집합을 만든다.
+ * 노드에 값 배열이 없으므로 4바이트 키와 포인터 값의 맵에 비해 키 하나당
+ * 크기가 절반 이하가 된다. alloc, free, delete, scan, for_each, bytes는 위와 같고, 나머지는 다음과 같다.
+ *
+ * - bool name_contains(struct name *T, key_type key)
+ * - int name_insert(struct name *T, key_type key): 이미 있으면 -EEXIST를 반환한다.
+ * - int name_union(struct name *T, struct name *other)
+ * - int name_intersect(struct name *T, struct name *other)
+ * - int name_subtract(struct name *T, struct name *other)
+ *
+ * 집합 연산은 결과를 T에 남기며 other는 바꾸지 않는다. 할당에 실패하면
+ * -ENOMEM을 반환하며, union은 그 때까지 넣은 키가 T에 남는다.
+ *
+ * BTREE_HANDLE_DEFINE(name, key_type, value_type, cmp)는 BTREE_DEFINE과 같은
+ * 함수를 만들지만, 노드를 트리가 가진 풀에서 할당하고 자식을 32비트 핸들로
+ * 가리킨다. 내부 노드의 자식 배열이 절반이 되며 노드 사이의 참조가 주소와
+ * 무관하므로 풀을 통째로 옮기거나 저장할 수 있다.
+ *
+ * 알고리즘과 반환값은 struct btree(CLRS, 중복 키 허용)와 같으며, 삽입은
+ * 할당에 실패하면 -ENOMEM을, 삭제는 키가 없으면 -EINVAL을 반환한다. 삽입이
+ * 실패해도 트리의 키는 그대로이지만, 내려가며 먼저 끝낸 분할은 되돌리지 않으므로
+ * 노드의 모양은 달라질 수 있다. cmp(a, b)는 a < b, a == b, a > b일 때 각각 음수, 0, 양수가 되는
+ * 함수형 매크로 또는 static inline 함수로, 모든 함수가 헤더에서 만들어지므로
+ * 비교가 함수 포인터 없이 그대로 인라인된다.
+ *
+ * 노드는 [struct name_node][keys][values][child]의 한 덩어리로 할당되며,
+ * 잎에는 child를 두지 않는다. 탐색은 키 배열만 훑으므로 값의 크기가 캐시
+ * 사용량에 영향을 주지 않는다.
+ *
+ * 예시:
+ *
+ *     BTREE_DEFINE(btree_u64, uint64_t, void *, BTREE_CMP_SCALAR)
+ *
+ *     struct btree_u64 *tree = btree_u64_alloc(8);
+ *     btree_u64_insert(tree, 42, NULL);
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _B_TREE_GENERIC_H
+#define _B_TREE_GENERIC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "btree.h"
+
+/**
+ * @brief 정수나 실수처럼 비교 연산자를 쓸 수 있는 키의 비교에 해당한다.
+ */
+#define BTREE_CMP_SCALAR(a, b) (((a) > (b)) - ((a) < (b)))
+
+/**
+ * @brief 핸들 풀의 청크 하나에 들어가는 노드 수의 log2에 해당한다.
+ */
+#define B_TREE_HANDLE_CHUNK_SHIFT 10
+#define B_TREE_HANDLE_CHUNK (1u << B_TREE_HANDLE_CHUNK_SHIFT)
+#define B_TREE_HANDLE_LEAF_SHIFT 31 /**< 핸들의 최상위 비트는 잎 여부이다. */
+#define B_TREE_HANDLE_INDEX_MASK ((1u << B_TREE_HANDLE_LEAF_SHIFT) - 1)
+#define B_TREE_HANDLE_NONE UINT32_MAX
+
+/**
+ * @brief 같은 크기의 노드를 32비트 번호로 나누어 주는 풀에 해당한다.
+ * @details 노드는 B_TREE_HANDLE_CHUNK개씩 묶인 청크에 놓이고, 청크는 한 번
+ * 할당되면 옮겨지지 않으므로 번호에서 얻은 주소는 풀이 없어질 때까지 유효하다.
+ * 반환된 칸은 칸의 앞 4바이트에 다음 빈 칸의 번호를 적어 연결한다.
+ */
+struct btree_handle_pool {
+        char **chunks;
+        uint32_t nr_chunks;
+        uint32_t nr_used; /**< 한 번이라도 나누어 준 칸의 수 */
+        uint32_t free; /**< 반환된 칸 목록의 머리 */
+        size_t stride; /**< 칸 하나의 크기 */
+};
+
+static inline void btree_handle_init(struct btree_handle_pool *pool,
+                                     size_t size, size_t align)
+{
+        memset(pool, 0, sizeof(struct btree_handle_pool));
+        pool->free = B_TREE_HANDLE_NONE;
+        pool->stride = (size + align - 1) / align * align;
+}
+
+static inline void *btree_handle_ptr(const struct btree_handle_pool *pool,
+                                     uint32_t index)
+{
+        return pool->chunks[index >> B_TREE_HANDLE_CHUNK_SHIFT] +
+               (size_t)(index & (B_TREE_HANDLE_CHUNK - 1)) * pool->stride;
+}
+
+/**
+ * @brief 풀에서 칸 하나를 할당한다.
+ *
+ * @return uint32_t 칸의 번호를, 실패하면 B_TREE_HANDLE_NONE을 반환한다.
+ */
+static inline uint32_t btree_handle_alloc(struct btree_handle_pool *pool)
+{
+        uint32_t index = pool->free;
+        char **chunks = NULL;
+
+        if (index != B_TREE_HANDLE_NONE) {
+                memcpy(&pool->free, btree_handle_ptr(pool, index),
+                       sizeof(uint32_t));
+                return index;
+        }
+        if (pool->nr_used > B_TREE_HANDLE_INDEX_MASK) {
+                return B_TREE_HANDLE_NONE;
+        }
+        if (pool->nr_used == pool->nr_chunks * B_TREE_HANDLE_CHUNK) {
+                chunks = (char **)realloc(pool->chunks,
+                                          (pool->nr_chunks + 1) *
+                                                  sizeof(char *));
+                if (!chunks) {
+                        return B_TREE_HANDLE_NONE;
+                }
+                pool->chunks = chunks;
+                chunks[pool->nr_chunks] =
+                        (char *)malloc(B_TREE_HANDLE_CHUNK * pool->stride);
+                if (!chunks[pool->nr_chunks]) {
+                        return B_TREE_HANDLE_NONE;
+                }
+                pool->nr_chunks++;
+        }
+        return pool->nr_used++;
+}
+
+static inline void btree_handle_free(struct btree_handle_pool *pool,
+                                     uint32_t index)
+{
+        memcpy(btree_handle_ptr(pool, index), &pool->free, sizeof(uint32_t));
+        pool->free = index;
+}
+
+static inline void btree_handle_destroy(struct btree_handle_pool *pool)
+{
+        for (uint32_t i = 0; i < pool->nr_chunks; i++) {
+                free(pool->chunks[i]);
+        }
+        free(pool->chunks);
+        pool->chunks = NULL;
+        pool->nr_chunks = pool->nr_used = 0;
+        pool->free = B_TREE_HANDLE_NONE;
+}
+
+/**
+ * @brief 풀에서 나누어 준 칸과 청크 표의 크기를 반환한다.
+ * @details 마지막 청크에서 아직 쓰이지 않은 칸은 포함하지 않는다.
+ */
+static inline size_t btree_handle_bytes(const struct btree_handle_pool *pool)
+{
+        return (size_t)pool->nr_used * pool->stride +
+               pool->nr_chunks * sizeof(char *);
+}
+
+/**
+ * @brief BTREE_DEFINE과 BTREE_SET_DEFINE이 함께 쓰는 부분을 정의한다.
+ * @details has_values가 0이면 노드에 값 배열을 두지 않으며, 값을 옮기는 코드는
+ * 상수 조건으로 감싸져 있으므로 컴파일러가 모두 지운다. 방문 함수의 형태가
+ * 두 매크로에서 다르므로 name_visit_fn과 __name_visit은 먼저 정의되어야 한다.
+ *
+ * child_type은 자식을 가리키는 값의 타입이다. handles가 0이면 노드 포인터이고,
+ * 1이면 uint32_t 핸들로 최상위 비트가 잎 여부, 나머지가 풀에서의 번호이다.
+ * 노드는 항상 __name_node()로 찾아가며, handles는 상수이므로 쓰이지 않는 쪽은
+ * 컴파일러가 지운다.
+ */
+#define __BTREE_DEFINE_COMMON(name, key_type, value_type, cmp, has_values,    \
+                              child_type, handles)                            \
+struct name##_node {                                                          \
+        int n;                                                                \
+        bool is_leaf;                                                         \
+        key_type *keys;                                                       \
+        value_type *values;                                                   \
+        child_type *child;                                                    \
+};                                                                            \
+                                                                              \
+struct name {                                                                 \
+        int min_degree;                                                       \
+        unsigned long nr_keys;                                                \
+        struct name##_node *root;                                             \
+        child_type root_ref;                                                  \
+        struct btree_handle_pool pool[2]; /**< [0]: 내부 노드, [1]: 잎 */          \
+};                                                                            \
+                                                                              \
+static inline size_t __##name##_round_up(size_t size, size_t align)           \
+{                                                                             \
+        return (size + align - 1) / align * align;                            \
+}                                                                             \
+                                                                              \
+static inline size_t __##name##_node_size(const struct name *T, bool is_leaf, \
+                                          size_t *off_keys, size_t *off_values, \
+                                          size_t *off_child)                  \
+{                                                                             \
+        const size_t nr_keys = B_TREE_NR_KEYS(T->min_degree);                 \
+                                                                              \
+        *off_keys = __##name##_round_up(sizeof(struct name##_node),           \
+                                        _Alignof(key_type));                  \
+        *off_values = __##name##_round_up(                                    \
+                *off_keys + nr_keys * sizeof(key_type), _Alignof(value_type)); \
+        *off_child = __##name##_round_up(                                     \
+                *off_values + (has_values ? nr_keys * sizeof(value_type) : 0), \
+                _Alignof(child_type));                                        \
+        if (is_leaf) {                                                        \
+                return *off_child;                                            \
+        }                                                                     \
+        return *off_child +                                                   \
+               B_TREE_NR_CHILD(T->min_degree) * sizeof(child_type);           \
+}                                                                             \
+                                                                              \
+static inline size_t __##name##_align(void)                                   \
+{                                                                             \
+        size_t align = _Alignof(struct name##_node);                          \
+                                                                              \
+        if (align < _Alignof(key_type)) {                                     \
+                align = _Alignof(key_type);                                   \
+        }                                                                     \
+        if (align < _Alignof(value_type)) {                                   \
+                align = _Alignof(value_type);                                 \
+        }                                                                     \
+        return align;                                                         \
+}                                                                             \
+                                                                              \
+static inline struct name##_node *__##name##_node(const struct name *T,       \
+                                                  child_type ref)             \
+{                                                                             \
+        if (handles) {                                                        \
+                const uint32_t h = (uint32_t)(uintptr_t)ref;                  \
+                return (struct name##_node *)btree_handle_ptr(                \
+                        &T->pool[h >> B_TREE_HANDLE_LEAF_SHIFT],              \
+                        h & B_TREE_HANDLE_INDEX_MASK);                        \
+        }                                                                     \
+        return (struct name##_node *)(uintptr_t)ref;                          \
+}                                                                             \
+                                                                              \
+static inline struct name##_node *                                            \
+__##name##_child(const struct name *T, const struct name##_node *x, int i)    \
+{                                                                             \
+        return __##name##_node(T, x->child[i]);                               \
+}                                                                             \
+                                                                              \
+static inline struct name##_node *__##name##_alloc_node(struct name *T,       \
+                                                        bool is_leaf,         \
+                                                        child_type *ref)      \
+{                                                                             \
+        size_t off_keys = 0, off_values = 0, off_child = 0;                   \
+        const size_t size = __##name##_node_size(T, is_leaf, &off_keys,       \
+                                                 &off_values, &off_child);    \
+        char *block = NULL;                                                   \
+        struct name##_node *x = NULL;                                         \
+                                                                              \
+        if (handles) {                                                        \
+                const uint32_t index = btree_handle_alloc(&T->pool[is_leaf]); \
+                                                                              \
+                if (index == B_TREE_HANDLE_NONE) {                            \
+                        return NULL;                                          \
+                }                                                             \
+                block = (char *)btree_handle_ptr(&T->pool[is_leaf], index);   \
+                *ref = (child_type)(uintptr_t)(                               \
+                        (uint32_t)is_leaf << B_TREE_HANDLE_LEAF_SHIFT |       \
+                        index);                                               \
+        } else {                                                              \
+                block = (char *)malloc(size);                                 \
+                if (!block) {                                                 \
+                        return NULL;                                          \
+                }                                                             \
+                *ref = (child_type)(uintptr_t)block;                          \
+        }                                                                     \
+        x = (struct name##_node *)block;                                      \
+        x->n = 0;                                                             \
+        x->is_leaf = is_leaf;                                                 \
+        x->keys = (key_type *)(block + off_keys);                             \
+        x->values = has_values ? (value_type *)(block + off_values) : NULL;   \
+        x->child = is_leaf ? NULL : (child_type *)(block + off_child);        \
+        return x;                                                             \
+}                                                                             \
+                                                                              \
+static inline void __##name##_free_node(struct name *T, child_type ref)       \
+{                                                                             \
+        if (handles) {                                                        \
+                const uint32_t h = (uint32_t)(uintptr_t)ref;                  \
+                btree_handle_free(&T->pool[h >> B_TREE_HANDLE_LEAF_SHIFT],    \
+                                  h & B_TREE_HANDLE_INDEX_MASK);              \
+        } else {                                                              \
+                free(__##name##_node(T, ref));                                \
+        }                                                                     \
+}                                                                             \
+                                                                              \
+static inline struct name *name##_alloc(int min_degree)                       \
+{                                                                             \
+        size_t off_keys = 0, off_values = 0, off_child = 0;                   \
+        struct name *T = NULL;                                                \
+                                                                              \
+        if (min_degree < B_TREE_MIN_DEGREE) {                                 \
+                return NULL;                                                  \
+        }                                                                     \
+        T = (struct name *)calloc(1, sizeof(struct name));                    \
+        if (!T) {                                                             \
+                return NULL;                                                  \
+        }                                                                     \
+        T->min_degree = min_degree;                                           \
+        if (handles) {                                                        \
+                for (int leaf = 0; leaf < 2; leaf++) {                        \
+                        btree_handle_init(&T->pool[leaf],                     \
+                                          __##name##_node_size(               \
+                                                  T, leaf, &off_keys,         \
+                                                  &off_values, &off_child),   \
+                                          __##name##_align());                \
+                }                                                             \
+        }                                                                     \
+        T->root = __##name##_alloc_node(T, true, &T->root_ref);               \
+        if (!T->root) {                                                       \
+                if (handles) {                                                \
+                        btree_handle_destroy(&T->pool[0]);                    \
+                        btree_handle_destroy(&T->pool[1]);                    \
+                }                                                             \
+                free(T);                                                      \
+                return NULL;                                                  \
+        }                                                                     \
+        return T;                                                             \
+}                                                                             \
+                                                                              \
+static inline void __##name##_clear(struct name *T, child_type ref)           \
+{                                                                             \
+        struct name##_node *x = __##name##_node(T, ref);                      \
+                                                                              \
+        if (!x->is_leaf) {                                                    \
+                for (int i = 0; i <= x->n; i++) {                             \
+                        __##name##_clear(T, x->child[i]);                     \
+                }                                                             \
+        }                                                                     \
+        __##name##_free_node(T, ref);                                         \
+}                                                                             \
+                                                                              \
+static inline void name##_free(struct name *T)                                \
+{                                                                             \
+        if (T) {                                                              \
+                if (handles) {                                                \
+                        btree_handle_destroy(&T->pool[0]);                    \
+                        btree_handle_destroy(&T->pool[1]);                    \
+                } else {                                                      \
+                        __##name##_clear(T, T->root_ref);                     \
+                }                                                             \
+                free(T);                                                      \
+        }                                                                     \
+}                                                                             \
+                                                                              \
+static inline size_t __##name##_bytes(const struct name *T,                   \
+                                      const struct name##_node *x)            \
+{                                                                             \
+        size_t off_keys = 0, off_values = 0, off_child = 0;                   \
+        size_t bytes = __##name##_node_size(T, x->is_leaf, &off_keys,         \
+                                            &off_values, &off_child);         \
+                                                                              \
+        if (!x->is_leaf) {                                                    \
+                for (int i = 0; i <= x->n; i++) {                             \
+                        bytes += __##name##_bytes(                            \
+                                T, __##name##_child(T, x, i));                \
+                }                                                             \
+        }                                                                     \
+        return bytes;                                                         \
+}                                                                             \
+                                                                              \
+static inline size_t name##_bytes(const struct name *T)                       \
+{                                                                             \
+        if (handles) {                                                        \
+                return sizeof(struct name) + btree_handle_bytes(&T->pool[0]) + \
+                       btree_handle_bytes(&T->pool[1]);                       \
+        }                                                                     \
+        return sizeof(struct name) + __##name##_bytes(T, T->root);            \
+}                                                                             \
+                                                                              \
+static inline bool __##name##_find(const struct name *T, key_type key,        \
+                                   struct name##_node **node, int *index)     \
+{                                                                             \
+        struct name##_node *x = T->root;                                      \
+                                                                              \
+        for (;;) {                                                            \
+                int i = 0, c = 1;                                             \
+                                                                              \
+                while (i < x->n && (c = cmp(key, x->keys[i])) > 0) {          \
+                        i++;                                                  \
+                }                                                             \
+                if (i < x->n && c == 0) {                                     \
+                        *node = x;                                            \
+                        *index = i;                                           \
+                        return true;                                          \
+                }                                                             \
+                if (x->is_leaf) {                                             \
+                        return false;                                         \
+                }                                                             \
+                x = __##name##_child(T, x, i);                                \
+        }                                                                     \
+}                                                                             \
+                                                                              \
+static inline int __##name##_split_child(struct name *T,                      \
+                                         struct name##_node *x, int i)        \
+{                                                                             \
+        const int t = T->min_degree;                                          \
+        struct name##_node *y = __##name##_child(T, x, i);                    \
+        child_type zref;                                                      \
+        struct name##_node *z = __##name##_alloc_node(T, y->is_leaf, &zref);  \
+                                                                              \
+        if (!z) {                                                             \
+                return -ENOMEM;                                               \
+        }                                                                     \
+        z->n = t - 1;                                                         \
+        memcpy(z->keys, y->keys + t, (t - 1) * sizeof(key_type));             \
+        if (has_values) {                                                     \
+                memcpy(z->values, y->values + t,                              \
+                       (t - 1) * sizeof(value_type));                         \
+        }                                                                     \
+        if (!y->is_leaf) {                                                    \
+                memcpy(z->child, y->child + t, t * sizeof(child_type));       \
+        }                                                                     \
+        y->n = t - 1;                                                         \
+                                                                              \
+        memmove(x->child + i + 2, x->child + i + 1,                           \
+                (x->n - i) * sizeof(child_type));                             \
+        memmove(x->keys + i + 1, x->keys + i, (x->n - i) * sizeof(key_type)); \
+        if (has_values) {                                                     \
+                memmove(x->values + i + 1, x->values + i,                     \
+                        (x->n - i) * sizeof(value_type));                     \
+                x->values[i] = y->values[t - 1];                              \
+        }                                                                     \
+        x->child[i + 1] = zref;                                               \
+        x->keys[i] = y->keys[t - 1];                                          \
+        x->n++;                                                               \
+        return 0;                                                             \
+}                                                                             \
+                                                                              \
+static inline int __##name##_insert(struct name *T, key_type key,             \
+                                    value_type *value)                        \
+{                                                                             \
+        const int nr_keys = B_TREE_NR_KEYS(T->min_degree);                    \
+        struct name##_node *x = T->root;                                      \
+        int i = 0;                                                            \
+                                                                              \
+        if (x->n == nr_keys) {                                                \
+                child_type sref;                                              \
+                struct name##_node *s =                                       \
+                        __##name##_alloc_node(T, false, &sref);               \
+                                                                              \
+                if (!s) {                                                     \
+                        return -ENOMEM;                                       \
+                }                                                             \
+                s->child[0] = T->root_ref;                                    \
+                if (__##name##_split_child(T, s, 0)) {                        \
+                        __##name##_free_node(T, sref);                        \
+                        return -ENOMEM;                                       \
+                }                                                             \
+                T->root = x = s;                                              \
+                T->root_ref = sref;                                           \
+        }                                                                     \
+        while (!x->is_leaf) {                                                 \
+                i = x->n;                                                     \
+                while (i > 0 && cmp(key, x->keys[i - 1]) < 0) {               \
+                        i--;                                                  \
+                }                                                             \
+                if (__##name##_child(T, x, i)->n == nr_keys) {                \
+                        if (__##name##_split_child(T, x, i)) {                \
+                                return -ENOMEM;                               \
+                        }                                                     \
+                        if (cmp(key, x->keys[i]) > 0) {                       \
+                                i++;                                          \
+                        }                                                     \
+                }                                                             \
+                x = __##name##_child(T, x, i);                                \
+        }                                                                     \
+                                                                              \
+        i = x->n;                                                             \
+        while (i > 0 && cmp(key, x->keys[i - 1]) < 0) {                       \
+                x->keys[i] = x->keys[i - 1];                                  \
+                if (has_values) {                                             \
+                        x->values[i] = x->values[i - 1];                      \
+                }                                                             \
+                i--;                                                          \
+        }                                                                     \
+        x->keys[i] = key;                                                     \
+        if (has_values) {                                                     \
+                x->values[i] = *value;                                        \
+        }                                                                     \
+        x->n++;                                                               \
+        T->nr_keys++;                                                         \
+        return 0;                                                             \
+}                                                                             \
+                                                                              \
+static inline void __##name##_merge_child(struct name *T,                     \
+                                          struct name##_node *p, int i)       \
+{                                                                             \
+        const int t = T->min_degree;                                          \
+        child_type left_ref = p->child[i];                                    \
+        child_type right_ref = p->child[i + 1];                               \
+        struct name##_node *left = __##name##_node(T, left_ref);              \
+        struct name##_node *right = __##name##_node(T, right_ref);            \
+                                                                              \
+        left->keys[t - 1] = p->keys[i];                                       \
+        memcpy(left->keys + t, right->keys, (t - 1) * sizeof(key_type));      \
+        if (has_values) {                                                     \
+                left->values[t - 1] = p->values[i];                           \
+                memcpy(left->values + t, right->values,                       \
+                       (t - 1) * sizeof(value_type));                         \
+                memmove(p->values + i, p->values + i + 1,                     \
+                        (p->n - i - 1) * sizeof(value_type));                 \
+        }                                                                     \
+        if (!left->is_leaf) {                                                 \
+                memcpy(left->child + t, right->child, t * sizeof(child_type)); \
+        }                                                                     \
+        left->n = B_TREE_NR_KEYS(t);                                          \
+                                                                              \
+        memmove(p->keys + i, p->keys + i + 1,                                 \
+                (p->n - i - 1) * sizeof(key_type));                           \
+        memmove(p->child + i + 1, p->child + i + 2,                           \
+                (p->n - i - 1) * sizeof(child_type));                         \
+        p->n--;                                                               \
+        __##name##_free_node(T, right_ref);                                   \
+        if (p->n == 0 && p == T->root) {                                      \
+                __##name##_free_node(T, T->root_ref);                         \
+                T->root = left;                                               \
+                T->root_ref = left_ref;                                       \
+        }                                                                     \
+}                                                                             \
+                                                                              \
+static inline struct name##_node *                                            \
+__##name##_fill_child(struct name *T, struct name##_node *x, int i)           \
+{                                                                             \
+        const int t = T->min_degree;                                          \
+        struct name##_node *child = __##name##_child(T, x, i);                \
+        struct name##_node *left =                                            \
+                i > 0 ? __##name##_child(T, x, i - 1) : NULL;                 \
+        struct name##_node *right =                                           \
+                i < x->n ? __##name##_child(T, x, i + 1) : NULL;              \
+                                                                              \
+        if (left && left->n >= t) {                                           \
+                memmove(child->keys + 1, child->keys,                         \
+                        child->n * sizeof(key_type));                         \
+                if (has_values) {                                             \
+                        memmove(child->values + 1, child->values,             \
+                                child->n * sizeof(value_type));               \
+                        child->values[0] = x->values[i - 1];                  \
+                        x->values[i - 1] = left->values[left->n - 1];         \
+                }                                                             \
+                if (!child->is_leaf) {                                        \
+                        memmove(child->child + 1, child->child,               \
+                                (child->n + 1) * sizeof(child_type));         \
+                        child->child[0] = left->child[left->n];               \
+                }                                                             \
+                child->keys[0] = x->keys[i - 1];                              \
+                child->n++;                                                   \
+                x->keys[i - 1] = left->keys[left->n - 1];                     \
+                left->n--;                                                    \
+        } else if (right && right->n >= t) {                                  \
+                child->keys[child->n] = x->keys[i];                           \
+                if (has_values) {                                             \
+                        child->values[child->n] = x->values[i];               \
+                        x->values[i] = right->values[0];                      \
+                }                                                             \
+                child->n++;                                                   \
+                x->keys[i] = right->keys[0];                                  \
+                if (!right->is_leaf) {                                        \
+                        child->child[child->n] = right->child[0];             \
+                        memmove(right->child, right->child + 1,               \
+                                right->n * sizeof(child_type));               \
+                }                                                             \
+                right->n--;                                                   \
+                memmove(right->keys, right->keys + 1,                         \
+                        right->n * sizeof(key_type));                         \
+                if (has_values) {                                             \
+                        memmove(right->values, right->values + 1,             \
+                                right->n * sizeof(value_type));               \
+                }                                                             \
+        } else if (left) {                                                    \
+                __##name##_merge_child(T, x, i - 1);                          \
+                return left;                                                  \
+        } else if (right) {                                                   \
+                __##name##_merge_child(T, x, i);                              \
+        }                                                                     \
+        return child;                                                         \
+}                                                                             \
+                                                                              \
+static inline void __##name##_delete(struct name *T, struct name##_node *x,   \
+                                     key_type key)                            \
+{                                                                             \
+        const int t = T->min_degree;                                          \
+                                                                              \
+        for (;;) {                                                            \
+                int i = 0, c = 1;                                             \
+                                                                              \
+                while (i < x->n && (c = cmp(key, x->keys[i])) > 0) {          \
+                        i++;                                                  \
+                }                                                             \
+                if (i < x->n && c == 0) {                                     \
+                        struct name##_node *prev = NULL, *next = NULL;        \
+                                                                              \
+                        if (x->is_leaf) {                                     \
+                                x->n--;                                       \
+                                memmove(x->keys + i, x->keys + i + 1,         \
+                                        (x->n - i) * sizeof(key_type));       \
+                                if (has_values) {                             \
+                                        memmove(x->values + i,                \
+                                                x->values + i + 1,            \
+                                                (x->n - i) *                  \
+                                                        sizeof(value_type));  \
+                                }                                             \
+                                return;                                       \
+                        }                                                     \
+                        prev = __##name##_child(T, x, i);                     \
+                        next = __##name##_child(T, x, i + 1);                 \
+                        if (prev->n >= t) {                                   \
+                                struct name##_node *y = prev;                 \
+                                key_type k;                                   \
+                                                                              \
+                                while (!y->is_leaf) {                         \
+                                        y = __##name##_child(T, y, y->n);     \
+                                }                                             \
+                                k = y->keys[y->n - 1];                        \
+                                if (has_values) {                             \
+                                        x->values[i] = y->values[y->n - 1];   \
+                                }                                             \
+                                __##name##_delete(T, prev, k);                \
+                                x->keys[i] = k;                               \
+                                return;                                       \
+                        }                                                     \
+                        if (next->n >= t) {                                   \
+                                struct name##_node *y = next;                 \
+                                key_type k;                                   \
+                                                                              \
+                                while (!y->is_leaf) {                         \
+                                        y = __##name##_child(T, y, 0);        \
+                                }                                             \
+                                k = y->keys[0];                               \
+                                if (has_values) {                             \
+                                        x->values[i] = y->values[0];          \
+                                }                                             \
+                                __##name##_delete(T, next, k);                \
+                                x->keys[i] = k;                               \
+                                return;                                       \
+                        }                                                     \
+                        __##name##_merge_child(T, x, i);                      \
+                        x = prev;                                             \
+                        continue;                                             \
+                }                                                             \
+                if (x->is_leaf) {                                             \
+                        return;                                               \
+                }                                                             \
+                if (__##name##_child(T, x, i)->n == t - 1) {                  \
+                        x = __##name##_fill_child(T, x, i);                   \
+                } else {                                                      \
+                        x = __##name##_child(T, x, i);                        \
+                }                                                             \
+        }                                                                     \
+}                                                                             \
+                                                                              \
+static inline int name##_delete(struct name *T, key_type key)                 \
+{                                                                             \
+        struct name##_node *x = NULL;                                         \
+        int i = 0;                                                            \
+                                                                              \
+        if (!__##name##_find(T, key, &x, &i)) {                               \
+                return -EINVAL;                                               \
+        }                                                                     \
+        __##name##_delete(T, T->root, key);                                   \
+        T->nr_keys--;                                                         \
+        return 0;                                                             \
+}                                                                             \
+                                                                              \
+static inline int __##name##_for_each(struct name *T, struct name##_node *x,  \
+                                      name##_visit_fn fn, void *private)      \
+{                                                                             \
+        int ret = 0;                                                          \
+                                                                              \
+        for (int i = 0; i <= x->n; i++) {                                     \
+                if (!x->is_leaf) {                                            \
+                        ret = __##name##_for_each(                            \
+                                T, __##name##_child(T, x, i), fn, private);   \
+                        if (ret) {                                            \
+                                return ret;                                   \
+                        }                                                     \
+                }                                                             \
+                if (i == x->n) {                                              \
+                        break;                                                \
+                }                                                             \
+                ret = __##name##_visit(fn, &x->keys[i],                       \
+                                       has_values ? &x->values[i] : NULL,     \
+                                       private);                              \
+                if (ret) {                                                    \
+                        return ret;                                           \
+                }                                                             \
+        }                                                                     \
+        return 0;                                                             \
+}                                                                             \
+                                                                              \
+static inline int name##_for_each(struct name *T, name##_visit_fn fn,         \
+                                  void *private)                              \
+{                                                                             \
+        return __##name##_for_each(T, T->root, fn, private);                  \
+}                                                                             \
+                                                                              \
+static inline int __##name##_scan(struct name *T, struct name##_node *x,      \
+                                  key_type start, int *remain,                \
+                                  name##_visit_fn fn, void *private)          \
+{                                                                             \
+        int i = 0;                                                            \
+        int ret = 0;                                                          \
+                                                                              \
+        while (i < x->n && cmp(start, x->keys[i]) > 0) {                      \
+                i++;                                                          \
+        }                                                                     \
+        for (; i <= x->n && *remain > 0; i++) {                               \
+                if (!x->is_leaf) {                                            \
+                        ret = __##name##_scan(T, __##name##_child(T, x, i),   \
+                                              start, remain, fn, private);    \
+                        if (ret) {                                            \
+                                return ret;                                   \
+                        }                                                     \
+                }                                                             \
+                if (i == x->n || *remain == 0) {                              \
+                        break;                                                \
+                }                                                             \
+                *remain -= 1;                                                 \
+                ret = __##name##_visit(fn, &x->keys[i],                       \
+                                       has_values ? &x->values[i] : NULL,     \
+                                       private);                              \
+                if (ret) {                                                    \
+                        return ret;                                           \
+                }                                                             \
+        }                                                                     \
+        return 0;                                                             \
+}                                                                             \
+                                                                              \
+static inline int name##_scan(struct name *T, key_type start, int count,      \
+                              name##_visit_fn fn, void *private)              \
+{                                                                             \
+        int remain = count;                                                   \
+        __##name##_scan(T, T->root, start, &remain, fn, private);             \
+        return count - remain;                                                \
+}
+
+/**
+ * @brief BTREE_DEFINE과 BTREE_HANDLE_DEFINE이 함께 쓰는 부분을 정의한다.
+ */
+#define __BTREE_DEFINE_MAP(name, key_type, value_type, cmp, child_type,       \
+                           handles)                                           \
+typedef int (*name##_visit_fn)(const key_type *key, value_type *value,        \
+                               void *private);                                \
+                                                                              \
+static inline int __##name##_visit(name##_visit_fn fn, const key_type *key,   \
+                                   value_type *value, void *private)          \
+{                                                                             \
+        return fn(key, value, private);                                       \
+}                                                                             \
+                                                                              \
+__BTREE_DEFINE_COMMON(name, key_type, value_type, cmp, 1, child_type,         \
+                      handles)                                                \
+                                                                              \
+static inline value_type *name##_search(struct name *T, key_type key)         \
+{                                                                             \
+        struct name##_node *x = NULL;                                         \
+        int i = 0;                                                            \
+                                                                              \
+        return __##name##_find(T, key, &x, &i) ? &x->values[i] : NULL;        \
+}                                                                             \
+                                                                              \
+static inline int name##_insert(struct name *T, key_type key,                 \
+                                value_type value)                             \
+{                                                                             \
+        return __##name##_insert(T, key, &value);                             \
+}
+
+/**
+ * @brief name으로 시작하는 B-Tree의 타입과 함수를 정의한다.
+ *
+ * @param name 만들어지는 타입과 함수의 이름 앞에 붙는다.
+ * @param key_type 키의 타입으로 구조체도 사용할 수 있다.
+ * @param value_type 값의 타입에 해당한다.
+ * @param cmp 키 두 개를 받는 비교에 해당한다.
+ */
+#define BTREE_DEFINE(name, key_type, value_type, cmp)                         \
+        __BTREE_DEFINE_MAP(name, key_type, value_type, cmp,                   \
+                           struct name##_node *, 0)
+
+/**
+ * @brief BTREE_DEFINE과 같지만 자식을 8바이트 포인터 대신 32비트 핸들로 가리킨다.
+ * @details 노드는 트리마다 잎과 내부 노드로 나뉜 두 개의 풀에서 할당되므로
+ * 내부 노드의 자식 배열이 절반으로 줄고, 노드 사이의 참조가 주소에 묶이지 않는다.
+ * 대신 자식으로 내려갈 때마다 청크 표를 한 번 더 읽는다. 삭제로 빈 칸은 풀에
+ * 남아 다음 할당에 다시 쓰이며, 풀의 메모리는 name_free에서 한 번에 반환된다.
+ *
+ * @param name 만들어지는 타입과 함수의 이름 앞에 붙는다.
+ * @param key_type 키의 타입으로 구조체도 사용할 수 있다.
+ * @param value_type 값의 타입에 해당한다.
+ * @param cmp 키 두 개를 받는 비교에 해당한다.
+ */
+#define BTREE_HANDLE_DEFINE(name, key_type, value_type, cmp)                  \
+        __BTREE_DEFINE_MAP(name, key_type, value_type, cmp, uint32_t, 1)
+
+/**
+ * @brief name으로 시작하는 키만 가지는 B-Tree 집합의 타입과 함수를 정의한다.
+ *
+ * @param name 만들어지는 타입과 함수의 이름 앞에 붙는다.
+ * @param key_type 키의 타입으로 구조체도 사용할 수 있다.
+ * @param cmp 키 두 개를 받는 비교에 해당한다.
+ */
+#define BTREE_SET_DEFINE(name, key_type, cmp)                                 \
+typedef int (*name##_visit_fn)(const key_type *key, void *private);           \
+                                                                              \
+static inline int __##name##_visit(name##_visit_fn fn, const key_type *key,   \
+                                   char *value, void *private)                \
+{                                                                             \
+        (void)value;                                                          \
+        return fn(key, private);                                              \
+}                                                                             \
+                                                                              \
+__BTREE_DEFINE_COMMON(name, key_type, char, cmp, 0, struct name##_node *, 0)  \
+                                                                              \
+struct __##name##_filter {                                                    \
+        struct name *other;                                                   \
+        key_type *keys;                                                       \
+        unsigned long n;                                                      \
+};                                                                            \
+                                                                              \
+static inline bool name##_contains(struct name *T, key_type key)              \
+{                                                                             \
+        struct name##_node *x = NULL;                                         \
+        int i = 0;                                                            \
+                                                                              \
+        return __##name##_find(T, key, &x, &i);                               \
+}                                                                             \
+                                                                              \
+static inline int name##_insert(struct name *T, key_type key)                 \
+{                                                                             \
+        if (name##_contains(T, key)) {                                        \
+                return -EEXIST;                                               \
+        }                                                                     \
+        return __##name##_insert(T, key, NULL);                               \
+}                                                                             \
+                                                                              \
+static inline int __##name##_union_visit(const key_type *key, void *private)  \
+{                                                                             \
+        const int ret = name##_insert((struct name *)private, *key);          \
+        return ret == -EEXIST ? 0 : ret;                                      \
+}                                                                             \
+                                                                              \
+static inline int __##name##_subtract_visit(const key_type *key,              \
+                                            void *private)                    \
+{                                                                             \
+        name##_delete((struct name *)private, *key);                          \
+        return 0;                                                             \
+}                                                                             \
+                                                                              \
+static inline int __##name##_filter_visit(const key_type *key, void *private) \
+{                                                                             \
+        struct __##name##_filter *filter =                                    \
+                (struct __##name##_filter *)private;                          \
+                                                                              \
+        if (!name##_contains(filter->other, *key)) {                          \
+                filter->keys[filter->n++] = *key;                             \
+        }                                                                     \
+        return 0;                                                             \
+}                                                                             \
+                                                                              \
+static inline int name##_union(struct name *T, struct name *other)            \
+{                                                                             \
+        if (T == other) {                                                     \
+                return 0;                                                     \
+        }                                                                     \
+        return name##_for_each(other, __##name##_union_visit, T);             \
+}                                                                             \
+                                                                              \
+static inline int name##_intersect(struct name *T, struct name *other)        \
+{                                                                             \
+        struct __##name##_filter filter = { .other = other };                 \
+                                                                              \
+        if (T == other || T->nr_keys == 0) {                                  \
+                return 0;                                                     \
+        }                                                                     \
+        filter.keys = (key_type *)malloc(T->nr_keys * sizeof(key_type));      \
+        if (!filter.keys) {                                                   \
+                return -ENOMEM;                                               \
+        }                                                                     \
+        name##_for_each(T, __##name##_filter_visit, &filter);                 \
+        for (unsigned long i = 0; i < filter.n; i++) {                        \
+                name##_delete(T, filter.keys[i]);                             \
+        }                                                                     \
+        free(filter.keys);                                                    \
+        return 0;                                                             \
+}                                                                             \
+                                                                              \
+static inline int name##_subtract(struct name *T, struct name *other)         \
+{                                                                             \
+        struct name##_node *root = NULL, *root_ref = NULL;                    \
+                                                                              \
+        if (T != other) {                                                     \
+                return name##_for_each(other, __##name##_subtract_visit, T);  \
+        }                                                                     \
+        root = __##name##_alloc_node(T, true, &root_ref);                     \
+        if (!root) {                                                          \
+                return -ENOMEM;                                               \
+        }                                                                     \
+        __##name##_clear(T, T->root_ref);                                     \
+        T->root = root;                                                       \
+        T->root_ref = root_ref;                                               \
+        T->nr_keys = 0;                                                       \
+        return 0;                                                             \
+}
+
+#endif
@@ -0,0 +1,664 @@
+/**
+ * @file btree-image.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 읽기 전용 B-Tree 이미지의 생성과 탐색에 대한 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 이미지는 포인터를 가지지 않으므로 mmap 한 주소를 그대로 노드로
+ * 사용하며, 열 때 역직렬화나 재구성을 하지 않는다. 항목의 data는 포인터가
+ * 아닌 값(uintptr_t)으로 취급되어 그대로 저장된다.
+ *
+ * B_TREE_IMAGE_F_PACK_LEAVES로 내보내면 잎마다 첫 번째 키를 base로 두고 나머지
+ * 키는 base와의 차이를 1, 2, 4바이트 중 들어가는 가장 작은 크기로 저장한다
+ * (frame of reference). 촘촘한 정수 키에서는 캐시 라인 하나에 키가 4배까지
+ * 들어가며, 잎의 탐색은 SSE2로 차이 16개(또는 8개)를 한 번에 비교한다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "btree-image.h"
+
+#define INODE(addr) ((const struct btree_image_node *)(addr))
+#define ILEAF(addr) ((const struct btree_image_leaf *)(addr))
+
+static inline size_t btree_image_round_up(size_t size, size_t align)
+{
+        return (size + align - 1) / align * align;
+}
+
+/**
+ * @brief 최소 차수에 맞추어 노드의 배치와 크기를 정한다.
+ *
+ * @return size_t 노드 하나가 차지하는 크기를 반환한다.
+ */
+static size_t btree_image_layout(struct btree_image *image, int min_degree)
+{
+        const size_t nr_keys = B_TREE_NR_KEYS(min_degree);
+        size_t raw = 0;
+        size_t node_size = 0;
+
+        image->off_keys = sizeof(struct btree_image_node);
+        image->off_child = image->off_keys + nr_keys * sizeof(key_t);
+        image->off_child = (image->off_child + 7) & ~(size_t)7;
+        image->off_values = image->off_child + (nr_keys + 1) * sizeof(uint64_t);
+        raw = image->off_values + nr_keys * sizeof(uint64_t);
+
+        if (raw > B_TREE_IMAGE_PAGE_SIZE) {
+                return (raw + B_TREE_IMAGE_PAGE_SIZE - 1) &
+                       ~(size_t)(B_TREE_IMAGE_PAGE_SIZE - 1);
+        }
+        for (node_size = 64; node_size < raw; node_size <<= 1)
+                ;
+        return node_size;
+}
+
+static inline const key_t *btree_image_keys(const struct btree_image *image,
+                                            const char *x)
+{
+        return (const key_t *)(x + image->off_keys);
+}
+
+static inline const uint64_t *
+btree_image_child(const struct btree_image *image, const char *x)
+{
+        return (const uint64_t *)(x + image->off_child);
+}
+
+static inline const uint64_t *
+btree_image_values(const struct btree_image *image, const char *x)
+{
+        return (const uint64_t *)(x + image->off_values);
+}
+
+static inline bool btree_image_packed(const char *x)
+{
+        return INODE(x)->is_leaf == B_TREE_IMAGE_LEAF_PACKED;
+}
+
+/**
+ * @brief 압축된 잎의 차이 배열을 반환한다. 배열은 16바이트 단위로 채워져 있다.
+ */
+static inline const unsigned char *btree_image_deltas(const char *x)
+{
+        return (const unsigned char *)(x + sizeof(struct btree_image_leaf));
+}
+
+static inline const uint64_t *btree_image_leaf_values(const char *x)
+{
+        return (const uint64_t *)(btree_image_deltas(x) +
+                                  btree_image_round_up((size_t)ILEAF(x)->n *
+                                                               ILEAF(x)->width,
+                                                       16));
+}
+
+/**
+ * @brief 노드의 i번째 키를 반환한다. 압축된 잎이면 base에 차이를 더한다.
+ */
+static inline key_t btree_image_key(const struct btree_image *image,
+                                    const char *x, int i)
+{
+        const unsigned char *deltas = NULL;
+
+        if (!btree_image_packed(x)) {
+                return btree_image_keys(image, x)[i];
+        }
+        deltas = btree_image_deltas(x);
+        switch (ILEAF(x)->width) {
+        case 1:
+                return ILEAF(x)->base + deltas[i];
+        case 2:
+                return ILEAF(x)->base + ((const uint16_t *)deltas)[i];
+        default:
+                return ILEAF(x)->base + ((const uint32_t *)deltas)[i];
+        }
+}
+
+static inline uint64_t btree_image_value(const struct btree_image *image,
+                                         const char *x, int i)
+{
+        if (btree_image_packed(x)) {
+                return btree_image_leaf_values(x)[i];
+        }
+        return btree_image_values(image, x)[i];
+}
+
+/**
+ * @brief 압축된 잎에서 key 이상인 첫 번째 키의 위치를 찾는다.
+ * @details 남는 칸은 최댓값으로 채워져 있어 차이 d보다 작게 세어지지 않으므로,
+ * 16바이트씩 d보다 작은 차이의 수를 세면 그대로 위치가 된다.
+ */
+static int btree_image_leaf_lower_bound(const char *x, key_t key)
+{
+        const unsigned char *deltas = btree_image_deltas(x);
+        const int n = (int)ILEAF(x)->n;
+        key_t d = 0;
+        int count = 0;
+
+        if (key <= ILEAF(x)->base) {
+                return 0;
+        }
+        d = key - ILEAF(x)->base;
+        switch (ILEAF(x)->width) {
+        case 1:
+                if (d > UINT8_MAX) {
+                        return n;
+                }
+#ifdef __SSE2__
+                {
+                        const __m128i bias = _mm_set1_epi8((char)0x80);
+                        const __m128i pivot = _mm_set1_epi8((char)(d ^ 0x80));
+
+                        for (int i = 0; i < n; i += 16) {
+                                __m128i v = _mm_loadu_si128(
+                                        (const __m128i *)(deltas + i));
+                                v = _mm_cmplt_epi8(_mm_xor_si128(v, bias),
+                                                   pivot);
+                                count += __builtin_popcount(
+                                        _mm_movemask_epi8(v));
+                        }
+                }
+#else
+                while (count < n && deltas[count] < d) {
+                        count++;
+                }
+#endif
+                return count;
+        case 2:
+                if (d > UINT16_MAX) {
+                        return n;
+                }
+#ifdef __SSE2__
+                {
+                        const __m128i bias = _mm_set1_epi16((short)0x8000);
+                        const __m128i pivot =
+                                _mm_set1_epi16((short)(d ^ 0x8000));
+
+                        for (int i = 0; i < n; i += 8) {
+                                __m128i v = _mm_loadu_si128(
+                                        (const __m128i *)(deltas + i * 2));
+                                v = _mm_cmplt_epi16(_mm_xor_si128(v, bias),
+                                                    pivot);
+                                /* 비교 결과 하나가 2비트로 나타난다. */
+                                count += __builtin_popcount(
+                                                 _mm_movemask_epi8(v)) /
+                                         2;
+                        }
+                }
+#else
+                while (count < n && ((const uint16_t *)deltas)[count] < d) {
+                        count++;
+                }
+#endif
+                return count;
+        default: {
+                const uint32_t *wide = (const uint32_t *)deltas;
+                int lo = 0, hi = n;
+
+                while (lo < hi) {
+                        int mid = (lo + hi) / 2;
+                        if (wide[mid] < d) {
+                                lo = mid + 1;
+                        } else {
+                                hi = mid;
+                        }
+                }
+                return lo;
+        }
+        }
+}
+
+/**
+ * @brief 노드에서 key 이상인 첫 번째 키의 위치를 이진 탐색으로 찾는다.
+ */
+static int btree_image_lower_bound(const struct btree_image *image,
+                                   const char *x, key_t key)
+{
+        const key_t *keys = btree_image_keys(image, x);
+        int lo = 0;
+        int hi = (int)INODE(x)->n;
+
+        if (btree_image_packed(x)) {
+                return btree_image_leaf_lower_bound(x, key);
+        }
+
+        while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (keys[mid] < key) {
+                        lo = mid + 1;
+                } else {
+                        hi = mid;
+                }
+        }
+        return lo;
+}
+
+/**
+ * @brief 부트리에 있는 노드와 항목의 수를 센다.
+ */
+static void btree_image_count(struct btree_node *x, uint64_t *nr_nodes,
+                              uint64_t *nr_items)
+{
+        *nr_nodes += 1;
+        *nr_items += x->n;
+        if (!x->is_leaf) {
+                for (int i = 0; i <= x->n; i++) {
+                        btree_image_count(x->child[i], nr_nodes, nr_items);
+                }
+        }
+}
+
+/**
+ * @brief 압축된 잎에서 차이 하나에 쓸 바이트 수를 정한다.
+ */
+static uint32_t btree_image_leaf_width(const struct btree_node *x)
+{
+        const key_t span = x->n ? x->items[x->n - 1].key - x->items[0].key : 0;
+
+        if (span <= UINT8_MAX) {
+                return 1;
+        }
+        if (span <= UINT16_MAX) {
+                return 2;
+        }
+        return 4;
+}
+
+static size_t btree_image_leaf_size(uint32_t n, uint32_t width)
+{
+        const size_t nr_bytes = btree_image_round_up((size_t)n * width, 16);
+
+        return btree_image_round_up(sizeof(struct btree_image_leaf) + nr_bytes +
+                                            n * sizeof(uint64_t),
+                                    16);
+}
+
+/**
+ * @brief 노드가 이미지에서 차지하는 크기를 반환한다.
+ */
+static size_t btree_image_size_of(const struct btree_image_header *header,
+                                  const struct btree_node *x)
+{
+        if (x->is_leaf && (header->flags & B_TREE_IMAGE_F_PACK_LEAVES)) {
+                return btree_image_leaf_size((uint32_t)x->n,
+                                             btree_image_leaf_width(x));
+        }
+        return header->node_size;
+}
+
+/**
+ * @brief 노드를 node_size 크기의 평범한 형식으로 buffer에 적는다.
+ *
+ * @param offset 너비 우선 순서로 정해진 노드들의 위치에 해당한다.
+ * @param next 다음 자식의 큐에서의 순서로 자식의 수만큼 증가한다.
+ */
+static void btree_image_encode_node(const struct btree_image *layout,
+                                    const struct btree_image_header *header,
+                                    struct btree_node *x, char *buffer,
+                                    const uint64_t *offset, uint64_t *next)
+{
+        struct btree_image_node *node = (struct btree_image_node *)buffer;
+        key_t *keys = (key_t *)(buffer + layout->off_keys);
+        uint64_t *child = (uint64_t *)(buffer + layout->off_child);
+        uint64_t *values = (uint64_t *)(buffer + layout->off_values);
+
+        memset(buffer, 0, header->node_size);
+        node->n = (uint32_t)x->n;
+        node->is_leaf = x->is_leaf;
+        for (int i = 0; i < x->n; i++) {
+                keys[i] = x->items[i].key;
+                values[i] = (uint64_t)(uintptr_t)x->items[i].data;
+        }
+        for (int i = 0; !x->is_leaf && i <= x->n; i++) {
+                child[i] = offset[(*next)++];
+        }
+}
+
+/**
+ * @brief 잎을 압축된 형식으로 buffer에 적는다.
+ *
+ * @return uint32_t 차이 하나에 쓴 바이트 수를 반환한다.
+ */
+static uint32_t btree_image_encode_leaf(struct btree_node *x, char *buffer)
+{
+        struct btree_image_leaf *leaf = (struct btree_image_leaf *)buffer;
+        const uint32_t width = btree_image_leaf_width(x);
+        const size_t nr_bytes = btree_image_round_up((size_t)x->n * width, 16);
+        unsigned char *deltas = (unsigned char *)(leaf + 1);
+        uint64_t *values = (uint64_t *)(deltas + nr_bytes);
+
+        memset(buffer, 0, btree_image_leaf_size((uint32_t)x->n, width));
+        leaf->n = (uint32_t)x->n;
+        leaf->is_leaf = B_TREE_IMAGE_LEAF_PACKED;
+        leaf->base = x->n ? x->items[0].key : 0;
+        leaf->width = width;
+        memset(deltas, 0xff, nr_bytes);
+        for (int i = 0; i < x->n; i++) {
+                const key_t d = x->items[i].key - leaf->base;
+
+                if (width == 1) {
+                        deltas[i] = (uint8_t)d;
+                } else if (width == 2) {
+                        ((uint16_t *)deltas)[i] = (uint16_t)d;
+                } else {
+                        ((uint32_t *)deltas)[i] = d;
+                }
+                values[i] = (uint64_t)(uintptr_t)x->items[i].data;
+        }
+        return width;
+}
+
+/**
+ * @brief 메모리 B-Tree를 읽기 전용 이미지 파일로 내보내도록 한다.
+ *
+ * @param tree 내보낼 B-Tree를 가리키는 포인터에 해당한다.
+ * @param path 이미지가 저장될 파일의 경로에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int btree_export_image(struct btree *tree, const char *path)
+{
+        return btree_export_image_flags(tree, path, 0);
+}
+
+/**
+ * @brief 메모리 B-Tree를 flags에 따른 형식의 이미지 파일로 내보내도록 한다.
+ * @details 노드를 너비 우선 순서로 늘어놓으므로 위쪽 노드들이 파일의 앞쪽에
+ * 모이게 된다. 잎은 모두 같은 깊이에 있으므로 내부 노드 뒤에 모이며, 노드의
+ * 위치는 쓰기 전에 크기로부터 모두 계산된다.
+ *
+ * @param tree 내보낼 B-Tree를 가리키는 포인터에 해당한다.
+ * @param path 이미지가 저장될 파일의 경로에 해당한다.
+ * @param flags B_TREE_IMAGE_F_*를 OR 한 값에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int btree_export_image_flags(struct btree *tree, const char *path,
+                             unsigned int flags)
+{
+        struct btree_image layout;
+        struct btree_image_header header;
+        struct btree_node **queue = NULL;
+        uint64_t *offset = NULL;
+        char *buffer = NULL;
+        FILE *fp = NULL;
+        uint64_t head = 0, tail = 0, next = 1, pos = 0;
+        int ret = 0;
+
+        memset(&header, 0, sizeof(struct btree_image_header));
+        header.magic = B_TREE_IMAGE_MAGIC;
+        header.version = B_TREE_IMAGE_VERSION;
+        header.min_degree = (uint32_t)tree->min_degree;
+        header.node_size = (uint32_t)btree_image_layout(&layout, tree->min_degree);
+        header.flags = flags & B_TREE_IMAGE_F_PACK_LEAVES;
+        btree_image_count(tree->root, &header.nr_nodes, &header.nr_items);
+
+        queue = (struct btree_node **)malloc(header.nr_nodes *
+                                             sizeof(struct btree_node *));
+        offset = (uint64_t *)malloc(header.nr_nodes * sizeof(uint64_t));
+        buffer = (char *)calloc(1, B_TREE_IMAGE_PAGE_SIZE > header.node_size ?
+                                           B_TREE_IMAGE_PAGE_SIZE :
+                                           header.node_size);
+        if (!queue || !offset || !buffer) {
+                pr_info("Allocation export buffer failed\n");
+                ret = -ENOMEM;
+                goto exception;
+        }
+
+        queue[tail++] = tree->root;
+        offset[0] = B_TREE_IMAGE_PAGE_SIZE;
+        while (head < tail) {
+                struct btree_node *x = queue[head++];
+
+                for (int i = 0; !x->is_leaf && i <= x->n; i++) {
+                        queue[tail++] = x->child[i];
+                }
+        }
+        pos = B_TREE_IMAGE_PAGE_SIZE;
+        for (uint64_t i = 0; i < tail; i++) {
+                const size_t size = btree_image_size_of(&header, queue[i]);
+
+                if (size <= B_TREE_IMAGE_PAGE_SIZE &&
+                    pos / B_TREE_IMAGE_PAGE_SIZE !=
+                            (pos + size - 1) / B_TREE_IMAGE_PAGE_SIZE) {
+                        pos = btree_image_round_up(pos, B_TREE_IMAGE_PAGE_SIZE);
+                }
+                offset[i] = pos;
+                pos += size;
+        }
+        header.root = offset[0];
+        header.size = pos;
+
+        fp = fopen(path, "wb");
+        if (!fp) {
+                pr_info("Cannot open image file(%s)\n", path);
+                ret = -errno;
+                goto exception;
+        }
+
+        /* 노드 사이의 빈 곳은 파일의 구멍으로 남아 0으로 읽힌다. */
+        for (uint64_t i = 0; i < tail; i++) {
+                struct btree_node *x = queue[i];
+                const size_t size = btree_image_size_of(&header, x);
+
+                if (x->is_leaf && (header.flags & B_TREE_IMAGE_F_PACK_LEAVES)) {
+                        if (btree_image_encode_leaf(x, buffer) < 4) {
+                                header.nr_packed++;
+                        }
+                } else {
+                        btree_image_encode_node(&layout, &header, x, buffer,
+                                                offset, &next);
+                }
+                if (fseek(fp, (long)offset[i], SEEK_SET) ||
+                    fwrite(buffer, size, 1, fp) != 1) {
+                        ret = -EIO;
+                        goto exception;
+                }
+        }
+
+        /* 압축된 잎의 수는 잎을 적은 뒤에야 알 수 있으므로 헤더는 마지막에 적는다. */
+        if (fseek(fp, 0, SEEK_SET) ||
+            fwrite(&header, sizeof(struct btree_image_header), 1, fp) != 1) {
+                ret = -EIO;
+                goto exception;
+        }
+        if (fflush(fp) || fsync(fileno(fp))) {
+                ret = -EIO;
+                goto exception;
+        }
+        ret = fclose(fp) ? -EIO : 0;
+        fp = NULL;
+
+exception:
+        if (fp) {
+                fclose(fp);
+        }
+        free(buffer);
+        free(offset);
+        free(queue);
+        return ret;
+}
+
+/**
+ * @brief 이미지 파일을 mmap 하여 열도록 한다.
+ *
+ * @param path 이미지 파일의 경로에 해당한다.
+ * @return struct btree_image* 정상적으로 열린 경우에는 이미지의 주소가 반환된다.
+ * @exception 파일이 없거나 올바른 이미지가 아니면 NULL이 반환된다.
+ */
+struct btree_image *btree_open_image(const char *path)
+{
+        struct btree_image *image = NULL;
+        const struct btree_image_header *header = NULL;
+        struct stat st;
+        void *base = MAP_FAILED;
+        int fd = -1;
+
+        image = (struct btree_image *)calloc(1, sizeof(struct btree_image));
+        if (!image) {
+                pr_info("Allocation image failed\n");
+                return NULL;
+        }
+
+        fd = open(path, O_RDONLY);
+        if (fd < 0 || fstat(fd, &st)) {
+                pr_info("Cannot open image file(%s)\n", path);
+                goto exception;
+        }
+        if ((size_t)st.st_size < B_TREE_IMAGE_PAGE_SIZE) {
+                pr_info("Invalid image file(%s)\n", path);
+                goto exception;
+        }
+
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+                pr_info("Cannot map image file(%s)\n", path);
+                goto exception;
+        }
+        close(fd);
+        fd = -1;
+
+        header = (const struct btree_image_header *)base;
+        if (header->magic != B_TREE_IMAGE_MAGIC ||
+            header->version != B_TREE_IMAGE_VERSION ||
+            header->min_degree < B_TREE_MIN_DEGREE ||
+            header->size != (uint64_t)st.st_size ||
+            header->node_size != btree_image_layout(image, header->min_degree) ||
+            header->root + ((header->flags & B_TREE_IMAGE_F_PACK_LEAVES) ?
+                                    sizeof(struct btree_image_leaf) :
+                                    header->node_size) >
+                    header->size) {
+                pr_info("Invalid image file(%s)\n", path);
+                goto exception;
+        }
+
+        image->base = (const char *)base;
+        image->size = (size_t)st.st_size;
+        image->header = header;
+        return image;
+
+exception:
+        if (base != MAP_FAILED) {
+                munmap(base, (size_t)st.st_size);
+        }
+        if (fd >= 0) {
+                close(fd);
+        }
+        free(image);
+        return NULL;
+}
+
+/**
+ * @brief 이미지에서 탐색을 수행하도록 한다.
+ *
+ * @param image 이미지를 가리키는 포인터에 해당한다.
+ * @param key 찾고자 하는 키에 해당한다.
+ * @param value 찾은 값을 받을 위치로 NULL이면 무시한다.
+ * @return int 찾은 경우에는 0을, 없는 경우에는 -ENOENT를 반환한다.
+ */
+int btree_image_search(const struct btree_image *image, key_t key,
+                       uint64_t *value)
+{
+        const char *x = image->base + image->header->root;
+
+        for (;;) {
+                int i = btree_image_lower_bound(image, x, key);
+
+                if (i < (int)INODE(x)->n && btree_image_key(image, x, i) == key) {
+                        if (value) {
+                                *value = btree_image_value(image, x, i);
+                        }
+                        return 0;
+                }
+                if (INODE(x)->is_leaf) {
+                        return -ENOENT;
+                }
+                x = image->base + btree_image_child(image, x)[i];
+        }
+}
+
+/**
+ * @brief [lo, hi] 범위에 있는 항목을 부트리에서 순서대로 방문한다.
+ *
+ * @param done hi보다 큰 키를 만나면 설정되어 위쪽의 순회도 멈추게 한다.
+ * @return int 방문을 계속하는 경우 0을, 그렇지 않으면 fn의 반환값이다.
+ */
+static int __btree_image_range(const struct btree_image *image, const char *x,
+                               key_t lo, key_t hi, btree_visit_fn fn,
+                               void *private, bool *done)
+{
+        const uint64_t *child = btree_image_child(image, x);
+        const int n = (int)INODE(x)->n;
+        struct btree_item item;
+        int ret = 0;
+        int i = btree_image_lower_bound(image, x, lo);
+
+        for (; i <= n; i++) {
+                if (!INODE(x)->is_leaf) {
+                        ret = __btree_image_range(image, image->base + child[i],
+                                                  lo, hi, fn, private, done);
+                        if (ret || *done) {
+                                return ret;
+                        }
+                }
+                if (i == n) {
+                        break;
+                }
+                item.key = btree_image_key(image, x, i);
+                if (item.key > hi) {
+                        *done = true;
+                        return 0;
+                }
+                item.data = (void *)(uintptr_t)btree_image_value(image, x, i);
+                ret = fn(&item, private);
+                if (ret) {
+                        return ret;
+                }
+        }
+        return 0;
+}
+
+/**
+ * @brief 이미지에서 [lo, hi] 범위에 있는 항목을 키 순서대로 방문한다.
+ *
+ * @param image 이미지를 가리키는 포인터에 해당한다.
+ * @param lo 범위의 시작(포함)에 해당한다.
+ * @param hi 범위의 끝(포함)에 해당한다.
+ * @param fn 항목마다 호출되는 함수로 item->data에는 저장된 값이 들어간다.
+ * @param private fn에 그대로 전달되는 값이다.
+ * @return int 모두 방문한 경우에는 0을, fn이 0이 아닌 값을 반환하여 중단된
+ * 경우에는 그 값을 반환한다.
+ */
+int btree_image_range(const struct btree_image *image, key_t lo, key_t hi,
+                      btree_visit_fn fn, void *private)
+{
+        bool done = false;
+
+        if (lo > hi) {
+                return 0;
+        }
+        return __btree_image_range(image, image->base + image->header->root,
+                                   lo, hi, fn, private, &done);
+}
+
+/**
+ * @brief 이미지의 mmap을 해제하고 할당된 메모리를 해제한다.
+ *
+ * @param image 이미지를 가리키는 포인터에 해당한다.
+ */
+void btree_image_close(struct btree_image *image)
+{
+        if (image) {
+                munmap((void *)image->base, image->size);
+                free(image);
+        }
+}
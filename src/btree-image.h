@@ -0,0 +1,96 @@
+/**
+ * @file btree-image.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 읽기 전용으로 mmap 해서 사용하는 B-Tree 이미지에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _B_TREE_IMAGE_H
+#define _B_TREE_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "btree.h"
+
+#define B_TREE_IMAGE_MAGIC 0x4d495442u /**< "BTIM" */
+#define B_TREE_IMAGE_VERSION 2
+#define B_TREE_IMAGE_PAGE_SIZE (4 * 1024) /**< 헤더가 차지하는 크기이다. */
+
+#define B_TREE_IMAGE_F_PACK_LEAVES (1 << 0) /**< 잎의 키를 기준 키와의 차이로 줄여서 저장한다. */
+
+#define B_TREE_IMAGE_LEAF_PACKED 2 /**< 압축된 잎의 is_leaf 값이다. */
+
+/**
+ * @brief 이미지 파일의 맨 앞에 놓이는 헤더에 해당한다.
+ * @details 노드는 헤더 뒤에 너비 우선 순서로 node_size 간격으로 놓인다.
+ * node_size는 페이지 크기 이하의 2의 거듭제곱이거나 페이지 크기의 배수이므로
+ * 노드가 페이지 경계에 걸치지 않는다.
+ *
+ * B_TREE_IMAGE_F_PACK_LEAVES로 만든 이미지에서는 잎이 내부 노드 뒤에 각자의
+ * 크기대로 놓이며, 페이지 크기 이하의 잎은 페이지 경계에 걸치지 않는다.
+ */
+struct btree_image_header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t min_degree;
+        uint32_t node_size;
+        uint64_t root; /**< 루트 노드의 파일 내 위치(offset)이다. */
+        uint64_t nr_nodes;
+        uint64_t nr_items;
+        uint64_t size; /**< 이미지 파일 전체의 크기이다. */
+        uint32_t flags; /**< 이미지를 만들 때 사용한 B_TREE_IMAGE_F_* 값이다. */
+        uint32_t reserved;
+        uint64_t nr_packed; /**< 1바이트나 2바이트 차이로 저장된 잎의 수이다. */
+};
+
+/**
+ * @brief 이미지 안에 놓이는 노드의 머리 부분에 해당한다.
+ * @details 머리 뒤에는 키(key_t), 자식 위치(uint64_t), 값(uint64_t)의
+ * 배열이 차례대로 놓인다. 자식은 포인터 대신 파일 내 위치로 가리킨다.
+ */
+struct btree_image_node {
+        uint32_t n; /**< 노드가 현재 사용 중인 항목의 갯수를 가진다. */
+        uint32_t is_leaf; /**< 노드가 leaf 위치에 있는 지에 대한 정보를 가진다. */
+};
+
+/**
+ * @brief 압축된 잎의 머리 부분에 해당한다.
+ * @details 머리 뒤에는 키와 base의 차이(delta)가 width 바이트씩 놓이며, 16바이트
+ * 단위로 맞추기 위해 남는 칸은 width 바이트로 나타낼 수 있는 최댓값으로 채운다.
+ * 그 뒤에 값(uint64_t)의 배열이 놓인다. 차이가 2바이트를 넘으면 width는 4가 되어
+ * 평범한 키 배열과 같은 크기가 된다.
+ */
+struct btree_image_leaf {
+        uint32_t n;
+        uint32_t is_leaf; /**< 항상 B_TREE_IMAGE_LEAF_PACKED이다. */
+        key_t base; /**< 잎의 첫 번째 키이다. */
+        uint32_t width; /**< 차이 하나의 크기로 1, 2, 4 중의 하나이다. */
+};
+
+/**
+ * @brief mmap 된 이미지 하나를 관리하는 구조체에 해당한다.
+ */
+struct btree_image {
+        const char *base; /**< mmap 된 영역의 시작 주소이다. */
+        size_t size;
+        const struct btree_image_header *header;
+
+        size_t off_keys; /**< 노드에서 키 배열이 시작하는 위치 */
+        size_t off_child; /**< 노드에서 자식 배열이 시작하는 위치 */
+        size_t off_values; /**< 노드에서 값 배열이 시작하는 위치 */
+};
+
+int btree_export_image(struct btree *tree, const char *path);
+int btree_export_image_flags(struct btree *tree, const char *path,
+                             unsigned int flags);
+struct btree_image *btree_open_image(const char *path);
+int btree_image_search(const struct btree_image *image, key_t key,
+                       uint64_t *value);
+int btree_image_range(const struct btree_image *image, key_t lo, key_t hi,
+                      btree_visit_fn fn, void *private);
+void btree_image_close(struct btree_image *image);
+
+#endif
@@ -0,0 +1,474 @@
+/**
+ * @file btree-parallel.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief B-Tree 전체를 여러 스레드로 나누어 순회하는 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 루트부터 너비 우선으로 서브 트리를 펼쳐서 작업(task) 목록을 만든 뒤,
+ * 각 작업자(worker)의 deque에 연속된 구간으로 나누어 담는다.
+ * 작업자는 자신의 deque 뒤쪽에서 작업을 꺼내고, 비게 되면 다른 작업자의
+ * deque 앞쪽에서 서브 트리를 훔쳐와서(work stealing) 처리한다.
+ *
+ * 각 작업은 (서브 트리, 뒤따르는 구분 키)의 쌍으로 정의되며 작업 목록은
+ * 항상 키 순서를 유지한다. 따라서 작업 단위로 결과를 모으면 키 순서대로
+ * 병합할 수 있다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "btree.h"
+
+#define B_TREE_PARALLEL_TASKS_PER_THREAD 8 /**< 작업자 당 만들어 둘 작업 수 */
+#define B_TREE_PARALLEL_MAX_THREADS 1024 /**< 이보다 많은 스레드 수는 잘라낸다. */
+
+/**
+ * @brief 병렬 순회에서 하나의 작업에 해당한다.
+ */
+struct btree_task {
+        struct btree_node *node; /**< 통째로 순회할 서브 트리의 루트 */
+        struct btree_item *sep; /**< 서브 트리 다음에 방문할 구분 키 */
+        void *result; /**< ORDERED 모드에서 작업 별 결과를 가진다. */
+};
+
+/**
+ * @brief 작업자 별로 가지는 작업 deque에 해당한다.
+ * @details 작업은 순회 시작 전에 모두 만들어지므로 push는 필요 없다.
+ * 주인은 bottom에서, 훔치는 쪽은 top에서 꺼내간다.
+ */
+struct btree_deque {
+        pthread_mutex_t lock;
+        int top; /**< 훔쳐갈 다음 작업 위치 */
+        int bottom; /**< 주인이 꺼낼 마지막 작업 위치 + 1 */
+};
+
+struct btree_parallel_ctx;
+
+/**
+ * @brief 병렬 순회를 수행하는 작업자에 해당한다.
+ */
+struct btree_worker {
+        int id;
+        pthread_t thread;
+        struct btree_deque deque;
+        void *result; /**< 순서를 따지지 않는 경우 작업자 별 결과를 가진다. */
+        struct btree_parallel_ctx *ctx;
+};
+
+/**
+ * @brief 병렬 순회 전체의 상태를 가진다.
+ */
+struct btree_parallel_ctx {
+        const struct btree_parallel_ops *ops;
+        void *private;
+        unsigned int flags;
+
+        struct btree_task *tasks;
+        int nr_tasks;
+
+        struct btree_worker *workers;
+        int nr_workers;
+
+        atomic_int stop; /**< visit이 0이 아닌 값을 반환하면 설정된다. */
+        int ret;
+};
+
+/**
+ * @brief 루트부터 너비 우선으로 서브 트리를 펼쳐 작업 목록을 만든다.
+ *
+ * @param tree B-Tree를 가리키는 포인터에 해당한다.
+ * @param nr_tasks 만들어진 작업의 갯수가 반환된다.
+ * @param target 만들고자 하는 최소 작업의 갯수에 해당한다.
+ * @return struct btree_task* 키 순서로 정렬된 작업 목록을 반환한다.
+ * @exception 동적 할당에 실패한 경우에는 NULL이 반환된다.
+ */
+static struct btree_task *btree_split_tasks(struct btree *tree, int *nr_tasks,
+                                            int target)
+{
+        struct btree_task *tasks = NULL;
+        struct btree_task *next = NULL;
+        int n = 1;
+
+        tasks = (struct btree_task *)calloc(1, sizeof(struct btree_task));
+        if (!tasks) {
+                return NULL;
+        }
+        tasks[0].node = tree->root;
+        tasks[0].sep = NULL;
+
+        while (n < target) {
+                int nr_next = 0;
+                bool expanded = false;
+
+                for (int i = 0; i < n; i++) {
+                        struct btree_node *x = tasks[i].node;
+                        nr_next += x->is_leaf ? 1 : x->n + 1;
+                }
+
+                next = (struct btree_task *)calloc(nr_next,
+                                                   sizeof(struct btree_task));
+                if (!next) {
+                        free(tasks);
+                        return NULL;
+                }
+
+                nr_next = 0;
+                for (int i = 0; i < n; i++) {
+                        struct btree_node *x = tasks[i].node;
+                        if (x->is_leaf) {
+                                next[nr_next++] = tasks[i];
+                                continue;
+                        }
+                        for (int j = 0; j <= x->n; j++) {
+                                next[nr_next].node = x->child[j];
+                                next[nr_next].sep = (j < x->n) ?
+                                                            &x->items[j] :
+                                                            tasks[i].sep;
+                                nr_next++;
+                        }
+                        expanded = true;
+                }
+
+                free(tasks);
+                tasks = next;
+                n = nr_next;
+                if (!expanded) {
+                        break;
+                }
+        }
+
+        *nr_tasks = n;
+        return tasks;
+}
+
+/**
+ * @brief 서브 트리를 키 순서대로 방문한다.
+ *
+ * @return int visit이 반환한 0이 아닌 값 또는 0을 반환한다.
+ */
+static int __btree_parallel_walk(struct btree_parallel_ctx *ctx,
+                                 struct btree_node *x, void *result)
+{
+        int ret = 0;
+
+        for (int i = 0; i <= x->n; i++) {
+                if (atomic_load_explicit(&ctx->stop, memory_order_relaxed)) {
+                        return 0;
+                }
+                if (!x->is_leaf) {
+                        ret = __btree_parallel_walk(ctx, x->child[i], result);
+                        if (ret) {
+                                return ret;
+                        }
+                }
+                if (i < x->n) {
+                        ret = ctx->ops->visit(&x->items[i], result);
+                        if (ret) {
+                                return ret;
+                        }
+                }
+        }
+        return 0;
+}
+
+/**
+ * @brief 하나의 작업을 수행하고 중단 여부를 기록한다.
+ */
+static void btree_run_task(struct btree_parallel_ctx *ctx,
+                           struct btree_worker *w, struct btree_task *task)
+{
+        void *result = (ctx->flags & B_TREE_PARALLEL_ORDERED) ? task->result :
+                                                                 w->result;
+        int ret = __btree_parallel_walk(ctx, task->node, result);
+
+        if (!ret && task->sep &&
+            !atomic_load_explicit(&ctx->stop, memory_order_relaxed)) {
+                ret = ctx->ops->visit(task->sep, result);
+        }
+
+        if (ret) {
+                int expected = 0;
+                if (atomic_compare_exchange_strong(&ctx->stop, &expected, 1)) {
+                        ctx->ret = ret;
+                }
+        }
+}
+
+/**
+ * @brief 자신의 deque 뒤쪽에서 작업을 꺼낸다.
+ */
+static struct btree_task *btree_deque_pop(struct btree_parallel_ctx *ctx,
+                                          struct btree_deque *dq)
+{
+        struct btree_task *task = NULL;
+
+        pthread_mutex_lock(&dq->lock);
+        if (dq->top < dq->bottom) {
+                dq->bottom -= 1;
+                task = &ctx->tasks[dq->bottom];
+        }
+        pthread_mutex_unlock(&dq->lock);
+        return task;
+}
+
+/**
+ * @brief 다른 작업자의 deque 앞쪽에서 서브 트리를 훔쳐온다.
+ */
+static struct btree_task *btree_deque_steal(struct btree_parallel_ctx *ctx,
+                                            struct btree_worker *thief)
+{
+        for (int i = 1; i < ctx->nr_workers; i++) {
+                int victim = (thief->id + i) % ctx->nr_workers;
+                struct btree_deque *dq = &ctx->workers[victim].deque;
+                struct btree_task *task = NULL;
+
+                pthread_mutex_lock(&dq->lock);
+                if (dq->top < dq->bottom) {
+                        task = &ctx->tasks[dq->top];
+                        dq->top += 1;
+                }
+                pthread_mutex_unlock(&dq->lock);
+                if (task) {
+                        return task;
+                }
+        }
+        return NULL;
+}
+
+/**
+ * @brief 작업자 스레드의 본체에 해당한다.
+ */
+static void *btree_parallel_worker(void *arg)
+{
+        struct btree_worker *w = (struct btree_worker *)arg;
+        struct btree_parallel_ctx *ctx = w->ctx;
+        struct btree_task *task = NULL;
+
+        while (!atomic_load_explicit(&ctx->stop, memory_order_relaxed)) {
+                task = btree_deque_pop(ctx, &w->deque);
+                if (!task) {
+                        task = btree_deque_steal(ctx, w);
+                }
+                if (!task) {
+                        break;
+                }
+                btree_run_task(ctx, w, task);
+        }
+        return NULL;
+}
+
+/**
+ * @brief 결과 공간을 만든다. alloc이 없으면 private을 그대로 사용한다.
+ */
+static int btree_parallel_alloc_result(struct btree_parallel_ctx *ctx,
+                                       void **result)
+{
+        if (!ctx->ops->alloc) {
+                *result = ctx->private;
+                return 0;
+        }
+        *result = ctx->ops->alloc(ctx->private);
+        return *result ? 0 : -ENOMEM;
+}
+
+/**
+ * @brief 만들어진 결과를 병합한다. 순서 모드에서는 작업 순서가 곧 키 순서이다.
+ */
+static void btree_parallel_merge(struct btree_parallel_ctx *ctx)
+{
+        if (!ctx->ops->merge) {
+                return;
+        }
+
+        if (ctx->flags & B_TREE_PARALLEL_ORDERED) {
+                for (int i = 0; i < ctx->nr_tasks; i++) {
+                        if (ctx->tasks[i].result) {
+                                ctx->ops->merge(ctx->private,
+                                                ctx->tasks[i].result);
+                        }
+                }
+        } else {
+                for (int i = 0; i < ctx->nr_workers; i++) {
+                        if (ctx->workers[i].result) {
+                                ctx->ops->merge(ctx->private,
+                                                ctx->workers[i].result);
+                        }
+                }
+        }
+}
+
+/**
+ * @brief 병합하지 않고 만들어진 결과를 모두 해제한다.
+ */
+static void btree_parallel_release(struct btree_parallel_ctx *ctx)
+{
+        void **result = NULL;
+        const int nr = (ctx->flags & B_TREE_PARALLEL_ORDERED) ?
+                               ctx->nr_tasks :
+                               ctx->nr_workers;
+
+        if (!ctx->ops->alloc) {
+                return;
+        }
+        for (int i = 0; i < nr; i++) {
+                result = (ctx->flags & B_TREE_PARALLEL_ORDERED) ?
+                                 &ctx->tasks[i].result :
+                                 &ctx->workers[i].result;
+                if (!*result) {
+                        continue;
+                }
+                if (ctx->ops->release) {
+                        ctx->ops->release(ctx->private, *result);
+                } else {
+                        free(*result);
+                }
+                *result = NULL;
+        }
+}
+
+/**
+ * @brief 작업 별 결과를 이용하여 B-Tree 전체에 대한 병렬 집계를 수행한다.
+ *
+ * @param tree B-Tree를 가리키는 포인터에 해당한다.
+ * @param ops 결과의 생성, 누적, 병합을 담당하는 연산에 해당한다.
+ * @param private alloc과 merge에 그대로 전달되는 값에 해당한다.
+ * @param nthreads 사용할 스레드의 수로 0 이하이면 온라인 CPU 갯수를 사용하며,
+ * B_TREE_PARALLEL_MAX_THREADS보다 크면 그 값으로 줄인다.
+ * @param flags B_TREE_PARALLEL_ORDERED를 주면 작업 별 결과를 키 순서대로
+ * 병합하고, 그렇지 않으면 작업자 별 결과를 임의의 순서로 병합한다.
+ * @return int 성공 시에 0을, visit이 중단한 경우에는 그 값을 반환한다.
+ * alloc 없이 merge만 주면 -EINVAL을, alloc이 실패하면 아무 것도 병합하지 않고
+ * -ENOMEM을 반환한다.
+ * @exception 동적 할당이나 스레드 생성에 실패하면 음수의 errno가 반환된다.
+ *
+ * @warning 순회하는 동안에 B-Tree를 수정해서는 안된다.
+ */
+int btree_parallel_reduce(struct btree *tree,
+                          const struct btree_parallel_ops *ops, void *private,
+                          int nthreads, unsigned int flags)
+{
+        struct btree_parallel_ctx ctx = { 0 };
+        int nr_started = 1;
+        int ret = 0;
+
+        if (!tree || !tree->root || !ops || !ops->visit) {
+                return -EINVAL;
+        }
+        if (ops->merge && !ops->alloc) {
+                /* 모든 결과가 private이므로 merge가 같은 결과를 여러 번 해제하게 된다. */
+                return -EINVAL;
+        }
+
+        if (nthreads <= 0) {
+                nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+                nthreads = (nthreads > 0) ? nthreads : 1;
+        }
+        if (nthreads > B_TREE_PARALLEL_MAX_THREADS) {
+                nthreads = B_TREE_PARALLEL_MAX_THREADS;
+        }
+
+        ctx.ops = ops;
+        ctx.private = private;
+        ctx.flags = flags;
+        atomic_init(&ctx.stop, 0);
+
+        ctx.tasks = btree_split_tasks(
+                tree, &ctx.nr_tasks,
+                nthreads * B_TREE_PARALLEL_TASKS_PER_THREAD);
+        if (!ctx.tasks) {
+                pr_info("Task allocation failed...\n");
+                return -ENOMEM;
+        }
+
+        if (nthreads > ctx.nr_tasks) {
+                nthreads = ctx.nr_tasks;
+        }
+        ctx.nr_workers = nthreads;
+        ctx.workers = (struct btree_worker *)calloc(
+                nthreads, sizeof(struct btree_worker));
+        if (!ctx.workers) {
+                pr_info("Worker allocation failed...\n");
+                ret = -ENOMEM;
+                goto exception;
+        }
+
+        for (int i = 0; i < ctx.nr_tasks && !ret; i++) {
+                if (flags & B_TREE_PARALLEL_ORDERED) {
+                        ret = btree_parallel_alloc_result(
+                                &ctx, &ctx.tasks[i].result);
+                }
+        }
+
+        for (int i = 0; i < nthreads; i++) {
+                struct btree_worker *w = &ctx.workers[i];
+                w->id = i;
+                w->ctx = &ctx;
+                w->deque.top = (int)((long)ctx.nr_tasks * i / nthreads);
+                w->deque.bottom = (int)((long)ctx.nr_tasks * (i + 1) / nthreads);
+                pthread_mutex_init(&w->deque.lock, NULL);
+                if (!ret && !(flags & B_TREE_PARALLEL_ORDERED)) {
+                        ret = btree_parallel_alloc_result(&ctx, &w->result);
+                }
+        }
+        if (ret) {
+                pr_info("Result allocation failed...\n");
+                btree_parallel_release(&ctx);
+                goto destroy;
+        }
+
+        for (; nr_started < nthreads; nr_started++) {
+                struct btree_worker *w = &ctx.workers[nr_started];
+                if (pthread_create(&w->thread, NULL, btree_parallel_worker,
+                                   w)) {
+                        pr_info("Worker creation failed...\n");
+                        break;
+                }
+        }
+
+        btree_parallel_worker(&ctx.workers[0]); /**< 호출한 스레드도 참여한다. */
+
+        for (int i = 1; i < nr_started; i++) {
+                pthread_join(ctx.workers[i].thread, NULL);
+        }
+        ret = ctx.ret;
+
+        btree_parallel_merge(&ctx);
+destroy:
+        for (int i = 0; i < nthreads; i++) {
+                pthread_mutex_destroy(&ctx.workers[i].deque.lock);
+        }
+exception:
+        free(ctx.workers);
+        free(ctx.tasks);
+        return ret;
+}
+
+/**
+ * @brief B-Tree의 모든 항목에 대해서 fn을 병렬로 호출하도록 한다.
+ *
+ * @param tree B-Tree를 가리키는 포인터에 해당한다.
+ * @param fn 항목마다 호출될 함수로 여러 스레드에서 동시에 불린다.
+ * @param private fn에 그대로 전달되는 값에 해당한다.
+ * @param nthreads 사용할 스레드의 수로 0 이하이면 온라인 CPU 갯수를 사용한다.
+ * @return int btree_parallel_reduce()와 동일하다.
+ */
+int btree_parallel_for_each(struct btree *tree, btree_visit_fn fn,
+                            void *private, int nthreads)
+{
+        const struct btree_parallel_ops ops = {
+                .alloc = NULL,
+                .visit = fn,
+                .merge = NULL,
+        };
+
+        if (!fn) {
+                return -EINVAL;
+        }
+        return btree_parallel_reduce(tree, &ops, private, nthreads, 0);
+}
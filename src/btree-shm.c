@@ -0,0 +1,745 @@
+/**
+ * @file btree-shm.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 공유 메모리 B-Tree의 생성, 갱신과 탐색에 대한 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 세그먼트를 만든 프로세스 하나만 트리를 고치고, 다른 프로세스는
+ * 세그먼트를 읽기 전용으로 mmap 해서 복사나 IPC 없이 바로 탐색한다.
+ * 쓰는 쪽은 연산 하나를 seq가 홀수인 동안 수행하며, 읽는 쪽은 탐색 전후의 seq가
+ * 같고 짝수일 때만 결과를 믿는다. 쓰기와 겹친 탐색은 반쯤 고쳐진 노드를 볼 수
+ * 있으므로, 노드의 위치와 키의 수를 확인하여 세그먼트 밖을 읽지 않게 한다.
+ *
+ * 노드는 세그먼트 안에서만 할당되며 세그먼트는 커지지 않는다. 삽입은 분할에
+ * 필요한 노드를 확보할 수 없으면 트리를 바꾸지 않고 -ENOSPC를 반환한다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "btree-shm.h"
+
+_Static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+               "seqlock in shared memory needs a lock-free 64-bit atomic");
+
+static inline struct btree_shm_node *btree_shm_node(const struct btree_shm *shm,
+                                                    uint64_t x)
+{
+        return (struct btree_shm_node *)(shm->base + x);
+}
+
+static inline key_t *btree_shm_keys(const struct btree_shm *shm, uint64_t x)
+{
+        return (key_t *)(shm->base + x + shm->off_keys);
+}
+
+static inline uint64_t *btree_shm_child(const struct btree_shm *shm,
+                                        uint64_t x)
+{
+        return (uint64_t *)(shm->base + x + shm->off_child);
+}
+
+static inline uint64_t *btree_shm_values(const struct btree_shm *shm,
+                                         uint64_t x)
+{
+        return (uint64_t *)(shm->base + x + shm->off_values);
+}
+
+/**
+ * @brief 최소 차수에 맞추어 노드의 배치와 크기를 정한다.
+ * @details 배치는 btree-image와 같으며, 노드가 페이지 경계에 걸치지 않도록
+ * 크기를 페이지 크기 이하의 2의 거듭제곱이나 페이지 크기의 배수로 맞춘다.
+ *
+ * @return size_t 노드 하나가 차지하는 크기를 반환한다.
+ */
+static size_t btree_shm_layout(struct btree_shm *shm, int min_degree)
+{
+        const size_t nr_keys = B_TREE_NR_KEYS(min_degree);
+        size_t raw = 0;
+        size_t node_size = 0;
+
+        shm->off_keys = sizeof(struct btree_shm_node);
+        shm->off_child = shm->off_keys + nr_keys * sizeof(key_t);
+        shm->off_child = (shm->off_child + 7) & ~(size_t)7;
+        shm->off_values = shm->off_child + (nr_keys + 1) * sizeof(uint64_t);
+        raw = shm->off_values + nr_keys * sizeof(uint64_t);
+
+        if (raw > B_TREE_SHM_PAGE_SIZE) {
+                return (raw + B_TREE_SHM_PAGE_SIZE - 1) &
+                       ~(size_t)(B_TREE_SHM_PAGE_SIZE - 1);
+        }
+        for (node_size = 64; node_size < raw; node_size <<= 1)
+                ;
+        return node_size;
+}
+
+/**
+ * @brief 쓰는 쪽이 세그먼트를 고치기 시작함을 알린다.
+ */
+static inline void btree_shm_write_begin(struct btree_shm *shm)
+{
+        atomic_fetch_add_explicit(&shm->header->seq, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+}
+
+static inline void btree_shm_write_end(struct btree_shm *shm)
+{
+        atomic_fetch_add_explicit(&shm->header->seq, 1, memory_order_release);
+}
+
+/**
+ * @brief 쓰기가 진행 중이 아닐 때의 seq를 읽는다.
+ */
+static inline uint64_t btree_shm_read_begin(const struct btree_shm *shm)
+{
+        uint64_t seq = 0;
+
+        while ((seq = atomic_load_explicit(&shm->header->seq,
+                                           memory_order_acquire)) &
+               1) {
+                sched_yield();
+        }
+        return seq;
+}
+
+/**
+ * @brief 탐색하는 동안 쓰기가 있었는 지 확인한다.
+ *
+ * @return bool 탐색을 다시 해야 하면 true를 반환한다.
+ */
+static inline bool btree_shm_read_retry(const struct btree_shm *shm,
+                                        uint64_t seq)
+{
+        atomic_thread_fence(memory_order_acquire);
+        return atomic_load_explicit(&shm->header->seq, memory_order_relaxed) !=
+               seq;
+}
+
+/**
+ * @brief 노드의 위치가 세그먼트 안의 노드 경계를 가리키는 지 확인한다.
+ */
+static inline bool btree_shm_valid(const struct btree_shm *shm, uint64_t x)
+{
+        const uint64_t node_size = shm->header->node_size;
+
+        return x >= B_TREE_SHM_PAGE_SIZE && x <= shm->size - node_size &&
+               (x - B_TREE_SHM_PAGE_SIZE) % node_size == 0;
+}
+
+/**
+ * @brief 남은 공간에서 할당할 수 있는 노드의 수를 반환한다.
+ */
+static uint64_t btree_shm_available(const struct btree_shm *shm)
+{
+        const struct btree_shm_header *header = shm->header;
+
+        return header->nr_free +
+               (header->size - header->brk) / header->node_size;
+}
+
+static uint64_t btree_shm_alloc_node(struct btree_shm *shm, bool is_leaf)
+{
+        struct btree_shm_header *header = shm->header;
+        uint64_t x = header->free;
+
+        if (x) {
+                memcpy(&header->free, shm->base + x, sizeof(uint64_t));
+                header->nr_free--;
+        } else {
+                x = header->brk;
+                header->brk += header->node_size;
+        }
+        btree_shm_node(shm, x)->n = 0;
+        btree_shm_node(shm, x)->is_leaf = is_leaf;
+        header->nr_nodes++;
+        return x;
+}
+
+/**
+ * @brief 노드를 반환한다. 노드의 앞 8바이트에 다음 빈 노드의 위치를 적는다.
+ */
+static void btree_shm_free_node(struct btree_shm *shm, uint64_t x)
+{
+        struct btree_shm_header *header = shm->header;
+
+        memcpy(shm->base + x, &header->free, sizeof(uint64_t));
+        header->free = x;
+        header->nr_free++;
+        header->nr_nodes--;
+}
+
+/**
+ * @brief 공유 메모리 세그먼트를 만들고 빈 트리를 쓸 수 있게 연다.
+ *
+ * @param name shm_open에 넘길 '/'로 시작하는 이름에 해당한다.
+ * @param min_degree 트리의 최소 차수에 해당한다.
+ * @param size 세그먼트의 크기로 페이지 크기의 배수로 올림된다.
+ * @return struct btree_shm* 정상적으로 만들어진 경우에는 주소가 반환된다.
+ * @exception 같은 이름의 세그먼트가 이미 있거나 만들 수 없으면 NULL이 반환된다.
+ */
+struct btree_shm *btree_shm_create(const char *name, int min_degree,
+                                   size_t size)
+{
+        struct btree_shm *shm = NULL;
+        struct btree_shm_header *header = NULL;
+        size_t node_size = 0;
+        void *base = MAP_FAILED;
+        int fd = -1;
+
+        if (min_degree < B_TREE_MIN_DEGREE) {
+                pr_info("Invalid min degree(%d)\n", min_degree);
+                return NULL;
+        }
+        shm = (struct btree_shm *)calloc(1, sizeof(struct btree_shm));
+        if (!shm) {
+                pr_info("Allocation shared memory tree failed\n");
+                return NULL;
+        }
+        node_size = btree_shm_layout(shm, min_degree);
+        size = (size + B_TREE_SHM_PAGE_SIZE - 1) &
+               ~(size_t)(B_TREE_SHM_PAGE_SIZE - 1);
+        if (size < B_TREE_SHM_PAGE_SIZE + node_size) {
+                pr_info("Shared memory size(%zu) is too small\n", size);
+                goto exception;
+        }
+
+        fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) {
+                pr_info("Cannot create shared memory(%s)\n", name);
+                goto exception;
+        }
+        if (ftruncate(fd, (off_t)size)) {
+                pr_info("Cannot resize shared memory(%s)\n", name);
+                goto exception;
+        }
+        base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+                pr_info("Cannot map shared memory(%s)\n", name);
+                goto exception;
+        }
+        close(fd);
+        fd = -1;
+
+        shm->base = (char *)base;
+        shm->size = size;
+        shm->header = header = (struct btree_shm_header *)base;
+        shm->writable = true;
+
+        header->version = B_TREE_SHM_VERSION;
+        header->min_degree = (uint32_t)min_degree;
+        header->node_size = (uint32_t)node_size;
+        atomic_init(&header->seq, 0);
+        header->size = size;
+        header->brk = B_TREE_SHM_PAGE_SIZE;
+        header->root = btree_shm_alloc_node(shm, true);
+        header->height = 1;
+        /* magic이 보이면 나머지 헤더도 보이도록 가장 나중에 쓴다. */
+        atomic_thread_fence(memory_order_release);
+        header->magic = B_TREE_SHM_MAGIC;
+        return shm;
+
+exception:
+        if (fd >= 0) {
+                close(fd);
+                shm_unlink(name);
+        }
+        free(shm);
+        return NULL;
+}
+
+/**
+ * @brief 다른 프로세스가 만든 세그먼트를 읽기 전용으로 연다.
+ *
+ * @param name btree_shm_create에 넘긴 이름에 해당한다.
+ * @return struct btree_shm* 정상적으로 열린 경우에는 주소가 반환된다.
+ * @exception 세그먼트가 없거나 올바른 트리가 아니면 NULL이 반환된다.
+ */
+struct btree_shm *btree_shm_open(const char *name)
+{
+        struct btree_shm *shm = NULL;
+        const struct btree_shm_header *header = NULL;
+        struct stat st;
+        void *base = MAP_FAILED;
+        int fd = -1;
+
+        shm = (struct btree_shm *)calloc(1, sizeof(struct btree_shm));
+        if (!shm) {
+                pr_info("Allocation shared memory tree failed\n");
+                return NULL;
+        }
+
+        fd = shm_open(name, O_RDONLY, 0);
+        if (fd < 0 || fstat(fd, &st)) {
+                pr_info("Cannot open shared memory(%s)\n", name);
+                goto exception;
+        }
+        if ((size_t)st.st_size < B_TREE_SHM_PAGE_SIZE) {
+                pr_info("Invalid shared memory(%s)\n", name);
+                goto exception;
+        }
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+                pr_info("Cannot map shared memory(%s)\n", name);
+                goto exception;
+        }
+        close(fd);
+        fd = -1;
+
+        header = (const struct btree_shm_header *)base;
+        if (header->magic != B_TREE_SHM_MAGIC) {
+                pr_info("Invalid shared memory(%s)\n", name);
+                goto exception;
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (header->version != B_TREE_SHM_VERSION ||
+            header->min_degree < B_TREE_MIN_DEGREE ||
+            header->size != (uint64_t)st.st_size ||
+            header->node_size != btree_shm_layout(shm, header->min_degree)) {
+                pr_info("Invalid shared memory(%s)\n", name);
+                goto exception;
+        }
+
+        shm->base = (char *)base;
+        shm->size = (size_t)st.st_size;
+        shm->header = (struct btree_shm_header *)base;
+        shm->writable = false;
+        return shm;
+
+exception:
+        if (base != MAP_FAILED) {
+                munmap(base, (size_t)st.st_size);
+        }
+        if (fd >= 0) {
+                close(fd);
+        }
+        free(shm);
+        return NULL;
+}
+
+/**
+ * @brief x의 i번째 자식을 분할하여 가운데 키를 x로 올린다.
+ */
+static void btree_shm_split_child(struct btree_shm *shm, uint64_t x, int i)
+{
+        const int t = (int)shm->header->min_degree;
+        const uint64_t y = btree_shm_child(shm, x)[i];
+        const uint64_t z =
+                btree_shm_alloc_node(shm, btree_shm_node(shm, y)->is_leaf);
+        struct btree_shm_node *xn = btree_shm_node(shm, x);
+
+        btree_shm_node(shm, z)->n = (uint32_t)(t - 1);
+        memcpy(btree_shm_keys(shm, z), btree_shm_keys(shm, y) + t,
+               (t - 1) * sizeof(key_t));
+        memcpy(btree_shm_values(shm, z), btree_shm_values(shm, y) + t,
+               (t - 1) * sizeof(uint64_t));
+        if (!btree_shm_node(shm, y)->is_leaf) {
+                memcpy(btree_shm_child(shm, z), btree_shm_child(shm, y) + t,
+                       t * sizeof(uint64_t));
+        }
+        btree_shm_node(shm, y)->n = (uint32_t)(t - 1);
+
+        memmove(btree_shm_child(shm, x) + i + 2,
+                btree_shm_child(shm, x) + i + 1,
+                (xn->n - i) * sizeof(uint64_t));
+        memmove(btree_shm_keys(shm, x) + i + 1, btree_shm_keys(shm, x) + i,
+                (xn->n - i) * sizeof(key_t));
+        memmove(btree_shm_values(shm, x) + i + 1,
+                btree_shm_values(shm, x) + i, (xn->n - i) * sizeof(uint64_t));
+        btree_shm_child(shm, x)[i + 1] = z;
+        btree_shm_keys(shm, x)[i] = btree_shm_keys(shm, y)[t - 1];
+        btree_shm_values(shm, x)[i] = btree_shm_values(shm, y)[t - 1];
+        xn->n++;
+}
+
+static void __btree_shm_insert(struct btree_shm *shm, key_t key,
+                               uint64_t value)
+{
+        struct btree_shm_header *header = shm->header;
+        const uint32_t nr_keys = B_TREE_NR_KEYS(header->min_degree);
+        uint64_t x = header->root;
+        int i = 0;
+
+        if (btree_shm_node(shm, x)->n == nr_keys) {
+                const uint64_t s = btree_shm_alloc_node(shm, false);
+
+                btree_shm_child(shm, s)[0] = x;
+                btree_shm_split_child(shm, s, 0);
+                header->root = x = s;
+                header->height++;
+        }
+        while (!btree_shm_node(shm, x)->is_leaf) {
+                const key_t *keys = btree_shm_keys(shm, x);
+
+                i = (int)btree_shm_node(shm, x)->n;
+                while (i > 0 && key < keys[i - 1]) {
+                        i--;
+                }
+                if (btree_shm_node(shm, btree_shm_child(shm, x)[i])->n ==
+                    nr_keys) {
+                        btree_shm_split_child(shm, x, i);
+                        if (key > keys[i]) {
+                                i++;
+                        }
+                }
+                x = btree_shm_child(shm, x)[i];
+        }
+
+        i = (int)btree_shm_node(shm, x)->n;
+        while (i > 0 && key < btree_shm_keys(shm, x)[i - 1]) {
+                btree_shm_keys(shm, x)[i] = btree_shm_keys(shm, x)[i - 1];
+                btree_shm_values(shm, x)[i] = btree_shm_values(shm, x)[i - 1];
+                i--;
+        }
+        btree_shm_keys(shm, x)[i] = key;
+        btree_shm_values(shm, x)[i] = value;
+        btree_shm_node(shm, x)->n++;
+        header->nr_keys++;
+}
+
+/**
+ * @brief 공유 메모리 B-Tree에 대한 데이터의 삽입을 수행하도록 한다.
+ * @details struct btree와 같이 같은 키가 여러 번 들어갈 수 있다.
+ *
+ * @param shm btree_shm_create로 만든 트리를 가리키는 포인터에 해당한다.
+ * @param key 입력하고자 하는 데이터의 키에 해당한다.
+ * @param value 키와 함께 입력되고자 하는 값에 해당한다.
+ * @return int 성공 시에 0을, 읽기 전용이면 -EPERM을, 분할에 쓸 노드를
+ * 확보할 수 없으면 -ENOSPC를 반환한다.
+ */
+int btree_shm_insert(struct btree_shm *shm, key_t key, uint64_t value)
+{
+        if (!shm->writable) {
+                return -EPERM;
+        }
+        /* 루트부터 잎까지 모두 분할되어도 되는 만큼의 노드가 있어야 한다. */
+        if (btree_shm_available(shm) < shm->header->height + 1) {
+                return -ENOSPC;
+        }
+        btree_shm_write_begin(shm);
+        __btree_shm_insert(shm, key, value);
+        btree_shm_write_end(shm);
+        return 0;
+}
+
+/**
+ * @brief p의 i번째 자식과 i+1번째 자식을 p의 i번째 키와 함께 합친다.
+ */
+static void btree_shm_merge_child(struct btree_shm *shm, uint64_t p, int i)
+{
+        struct btree_shm_header *header = shm->header;
+        const int t = (int)header->min_degree;
+        const uint64_t left = btree_shm_child(shm, p)[i];
+        const uint64_t right = btree_shm_child(shm, p)[i + 1];
+        struct btree_shm_node *pn = btree_shm_node(shm, p);
+
+        btree_shm_keys(shm, left)[t - 1] = btree_shm_keys(shm, p)[i];
+        btree_shm_values(shm, left)[t - 1] = btree_shm_values(shm, p)[i];
+        memcpy(btree_shm_keys(shm, left) + t, btree_shm_keys(shm, right),
+               (t - 1) * sizeof(key_t));
+        memcpy(btree_shm_values(shm, left) + t, btree_shm_values(shm, right),
+               (t - 1) * sizeof(uint64_t));
+        if (!btree_shm_node(shm, left)->is_leaf) {
+                memcpy(btree_shm_child(shm, left) + t,
+                       btree_shm_child(shm, right), t * sizeof(uint64_t));
+        }
+        btree_shm_node(shm, left)->n = (uint32_t)B_TREE_NR_KEYS(t);
+
+        memmove(btree_shm_keys(shm, p) + i, btree_shm_keys(shm, p) + i + 1,
+                (pn->n - i - 1) * sizeof(key_t));
+        memmove(btree_shm_values(shm, p) + i,
+                btree_shm_values(shm, p) + i + 1,
+                (pn->n - i - 1) * sizeof(uint64_t));
+        memmove(btree_shm_child(shm, p) + i + 1,
+                btree_shm_child(shm, p) + i + 2,
+                (pn->n - i - 1) * sizeof(uint64_t));
+        pn->n--;
+        btree_shm_free_node(shm, right);
+        if (pn->n == 0 && p == header->root) {
+                btree_shm_free_node(shm, p);
+                header->root = left;
+                header->height--;
+        }
+}
+
+/**
+ * @brief x의 i번째 자식이 최소 차수 이상의 키를 가지도록 형제에게서 빌리거나 합친다.
+ *
+ * @return uint64_t 탐색을 이어갈 자식의 위치를 반환한다.
+ */
+static uint64_t btree_shm_fill_child(struct btree_shm *shm, uint64_t x, int i)
+{
+        const int t = (int)shm->header->min_degree;
+        const int n = (int)btree_shm_node(shm, x)->n;
+        const uint64_t child = btree_shm_child(shm, x)[i];
+        const uint64_t left = i > 0 ? btree_shm_child(shm, x)[i - 1] : 0;
+        const uint64_t right = i < n ? btree_shm_child(shm, x)[i + 1] : 0;
+        struct btree_shm_node *cn = btree_shm_node(shm, child);
+
+        if (left && btree_shm_node(shm, left)->n >= (uint32_t)t) {
+                struct btree_shm_node *ln = btree_shm_node(shm, left);
+
+                memmove(btree_shm_keys(shm, child) + 1,
+                        btree_shm_keys(shm, child), cn->n * sizeof(key_t));
+                memmove(btree_shm_values(shm, child) + 1,
+                        btree_shm_values(shm, child),
+                        cn->n * sizeof(uint64_t));
+                if (!cn->is_leaf) {
+                        memmove(btree_shm_child(shm, child) + 1,
+                                btree_shm_child(shm, child),
+                                (cn->n + 1) * sizeof(uint64_t));
+                        btree_shm_child(shm, child)[0] =
+                                btree_shm_child(shm, left)[ln->n];
+                }
+                btree_shm_keys(shm, child)[0] = btree_shm_keys(shm, x)[i - 1];
+                btree_shm_values(shm, child)[0] =
+                        btree_shm_values(shm, x)[i - 1];
+                cn->n++;
+                btree_shm_keys(shm, x)[i - 1] =
+                        btree_shm_keys(shm, left)[ln->n - 1];
+                btree_shm_values(shm, x)[i - 1] =
+                        btree_shm_values(shm, left)[ln->n - 1];
+                ln->n--;
+        } else if (right && btree_shm_node(shm, right)->n >= (uint32_t)t) {
+                struct btree_shm_node *rn = btree_shm_node(shm, right);
+
+                btree_shm_keys(shm, child)[cn->n] = btree_shm_keys(shm, x)[i];
+                btree_shm_values(shm, child)[cn->n] =
+                        btree_shm_values(shm, x)[i];
+                cn->n++;
+                btree_shm_keys(shm, x)[i] = btree_shm_keys(shm, right)[0];
+                btree_shm_values(shm, x)[i] = btree_shm_values(shm, right)[0];
+                if (!rn->is_leaf) {
+                        btree_shm_child(shm, child)[cn->n] =
+                                btree_shm_child(shm, right)[0];
+                        memmove(btree_shm_child(shm, right),
+                                btree_shm_child(shm, right) + 1,
+                                rn->n * sizeof(uint64_t));
+                }
+                rn->n--;
+                memmove(btree_shm_keys(shm, right),
+                        btree_shm_keys(shm, right) + 1, rn->n * sizeof(key_t));
+                memmove(btree_shm_values(shm, right),
+                        btree_shm_values(shm, right) + 1,
+                        rn->n * sizeof(uint64_t));
+        } else if (left) {
+                btree_shm_merge_child(shm, x, i - 1);
+                return left;
+        } else if (right) {
+                btree_shm_merge_child(shm, x, i);
+        }
+        return child;
+}
+
+/**
+ * @brief x를 루트로 하는 부트리에서 key를 지운다. key는 부트리에 있어야 한다.
+ */
+static void __btree_shm_delete(struct btree_shm *shm, uint64_t x, key_t key)
+{
+        const uint32_t t = shm->header->min_degree;
+
+        for (;;) {
+                struct btree_shm_node *xn = btree_shm_node(shm, x);
+                const key_t *keys = btree_shm_keys(shm, x);
+                int i = 0;
+
+                while (i < (int)xn->n && key > keys[i]) {
+                        i++;
+                }
+                if (i < (int)xn->n && key == keys[i]) {
+                        uint64_t prev = 0, next = 0, y = 0;
+                        uint32_t n = 0;
+
+                        if (xn->is_leaf) {
+                                xn->n--;
+                                memmove(btree_shm_keys(shm, x) + i,
+                                        btree_shm_keys(shm, x) + i + 1,
+                                        (xn->n - i) * sizeof(key_t));
+                                memmove(btree_shm_values(shm, x) + i,
+                                        btree_shm_values(shm, x) + i + 1,
+                                        (xn->n - i) * sizeof(uint64_t));
+                                return;
+                        }
+                        prev = btree_shm_child(shm, x)[i];
+                        next = btree_shm_child(shm, x)[i + 1];
+                        if (btree_shm_node(shm, prev)->n >= t) {
+                                key_t k;
+
+                                y = prev;
+                                while (!btree_shm_node(shm, y)->is_leaf) {
+                                        n = btree_shm_node(shm, y)->n;
+                                        y = btree_shm_child(shm, y)[n];
+                                }
+                                n = btree_shm_node(shm, y)->n - 1;
+                                k = btree_shm_keys(shm, y)[n];
+                                btree_shm_values(shm, x)[i] =
+                                        btree_shm_values(shm, y)[n];
+                                __btree_shm_delete(shm, prev, k);
+                                btree_shm_keys(shm, x)[i] = k;
+                                return;
+                        }
+                        if (btree_shm_node(shm, next)->n >= t) {
+                                key_t k;
+
+                                y = next;
+                                while (!btree_shm_node(shm, y)->is_leaf) {
+                                        y = btree_shm_child(shm, y)[0];
+                                }
+                                k = btree_shm_keys(shm, y)[0];
+                                btree_shm_values(shm, x)[i] =
+                                        btree_shm_values(shm, y)[0];
+                                __btree_shm_delete(shm, next, k);
+                                btree_shm_keys(shm, x)[i] = k;
+                                return;
+                        }
+                        btree_shm_merge_child(shm, x, i);
+                        x = prev;
+                        continue;
+                }
+                if (xn->is_leaf) {
+                        return;
+                }
+                if (btree_shm_node(shm, btree_shm_child(shm, x)[i])->n ==
+                    t - 1) {
+                        x = btree_shm_fill_child(shm, x, i);
+                } else {
+                        x = btree_shm_child(shm, x)[i];
+                }
+        }
+}
+
+/**
+ * @brief 부트리에서 탐색을 수행한다. 쓰기와 겹칠 수 있으므로 읽는 값을 모두 확인한다.
+ *
+ * @return int 찾은 경우에는 0을, 없는 경우에는 -ENOENT를, 올바르지 않은
+ * 노드를 만난 경우에는 -EAGAIN을 반환한다.
+ */
+static int __btree_shm_search(const struct btree_shm *shm, key_t key,
+                              uint64_t *value)
+{
+        const uint32_t nr_keys = B_TREE_NR_KEYS(shm->header->min_degree);
+        uint64_t x = shm->header->root;
+
+        for (int depth = 0; depth < B_TREE_SHM_MAX_HEIGHT; depth++) {
+                const key_t *keys = NULL;
+                uint32_t n = 0;
+                int lo = 0, hi = 0;
+
+                if (!btree_shm_valid(shm, x)) {
+                        return -EAGAIN;
+                }
+                keys = btree_shm_keys(shm, x);
+                n = btree_shm_node(shm, x)->n;
+                if (n > nr_keys) {
+                        return -EAGAIN;
+                }
+                hi = (int)n;
+                while (lo < hi) {
+                        int mid = (lo + hi) / 2;
+                        if (keys[mid] < key) {
+                                lo = mid + 1;
+                        } else {
+                                hi = mid;
+                        }
+                }
+                if (lo < (int)n && keys[lo] == key) {
+                        *value = btree_shm_values(shm, x)[lo];
+                        return 0;
+                }
+                if (btree_shm_node(shm, x)->is_leaf) {
+                        return -ENOENT;
+                }
+                x = btree_shm_child(shm, x)[lo];
+        }
+        return -EAGAIN;
+}
+
+/**
+ * @brief 공유 메모리 B-Tree에서 탐색을 수행하도록 한다.
+ * @details 쓰는 쪽과 겹치면 쓰기가 끝난 뒤에 다시 탐색하며, 다시 한 횟수는
+ * shm->retries에 더해진다.
+ *
+ * @param shm 트리를 가리키는 포인터에 해당한다.
+ * @param key 찾고자 하는 키에 해당한다.
+ * @param value 찾은 값을 받을 위치로 NULL이면 무시한다.
+ * @return int 찾은 경우에는 0을, 없는 경우에는 -ENOENT를, 세그먼트가 손상된
+ * 경우에는 -EIO를 반환한다.
+ */
+int btree_shm_search(struct btree_shm *shm, key_t key, uint64_t *value)
+{
+        uint64_t found = 0;
+        uint64_t seq = 0;
+        int ret = 0;
+
+        for (;;) {
+                seq = btree_shm_read_begin(shm);
+                ret = __btree_shm_search(shm, key, &found);
+                if (!btree_shm_read_retry(shm, seq)) {
+                        break;
+                }
+                shm->retries++;
+        }
+        if (ret == -EAGAIN) {
+                return -EIO;
+        }
+        if (!ret && value) {
+                *value = found;
+        }
+        return ret;
+}
+
+/**
+ * @brief 공유 메모리 B-Tree에서 삭제를 수행하도록 한다.
+ *
+ * @param shm btree_shm_create로 만든 트리를 가리키는 포인터에 해당한다.
+ * @param key 삭제를 하고자 하는 키에 해당한다.
+ * @return int 삭제를 성공한 경우에는 0을, 키가 없으면 -EINVAL을, 읽기
+ * 전용이면 -EPERM을 반환한다.
+ */
+int btree_shm_delete(struct btree_shm *shm, key_t key)
+{
+        if (!shm->writable) {
+                return -EPERM;
+        }
+        if (btree_shm_search(shm, key, NULL)) {
+                return -EINVAL;
+        }
+        btree_shm_write_begin(shm);
+        __btree_shm_delete(shm, shm->header->root, key);
+        shm->header->nr_keys--;
+        btree_shm_write_end(shm);
+        return 0;
+}
+
+/**
+ * @brief 세그먼트의 mmap을 해제하고 할당된 메모리를 해제한다.
+ * @details 세그먼트 자체는 btree_shm_unlink를 호출할 때까지 남는다.
+ *
+ * @param shm 트리를 가리키는 포인터에 해당한다.
+ */
+void btree_shm_close(struct btree_shm *shm)
+{
+        if (shm) {
+                munmap(shm->base, shm->size);
+                free(shm);
+        }
+}
+
+/**
+ * @brief 세그먼트의 이름을 지운다. 이미 mmap 한 프로세스는 계속 사용할 수 있다.
+ *
+ * @param name btree_shm_create에 넘긴 이름에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int btree_shm_unlink(const char *name)
+{
+        return shm_unlink(name) ? -errno : 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file btree-shm.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 여러 프로세스가 POSIX 공유 메모리로 함께 쓰는 B-Tree에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _B_TREE_SHM_H
+#define _B_TREE_SHM_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "btree.h"
+
+#define B_TREE_SHM_MAGIC 0x4d485342u /**< "BSHM" */
+#define B_TREE_SHM_VERSION 1
+#define B_TREE_SHM_PAGE_SIZE (4 * 1024) /**< 헤더가 차지하는 크기이다. */
+#define B_TREE_SHM_MAX_HEIGHT 64 /**< 읽는 쪽이 따라 내려가는 최대 깊이이다. */
+
+/**
+ * @brief 공유 메모리 세그먼트의 맨 앞에 놓이는 헤더에 해당한다.
+ * @details 노드는 헤더 뒤에 node_size 간격으로 놓이고 서로를 세그먼트 내의
+ * 위치(offset)로 가리키므로, 프로세스마다 다른 주소에 mmap 되어도 된다.
+ * seq는 쓰는 쪽이 고치는 동안 홀수가 되는 seqlock으로, 나머지 필드는
+ * seq로 보호된다.
+ */
+struct btree_shm_header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t min_degree;
+        uint32_t node_size;
+        _Atomic uint64_t seq;
+        uint64_t size; /**< 세그먼트 전체의 크기이다. */
+        uint64_t root;
+        uint64_t height; /**< 잎만 있으면 1이다. */
+        uint64_t nr_keys;
+        uint64_t nr_nodes;
+        uint64_t brk; /**< 아직 한 번도 쓰이지 않은 영역의 시작 위치이다. */
+        uint64_t free; /**< 반환된 노드 목록의 머리로 없으면 0이다. */
+        uint64_t nr_free;
+};
+
+/**
+ * @brief 세그먼트 안에 놓이는 노드의 머리 부분에 해당한다.
+ * @details 머리 뒤에는 키(key_t), 자식 위치(uint64_t), 값(uint64_t)의
+ * 배열이 btree_image_node와 같은 순서로 놓인다.
+ */
+struct btree_shm_node {
+        uint32_t n;
+        uint32_t is_leaf;
+};
+
+/**
+ * @brief 프로세스 하나가 세그먼트를 mmap 한 상태에 해당한다.
+ */
+struct btree_shm {
+        char *base; /**< mmap 된 영역의 시작 주소로 프로세스마다 다르다. */
+        size_t size;
+        struct btree_shm_header *header;
+        bool writable; /**< btree_shm_create로 만든 쪽만 쓸 수 있다. */
+
+        size_t off_keys; /**< 노드에서 키 배열이 시작하는 위치 */
+        size_t off_child; /**< 노드에서 자식 배열이 시작하는 위치 */
+        size_t off_values; /**< 노드에서 값 배열이 시작하는 위치 */
+
+        unsigned long retries; /**< 쓰기와 겹쳐서 탐색을 다시 한 횟수 */
+};
+
+struct btree_shm *btree_shm_create(const char *name, int min_degree,
+                                   size_t size);
+struct btree_shm *btree_shm_open(const char *name);
+int btree_shm_insert(struct btree_shm *shm, key_t key, uint64_t value);
+int btree_shm_delete(struct btree_shm *shm, key_t key);
+int btree_shm_search(struct btree_shm *shm, key_t key, uint64_t *value);
+void btree_shm_close(struct btree_shm *shm);
+int btree_shm_unlink(const char *name);
+
+#endif
@@ -0,0 +1,739 @@
+/**
+ * @file btree-str.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 가변 길이 바이트 문자열을 키로 하는 prefix B+-Tree의 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details Bayer와 Unterauer의 prefix B-Tree를 따른다.
+ *
+ * - 노드마다 모든 키가 공유하는 접두사를 한 번만 저장한다(prefix truncation).
+ * - 잎을 분할할 때 부모로 올리는 구분 키는 왼쪽의 마지막 키와 오른쪽의 첫 키를
+ *   구분하는 가장 짧은 접두사로 줄인다(suffix truncation).
+ *
+ * 노드는 키의 수가 아닌 바이트 단위로 가득 찬다. 셀이 들어가지 않거나 새 키가
+ * 노드의 접두사를 공유하지 않으면 노드 전체를 다시 쓰며, 그래도 넘치면 두 노드가
+ * 모두 들어가는 위치 중에서 바이트 수가 가장 고르게 나뉘는 곳에서 분할한다.
+ *
+ * 삭제는 잎이 완전히 비었을 때에만 노드를 해제하고 병합은 하지 않는다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "btree.h"
+#include "btree-str.h"
+
+#define B_TREE_STR_HEADER offsetof(struct btree_str_node, slot)
+#define B_TREE_STR_CELL_HEADER (sizeof(void *) + sizeof(uint16_t))
+#define B_TREE_STR_MAX_ENTRIES                                                 \
+        ((B_TREE_STR_NODE_SIZE - B_TREE_STR_HEADER) /                          \
+                 (sizeof(uint16_t) + B_TREE_STR_CELL_HEADER) +                 \
+         1)
+
+/**
+ * @brief 노드를 다시 쓸 때 키 하나를 가리킨다. 키는 접두사와 나머지를 이은 것이다.
+ */
+struct btree_str_entry {
+        const uint8_t *prefix;
+        size_t prefix_len;
+        const uint8_t *suffix;
+        size_t suffix_len;
+        void *ptr;
+};
+
+/**
+ * @brief 분할된 노드를 부모에게 알려주기 위한 정보에 해당한다.
+ */
+struct btree_str_split {
+        uint8_t key[B_TREE_STR_MAX_KEY]; /**< 오른쪽 노드의 구분 키 */
+        size_t len;
+        struct btree_str_node *right;
+};
+
+static inline uint8_t *btree_str_base(const struct btree_str_node *x)
+{
+        return (uint8_t *)x;
+}
+
+static inline const uint8_t *btree_str_prefix(const struct btree_str_node *x)
+{
+        return btree_str_base(x) + B_TREE_STR_NODE_SIZE - x->prefix_len;
+}
+
+/**
+ * @brief i번째 셀의 나머지 키와 포인터를 가져온다.
+ */
+static inline const uint8_t *btree_str_cell(const struct btree_str_node *x,
+                                            int i, size_t *len, void **ptr)
+{
+        const uint8_t *cell = btree_str_base(x) + x->slot[i];
+        uint16_t cell_len = 0;
+
+        memcpy(&cell_len, cell + sizeof(void *), sizeof(uint16_t));
+        if (ptr) {
+                memcpy(ptr, cell, sizeof(void *));
+        }
+        *len = cell_len;
+        return cell + B_TREE_STR_CELL_HEADER;
+}
+
+static inline struct btree_str_node *
+btree_str_child(const struct btree_str_node *x, int i)
+{
+        void *ptr = x->child0;
+        size_t len = 0;
+
+        if (i > 0) {
+                btree_str_cell(x, i - 1, &len, &ptr);
+        }
+        return (struct btree_str_node *)ptr;
+}
+
+static inline size_t btree_str_free_space(const struct btree_str_node *x)
+{
+        return x->heap - (B_TREE_STR_HEADER + x->n * sizeof(uint16_t));
+}
+
+static inline int btree_str_cmp(const uint8_t *a, size_t alen,
+                                const uint8_t *b, size_t blen)
+{
+        const int ret = memcmp(a, b, alen < blen ? alen : blen);
+
+        if (ret) {
+                return ret;
+        }
+        return (alen > blen) - (alen < blen);
+}
+
+static void btree_str_node_init(struct btree_str_node *x, bool is_leaf,
+                                struct btree_str_node *child0)
+{
+        x->n = 0;
+        x->is_leaf = is_leaf;
+        x->prefix_len = 0;
+        x->heap = B_TREE_STR_NODE_SIZE;
+        x->garbage = 0;
+        x->child0 = child0;
+}
+
+static struct btree_str_node *btree_str_alloc_node(void)
+{
+        return (struct btree_str_node *)aligned_alloc(B_TREE_STR_NODE_SIZE,
+                                                      B_TREE_STR_NODE_SIZE);
+}
+
+/**
+ * @brief 노드에서 key의 위치를 이진 탐색으로 찾는다.
+ * @details 먼저 노드의 접두사와 한 번 비교하여 키가 노드의 모든 키보다 작거나
+ * 큰 경우를 걸러내고, 그렇지 않으면 나머지 키끼리만 비교한다.
+ *
+ * @param upper 거짓이면 key 이상인 첫 위치를, 참이면 key보다 큰 첫 위치를 찾는다.
+ * @param found 같은 키가 있는 지가 저장된다. upper가 거짓일 때에만 의미가 있다.
+ * @return int 찾은 위치를 반환한다.
+ */
+static int btree_str_node_search(const struct btree_str_node *x,
+                                 const uint8_t *key, size_t len, bool upper,
+                                 bool *found)
+{
+        const size_t plen = x->prefix_len;
+        const int ret = memcmp(key, btree_str_prefix(x), len < plen ? len : plen);
+        int lo = 0, hi = x->n;
+
+        *found = false;
+        if (ret < 0 || (ret == 0 && len < plen)) {
+                return 0;
+        }
+        if (ret > 0) {
+                return x->n;
+        }
+
+        key += plen;
+        len -= plen;
+        while (lo < hi) {
+                const int mid = (lo + hi) / 2;
+                size_t cell_len = 0;
+                const uint8_t *cell = btree_str_cell(x, mid, &cell_len, NULL);
+                const int c = btree_str_cmp(cell, cell_len, key, len);
+
+                if (c == 0 && !upper) {
+                        *found = true;
+                }
+                if (c < 0 || (upper && c == 0)) {
+                        lo = mid + 1;
+                } else {
+                        hi = mid;
+                }
+        }
+        return lo;
+}
+
+static inline size_t btree_str_entry_len(const struct btree_str_entry *e)
+{
+        return e->prefix_len + e->suffix_len;
+}
+
+static inline uint8_t btree_str_entry_byte(const struct btree_str_entry *e,
+                                           size_t j)
+{
+        return j < e->prefix_len ? e->prefix[j] : e->suffix[j - e->prefix_len];
+}
+
+/**
+ * @brief 두 키의 공통 접두사의 길이를 구한다.
+ */
+static size_t btree_str_entry_lcp(const struct btree_str_entry *a,
+                                  const struct btree_str_entry *b)
+{
+        const size_t alen = btree_str_entry_len(a);
+        const size_t blen = btree_str_entry_len(b);
+        const size_t n = alen < blen ? alen : blen;
+        size_t j = 0;
+
+        if (a->prefix == b->prefix && a->prefix_len == b->prefix_len) {
+                j = a->prefix_len; /**< 같은 노드의 키는 접두사를 비교하지 않는다. */
+        }
+        while (j < n && btree_str_entry_byte(a, j) == btree_str_entry_byte(b, j)) {
+                j++;
+        }
+        return j;
+}
+
+static void btree_str_entry_copy(const struct btree_str_entry *e, size_t from,
+                                 uint8_t *dst, size_t count)
+{
+        if (from < e->prefix_len) {
+                const size_t n = e->prefix_len - from < count ?
+                                         e->prefix_len - from :
+                                         count;
+                memcpy(dst, e->prefix + from, n);
+                dst += n;
+                count -= n;
+                from += n;
+        }
+        memcpy(dst, e->suffix + (from - e->prefix_len), count);
+}
+
+/**
+ * @brief entries[a, b)를 접두사 plen으로 한 노드에 담을 때의 크기를 구한다.
+ */
+static size_t btree_str_size(const struct btree_str *T, int a, int b,
+                             size_t plen)
+{
+        const size_t n = (size_t)(b - a);
+
+        return B_TREE_STR_HEADER + plen +
+               n * (sizeof(uint16_t) + B_TREE_STR_CELL_HEADER - plen) +
+               (T->lens[b] - T->lens[a]);
+}
+
+/**
+ * @brief entries[a, b)가 공유하는 접두사의 길이를 구한다.
+ */
+static size_t btree_str_range_prefix(const struct btree_str *T, int a, int b)
+{
+        if ((T->flags & B_TREE_STR_F_FULL_KEYS) || a == b) {
+                return 0;
+        }
+        return btree_str_entry_lcp(&T->entries[a], &T->entries[b - 1]);
+}
+
+/**
+ * @brief entries[a, b)로 노드 x를 새로 쓴다.
+ * @warning x는 entries가 가리키는 노드와 달라야 한다.
+ */
+static void btree_str_build(const struct btree_str *T, struct btree_str_node *x,
+                            int a, int b, bool is_leaf,
+                            struct btree_str_node *child0)
+{
+        const size_t plen = btree_str_range_prefix(T, a, b);
+        uint8_t *base = btree_str_base(x);
+
+        btree_str_node_init(x, is_leaf, child0);
+        x->prefix_len = (uint16_t)plen;
+        x->heap = (uint16_t)(B_TREE_STR_NODE_SIZE - plen);
+        if (plen) {
+                btree_str_entry_copy(&T->entries[a], 0, base + x->heap, plen);
+        }
+        for (int i = a; i < b; i++) {
+                const struct btree_str_entry *e = &T->entries[i];
+                const uint16_t len = (uint16_t)(btree_str_entry_len(e) - plen);
+                uint8_t *cell = NULL;
+
+                x->heap -= B_TREE_STR_CELL_HEADER + len;
+                cell = base + x->heap;
+                memcpy(cell, &e->ptr, sizeof(void *));
+                memcpy(cell + sizeof(void *), &len, sizeof(uint16_t));
+                btree_str_entry_copy(e, plen, cell + B_TREE_STR_CELL_HEADER,
+                                     len);
+                x->slot[x->n++] = x->heap;
+        }
+}
+
+/**
+ * @brief 노드 x의 셀과 새 키를 합쳐 entries를 채운다.
+ *
+ * @return int entries의 수를 반환한다.
+ */
+static int btree_str_gather(struct btree_str *T, const struct btree_str_node *x,
+                            const uint8_t *key, size_t len, void *ptr, int pos)
+{
+        const uint8_t *prefix = btree_str_prefix(x);
+        int m = 0;
+
+        for (int i = 0; i <= x->n; i++) {
+                struct btree_str_entry *e = &T->entries[m];
+
+                if (i == pos) {
+                        e->prefix = key;
+                        e->prefix_len = 0;
+                        e->suffix = key;
+                        e->suffix_len = len;
+                        e->ptr = ptr;
+                        T->lens[m + 1] = T->lens[m] + len;
+                        e = &T->entries[++m];
+                }
+                if (i == x->n) {
+                        break;
+                }
+                e->prefix = prefix;
+                e->prefix_len = x->prefix_len;
+                e->suffix = btree_str_cell(x, i, &e->suffix_len, &e->ptr);
+                T->lens[m + 1] = T->lens[m] + btree_str_entry_len(e);
+                m++;
+        }
+        return m;
+}
+
+/**
+ * @brief 분할할 위치를 고른다.
+ * @details 먼저 전체의 접두사로 크기를 어림하여 가운데 근처에서 찾고, 없으면
+ * 모든 위치를 각 쪽의 실제 접두사로 따져본다. 새 키가 노드의 접두사를 공유하지
+ * 않는 경우에는 새 키가 한쪽 끝에 있으므로 그 자리에서 나누면 항상 들어간다.
+ *
+ * @return int 오른쪽이 시작하는 위치를, 찾지 못하면 -1을 반환한다.
+ * 내부 노드에서는 그 위치의 키가 부모로 올라간다.
+ */
+static int btree_str_choose_split(const struct btree_str *T, int m,
+                                  bool is_leaf)
+{
+        const size_t whole = btree_str_range_prefix(T, 0, m);
+        const int skip = is_leaf ? 0 : 1;
+        size_t best_diff = (size_t)-1;
+        int best = -1;
+
+        for (int pass = 0; pass < 2 && best < 0; pass++) {
+                for (int k = 1; k + skip < m; k++) {
+                        const size_t lp =
+                                pass ? btree_str_range_prefix(T, 0, k) : whole;
+                        const size_t rp = pass ? btree_str_range_prefix(
+                                                         T, k + skip, m) :
+                                                 whole;
+                        const size_t l = btree_str_size(T, 0, k, lp);
+                        const size_t r = btree_str_size(T, k + skip, m, rp);
+                        const size_t diff = l > r ? l - r : r - l;
+
+                        if (l <= B_TREE_STR_NODE_SIZE &&
+                            r <= B_TREE_STR_NODE_SIZE && diff < best_diff) {
+                                best = k;
+                                best_diff = diff;
+                        }
+                }
+        }
+        return best;
+}
+
+/**
+ * @brief 노드 x의 pos 위치에 (key, ptr)을 넣는다.
+ * @details 접두사를 공유하고 자리가 있으면 셀 하나만 쓴다. 그렇지 않으면
+ * 노드를 다시 쓰며, 넘치는 경우에는 분할하여 오른쪽 노드와 구분 키를 split에 넣는다.
+ *
+ * @return int 분할하지 않은 경우에는 0을, 분할한 경우에는 1을,
+ * 실패 시에는 음수의 errno를 반환한다.
+ */
+static int btree_str_insert_entry(struct btree_str *T, struct btree_str_node *x,
+                                  const uint8_t *key, size_t len, void *ptr,
+                                  int pos, struct btree_str_split *split)
+{
+        const size_t plen = x->prefix_len;
+        struct btree_str_node *right = NULL;
+        const bool is_leaf = x->is_leaf;
+        int m = 0, k = 0;
+
+        if (len >= plen && !memcmp(key, btree_str_prefix(x), plen) &&
+            btree_str_free_space(x) >=
+                    sizeof(uint16_t) + B_TREE_STR_CELL_HEADER + len - plen) {
+                const uint16_t suffix_len = (uint16_t)(len - plen);
+                uint8_t *cell = NULL;
+
+                x->heap -= B_TREE_STR_CELL_HEADER + suffix_len;
+                cell = btree_str_base(x) + x->heap;
+                memcpy(cell, &ptr, sizeof(void *));
+                memcpy(cell + sizeof(void *), &suffix_len, sizeof(uint16_t));
+                memcpy(cell + B_TREE_STR_CELL_HEADER, key + plen, suffix_len);
+                memmove(&x->slot[pos + 1], &x->slot[pos],
+                        (x->n - pos) * sizeof(uint16_t));
+                x->slot[pos] = x->heap;
+                x->n++;
+                return 0;
+        }
+
+        m = btree_str_gather(T, x, key, len, ptr, pos);
+        if (btree_str_size(T, 0, m, btree_str_range_prefix(T, 0, m)) <=
+            B_TREE_STR_NODE_SIZE) {
+                btree_str_build(T, T->scratch, 0, m, is_leaf, x->child0);
+                memcpy(x, T->scratch, B_TREE_STR_NODE_SIZE);
+                return 0;
+        }
+
+        k = btree_str_choose_split(T, m, is_leaf);
+        if (k < 0 || T->nr_spare == 0) {
+                pr_info("Cannot split string node\n");
+                return -ENOSPC;
+        }
+        right = T->spare[--T->nr_spare];
+        if (is_leaf) {
+                const struct btree_str_entry *l = &T->entries[k - 1];
+                const struct btree_str_entry *r = &T->entries[k];
+
+                split->len = btree_str_entry_len(r);
+                if (!(T->flags & B_TREE_STR_F_FULL_KEYS)) {
+                        split->len = btree_str_entry_lcp(l, r) + 1;
+                }
+                btree_str_entry_copy(r, 0, split->key, split->len);
+                btree_str_build(T, right, k, m, true, NULL);
+        } else {
+                const struct btree_str_entry *mid = &T->entries[k];
+
+                split->len = btree_str_entry_len(mid);
+                btree_str_entry_copy(mid, 0, split->key, split->len);
+                btree_str_build(T, right, k + 1, m, false,
+                                (struct btree_str_node *)mid->ptr);
+        }
+        btree_str_build(T, T->scratch, 0, k, is_leaf, x->child0);
+        memcpy(x, T->scratch, B_TREE_STR_NODE_SIZE);
+        split->right = right;
+        T->nr_nodes++;
+        return 1;
+}
+
+/**
+ * @brief 노드 x의 pos번째 셀을 지운다. 셀의 공간은 노드를 다시 쓸 때 회수한다.
+ */
+static void btree_str_remove_entry(struct btree_str_node *x, int pos)
+{
+        size_t len = 0;
+
+        btree_str_cell(x, pos, &len, NULL);
+        x->garbage += B_TREE_STR_CELL_HEADER + len;
+        x->n--;
+        memmove(&x->slot[pos], &x->slot[pos + 1],
+                (x->n - pos) * sizeof(uint16_t));
+}
+
+/**
+ * @brief 분할에 쓸 노드를 높이보다 하나 더 많이 미리 할당해 둔다.
+ * @details 삽입 도중에 할당이 실패하면 트리가 어중간한 상태로 남게 되므로
+ * 트리를 바꾸기 전에 필요한 노드를 모두 확보한다.
+ */
+static int btree_str_reserve(struct btree_str *T)
+{
+        while (T->nr_spare < T->height + 1) {
+                struct btree_str_node *x = btree_str_alloc_node();
+                if (!x) {
+                        pr_info("Node allocation failed...\n");
+                        return -ENOMEM;
+                }
+                T->spare[T->nr_spare++] = x;
+        }
+        return 0;
+}
+
+/**
+ * @brief 문자열 B+-Tree를 할당한다.
+ *
+ * @param flags B_TREE_STR_F_FULL_KEYS를 주면 키를 줄이지 않고 그대로 저장한다.
+ * @return struct btree_str* 할당된 트리를, 실패 시에는 NULL을 반환한다.
+ */
+struct btree_str *btree_str_alloc(unsigned int flags)
+{
+        struct btree_str *tree =
+                (struct btree_str *)calloc(1, sizeof(struct btree_str));
+
+        if (!tree) {
+                pr_info("Allocation tree failed\n");
+                return NULL;
+        }
+        tree->flags = flags;
+        tree->height = 1;
+        tree->root = btree_str_alloc_node();
+        tree->scratch = btree_str_alloc_node();
+        tree->entries = (struct btree_str_entry *)malloc(
+                B_TREE_STR_MAX_ENTRIES * sizeof(struct btree_str_entry));
+        tree->lens = (size_t *)malloc((B_TREE_STR_MAX_ENTRIES + 1) *
+                                      sizeof(size_t));
+        if (!tree->root || !tree->scratch || !tree->entries || !tree->lens) {
+                pr_info("Allocation tree failed\n");
+                goto exception;
+        }
+        btree_str_node_init(tree->root, true, NULL);
+        tree->lens[0] = 0;
+        tree->nr_nodes = 1;
+        return tree;
+exception:
+        free(tree->root);
+        free(tree->scratch);
+        free(tree->entries);
+        free(tree->lens);
+        free(tree);
+        return NULL;
+}
+
+static void __btree_str_free(struct btree_str_node *x)
+{
+        if (!x->is_leaf) {
+                for (int i = 0; i <= x->n; i++) {
+                        __btree_str_free(btree_str_child(x, i));
+                }
+        }
+        free(x);
+}
+
+/**
+ * @brief 문자열 B+-Tree를 해제한다. 값은 해제하지 않는다.
+ */
+void btree_str_free(struct btree_str *tree)
+{
+        if (tree) {
+                __btree_str_free(tree->root);
+                for (int i = 0; i < tree->nr_spare; i++) {
+                        free(tree->spare[i]);
+                }
+                free(tree->scratch);
+                free(tree->entries);
+                free(tree->lens);
+                free(tree);
+        }
+}
+
+static int __btree_str_insert(struct btree_str *T, struct btree_str_node *x,
+                              const uint8_t *key, size_t len, void *value,
+                              struct btree_str_split *split)
+{
+        struct btree_str_split child_split;
+        bool found = false;
+        int pos = 0, ret = 0;
+
+        if (x->is_leaf) {
+                pos = btree_str_node_search(x, key, len, false, &found);
+                if (found) {
+                        return -EEXIST;
+                }
+                return btree_str_insert_entry(T, x, key, len, value, pos,
+                                              split);
+        }
+
+        pos = btree_str_node_search(x, key, len, true, &found);
+        ret = __btree_str_insert(T, btree_str_child(x, pos), key, len, value,
+                                 &child_split);
+        if (ret != 1) {
+                return ret;
+        }
+        return btree_str_insert_entry(T, x, child_split.key, child_split.len,
+                                      child_split.right, pos, split);
+}
+
+/**
+ * @brief 키와 값을 삽입한다.
+ *
+ * @param tree 문자열 B+-Tree에 해당한다.
+ * @param key 키의 시작 주소로 NUL로 끝나지 않아도 된다.
+ * @param len 키의 길이로 B_TREE_STR_MAX_KEY를 넘을 수 없다.
+ * @param value 키와 함께 저장할 값에 해당한다.
+ * @return int 성공 시에 0을, 이미 있는 키이면 -EEXIST를, 키가 너무 길면
+ * -E2BIG을, 할당에 실패하면 -ENOMEM을 반환한다. 실패한 경우 트리는 바뀌지 않는다.
+ */
+int btree_str_insert(struct btree_str *tree, const void *key, size_t len,
+                     void *value)
+{
+        struct btree_str_split split;
+        struct btree_str_node *root = NULL;
+        int ret = 0;
+
+        if (len > B_TREE_STR_MAX_KEY) {
+                return -E2BIG;
+        }
+        if (tree->height == B_TREE_STR_MAX_HEIGHT) {
+                return -ERANGE;
+        }
+        ret = btree_str_reserve(tree);
+        if (ret) {
+                return ret;
+        }
+
+        ret = __btree_str_insert(tree, tree->root, (const uint8_t *)key, len,
+                                 value, &split);
+        if (ret == 1) {
+                root = tree->spare[--tree->nr_spare];
+                btree_str_node_init(root, false, tree->root);
+                btree_str_insert_entry(tree, root, split.key, split.len,
+                                       split.right, 0, NULL);
+                tree->root = root;
+                tree->height++;
+                tree->nr_nodes++;
+        }
+        if (ret < 0) {
+                return ret;
+        }
+        tree->nr_keys++;
+        return 0;
+}
+
+/**
+ * @brief 키에 해당하는 값을 찾는다.
+ *
+ * @param value 찾은 값이 저장될 위치로 NULL이어도 된다.
+ * @return int 찾은 경우에는 0을, 없는 경우에는 -ENOENT를 반환한다.
+ */
+int btree_str_search(struct btree_str *tree, const void *key, size_t len,
+                     void **value)
+{
+        struct btree_str_node *x = tree->root;
+        bool found = false;
+        int pos = 0;
+
+        while (!x->is_leaf) {
+                pos = btree_str_node_search(x, (const uint8_t *)key, len, true,
+                                            &found);
+                x = btree_str_child(x, pos);
+        }
+        pos = btree_str_node_search(x, (const uint8_t *)key, len, false,
+                                    &found);
+        if (!found) {
+                return -ENOENT;
+        }
+        if (value) {
+                size_t cell_len = 0;
+                btree_str_cell(x, pos, &cell_len, value);
+        }
+        return 0;
+}
+
+/**
+ * @return int 성공 시에 0을, x가 비게 되어 부모가 지워야 하면 1을,
+ * 키가 없으면 -EINVAL을 반환한다.
+ */
+static int __btree_str_delete(struct btree_str *T, struct btree_str_node *x,
+                              const uint8_t *key, size_t len)
+{
+        bool found = false;
+        int pos = 0, ret = 0;
+
+        if (x->is_leaf) {
+                pos = btree_str_node_search(x, key, len, false, &found);
+                if (!found) {
+                        return -EINVAL;
+                }
+                btree_str_remove_entry(x, pos);
+                return x->n == 0 ? 1 : 0;
+        }
+
+        pos = btree_str_node_search(x, key, len, true, &found);
+        ret = __btree_str_delete(T, btree_str_child(x, pos), key, len);
+        if (ret != 1) {
+                return ret;
+        }
+        free(btree_str_child(x, pos));
+        T->nr_nodes--;
+        if (x->n == 0) {
+                return 1;
+        }
+        if (pos == 0) {
+                x->child0 = btree_str_child(x, 1);
+                btree_str_remove_entry(x, 0);
+        } else {
+                btree_str_remove_entry(x, pos - 1);
+        }
+        return 0;
+}
+
+/**
+ * @brief 키를 삭제한다.
+ *
+ * @return int 성공 시에 0을, 키가 없으면 -EINVAL을 반환한다.
+ */
+int btree_str_delete(struct btree_str *tree, const void *key, size_t len)
+{
+        int ret = __btree_str_delete(tree, tree->root, (const uint8_t *)key,
+                                     len);
+
+        if (ret < 0) {
+                return ret;
+        }
+        if (ret == 1 && !tree->root->is_leaf) { /**< 모든 잎이 사라졌다. */
+                btree_str_node_init(tree->root, true, NULL);
+                tree->height = 1;
+        }
+        while (!tree->root->is_leaf && tree->root->n == 0) {
+                struct btree_str_node *root = tree->root;
+                tree->root = root->child0;
+                tree->height--;
+                tree->nr_nodes--;
+                free(root);
+        }
+        tree->nr_keys--;
+        return 0;
+}
+
+static int __btree_str_scan(struct btree_str_node *x, const uint8_t *start,
+                            size_t len, int *remain, btree_str_visit_fn fn,
+                            void *private, uint8_t *buf)
+{
+        bool found = false;
+        int i = btree_str_node_search(x, start, len, !x->is_leaf, &found);
+        int ret = 0;
+
+        if (!x->is_leaf) {
+                for (; i <= x->n && *remain > 0; i++) {
+                        ret = __btree_str_scan(btree_str_child(x, i), start,
+                                               len, remain, fn, private, buf);
+                        if (ret) {
+                                return ret;
+                        }
+                }
+                return 0;
+        }
+
+        memcpy(buf, btree_str_prefix(x), x->prefix_len);
+        for (; i < x->n && *remain > 0; i++) {
+                size_t cell_len = 0;
+                void *value = NULL;
+                const uint8_t *cell = btree_str_cell(x, i, &cell_len, &value);
+
+                memcpy(buf + x->prefix_len, cell, cell_len);
+                *remain -= 1;
+                ret = fn(buf, x->prefix_len + cell_len, value, private);
+                if (ret) {
+                        return ret;
+                }
+        }
+        return 0;
+}
+
+/**
+ * @brief start 이상인 키를 순서대로 최대 count개 방문한다.
+ *
+ * @return int 방문한 키의 수를 반환한다. fn이 0이 아닌 값을 반환하면
+ * 그 키까지 세고 방문을 멈춘다.
+ */
+int btree_str_scan(struct btree_str *tree, const void *start, size_t len,
+                   int count, btree_str_visit_fn fn, void *private)
+{
+        uint8_t buf[B_TREE_STR_MAX_KEY];
+        int remain = count;
+
+        __btree_str_scan(tree->root, (const uint8_t *)start, len, &remain, fn,
+                         private, buf);
+        return count - remain;
+}
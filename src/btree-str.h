@@ -0,0 +1,77 @@
+/**
+ * @file btree-str.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 가변 길이 바이트 문자열을 키로 하는 prefix B+-Tree에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _B_TREE_STR_H
+#define _B_TREE_STR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define B_TREE_STR_NODE_SIZE 4096 /**< 노드 하나의 크기로 페이지에 맞춘다. */
+#define B_TREE_STR_MAX_KEY 512 /**< 노드에 셀이 여러 개 들어가도록 키의 길이를 제한한다. */
+#define B_TREE_STR_MAX_HEIGHT 32
+
+#define B_TREE_STR_F_FULL_KEYS (1 << 0) /**< 접두사 압축과 구분 키 줄이기를 하지 않는다. */
+
+/**
+ * @brief 문자열 B+-Tree의 노드에 해당한다. 크기는 항상 B_TREE_STR_NODE_SIZE이다.
+ * @details 노드는 slotted page 형태로 앞쪽에는 셀의 위치(slot)가 키 순서대로
+ * 놓이고, 셀은 노드의 뒤쪽에서 앞쪽으로 자라는 힙에 놓인다. 노드의 모든 키가
+ * 공유하는 접두사는 노드의 맨 끝에 한 번만 저장하고, 셀에는 나머지(suffix)만 둔다.
+ *
+ * 셀은 [void *ptr][uint16_t len][len 바이트]로, ptr은 잎에서는 값을, 내부 노드에서는
+ * 구분 키의 오른쪽 자식을 가리킨다. 내부 노드의 맨 왼쪽 자식은 child0에 둔다.
+ */
+struct btree_str_node {
+        uint16_t n; /**< 셀(키)의 수 */
+        uint16_t is_leaf;
+        uint16_t prefix_len; /**< 노드의 끝에 저장된 공통 접두사의 길이 */
+        uint16_t heap; /**< 힙의 시작 위치 */
+        uint16_t garbage; /**< 삭제되어 힙에 남아있는 바이트의 수 */
+        struct btree_str_node *child0;
+        uint16_t slot[];
+};
+
+/**
+ * @brief 문자열 B+-Tree에 해당한다.
+ */
+struct btree_str {
+        struct btree_str_node *root;
+        unsigned int flags;
+        int height; /**< 잎만 있으면 1이다. */
+        unsigned long nr_keys;
+        unsigned long nr_nodes;
+
+        struct btree_str_node *spare[B_TREE_STR_MAX_HEIGHT + 1]; /**< 분할에 쓸 예비 노드 */
+        int nr_spare;
+        struct btree_str_node *scratch; /**< 노드를 다시 쓸 때의 임시 공간 */
+        struct btree_str_entry *entries;
+        size_t *lens;
+};
+
+/**
+ * @brief 문자열 B+-Tree의 항목을 방문할 때 호출되는 함수의 형태에 해당한다.
+ * @return int 0이 아닌 값을 반환하면 순회를 중단한다.
+ */
+typedef int (*btree_str_visit_fn)(const void *key, size_t len, void *value,
+                                  void *private);
+
+struct btree_str *btree_str_alloc(unsigned int flags);
+void btree_str_free(struct btree_str *tree);
+int btree_str_insert(struct btree_str *tree, const void *key, size_t len,
+                     void *value);
+int btree_str_search(struct btree_str *tree, const void *key, size_t len,
+                     void **value);
+int btree_str_delete(struct btree_str *tree, const void *key, size_t len);
+int btree_str_scan(struct btree_str *tree, const void *start, size_t len,
+                   int count, btree_str_visit_fn fn, void *private);
+
+#endif
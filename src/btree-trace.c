@@ -0,0 +1,225 @@
+/**
+ * @file btree-trace.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief B-Tree 연산의 기록과 그 읽기에 대한 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 기록은 프로세스에 하나만 열 수 있으며, 여러 스레드에서 연산을
+ * 수행하더라도 잠금으로 레코드가 섞이지 않도록 한다. 값은 LEB128 varint로
+ * 저장하므로 작은 키와 짧은 시간 간격은 몇 바이트만 차지한다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include "btree-trace.h"
+
+#define B_TREE_TRACE_VARINT_MAX 10 /**< 64비트 varint의 최대 길이 */
+
+/**
+ * @brief 현재 열려있는 기록의 상태에 해당한다.
+ */
+static struct {
+        FILE *fp;
+        uint64_t last_ns;
+        unsigned long records;
+        pthread_mutex_t lock;
+} trace = { NULL, 0, 0, PTHREAD_MUTEX_INITIALIZER };
+
+static uint64_t btree_trace_clock(clockid_t clock)
+{
+        struct timespec ts;
+        clock_gettime(clock, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 값을 varint로 buf에 쓰고 쓴 길이를 반환한다.
+ */
+static int btree_trace_put_varint(uint8_t *buf, uint64_t value)
+{
+        int len = 0;
+
+        while (value >= 0x80) {
+                buf[len++] = (uint8_t)(value | 0x80);
+                value >>= 7;
+        }
+        buf[len++] = (uint8_t)value;
+        return len;
+}
+
+/**
+ * @brief 파일에서 varint 하나를 읽는다.
+ *
+ * @return int 성공 시에 0을, 파일이 끝났거나 잘린 경우에는 -1을 반환한다.
+ */
+static int btree_trace_get_varint(FILE *fp, uint64_t *value)
+{
+        uint64_t result = 0;
+
+        for (int shift = 0; shift < 64; shift += 7) {
+                const int c = fgetc(fp);
+                if (c == EOF) {
+                        return -1;
+                }
+                result |= (uint64_t)(c & 0x7f) << shift;
+                if (!(c & 0x80)) {
+                        *value = result;
+                        return 0;
+                }
+        }
+        return -1;
+}
+
+/**
+ * @brief 연산의 기록을 시작하도록 한다.
+ *
+ * @param path 기록 파일의 경로로 이미 있으면 덮어쓴다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int btree_trace_open(const char *path)
+{
+        struct btree_trace_header header = {
+                .magic = B_TREE_TRACE_MAGIC,
+                .version = B_TREE_TRACE_VERSION,
+                .start_ns = btree_trace_clock(CLOCK_REALTIME),
+        };
+        FILE *fp = fopen(path, "wb");
+        int ret = 0;
+
+        if (!fp) {
+                pr_info("Cannot open trace file(%s)\n", path);
+                return -errno;
+        }
+        if (fwrite(&header, sizeof(header), 1, fp) != 1) {
+                fclose(fp);
+                return -EIO;
+        }
+
+        pthread_mutex_lock(&trace.lock);
+        if (trace.fp) {
+                ret = -EBUSY;
+        } else {
+                trace.fp = fp;
+                trace.last_ns = btree_trace_clock(CLOCK_MONOTONIC);
+                trace.records = 0;
+        }
+        pthread_mutex_unlock(&trace.lock);
+
+        if (ret) {
+                fclose(fp);
+        }
+        return ret;
+}
+
+/**
+ * @brief 연산 하나를 기록하도록 한다. 기록이 열려있지 않으면 무시한다.
+ *
+ * @param op 연산의 종류에 해당한다.
+ * @param key 연산의 대상 키에 해당한다.
+ */
+void btree_trace_record(enum btree_trace_op op, key_t key)
+{
+        uint8_t buf[2 * B_TREE_TRACE_VARINT_MAX];
+        uint64_t now = 0;
+        int len = 0;
+
+        pthread_mutex_lock(&trace.lock);
+        if (trace.fp) {
+                now = btree_trace_clock(CLOCK_MONOTONIC);
+                len = btree_trace_put_varint(
+                        buf, ((now - trace.last_ns) << 2) | (uint64_t)op);
+                len += btree_trace_put_varint(buf + len, key);
+                fwrite(buf, len, 1, trace.fp);
+                trace.last_ns = now;
+                trace.records++;
+        }
+        pthread_mutex_unlock(&trace.lock);
+}
+
+/**
+ * @brief 기록을 끝내고 파일을 닫는다.
+ *
+ * @return unsigned long 기록한 레코드의 수를 반환한다.
+ */
+unsigned long btree_trace_close(void)
+{
+        unsigned long records = 0;
+
+        pthread_mutex_lock(&trace.lock);
+        if (trace.fp) {
+                fclose(trace.fp);
+                trace.fp = NULL;
+                records = trace.records;
+        }
+        pthread_mutex_unlock(&trace.lock);
+        return records;
+}
+
+/**
+ * @brief 기록 파일을 읽기 위해 열도록 한다.
+ *
+ * @param reader 읽기 상태가 초기화될 위치에 해당한다.
+ * @param path 기록 파일의 경로에 해당한다.
+ * @return int 성공 시에 0을, 파일이 없거나 올바르지 않으면 음수의 errno를 반환한다.
+ */
+int btree_trace_reader_open(struct btree_trace_reader *reader,
+                            const char *path)
+{
+        memset(reader, 0, sizeof(struct btree_trace_reader));
+        reader->fp = fopen(path, "rb");
+        if (!reader->fp) {
+                pr_info("Cannot open trace file(%s)\n", path);
+                return -errno;
+        }
+        if (fread(&reader->header, sizeof(reader->header), 1, reader->fp) != 1 ||
+            reader->header.magic != B_TREE_TRACE_MAGIC ||
+            reader->header.version != B_TREE_TRACE_VERSION) {
+                pr_info("Invalid trace file(%s)\n", path);
+                fclose(reader->fp);
+                reader->fp = NULL;
+                return -EINVAL;
+        }
+        return 0;
+}
+
+/**
+ * @brief 다음 레코드를 읽도록 한다.
+ *
+ * @param reader 읽기 상태에 해당한다.
+ * @param record 읽은 레코드가 채워질 위치에 해당한다.
+ * @return int 레코드를 읽은 경우에는 1을, 파일이 끝난 경우에는 0을 반환한다.
+ * 마지막 레코드가 잘려있는 경우에도 끝난 것으로 본다.
+ */
+int btree_trace_next(struct btree_trace_reader *reader,
+                     struct btree_trace_record *record)
+{
+        uint64_t head = 0;
+        uint64_t key = 0;
+
+        if (btree_trace_get_varint(reader->fp, &head) ||
+            btree_trace_get_varint(reader->fp, &key)) {
+                return 0;
+        }
+        record->op = (enum btree_trace_op)(head & 0x3);
+        record->delta_ns = head >> 2;
+        record->key = (key_t)key;
+        reader->records++;
+        return 1;
+}
+
+/**
+ * @brief 기록 파일을 닫는다.
+ */
+void btree_trace_reader_close(struct btree_trace_reader *reader)
+{
+        if (reader->fp) {
+                fclose(reader->fp);
+                reader->fp = NULL;
+        }
+}
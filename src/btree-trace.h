@@ -0,0 +1,79 @@
+/**
+ * @file btree-trace.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief B-Tree 연산의 기록(trace)과 그 읽기에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _B_TREE_TRACE_H
+#define _B_TREE_TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "btree.h"
+
+#define B_TREE_TRACE_MAGIC 0x52545442u /**< "BTTR" */
+#define B_TREE_TRACE_VERSION 1
+
+/**
+ * @brief 기록되는 연산의 종류에 해당한다. 2비트 안에 들어가야 한다.
+ */
+enum btree_trace_op {
+        B_TREE_TRACE_SEARCH = 1,
+        B_TREE_TRACE_INSERT,
+        B_TREE_TRACE_DELETE,
+};
+
+/**
+ * @brief 기록 파일의 맨 앞에 놓이는 헤더에 해당한다.
+ * @details 헤더 뒤에는 레코드마다 varint((delta_ns << 2) | op)와 varint(key)가
+ * 차례대로 놓인다. delta_ns는 직전 레코드와의 시간 차이이다.
+ */
+struct btree_trace_header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t start_ns; /**< 기록을 시작한 시각(CLOCK_REALTIME)이다. */
+};
+
+/**
+ * @brief 기록 파일에서 읽은 레코드 하나에 해당한다.
+ */
+struct btree_trace_record {
+        enum btree_trace_op op;
+        key_t key;
+        uint64_t delta_ns;
+};
+
+/**
+ * @brief 기록 파일을 읽는 상태에 해당한다.
+ */
+struct btree_trace_reader {
+        FILE *fp;
+        struct btree_trace_header header;
+        unsigned long records;
+};
+
+/**
+ * @brief B_TREE_TRACE로 빌드한 경우에만 연산을 기록한다.
+ * @note 기록하지 않는 빌드에서는 아무런 비용이 없다.
+ */
+#ifdef B_TREE_TRACE
+#define btree_trace(op, key) btree_trace_record(op, key)
+#else
+#define btree_trace(op, key) ((void)0)
+#endif
+
+int btree_trace_open(const char *path);
+void btree_trace_record(enum btree_trace_op op, key_t key);
+unsigned long btree_trace_close(void);
+
+int btree_trace_reader_open(struct btree_trace_reader *reader,
+                            const char *path);
+int btree_trace_next(struct btree_trace_reader *reader,
+                     struct btree_trace_record *record);
+void btree_trace_reader_close(struct btree_trace_reader *reader);
+
+#endif
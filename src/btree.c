@@ -11,9 +11,154 @@
  * @copyright Copyright (c) 2020 오기준
  * 
  */
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
+#include <stdatomic.h>
 #include "btree.h"
+#include "btree-trace.h"
+#include "btree-arena.h"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#define btree_usable_size(ptr) malloc_usable_size(ptr)
+#else
+#define btree_usable_size(ptr) ((size_t)0)
+#endif
+
+/**
+ * @brief struct btree_stats의 항목 순서와 같은 통계의 번호에 해당한다.
+ */
+enum btree_stat {
+        B_TREE_STAT_SEARCHES = 0,
+        B_TREE_STAT_INSERTS,
+        B_TREE_STAT_DELETES,
+        B_TREE_STAT_NODE_VISITS,
+        B_TREE_STAT_KEY_COMPARES,
+        B_TREE_STAT_SPLITS,
+        B_TREE_STAT_MERGES,
+        B_TREE_STAT_BORROW_LEFT,
+        B_TREE_STAT_BORROW_RIGHT,
+        B_TREE_STAT_ROOT_SPLITS,
+        B_TREE_STAT_ROOT_COLLAPSES,
+        NR_B_TREE_STATS,
+};
+
+#ifdef B_TREE_STATS
+/**
+ * @brief 한 스레드가 통계를 세는 공간으로 캐시 라인을 공유하지 않도록 한다.
+ * @details 같은 슬롯을 쓰는 스레드가 없으면 갱신은 경합이 없는 load/store가
+ * 되며, 스레드가 B_TREE_STATS_SLOTS보다 많아 슬롯을 공유하는 경우에만
+ * 일부 갱신이 사라질 수 있다.
+ */
+struct btree_stats_slot {
+        _Alignas(64) atomic_ulong value[NR_B_TREE_STATS];
+};
+
+static atomic_uint btree_stats_next;
+static _Thread_local int btree_stats_self = -1;
+
+/**
+ * @brief 호출한 스레드에 배정된 통계 슬롯의 번호를 반환한다.
+ */
+static inline int btree_stats_slot(void)
+{
+        if (btree_stats_self < 0) {
+                btree_stats_self = (int)(atomic_fetch_add(&btree_stats_next, 1) %
+                                         B_TREE_STATS_SLOTS);
+        }
+        return btree_stats_self;
+}
+
+static inline void __btree_stat_add(struct btree *T, enum btree_stat stat,
+                                    unsigned long val)
+{
+        atomic_ulong *counter = &T->stats[btree_stats_slot()].value[stat];
+        atomic_store_explicit(
+                counter,
+                atomic_load_explicit(counter, memory_order_relaxed) + val,
+                memory_order_relaxed);
+}
+
+#define btree_stat_add(T, stat, val)                                           \
+        __btree_stat_add(T, B_TREE_STAT_##stat, (unsigned long)(val))
+#else
+#define btree_stat_add(T, stat, val) ((void)0)
+#endif
+
+/**
+ * @brief 아레나에서 노드 하나가 차지하는 크기를 구한다.
+ * @details 노드는 [struct btree_node][items][child] 순서로 한 덩어리에 놓이며,
+ * 노드의 n과 앞쪽 items가 같은 캐시 라인에 들어간다.
+ *
+ * @param min_degree 노드의 최소 차수에 해당한다.
+ * @param off_items items 배열의 시작 위치가 저장될 곳에 해당한다.
+ * @param off_child child 배열의 시작 위치가 저장될 곳에 해당한다.
+ * @return size_t 노드 하나의 크기를 반환한다.
+ */
+static size_t btree_arena_layout(int min_degree, size_t *off_items,
+                                 size_t *off_child)
+{
+#ifdef B_TREE_FIXED_DEGREE
+        (void)min_degree;
+        *off_items = offsetof(struct btree_node, items);
+        *off_child = offsetof(struct btree_node, child);
+        return sizeof(struct btree_node);
+#else
+        const size_t align = _Alignof(struct btree_item);
+
+        *off_items = (sizeof(struct btree_node) + align - 1) / align * align;
+        *off_child = *off_items +
+                     B_TREE_NR_KEYS(min_degree) * sizeof(struct btree_item);
+        return *off_child +
+               B_TREE_NR_CHILD(min_degree) * sizeof(struct btree_node *);
+#endif
+}
+
+/**
+ * @brief 노드를 담을 수 있도록 아레나를 초기화한다.
+ *
+ * @param arena 초기화할 아레나에 해당한다.
+ * @param min_degree 아레나에 담을 노드의 최소 차수에 해당한다.
+ */
+void btree_arena_init_node(struct btree_arena *arena, int min_degree)
+{
+        size_t off_items = 0, off_child = 0;
+
+        btree_arena_init(arena,
+                         btree_arena_layout(min_degree, &off_items, &off_child));
+}
+
+/**
+ * @brief 아레나에서 노드를 할당한다.
+ *
+ * @param arena btree_arena_init_node로 초기화한 아레나에 해당한다.
+ * @param min_degree 노드의 최소 차수에 해당한다.
+ * @return struct btree_node* 노드에 대한 포인터를, 실패 시에는 NULL을 반환한다.
+ */
+struct btree_node *btree_arena_alloc_node(struct btree_arena *arena,
+                                          int min_degree)
+{
+        char *block = (char *)btree_arena_alloc(arena);
+        struct btree_node *node = (struct btree_node *)block;
+
+        if (!block) {
+                pr_info("Node allocation failed...\n");
+                return NULL;
+        }
+#ifdef B_TREE_FIXED_DEGREE
+        (void)min_degree;
+#else
+        size_t off_items = 0, off_child = 0;
+
+        btree_arena_layout(min_degree, &off_items, &off_child);
+        node->items = (struct btree_item *)(block + off_items);
+        node->child = (struct btree_node **)(block + off_child);
+#endif
+        return node;
+}
 
 /**
  * @brief B-Tree에 들어갈 노드를 할당을 해주도록 한다.
@@ -27,6 +172,18 @@
 static struct btree_node *btree_alloc_node(struct btree *T)
 {
         struct btree_node *node = NULL;
+
+        if (T->arena) {
+                return btree_arena_alloc_node(T->arena, T->min_degree);
+        }
+
+#ifdef B_TREE_FIXED_DEGREE
+        node = (struct btree_node *)calloc(1, sizeof(struct btree_node));
+        if (!node) {
+                pr_info("Node allocation failed...\n");
+        }
+        return node;
+#else
         const int nr_keys = B_TREE_NR_KEYS(T->min_degree);
         const int nr_child = B_TREE_NR_CHILD(T->min_degree);
 
@@ -37,6 +194,7 @@ static struct btree_node *btree_alloc_node(struct btree *T)
         }
         node->n = 0;
         node->is_leaf = false;
+        node->child = NULL;
         node->items =
                 (struct btree_item *)calloc(nr_keys, sizeof(struct btree_item));
         if (!node->items) {
@@ -51,27 +209,25 @@ static struct btree_node *btree_alloc_node(struct btree *T)
         }
         return node;
 exception:
-        if (node->child) {
+        if (node) {
                 free(node->child);
-        }
-        if (node->items) {
                 free(node->items);
-        }
-        if (node) {
                 free(node);
         }
         return NULL;
+#endif
 }
 
 /**
  * @brief B-Tree에 대한 해제를 수행하도록 한다.
  * 
+ * @param T B-Tree 포인터에 해당한다.
  * @param node 할당 해제를 진행하고자하는 B-Tree의 노드를 지칭한다. 
  * @warning 동적 할당을 하여 data를 관리하는 경우에는 dangling pointer가 발생할 가능성이 매우 높다.
  * 현재 있는 item에 대한 동적 할당 해제 시퀀스는 정확한 임시로 최대한 해제할 수 있도록 만든 것일 뿐이므로
  * 향후 관련해서 수정 및 보완이 필요할 것으로 보인다.
  */
-static void btree_dealloc_node(struct btree_node *node)
+static void btree_dealloc_node(struct btree *T, struct btree_node *node)
 {
         if (node != NULL) {
 #ifdef B_TREE_DEALLOC_ITEM
@@ -81,12 +237,18 @@ static void btree_dealloc_node(struct btree_node *node)
                         }
                 }
 #endif
+                if (T->arena) {
+                        btree_arena_free(T->arena, node);
+                        return;
+                }
+#ifndef B_TREE_FIXED_DEGREE
                 if (node->child) {
                         free(node->child);
                 }
                 if (node->items) {
                         free(node->items);
                 }
+#endif
                 free(node);
         }
 }
@@ -95,12 +257,15 @@ static void btree_dealloc_node(struct btree_node *node)
  * @brief 새로운 B-Tree를 할당을 하도록 한다.
  * 
  * @param min_degree 노드가 가지는 최소 차수를 의미한다. 이 값이 2이면 2-3-4 트리에 해당한다.
+ * @param flags B_TREE_F_ARENA를 주면 노드를 64바이트 경계에 맞추어 huge page
+ * 영역에서 할당한다.
  * @return struct btree* 정상 할당이 된 경우에는 B-Tree 주소가 반환된다.
  * @exception 동적 할당을 실패한 경우에는 NULL이 반환된다.
+ * B_TREE_FIXED_DEGREE로 빌드한 경우에는 min_degree가 그 값과 다를 때에도 NULL이 반환된다.
  * 
  * @warning 절대로 min_degree 값이 2 미만을 가지도록 만들어서는 안된다.
  */
-struct btree *btree_alloc(int min_degree)
+struct btree *btree_alloc_flags(int min_degree, unsigned int flags)
 {
         struct btree *tree = NULL;
         struct btree_node *node = NULL;
@@ -109,6 +274,13 @@ struct btree *btree_alloc(int min_degree)
                 pr_info("Degree must over 2\n");
                 return NULL;
         }
+#ifdef B_TREE_FIXED_DEGREE
+        if (min_degree != B_TREE_FIXED_DEGREE) {
+                pr_info("Degree is fixed to %d at build time\n",
+                        B_TREE_FIXED_DEGREE);
+                return NULL;
+        }
+#endif
 
         tree = (struct btree *)malloc(sizeof(struct btree));
         if (!tree) {
@@ -116,6 +288,39 @@ struct btree *btree_alloc(int min_degree)
                 goto exception;
         }
         tree->min_degree = min_degree; /**< DO NOT CHANGE */
+        tree->root = NULL;
+        tree->arena = NULL;
+        tree->version = 0;
+        tree->node_search = B_TREE_SEARCH_LINEAR;
+        atomic_init(&tree->search_choice, B_TREE_SEARCH_INTERPOLATION);
+        atomic_init(&tree->search_samples, 0);
+        for (int m = 0; m < B_TREE_SEARCH_ADAPTIVE; m++) {
+                atomic_init(&tree->search_probes[m], 0);
+        }
+#ifdef B_TREE_STATS
+        tree->stats = NULL;
+#endif
+
+        if (flags & B_TREE_F_ARENA) {
+                tree->arena = (struct btree_arena *)malloc(
+                        sizeof(struct btree_arena));
+                if (!tree->arena) {
+                        pr_info("Allocation arena failed\n");
+                        goto exception;
+                }
+                btree_arena_init_node(tree->arena, min_degree);
+        }
+
+#ifdef B_TREE_STATS
+        tree->stats = (struct btree_stats_slot *)aligned_alloc(
+                _Alignof(struct btree_stats_slot),
+                B_TREE_STATS_SLOTS * sizeof(struct btree_stats_slot));
+        if (!tree->stats) {
+                pr_info("Allocation stats failed\n");
+                goto exception;
+        }
+        btree_stats_reset(tree);
+#endif
 
         node = btree_alloc_node(tree);
         if (!node) {
@@ -132,22 +337,254 @@ struct btree *btree_alloc(int min_degree)
 
 exception:
         if (node) {
-                btree_dealloc_node(node);
+                btree_dealloc_node(tree, node);
                 tree->root = NULL;
         }
 
         if (tree) {
+#ifdef B_TREE_STATS
+                free(tree->stats);
+#endif
+                if (tree->arena) {
+                        btree_arena_destroy(tree->arena);
+                        free(tree->arena);
+                }
                 free(tree);
         }
 
         return NULL;
 }
 
+/**
+ * @brief 새로운 B-Tree를 할당을 하도록 한다.
+ * 
+ * @param min_degree 노드가 가지는 최소 차수를 의미한다. 이 값이 2이면 2-3-4 트리에 해당한다.
+ * @return struct btree* 정상 할당이 된 경우에는 B-Tree 주소가 반환된다.
+ * @exception 동적 할당을 실패한 경우에는 NULL이 반환된다.
+ * 
+ * @warning 절대로 min_degree 값이 2 미만을 가지도록 만들어서는 안된다.
+ */
+struct btree *btree_alloc(int min_degree)
+{
+        return btree_alloc_flags(min_degree, 0);
+}
+
+#ifndef B_TREE_SEARCH_SAMPLE
+#define B_TREE_SEARCH_SAMPLE 64 /**< ADAPTIVE에서 스레드마다 몇 번의 탐색에 한 번 표본을 뜨는 지 */
+#endif
+#define B_TREE_SEARCH_WINDOW 256 /**< 방법을 다시 고르기까지 모으는 표본 탐색의 수 */
+#define B_TREE_SEARCH_JUMP_COST 2 /**< 떨어진 키를 읽는 비용으로, 바로 다음 키를 읽는 비용이 1이다. */
+
+static _Thread_local unsigned int btree_search_tick;
+
+static inline int btree_find_linear(const struct btree_node *x, key_t k,
+                                    int *compares)
+{
+        int i = 0;
+
+        while (i < x->n && k > x->items[i].key) {
+                i = i + 1;
+        }
+        *compares = i + (i < x->n);
+        return i;
+}
+
+static inline int btree_find_binary(const struct btree_node *x, key_t k,
+                                    int *compares)
+{
+        int lo = 0, hi = x->n;
+
+        *compares = 0;
+        while (lo < hi) {
+                const int mid = lo + (hi - lo) / 2;
+
+                *compares += 1;
+                if (x->items[mid].key < k) {
+                        lo = mid + 1;
+                } else {
+                        hi = mid;
+                }
+        }
+        return lo;
+}
+
+/**
+ * @brief 노드의 첫 키와 마지막 키 사이를 보간하여 위치를 짐작한 뒤 앞뒤로 고친다.
+ * @details 키가 고르게 퍼져 있으면 짐작한 위치가 거의 맞아 비교가 상수 번에
+ * 끝나지만, 치우쳐 있으면 고치는 데에 노드 크기에 비례하는 비교가 필요하다.
+ * 항목이 키와 값을 함께 가지므로 키가 연속되어 있지 않아 고치는 부분은
+ * SIMD 대신 차례대로 비교한다.
+ */
+static inline int btree_find_interpolation(const struct btree_node *x, key_t k,
+                                           int *compares)
+{
+        const int n = x->n;
+        key_t lo, hi;
+        int guess, i;
+
+        if (n == 0 || k <= x->items[0].key) {
+                *compares = n > 0;
+                return 0;
+        }
+        lo = x->items[0].key;
+        hi = x->items[n - 1].key;
+        if (k > hi) {
+                *compares = 2;
+                return n;
+        }
+        /* lo < k <= hi 이므로 hi - lo는 0이 아니다. */
+        guess = (int)((uint64_t)(k - lo) * (uint64_t)(n - 1) / (hi - lo));
+        i = guess;
+        if (x->items[i].key < k) {
+                do {
+                        i++;
+                } while (x->items[i].key < k);
+        } else {
+                while (i > 0 && x->items[i - 1].key >= k) {
+                        i--;
+                }
+        }
+        *compares = 3 + (i > guess ? i - guess : guess - i);
+        return i;
+}
+
+/**
+ * @brief 노드 안의 탐색 한 번이 키를 읽은 비용을 구한다.
+ * @details 차례대로 읽는 키는 1로, 떨어진 위치로 건너뛰어 읽는 키는
+ * B_TREE_SEARCH_JUMP_COST로 센다. 선형 탐색은 모두 차례대로 읽고, 이진 탐색은
+ * 모두 건너뛰며, 보간 탐색은 첫 키 뒤에 마지막 키와 짐작한 위치로 건너뛴 다음
+ * 차례대로 고쳐 간다.
+ *
+ * @param mode 탐색 방법에 해당한다.
+ * @param compares 그 방법이 비교한 횟수에 해당한다.
+ */
+static inline unsigned long btree_search_cost(enum btree_node_search mode,
+                                              int compares)
+{
+        switch (mode) {
+        case B_TREE_SEARCH_BINARY:
+                return (unsigned long)compares * B_TREE_SEARCH_JUMP_COST;
+        case B_TREE_SEARCH_INTERPOLATION:
+                if (compares < 2) { /**< 첫 키에서 끝났다. */
+                        return (unsigned long)compares;
+                }
+                if (compares == 2) { /**< 마지막 키보다 크다. */
+                        return 1 + B_TREE_SEARCH_JUMP_COST;
+                }
+                return 1 + 2 * B_TREE_SEARCH_JUMP_COST +
+                       (unsigned long)(compares - 3);
+        default:
+                return (unsigned long)compares;
+        }
+}
+
+/**
+ * @brief 노드 x에서 k 이상인 첫 번째 항목의 위치를 찾는다.
+ * @details mode가 B_TREE_SEARCH_ADAPTIVE이면 표본 탐색으로, 선형, 이진, 보간
+ * 탐색을 모두 수행하여 각각 키를 읽은 비용을 트리에 더한다.
+ *
+ * @param compares 사용한 방법이 비교한 횟수가 저장될 곳에 해당한다.
+ * @return int 찾은 위치로 k보다 큰 키가 없으면 x->n을 반환한다.
+ */
+static int btree_node_find(struct btree *T, const struct btree_node *x, key_t k,
+                           enum btree_node_search mode, int *compares)
+{
+        int probes[B_TREE_SEARCH_ADAPTIVE];
+        int i = 0;
+
+        switch (mode) {
+        case B_TREE_SEARCH_BINARY:
+                return btree_find_binary(x, k, compares);
+        case B_TREE_SEARCH_INTERPOLATION:
+                return btree_find_interpolation(x, k, compares);
+        case B_TREE_SEARCH_ADAPTIVE:
+                btree_find_linear(x, k, &probes[B_TREE_SEARCH_LINEAR]);
+                btree_find_binary(x, k, &probes[B_TREE_SEARCH_BINARY]);
+                i = btree_find_interpolation(
+                        x, k, &probes[B_TREE_SEARCH_INTERPOLATION]);
+                for (int m = 0; m < B_TREE_SEARCH_ADAPTIVE; m++) {
+                        atomic_fetch_add_explicit(
+                                &T->search_probes[m],
+                                btree_search_cost(m, probes[m]),
+                                memory_order_relaxed);
+                }
+                *compares = probes[B_TREE_SEARCH_INTERPOLATION];
+                return i;
+        default:
+                return btree_find_linear(x, k, compares);
+        }
+}
+
+/**
+ * @brief 표본 탐색이 끝날 때마다 불리며, 표본이 충분히 모이면 방법을 다시 고른다.
+ * @details 구간마다 비용의 합이 가장 적은 방법을 고르고 합을 비운다. 여러 스레드가
+ * 동시에 고르면 일부 표본이 사라질 수 있으나 다음 구간에서 다시 고르게 된다.
+ */
+static void btree_search_adapt(struct btree *T)
+{
+        unsigned long probes[B_TREE_SEARCH_ADAPTIVE];
+        int best = B_TREE_SEARCH_LINEAR;
+
+        if ((atomic_fetch_add_explicit(&T->search_samples, 1,
+                                       memory_order_relaxed) +
+             1) % B_TREE_SEARCH_WINDOW) {
+                return;
+        }
+        for (int m = 0; m < B_TREE_SEARCH_ADAPTIVE; m++) {
+                probes[m] = atomic_exchange_explicit(&T->search_probes[m], 0,
+                                                     memory_order_relaxed);
+                if (probes[m] < probes[best]) {
+                        best = m;
+                }
+        }
+        atomic_store_explicit(&T->search_choice, best, memory_order_relaxed);
+}
+
+/**
+ * @brief 트리가 노드 안에서 키를 찾는 방법을 정하도록 한다.
+ * @details B_TREE_SEARCH_ADAPTIVE는 스레드마다 B_TREE_SEARCH_SAMPLE번의
+ * btree_search에 한 번씩 선형, 이진, 보간 탐색을 모두 해 보고, 키를 읽은 비용을
+ * B_TREE_SEARCH_WINDOW개의 표본마다 비교하여 나머지 탐색의 방법을 정한다.
+ * 처음에는 보간 탐색으로 시작한다.
+ *
+ * @param tree 트리를 가리키는 포인터에 해당한다.
+ * @param mode 사용할 방법에 해당한다.
+ * @return int 성공 시에 0을, 알 수 없는 방법이면 -EINVAL을 반환한다.
+ */
+int btree_set_node_search(struct btree *tree, enum btree_node_search mode)
+{
+        if ((unsigned int)mode > B_TREE_SEARCH_ADAPTIVE) {
+                return -EINVAL;
+        }
+        tree->node_search = mode;
+        atomic_store(&tree->search_choice, B_TREE_SEARCH_INTERPOLATION);
+        atomic_store(&tree->search_samples, 0);
+        for (int m = 0; m < B_TREE_SEARCH_ADAPTIVE; m++) {
+                atomic_store(&tree->search_probes[m], 0);
+        }
+        return 0;
+}
+
+/**
+ * @brief 트리가 지금 노드 안에서 키를 찾는 데에 사용하는 방법을 반환한다.
+ * @return enum btree_node_search ADAPTIVE인 경우에는 현재 고른 방법을 반환한다.
+ */
+enum btree_node_search btree_node_search_in_use(struct btree *tree)
+{
+        if (tree->node_search == B_TREE_SEARCH_ADAPTIVE) {
+                return (enum btree_node_search)atomic_load_explicit(
+                        &tree->search_choice, memory_order_relaxed);
+        }
+        return tree->node_search;
+}
+
 /**
  * @brief B-Tree에 대한 탐색을 수행하도록 한다.
  * 
+ * @param T B-Tree를 가리키는 포인터에 해당한다.
  * @param x B-Tree의 노드 탐색 시작 지점에 해당한다.
  * @param k 입력하고자하는 키에 해당한다.
+ * @param mode 노드 안에서 키를 찾는 방법으로, ADAPTIVE이면 표본 탐색을 한다.
  * @return struct btree_search_result B-Tree의 경우 하나의 노드에는 여러 개의
  * 키를 포함하기 때문에 노드의 주소 뿐만 아니라 인덱스도 필요로 한다. 따라서, 그 인덱스를
  * 반환해주도록 한다.
@@ -155,13 +592,16 @@ exception:
  * 만약 데이터를 찾지 못한 경우에는 result의 node가 NULL로 설정이 되고,
  * index도 미리 정의된 B_TREE_NOT_FOUND
  */
-static struct btree_search_result __btree_search(struct btree_node *x, key_t k)
+static struct btree_search_result __btree_search(struct btree *T,
+                                                 struct btree_node *x, key_t k,
+                                                 enum btree_node_search mode)
 {
-        int i = 0;
+        int compares = 0;
+        int i = btree_node_find(T, x, k, mode, &compares);
         struct btree_search_result result;
-        while (i < x->n && k > x->items[i].key) {
-                i = i + 1;
-        }
+
+        btree_stat_add(T, NODE_VISITS, 1);
+        btree_stat_add(T, KEY_COMPARES, compares + (i < x->n));
 
         if (i < x->n && k == x->items[i].key) {
                 result.index = i;
@@ -172,7 +612,7 @@ static struct btree_search_result __btree_search(struct btree_node *x, key_t k)
                 result.node = NULL;
                 return result;
         } else {
-                return __btree_search(x->child[i], k);
+                return __btree_search(T, x->child[i], k, mode);
         }
 }
 
@@ -185,7 +625,19 @@ static struct btree_search_result __btree_search(struct btree_node *x, key_t k)
  */
 struct btree_search_result btree_search(struct btree *tree, key_t key)
 {
-        return __btree_search(tree->root, key);
+        enum btree_node_search mode = btree_node_search_in_use(tree);
+        struct btree_search_result result;
+
+        btree_trace(B_TREE_TRACE_SEARCH, key);
+        btree_stat_add(tree, SEARCHES, 1);
+        if (tree->node_search == B_TREE_SEARCH_ADAPTIVE &&
+            ++btree_search_tick % B_TREE_SEARCH_SAMPLE == 0) {
+                result = __btree_search(tree, tree->root, key,
+                                        B_TREE_SEARCH_ADAPTIVE);
+                btree_search_adapt(tree);
+                return result;
+        }
+        return __btree_search(tree, tree->root, key, mode);
 }
 
 /**
@@ -197,11 +649,13 @@ struct btree_search_result btree_search(struct btree *tree, key_t key)
  */
 static void btree_split_child(struct btree *T, struct btree_node *x, int i)
 {
-        const int t = T->min_degree;
+        const int t = B_TREE_DEGREE(T);
 
         struct btree_node *z = btree_alloc_node(T);
         struct btree_node *y = x->child[i - 1];
 
+        btree_stat_add(T, SPLITS, 1);
+
         z->is_leaf = y->is_leaf;
         z->n = t - 1;
 
@@ -241,19 +695,23 @@ static void btree_insert_non_full(struct btree *T, struct btree_node *x,
 {
         int i = x->n;
 
+        btree_stat_add(T, NODE_VISITS, 1);
         if (x->is_leaf) {
                 while (i >= 1 && k->key < x->items[i - 1].key) {
                         x->items[i] = x->items[i - 1];
                         i = i - 1;
                 }
+                btree_stat_add(T, KEY_COMPARES, x->n - i + (i >= 1));
                 x->items[i] = *k;
                 x->n = x->n + 1;
         } else {
                 while (i >= 1 && k->key < x->items[i - 1].key) {
                         i = i - 1;
                 }
-                if (x->child[i]->n == B_TREE_NR_KEYS(T->min_degree)) {
+                btree_stat_add(T, KEY_COMPARES, x->n - i + (i >= 1));
+                if (x->child[i]->n == B_TREE_NR_KEYS(B_TREE_DEGREE(T))) {
                         btree_split_child(T, x, i + 1);
+                        btree_stat_add(T, KEY_COMPARES, 1);
                         if (k->key > x->items[i].key) {
                                 i = i + 1;
                         }
@@ -271,13 +729,14 @@ static void btree_insert_non_full(struct btree *T, struct btree_node *x,
 static void __btree_insert(struct btree *T, struct btree_item *k)
 {
         struct btree_node *r = T->root;
-        if (r->n == B_TREE_NR_KEYS(T->min_degree)) {
+        if (r->n == B_TREE_NR_KEYS(B_TREE_DEGREE(T))) {
                 struct btree_node *s = btree_alloc_node(T);
                 T->root = s;
                 s->is_leaf = false;
                 s->n = 0;
                 s->child[0] = r;
 
+                btree_stat_add(T, ROOT_SPLITS, 1);
                 btree_split_child(T, s, 1);
                 btree_insert_non_full(T, s, k);
         } else {
@@ -296,12 +755,61 @@ static void __btree_insert(struct btree *T, struct btree_item *k)
  * data는 정수와 실수같은 스칼라 타입을 사용해야 한다.
  * 
  * 이를 테면, `*((int *)data) = 1234;` 후에 `btree_insert(..,data)`
- * 와 같이 사용하면 된다.
+ * 와 같이 사용하면 된다. B_TREE_INLINE_SIZE 이하의 값은 따로 할당하지 말고
+ * btree_insert_value로 항목에 바로 넣는 것이 좋다.
  */
 void btree_insert(struct btree *tree, key_t key, void *data)
 {
         struct btree_item item = { .key = key, .data = data };
+        btree_trace(B_TREE_TRACE_INSERT, key);
+        btree_stat_add(tree, INSERTS, 1);
+        tree->version++;
+        __btree_insert(tree, &item);
+}
+
+/**
+ * @brief 값을 가리키는 대신 항목 안에 복사하여 삽입하도록 한다.
+ * @details 값을 읽을 때 포인터를 한 번 더 따라가지 않아도 되며, 호출하는 쪽에서
+ * 값마다 작은 메모리를 할당할 필요가 없다.
+ *
+ * @param tree B-Tree를 가리키는 포인터에 해당한다.
+ * @param key 입력하고자 하는 데이터의 키에 해당한다.
+ * @param value 복사할 값의 시작 주소에 해당한다.
+ * @param size 값의 크기로 B_TREE_INLINE_SIZE를 넘을 수 없다.
+ * @return int 성공 시에 0을, 값이 너무 크면 -E2BIG을 반환한다.
+ */
+int btree_insert_value(struct btree *tree, key_t key, const void *value,
+                       size_t size)
+{
+        struct btree_item item = { .key = key };
+
+        if (size > B_TREE_INLINE_SIZE) {
+                return -E2BIG;
+        }
+        memcpy(item.value, value, size);
+        btree_trace(B_TREE_TRACE_INSERT, key);
+        btree_stat_add(tree, INSERTS, 1);
+        tree->version++;
         __btree_insert(tree, &item);
+        return 0;
+}
+
+/**
+ * @brief 키를 찾아서 항목 안의 값을 가리키는 포인터를 반환한다.
+ *
+ * @param tree B-Tree를 가리키는 포인터에 해당한다.
+ * @param key 찾고자 하는 키에 해당한다.
+ * @return void* 항목 안의 값에 대한 포인터를, 키가 없으면 NULL을 반환한다.
+ * 포인터는 다음 삽입이나 삭제 전까지만 유효하다.
+ */
+void *btree_search_value(struct btree *tree, key_t key)
+{
+        struct btree_search_result result = btree_search(tree, key);
+
+        if (!result.node) {
+                return NULL;
+        }
+        return result.node->items[result.index].value;
 }
 
 /**
@@ -341,20 +849,77 @@ void btree_traverse(struct btree *tree)
         __btree_traverse(tree->root, 0);
 }
 
+/**
+ * @brief 임의의 노드부터 start 이상인 항목을 키 순서대로 방문한다.
+ *
+ * @param x 방문을 시작하는 노드에 해당한다.
+ * @param start 방문할 키의 하한(포함)에 해당한다.
+ * @param remain 남은 방문 횟수로 방문할 때마다 줄어든다.
+ * @return int 방문을 계속하는 경우 0을, 그렇지 않으면 fn의 반환값이다.
+ */
+static int __btree_scan(struct btree_node *x, key_t start, int *remain,
+                        btree_visit_fn fn, void *private)
+{
+        int i = 0;
+        int ret = 0;
+
+        while (i < x->n && start > x->items[i].key) {
+                i = i + 1;
+        }
+
+        for (; i <= x->n && *remain > 0; i++) {
+                if (!x->is_leaf) {
+                        ret = __btree_scan(x->child[i], start, remain, fn,
+                                           private);
+                        if (ret) {
+                                return ret;
+                        }
+                }
+                if (i == x->n || *remain == 0) {
+                        break;
+                }
+                *remain -= 1;
+                ret = fn(&x->items[i], private);
+                if (ret) {
+                        return ret;
+                }
+        }
+        return 0;
+}
+
+/**
+ * @brief start 이상인 항목을 키 순서대로 최대 count개 방문한다.
+ *
+ * @param tree B-Tree를 가리키는 포인터에 해당한다.
+ * @param start 방문할 키의 하한(포함)에 해당한다.
+ * @param count 방문할 최대 항목의 수에 해당한다.
+ * @param fn 항목마다 호출되는 함수에 해당한다.
+ * @param private fn에 그대로 전달되는 값이다.
+ * @return int 방문한 항목의 수를 반환한다. fn이 0이 아닌 값을 반환하면
+ * 그 항목까지 세고 방문을 멈춘다.
+ */
+int btree_scan(struct btree *tree, key_t start, int count, btree_visit_fn fn,
+               void *private)
+{
+        int remain = count;
+        __btree_scan(tree->root, start, &remain, fn, private);
+        return count - remain;
+}
+
 /**
  * @brief 임의의 노드에 노드 자신 포함해서 자식까지 전체 해제를 수행하도록 한다.
  * 
  * @param node 삭제 시작점에 해당한다.
  */
-static void __btree_clear(struct btree_node *node)
+static void __btree_clear(struct btree *T, struct btree_node *node)
 {
         if (node) {
                 if (!node->is_leaf) {
                         for (int i = 0; i < (node->n + 1); i++) {
-                                __btree_clear(node->child[i]);
+                                __btree_clear(T, node->child[i]);
                         }
                 }
-                btree_dealloc_node(node);
+                btree_dealloc_node(T, node);
         }
 }
 
@@ -365,7 +930,7 @@ static void __btree_clear(struct btree_node *node)
  */
 static void btree_clear(struct btree *tree)
 {
-        __btree_clear(tree->root);
+        __btree_clear(tree, tree->root);
         tree->root = NULL;
 }
 
@@ -407,13 +972,14 @@ static struct btree_item btree_get_successor(struct btree_node *node)
  */
 static void btree_merge_child(struct btree *T, struct btree_node *p, int i)
 {
-        const int t = T->min_degree;
+        const int t = B_TREE_DEGREE(T);
         struct btree_node *child[] = {
                 p->child[i],
                 p->child[i + 1],
         };
 
-        child[0]->n = B_TREE_NR_KEYS(T->min_degree);
+        btree_stat_add(T, MERGES, 1);
+        child[0]->n = B_TREE_NR_KEYS(B_TREE_DEGREE(T));
         child[0]->items[t - 1] = p->items[i];
 
         for (int j = 0; j < t - 1; j++) {
@@ -433,10 +999,11 @@ static void btree_merge_child(struct btree *T, struct btree_node *p, int i)
                 p->child[j + 1] = p->child[j + 2];
         }
 
-        btree_dealloc_node(child[1]);
+        btree_dealloc_node(T, child[1]);
         if (p->n == 0) {
-                btree_dealloc_node(p);
+                btree_dealloc_node(T, p);
                 if (p == T->root) {
+                        btree_stat_add(T, ROOT_COLLAPSES, 1);
                         T->root = child[0];
                 }
         }
@@ -458,12 +1025,13 @@ static void btree_merge_child(struct btree *T, struct btree_node *p, int i)
  */
 static int __btree_delete(struct btree *T, struct btree_node *x, key_t key)
 {
-        const int t = T->min_degree;
+        const int t = B_TREE_DEGREE(T);
+        int compares = 0;
         int i = 0;
 
-        while (i < x->n && key > x->items[i].key) {
-                i = i + 1;
-        }
+        i = btree_node_find(T, x, key, btree_node_search_in_use(T), &compares);
+        btree_stat_add(T, NODE_VISITS, 1);
+        btree_stat_add(T, KEY_COMPARES, compares + (i < x->n));
 
         if (i < x->n && key == x->items[i].key) {
                 if (x->is_leaf) { /**< case 1 */
@@ -511,6 +1079,7 @@ static int __btree_delete(struct btree *T, struct btree_node *x, key_t key)
                         }
 
                         if (left && left->n >= t) {
+                                btree_stat_add(T, BORROW_LEFT, 1);
                                 for (j = child->n; j > 0; --j) {
                                         child->items[j] = child->items[j - 1];
                                 }
@@ -529,6 +1098,7 @@ static int __btree_delete(struct btree *T, struct btree_node *x, key_t key)
                                 left->n -= 1;
 
                         } else if (right && right->n >= t) {
+                                btree_stat_add(T, BORROW_RIGHT, 1);
                                 child->items[child->n] = x->items[i];
                                 child->n += 1;
 
@@ -561,6 +1131,32 @@ end:
         return 0;
 }
 
+/**
+ * @brief 키가 있는 지 확인한 후에 삭제를 수행한다.
+ *
+ * @param tree 트리를 가리키는 포인터에 해당한다.
+ * @param key 삭제를 하고자 하는 키에 해당한다.
+ * @return int 삭제를 성공한 경우에는 0을, 키가 없으면 -EINVAL을 반환한다.
+ */
+static int btree_delete_key(struct btree *tree, key_t key)
+{
+        struct btree_node *node = NULL;
+        struct btree_node *root = tree->root;
+
+        node = __btree_search(tree, root, key, btree_node_search_in_use(tree))
+                       .node;
+        if (!node) {
+                return -EINVAL;
+        }
+
+        if (root->n == 0 && root->is_leaf) {
+                btree_clear(tree);
+                return 0;
+        }
+
+        return __btree_delete(tree, root, key);
+}
+
 /**
  * @brief 삭제를 수행하는 함수의 래핑 함수에 해당한다.
  * 
@@ -576,21 +1172,29 @@ end:
  */
 int btree_delete(struct btree *tree, key_t key)
 {
-        struct btree_node *node = NULL;
-        struct btree_node *root = tree->root;
+        const int ret = btree_delete_quiet(tree, key);
 
-        node = (btree_search(tree, key)).node;
-        if (!node) {
+        if (ret) {
                 pr_info("Cannot find specific node\n");
-                return -EINVAL;
-        }
-
-        if (root->n == 0 && root->is_leaf) {
-                btree_clear(tree);
-                return 0;
         }
+        return ret;
+}
 
-        return __btree_delete(tree, root, key);
+/**
+ * @brief btree_delete와 같으나 키가 없어도 메시지를 출력하지 않는다.
+ * @details 없는 키를 반복해서 지우는 벤치마크나 기록 재생처럼, 실패가 예상되어
+ * 출력 시간이 측정에 섞이면 안 되는 곳에서 사용한다.
+ *
+ * @param tree 트리를 가리키는 포인터에 해당한다.
+ * @param key 삭제를 하고자 하는 키에 해당한다.
+ * @return int 삭제를 성공한 경우에는 0을, 키가 없으면 -EINVAL을 반환한다.
+ */
+int btree_delete_quiet(struct btree *tree, key_t key)
+{
+        btree_trace(B_TREE_TRACE_DELETE, key);
+        btree_stat_add(tree, DELETES, 1);
+        tree->version++;
+        return btree_delete_key(tree, key);
 }
 
 /**
@@ -604,10 +1208,171 @@ void btree_free(struct btree *tree)
                 struct btree_node *root = tree->root;
                 while (root->n > 0) {
                         key_t key = root->items[0].key;
-                        btree_delete(tree, key);
+                        btree_delete_key(tree, key);
                         root = tree->root;
                 }
-                btree_dealloc_node(tree->root);
+                btree_dealloc_node(tree, tree->root);
+#ifdef B_TREE_STATS
+                free(tree->stats);
+#endif
+                if (tree->arena) {
+                        btree_arena_destroy(tree->arena);
+                        free(tree->arena);
+                }
                 free(tree);
         }
 }
+
+/**
+ * @brief 할당 하나의 요청 크기와 실제 크기를 보고서에 더한다.
+ */
+static void btree_analyze_alloc(struct btree_report *report, const void *ptr,
+                                size_t size)
+{
+        const size_t usable = btree_usable_size((void *)ptr);
+
+        report->bytes += size;
+        report->allocated_bytes += usable ? usable : size;
+}
+
+/**
+ * @brief 노드 x를 루트로 하는 서브 트리를 순회하며 보고서를 채운다.
+ *
+ * @param T B-Tree를 가리키는 포인터에 해당한다.
+ * @param x 순회를 시작하는 노드에 해당한다.
+ * @param depth x의 깊이로 루트가 0이다.
+ * @param report 채워질 보고서에 해당한다.
+ */
+static void __btree_analyze(struct btree *T, struct btree_node *x, int depth,
+                            struct btree_report *report)
+{
+        const int nr_keys = B_TREE_NR_KEYS(B_TREE_DEGREE(T));
+        const int nr_child = B_TREE_NR_CHILD(B_TREE_DEGREE(T));
+        int bucket = x->n * B_TREE_FILL_BUCKETS / nr_keys;
+
+        if (bucket >= B_TREE_FILL_BUCKETS) {
+                bucket = B_TREE_FILL_BUCKETS - 1;
+        }
+        if (depth < B_TREE_MAX_HEIGHT) {
+                report->level_nodes[depth]++;
+        }
+        if (depth + 1 > report->height) {
+                report->height = depth + 1;
+        }
+
+        report->nr_nodes++;
+        report->nr_keys += x->n;
+        report->wasted_slots += nr_keys - x->n;
+        if (T->arena) {
+                report->bytes += T->arena->object_size;
+        } else {
+                btree_analyze_alloc(report, x, sizeof(struct btree_node));
+#ifndef B_TREE_FIXED_DEGREE
+                btree_analyze_alloc(report, x->items,
+                                    nr_keys * sizeof(struct btree_item));
+                btree_analyze_alloc(report, x->child,
+                                    nr_child * sizeof(struct btree_node *));
+#endif
+        }
+
+        if (x->is_leaf) {
+                report->nr_leaves++;
+                report->leaf_fill[bucket]++;
+                report->wasted_child_slots += nr_child;
+                return;
+        }
+        report->internal_fill[bucket]++;
+        report->wasted_child_slots += nr_child - (x->n + 1);
+        for (int i = 0; i <= x->n; i++) {
+                __btree_analyze(T, x->child[i], depth + 1, report);
+        }
+}
+
+/**
+ * @brief 트리를 한 번 순회하여 모양과 메모리 사용량을 분석한다.
+ *
+ * @param tree B-Tree를 가리키는 포인터에 해당한다.
+ * @param report 분석 결과가 채워질 위치에 해당한다.
+ * @return int 성공 시에 0을, 높이가 B_TREE_MAX_HEIGHT를 넘으면 -ERANGE를 반환한다.
+ * 이 경우에도 level_nodes를 제외한 항목은 모두 올바르게 채워진다.
+ *
+ * @note 순회하는 동안 트리가 바뀌어서는 안된다.
+ */
+int btree_analyze(struct btree *tree, struct btree_report *report)
+{
+        memset(report, 0, sizeof(struct btree_report));
+        btree_analyze_alloc(report, tree, sizeof(struct btree));
+#ifdef B_TREE_STATS
+        btree_analyze_alloc(report, tree->stats,
+                            B_TREE_STATS_SLOTS * sizeof(struct btree_stats_slot));
+#endif
+        if (tree->arena) {
+                btree_analyze_alloc(report, tree->arena,
+                                    sizeof(struct btree_arena));
+                report->allocated_bytes +=
+                        tree->arena->nr_regions * tree->arena->region_size;
+        }
+        __btree_analyze(tree, tree->root, 0, report);
+        report->bytes_per_key = report->nr_keys ?
+                                        (double)report->allocated_bytes /
+                                                (double)report->nr_keys :
+                                        0.0;
+        return report->height > B_TREE_MAX_HEIGHT ? -ERANGE : 0;
+}
+
+/**
+ * @brief 모든 스레드의 통계를 합친 스냅샷을 가져온다.
+ *
+ * @param tree B-Tree를 가리키는 포인터에 해당한다.
+ * @param stats 합친 통계가 채워질 위치에 해당한다.
+ * @return int 성공 시에 0을, B_TREE_STATS 없이 빌드한 경우에는 -ENOTSUP을 반환한다.
+ *
+ * @note 다른 스레드가 연산 중이면 항목마다 조금씩 다른 시점의 값일 수 있다.
+ */
+int btree_stats_get(struct btree *tree, struct btree_stats *stats)
+{
+#ifdef B_TREE_STATS
+        unsigned long sum[NR_B_TREE_STATS] = { 0 };
+
+        for (int slot = 0; slot < B_TREE_STATS_SLOTS; slot++) {
+                for (int stat = 0; stat < NR_B_TREE_STATS; stat++) {
+                        sum[stat] += atomic_load_explicit(
+                                &tree->stats[slot].value[stat],
+                                memory_order_relaxed);
+                }
+        }
+        stats->searches = sum[B_TREE_STAT_SEARCHES];
+        stats->inserts = sum[B_TREE_STAT_INSERTS];
+        stats->deletes = sum[B_TREE_STAT_DELETES];
+        stats->node_visits = sum[B_TREE_STAT_NODE_VISITS];
+        stats->key_compares = sum[B_TREE_STAT_KEY_COMPARES];
+        stats->splits = sum[B_TREE_STAT_SPLITS];
+        stats->merges = sum[B_TREE_STAT_MERGES];
+        stats->borrow_left = sum[B_TREE_STAT_BORROW_LEFT];
+        stats->borrow_right = sum[B_TREE_STAT_BORROW_RIGHT];
+        stats->root_splits = sum[B_TREE_STAT_ROOT_SPLITS];
+        stats->root_collapses = sum[B_TREE_STAT_ROOT_COLLAPSES];
+        return 0;
+#else
+        (void)tree;
+        memset(stats, 0, sizeof(struct btree_stats));
+        return -ENOTSUP;
+#endif
+}
+
+/**
+ * @brief 모든 스레드의 통계를 0으로 만든다.
+ * @warning 다른 스레드가 연산 중이 아닐 때에 호출해야 한다.
+ */
+void btree_stats_reset(struct btree *tree)
+{
+#ifdef B_TREE_STATS
+        for (int slot = 0; slot < B_TREE_STATS_SLOTS; slot++) {
+                for (int stat = 0; stat < NR_B_TREE_STATS; stat++) {
+                        atomic_init(&tree->stats[slot].value[stat], 0);
+                }
+        }
+#else
+        (void)tree;
+#endif
+}
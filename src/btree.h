@@ -11,6 +11,7 @@
 #ifndef _B_TREE_H
 #define _B_TREE_H
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -27,6 +28,21 @@
 #define B_TREE_NR_CHILD(DEG) (2 * (DEG)) // 4(2-3-4), 3(2-3)
 #define B_TREE_NR_KEYS(DEG) (B_TREE_NR_CHILD(DEG) - 1) // 3(2-3-4), 2(2-3)
 
+/**
+ * B_TREE_FIXED_DEGREE를 정의하여 빌드하면(예: make bench DEGREE=32) 차수가
+ * 컴파일 시간 상수가 된다. 노드가 items와 child 배열을 직접 가지며, 분할, 병합과
+ * 노드 안의 탐색에서 반복문의 경계가 상수가 되어 컴파일러가 펼칠 수 있다.
+ * 이렇게 빌드한 경우에는 같은 차수의 struct btree만 만들 수 있다.
+ */
+#ifdef B_TREE_FIXED_DEGREE
+#if B_TREE_FIXED_DEGREE < B_TREE_MIN_DEGREE
+#error "B_TREE_FIXED_DEGREE must not be less than B_TREE_MIN_DEGREE"
+#endif
+#define B_TREE_DEGREE(T) (B_TREE_FIXED_DEGREE)
+#else
+#define B_TREE_DEGREE(T) ((T)->min_degree)
+#endif
+
 #ifndef key_t
 typedef unsigned int key_t;
 #endif
@@ -45,13 +61,23 @@ struct btree_search_result {
         struct btree_node *node;
 };
 
+#ifndef B_TREE_INLINE_SIZE
+#define B_TREE_INLINE_SIZE sizeof(void *) /**< 항목에 바로 넣을 수 있는 값의 최대 크기 */
+#endif
+
 /**
  * @brief B-Tree의 노드가 가지는 항목에 해당한다.
+ * @details 값은 data로 가리키거나, btree_insert_value로 value에 바로 넣을 수 있다.
+ * B_TREE_INLINE_SIZE를 포인터보다 크게 정의하여 빌드하면(예: make INLINE=16)
+ * 그만큼 항목이 커진다. 이 때 btree_image는 value의 앞 8바이트만 저장한다.
  * 
  */
 struct btree_item {
         key_t key;
-        void *data;
+        union {
+                void *data;
+                unsigned char value[B_TREE_INLINE_SIZE];
+        };
 };
 
 /**
@@ -62,8 +88,77 @@ struct btree_node {
         int n; /**< 노드가 현재 사용 중인 항목의 갯수를 가진다. */
         bool is_leaf; /**< 노드가 leaf 위치에 있는 지에 대한 정보를 가진다. */
 
+#ifdef B_TREE_FIXED_DEGREE
+        struct btree_item items[B_TREE_NR_KEYS(B_TREE_FIXED_DEGREE)];
+        struct btree_node *child[B_TREE_NR_CHILD(B_TREE_FIXED_DEGREE)];
+#else
         struct btree_item *items; /**< 항목들에 대한 데이터들을 가진다. */
         struct btree_node **child; /**< 자식에 대한 포인터들을 가진다. */
+#endif
+};
+
+#ifndef B_TREE_STATS_SLOTS
+#define B_TREE_STATS_SLOTS 64 /**< 통계를 나누어 세는 스레드 슬롯의 수 */
+#endif
+
+/**
+ * @brief B_TREE_STATS로 빌드한 경우에 모이는 연산 통계에 해당한다.
+ * @details node_visits와 key_compares는 search, insert, delete에서 내려가며
+ * 거친 노드와 그 안에서의 키 비교를 모두 센다. delete는 키의 존재 여부를
+ * 확인하는 탐색도 포함한다.
+ */
+struct btree_stats {
+        unsigned long searches;
+        unsigned long inserts;
+        unsigned long deletes;
+        unsigned long node_visits;
+        unsigned long key_compares;
+        unsigned long splits; /**< btree_split_child의 호출 횟수 */
+        unsigned long merges; /**< btree_merge_child의 호출 횟수 */
+        unsigned long borrow_left; /**< 삭제 case 3에서 왼쪽 형제에서 빌려온 횟수 */
+        unsigned long borrow_right; /**< 삭제 case 3에서 오른쪽 형제에서 빌려온 횟수 */
+        unsigned long root_splits; /**< 루트가 분할되어 높이가 늘어난 횟수 */
+        unsigned long root_collapses; /**< 루트가 병합되어 높이가 줄어든 횟수 */
+};
+
+struct btree_stats_slot;
+struct btree_arena;
+
+#define B_TREE_MAX_HEIGHT 64 /**< btree_analyze가 층별로 세는 최대 높이 */
+#define B_TREE_FILL_BUCKETS 10 /**< 채움 비율 히스토그램의 구간 수(10% 단위) */
+
+/**
+ * @brief btree_analyze로 한 번 순회하여 얻은 트리의 모양과 메모리 사용량에 해당한다.
+ * @details bytes는 struct btree와 노드마다의 malloc/calloc 3번(노드, items, child)에서
+ * 요청한 크기의 합이며, allocated_bytes는 할당기가 실제로 내어준 크기(glibc에서만
+ * 구할 수 있고, 그 외에는 bytes와 같다)의 합이다. 아레나를 쓰는 트리에서는 노드마다
+ * 정렬된 블록 하나를 bytes로, mmap한 영역 전체를 allocated_bytes로 센다.
+ */
+struct btree_report {
+        int height;
+        unsigned long level_nodes[B_TREE_MAX_HEIGHT]; /**< 0이 루트에 해당한다. */
+        unsigned long nr_nodes;
+        unsigned long nr_leaves;
+        unsigned long nr_keys;
+        unsigned long leaf_fill[B_TREE_FILL_BUCKETS];
+        unsigned long internal_fill[B_TREE_FILL_BUCKETS];
+        size_t bytes;
+        size_t allocated_bytes;
+        double bytes_per_key; /**< allocated_bytes / nr_keys */
+        unsigned long wasted_slots; /**< 비어있는 items 칸의 수 */
+        unsigned long wasted_child_slots; /**< 쓰이지 않는 child 칸(leaf는 전부)의 수 */
+};
+
+/**
+ * @brief 노드 안에서 키의 위치를 찾는 방법에 해당한다.
+ * @details btree_search와 btree_delete가 내려가며 사용하며, 어느 방법이든
+ * 키 이상인 첫 번째 항목의 위치를 찾는다.
+ */
+enum btree_node_search {
+        B_TREE_SEARCH_LINEAR = 0, /**< 앞에서부터 차례대로 비교한다(기본값). */
+        B_TREE_SEARCH_BINARY,
+        B_TREE_SEARCH_INTERPOLATION, /**< 첫 키와 마지막 키 사이를 보간한 위치에서 앞뒤로 고쳐 간다. */
+        B_TREE_SEARCH_ADAPTIVE, /**< 표본 탐색에서 키를 읽은 비용으로 나머지 세 방법 중에서 고른다. */
 };
 
 /**
@@ -74,13 +169,104 @@ struct btree_node {
 struct btree {
         int min_degree; /**< 현재 B-Tree가 가지는 최소 차수를 가진다. */
         struct btree_node *root; /**< B-Tree의 루트 노드를 가리킨다. */
+        struct btree_arena *arena; /**< B_TREE_F_ARENA인 경우의 노드 할당기 */
+        unsigned long version; /**< 삽입과 삭제마다 1씩 증가한다. */
+        enum btree_node_search node_search; /**< 노드 안에서 키를 찾는 방법 */
+        atomic_int search_choice; /**< ADAPTIVE에서 지금 사용 중인 방법 */
+        atomic_ulong search_samples; /**< ADAPTIVE에서 모은 표본 탐색의 수 */
+        atomic_ulong search_probes[B_TREE_SEARCH_ADAPTIVE]; /**< 표본에서 방법마다 키를 읽은 비용 */
+#ifdef B_TREE_STATS
+        struct btree_stats_slot *stats; /**< 스레드마다 따로 세는 통계 슬롯 */
+#endif
+};
+
+/**
+ * @brief B-Tree의 항목을 방문할 때 호출되는 함수의 형태에 해당한다.
+ * @return int 0이 아닌 값을 반환하면 순회를 중단하고 그 값을 그대로 반환한다.
+ */
+typedef int (*btree_visit_fn)(struct btree_item *item, void *private);
+
+#define B_TREE_PARALLEL_ORDERED (1 << 0) /**< 작업 결과를 키 순서대로 병합한다. */
+
+#define B_TREE_AUTO_CALIBRATE (1 << 0) /**< 후보 차수를 직접 측정하여 고른다. */
+#define B_TREE_AUTO_PAGE (1 << 1) /**< 노드가 페이지 하나를 채우도록 고른다. */
+
+#define B_TREE_F_ARENA (1 << 0) /**< 노드를 huge page 아레나에서 할당한다. */
+
+#define B_TREE_COMPACT_FILL 0.9 /**< btree_compact가 노드를 채우는 기본 비율 */
+
+/**
+ * @brief btree_compact가 새 아레나에 노드를 놓는 순서에 해당한다.
+ */
+enum btree_layout {
+        B_TREE_LAYOUT_BFS = 0, /**< 루트부터 층마다 왼쪽에서 오른쪽으로 놓는다. */
+        B_TREE_LAYOUT_VEB, /**< 높이를 반씩 나누어 재귀적으로 놓는다(van Emde Boas). */
+};
+
+struct btree_compact;
+
+/**
+ * @brief 차수를 고르는 데에 사용하는 CPU 캐시의 모양에 해당한다.
+ */
+struct btree_cache_info {
+        long line_size;
+        long l1d_size;
+        long l2_size;
+        long page_size;
+};
+
+/**
+ * @brief 병렬 집계에서 작업(task) 단위 결과를 다루는 연산의 모음에 해당한다.
+ * @details alloc으로 결과 공간을 만들고, visit으로 항목을 누적한 뒤,
+ * 모든 작업이 끝나면 호출한 스레드에서 merge가 순서대로 불린다.
+ * merge는 결과의 소유권을 넘겨받으므로 해제까지 책임진다.
+ * alloc이 NULL이면 모든 작업이 private을 결과로 함께 사용하므로, visit은 여러
+ * 스레드에서 동시에 private을 고쳐도 안전해야 하며 merge는 NULL이어야 한다.
+ * alloc이 실패하면 아무 것도 병합하지 않고, 이미 만든 결과는 release로 해제한다.
+ */
+struct btree_parallel_ops {
+        void *(*alloc)(void *private);
+        int (*visit)(struct btree_item *item, void *result);
+        void (*merge)(void *private, void *result);
+        void (*release)(void *private, void *result); /**< NULL이면 free()로 해제한다. */
 };
 
 struct btree *btree_alloc(int min_degree);
+struct btree *btree_alloc_flags(int min_degree, unsigned int flags);
+struct btree *btree_alloc_auto(unsigned int flags);
+int btree_auto_degree(unsigned int flags);
+void btree_cache_info(struct btree_cache_info *info);
 struct btree_search_result btree_search(struct btree *tree, key_t key);
 void btree_insert(struct btree *tree, key_t key, void *data);
+int btree_insert_value(struct btree *tree, key_t key, const void *value,
+                       size_t size);
+void *btree_search_value(struct btree *tree, key_t key);
 void btree_traverse(struct btree *tree);
+int btree_scan(struct btree *tree, key_t start, int count, btree_visit_fn fn,
+               void *private);
 int btree_delete(struct btree *tree, key_t key);
+int btree_delete_quiet(struct btree *tree, key_t key);
 void btree_free(struct btree *tree);
+int btree_set_node_search(struct btree *tree, enum btree_node_search mode);
+enum btree_node_search btree_node_search_in_use(struct btree *tree);
+
+int btree_analyze(struct btree *tree, struct btree_report *report);
+
+int btree_compact(struct btree *tree, enum btree_layout layout);
+struct btree_compact *btree_compact_begin(struct btree *tree,
+                                          enum btree_layout layout,
+                                          double fill);
+int btree_compact_step(struct btree_compact *compact,
+                       unsigned long budget_ns);
+unsigned long btree_compact_restarts(const struct btree_compact *compact);
+void btree_compact_end(struct btree_compact *compact);
+int btree_stats_get(struct btree *tree, struct btree_stats *stats);
+void btree_stats_reset(struct btree *tree);
+
+int btree_parallel_for_each(struct btree *tree, btree_visit_fn fn,
+                            void *private, int nthreads);
+int btree_parallel_reduce(struct btree *tree,
+                          const struct btree_parallel_ops *ops, void *private,
+                          int nthreads, unsigned int flags);
 
 #endif
\ No newline at end of file
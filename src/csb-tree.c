@@ -0,0 +1,414 @@
+/**
+ * @file csb-tree.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief CSB+-Tree의 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details Rao와 Ross의 CSB+-Tree와 같이 노드의 자식을 모두 연속된 하나의
+ * 그룹에 두므로, 내부 노드는 자식마다 포인터를 두는 대신 그룹의 주소 하나만
+ * 가진다. 같은 크기의 내부 노드에 키가 두 배 가까이 들어가며, 자식은 그룹의
+ * 시작 주소에 위치와 노드 크기를 곱한 값을 더해서 찾는다.
+ *
+ * 삽입은 CLRS와 같이 내려가면서 가득 찬 자식을 미리 분할한다. 분할은 부모의
+ * 그룹을 하나 더 큰 그룹으로 다시 할당하여 새 노드를 형제 바로 옆에 두며,
+ * 내부 노드의 분할은 자식 그룹도 둘로 나눈다. 잎은 B+-Tree와 같이 모든 항목을
+ * 가지고 내부 노드의 키는 길잡이로만 쓰이므로 같은 키는 한 번만 넣을 수 있다.
+ * 삭제는 잎에서 항목만 지우며 노드를 합치지 않는다(lazy deletion).
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "csb-tree.h"
+
+#define CSB_TREE_NR_KEYS(tree) B_TREE_NR_KEYS((tree)->min_degree)
+
+/**
+ * @brief level에 있는 노드의 크기를 반환한다. 잎의 level은 1이다.
+ */
+static inline size_t csb_tree_node_size(const struct csb_tree *tree,
+                                        int level)
+{
+        return level == 1 ? tree->leaf_size : tree->inode_size;
+}
+
+static inline void *csb_tree_child(const struct csb_tree *tree,
+                                   const struct csb_inode *x, int i, int level)
+{
+        return (char *)x->children + i * csb_tree_node_size(tree, level - 1);
+}
+
+static void *csb_tree_alloc_group(struct csb_tree *tree, int count,
+                                  size_t size)
+{
+        void *group = malloc(count * size);
+
+        if (group) {
+                tree->bytes += count * size;
+        }
+        return group;
+}
+
+static void csb_tree_free_group(struct csb_tree *tree, void *group, int count,
+                                size_t size)
+{
+        tree->bytes -= count * size;
+        free(group);
+}
+
+/**
+ * @brief 새로운 CSB+-Tree를 할당하도록 한다.
+ *
+ * @param min_degree 노드가 가지는 키의 수를 정하는 최소 차수에 해당한다.
+ * @return struct csb_tree* 할당된 트리를, 실패한 경우에는 NULL을 반환한다.
+ */
+struct csb_tree *csb_tree_alloc(int min_degree)
+{
+        struct csb_tree *tree = NULL;
+        struct csb_leaf *root = NULL;
+
+        if (min_degree < B_TREE_MIN_DEGREE) {
+                pr_info("Invalid min degree(%d)\n", min_degree);
+                return NULL;
+        }
+        tree = (struct csb_tree *)calloc(1, sizeof(struct csb_tree));
+        if (!tree) {
+                pr_info("Allocation tree failed\n");
+                return NULL;
+        }
+        tree->min_degree = min_degree;
+        tree->height = 1;
+        tree->inode_size = sizeof(struct csb_inode) +
+                           CSB_TREE_NR_KEYS(tree) * sizeof(key_t);
+        tree->inode_size = (tree->inode_size + 7) & ~(size_t)7;
+        tree->leaf_size = sizeof(struct csb_leaf) +
+                          CSB_TREE_NR_KEYS(tree) * sizeof(struct btree_item);
+
+        root = (struct csb_leaf *)csb_tree_alloc_group(tree, 1,
+                                                       tree->leaf_size);
+        if (!root) {
+                pr_info("Allocation root failed\n");
+                free(tree);
+                return NULL;
+        }
+        root->n = 0;
+        tree->root = root;
+        return tree;
+}
+
+/**
+ * @brief 내부 노드에서 key가 내려갈 자식의 위치를 찾는다.
+ * @details 구분 키는 오른쪽 부트리의 가장 작은 키이므로 같으면 오른쪽으로 간다.
+ */
+static inline int csb_tree_route(const struct csb_inode *x, key_t key)
+{
+        int i = 0;
+
+        while (i < (int)x->n && key >= x->keys[i]) {
+                i++;
+        }
+        return i;
+}
+
+/**
+ * @brief 잎에서 key 이상인 첫 번째 항목의 위치를 찾는다.
+ */
+static inline int csb_tree_lower_bound(const struct csb_leaf *x, key_t key)
+{
+        int i = 0;
+
+        while (i < (int)x->n && x->items[i].key < key) {
+                i++;
+        }
+        return i;
+}
+
+/**
+ * @brief level에 있는 가득 찬 자식 i를 분할한다. 부모 p는 가득 차 있지 않아야 한다.
+ * @details 부모의 그룹을 자식이 하나 더 들어가는 새 그룹으로 옮기며, 필요한
+ * 메모리를 모두 할당한 뒤에 트리를 고치므로 실패하면 트리가 바뀌지 않는다.
+ *
+ * @return int 성공 시에 0을, 동적 할당을 실패한 경우에는 -ENOMEM을 반환한다.
+ */
+static int csb_tree_split_child(struct csb_tree *tree, struct csb_inode *p,
+                                int i, int level)
+{
+        const int t = tree->min_degree;
+        const size_t size = csb_tree_node_size(tree, level);
+        const size_t child_size = csb_tree_node_size(tree, level - 1);
+        char *old = (char *)p->children;
+        char *group = NULL;
+        void *right_children = NULL;
+        key_t separator = 0;
+
+        group = (char *)csb_tree_alloc_group(tree, p->n + 2, size);
+        if (!group) {
+                return -ENOMEM;
+        }
+        if (level > 1) {
+                right_children = csb_tree_alloc_group(tree, t, child_size);
+                if (!right_children) {
+                        csb_tree_free_group(tree, group, p->n + 2, size);
+                        return -ENOMEM;
+                }
+        }
+        memcpy(group, old, (i + 1) * size);
+        memcpy(group + (i + 2) * size, old + (i + 1) * size,
+               (p->n - i) * size);
+
+        if (level == 1) {
+                struct csb_leaf *left = (struct csb_leaf *)(group + i * size);
+                struct csb_leaf *right =
+                        (struct csb_leaf *)(group + (i + 1) * size);
+
+                right->n = (uint32_t)(t - 1);
+                memcpy(right->items, left->items + t,
+                       (t - 1) * sizeof(struct btree_item));
+                left->n = (uint32_t)t;
+                separator = right->items[0].key;
+        } else {
+                struct csb_inode *left = (struct csb_inode *)(group + i * size);
+                struct csb_inode *right =
+                        (struct csb_inode *)(group + (i + 1) * size);
+                void *shrunk = NULL;
+
+                memcpy(right_children, (char *)left->children + t * child_size,
+                       t * child_size);
+                right->n = (uint32_t)(t - 1);
+                right->children = right_children;
+                memcpy(right->keys, left->keys + t, (t - 1) * sizeof(key_t));
+                separator = left->keys[t - 1];
+                left->n = (uint32_t)(t - 1);
+
+                /* 왼쪽 노드의 그룹에서 오른쪽으로 옮겨간 뒤쪽 절반을 돌려준다. */
+                shrunk = realloc(left->children, t * child_size);
+                if (shrunk) {
+                        left->children = shrunk;
+                        tree->bytes -= t * child_size;
+                }
+        }
+
+        memmove(p->keys + i + 1, p->keys + i, (p->n - i) * sizeof(key_t));
+        p->keys[i] = separator;
+        p->children = group;
+        csb_tree_free_group(tree, old, p->n + 1, size);
+        p->n++;
+        return 0;
+}
+
+/**
+ * @brief CSB+-Tree에 항목을 삽입하도록 한다.
+ *
+ * @param tree 트리를 가리키는 포인터에 해당한다.
+ * @param key 삽입하고자 하는 키에 해당한다.
+ * @param data 키와 함께 삽입되는 데이터에 해당한다.
+ * @return int 성공 시에 0을, 이미 있는 키이면 -EEXIST를, 동적 할당을 실패한
+ * 경우에는 -ENOMEM을 반환한다.
+ */
+int csb_tree_insert(struct csb_tree *tree, key_t key, void *data)
+{
+        const uint32_t nr_keys = CSB_TREE_NR_KEYS(tree);
+        struct csb_leaf *leaf = NULL;
+        void *x = tree->root;
+        int level = tree->height;
+        int i = 0;
+
+        if (csb_tree_search(tree, key)) {
+                return -EEXIST;
+        }
+        if (((struct csb_inode *)x)->n == nr_keys) {
+                struct csb_inode *root = (struct csb_inode *)
+                        csb_tree_alloc_group(tree, 1, tree->inode_size);
+
+                if (!root) {
+                        return -ENOMEM;
+                }
+                root->n = 0;
+                root->children = tree->root;
+                if (csb_tree_split_child(tree, root, 0, level)) {
+                        csb_tree_free_group(tree, root, 1, tree->inode_size);
+                        return -ENOMEM;
+                }
+                x = tree->root = root;
+                level = ++tree->height;
+        }
+
+        for (; level > 1; level--) {
+                struct csb_inode *node = (struct csb_inode *)x;
+                void *child = NULL;
+
+                i = csb_tree_route(node, key);
+                child = csb_tree_child(tree, node, i, level);
+                if (((struct csb_inode *)child)->n == nr_keys) {
+                        if (csb_tree_split_child(tree, node, i, level - 1)) {
+                                return -ENOMEM;
+                        }
+                        if (key >= node->keys[i]) {
+                                i++;
+                        }
+                        child = csb_tree_child(tree, node, i, level);
+                }
+                x = child;
+        }
+
+        leaf = (struct csb_leaf *)x;
+        i = csb_tree_lower_bound(leaf, key);
+        memmove(leaf->items + i + 1, leaf->items + i,
+                (leaf->n - i) * sizeof(struct btree_item));
+        leaf->items[i].key = key;
+        leaf->items[i].data = data;
+        leaf->n++;
+        tree->nr_keys++;
+        return 0;
+}
+
+/**
+ * @brief 트리에서 key가 들어갈 잎을 찾는다.
+ */
+static struct csb_leaf *csb_tree_find_leaf(const struct csb_tree *tree,
+                                           key_t key)
+{
+        const void *x = tree->root;
+
+        for (int level = tree->height; level > 1; level--) {
+                const struct csb_inode *node = (const struct csb_inode *)x;
+                x = csb_tree_child(tree, node, csb_tree_route(node, key),
+                                   level);
+        }
+        return (struct csb_leaf *)x;
+}
+
+/**
+ * @brief CSB+-Tree에서 탐색을 수행하도록 한다.
+ *
+ * @param tree 트리를 가리키는 포인터에 해당한다.
+ * @param key 찾고자 하는 키에 해당한다.
+ * @return struct btree_item* 찾은 항목을, 없는 경우에는 NULL을 반환한다.
+ */
+struct btree_item *csb_tree_search(struct csb_tree *tree, key_t key)
+{
+        struct csb_leaf *leaf = csb_tree_find_leaf(tree, key);
+        const int i = csb_tree_lower_bound(leaf, key);
+
+        if (i < (int)leaf->n && leaf->items[i].key == key) {
+                return &leaf->items[i];
+        }
+        return NULL;
+}
+
+/**
+ * @brief CSB+-Tree에서 삭제를 수행하도록 한다.
+ * @details 잎에서 항목만 지우며, 비거나 절반 아래로 줄어든 노드도 그대로 둔다.
+ *
+ * @param tree 트리를 가리키는 포인터에 해당한다.
+ * @param key 삭제를 하고자 하는 키에 해당한다.
+ * @return int 삭제를 성공한 경우에는 0을, 키가 없으면 -EINVAL을 반환한다.
+ */
+int csb_tree_delete(struct csb_tree *tree, key_t key)
+{
+        struct csb_leaf *leaf = csb_tree_find_leaf(tree, key);
+        const int i = csb_tree_lower_bound(leaf, key);
+
+        if (i == (int)leaf->n || leaf->items[i].key != key) {
+                return -EINVAL;
+        }
+        leaf->n--;
+        memmove(leaf->items + i, leaf->items + i + 1,
+                (leaf->n - i) * sizeof(struct btree_item));
+        tree->nr_keys--;
+        return 0;
+}
+
+/**
+ * @brief 부트리에서 start 이상인 항목을 순서대로 방문한다.
+ *
+ * @return int 방문을 계속하는 경우 0을, 그렇지 않으면 fn의 반환값이다.
+ */
+static int __csb_tree_scan(const struct csb_tree *tree, const void *x,
+                           int level, key_t start, int *remain,
+                           btree_visit_fn fn, void *private)
+{
+        int ret = 0;
+
+        if (level == 1) {
+                struct csb_leaf *leaf = (struct csb_leaf *)x;
+
+                for (int i = csb_tree_lower_bound(leaf, start);
+                     i < (int)leaf->n && *remain > 0; i++) {
+                        *remain -= 1;
+                        ret = fn(&leaf->items[i], private);
+                        if (ret) {
+                                return ret;
+                        }
+                }
+                return 0;
+        }
+        for (int i = csb_tree_route((const struct csb_inode *)x, start);
+             i <= (int)((const struct csb_inode *)x)->n && *remain > 0; i++) {
+                ret = __csb_tree_scan(
+                        tree,
+                        csb_tree_child(tree, (const struct csb_inode *)x, i,
+                                       level),
+                        level - 1, start, remain, fn, private);
+                if (ret) {
+                        return ret;
+                }
+        }
+        return 0;
+}
+
+/**
+ * @brief start 이상인 항목을 키 순서대로 최대 count개 방문한다.
+ *
+ * @param tree 트리를 가리키는 포인터에 해당한다.
+ * @param start 방문할 키의 하한(포함)에 해당한다.
+ * @param count 방문할 최대 항목의 수에 해당한다.
+ * @param fn 항목마다 호출되는 함수에 해당한다.
+ * @param private fn에 그대로 전달되는 값이다.
+ * @return int 방문한 항목의 수를 반환한다. fn이 0이 아닌 값을 반환하면
+ * 그 항목까지 세고 멈춘다.
+ */
+int csb_tree_scan(struct csb_tree *tree, key_t start, int count,
+                  btree_visit_fn fn, void *private)
+{
+        int remain = count;
+
+        __csb_tree_scan(tree, tree->root, tree->height, start, &remain, fn,
+                        private);
+        return count - remain;
+}
+
+/**
+ * @brief 노드 x가 가진 자식 그룹을 모두 해제한다.
+ */
+static void csb_tree_clear(struct csb_tree *tree, void *x, int level)
+{
+        struct csb_inode *node = (struct csb_inode *)x;
+
+        if (level == 1) {
+                return;
+        }
+        for (int i = 0; i <= (int)node->n; i++) {
+                csb_tree_clear(tree, csb_tree_child(tree, node, i, level),
+                               level - 1);
+        }
+        csb_tree_free_group(tree, node->children, node->n + 1,
+                            csb_tree_node_size(tree, level - 1));
+}
+
+/**
+ * @brief 동적 할당된 CSB+-Tree를 해제한다.
+ *
+ * @param tree 트리를 가리키는 포인터에 해당한다.
+ */
+void csb_tree_free(struct csb_tree *tree)
+{
+        if (!tree) {
+                return;
+        }
+        csb_tree_clear(tree, tree->root, tree->height);
+        free(tree->root);
+        free(tree);
+}
@@ -0,0 +1,60 @@
+/**
+ * @file csb-tree.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 자식을 그룹으로 모아 두는 CSB+-Tree(Cache Sensitive B+-Tree)에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _CSB_TREE_H
+#define _CSB_TREE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "btree.h"
+
+/**
+ * @brief 내부 노드에 해당한다.
+ * @details 자식 n + 1개는 children이 가리키는 한 덩어리(노드 그룹)에 차례대로
+ * 놓이므로 자식 포인터는 하나만 둔다. 키 배열이 노드의 대부분을 차지한다.
+ */
+struct csb_inode {
+        uint32_t n;
+        uint32_t reserved;
+        void *children; /**< 자식 노드 그룹의 시작 주소이다. */
+        key_t keys[];
+};
+
+/**
+ * @brief 잎 노드에 해당한다.
+ */
+struct csb_leaf {
+        uint32_t n;
+        uint32_t reserved;
+        struct btree_item items[];
+};
+
+/**
+ * @brief CSB+-Tree에 해당한다. 노드 하나에는 최대 2t - 1개의 키가 들어간다.
+ */
+struct csb_tree {
+        int min_degree;
+        int height; /**< 잎만 있으면 1이다. */
+        void *root; /**< 노드 하나로 이루어진 그룹이다. */
+        size_t inode_size;
+        size_t leaf_size;
+        unsigned long nr_keys;
+        size_t bytes; /**< 할당된 노드 그룹의 크기의 합이다. */
+};
+
+struct csb_tree *csb_tree_alloc(int min_degree);
+int csb_tree_insert(struct csb_tree *tree, key_t key, void *data);
+struct btree_item *csb_tree_search(struct csb_tree *tree, key_t key);
+int csb_tree_delete(struct csb_tree *tree, key_t key);
+int csb_tree_scan(struct csb_tree *tree, key_t start, int count,
+                  btree_visit_fn fn, void *private);
+void csb_tree_free(struct csb_tree *tree);
+
+#endif
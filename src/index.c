@@ -0,0 +1,282 @@
+/**
+ * @file index.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 각 자료 구조의 함수를 struct index_ops의 형태로 감싼다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#include <string.h>
+#include "index.h"
+#include "rbtree.h"
+#include "bst.h"
+#include "sorted-array.h"
+#include "csb-tree.h"
+
+static void *index_btree_alloc(int degree)
+{
+        return btree_alloc(degree);
+}
+
+static void index_btree_free(void *index)
+{
+        btree_free((struct btree *)index);
+}
+
+static int index_btree_insert(void *index, key_t key, void *data)
+{
+        btree_insert((struct btree *)index, key, data);
+        return 0;
+}
+
+static struct btree_item *index_btree_search(void *index, key_t key)
+{
+        struct btree_search_result result =
+                btree_search((struct btree *)index, key);
+        return result.node ? &result.node->items[result.index] : NULL;
+}
+
+static int index_btree_remove(void *index, key_t key)
+{
+        return btree_delete_quiet((struct btree *)index, key);
+}
+
+static int index_btree_scan(void *index, key_t start, int count,
+                            btree_visit_fn fn, void *private)
+{
+        return btree_scan((struct btree *)index, start, count, fn, private);
+}
+
+const struct index_ops index_btree_ops = {
+        .name = "btree",
+        .alloc = index_btree_alloc,
+        .free = index_btree_free,
+        .insert = index_btree_insert,
+        .load = NULL,
+        .search = index_btree_search,
+        .remove = index_btree_remove,
+        .scan = index_btree_scan,
+};
+
+static void *index_btree_arena_alloc(int degree)
+{
+        return btree_alloc_flags(degree, B_TREE_F_ARENA);
+}
+
+const struct index_ops index_btree_arena_ops = {
+        .name = "btree-arena",
+        .alloc = index_btree_arena_alloc,
+        .free = index_btree_free,
+        .insert = index_btree_insert,
+        .load = NULL,
+        .search = index_btree_search,
+        .remove = index_btree_remove,
+        .scan = index_btree_scan,
+};
+
+static void *index_rbtree_alloc(int degree)
+{
+        (void)degree;
+        return rbtree_alloc();
+}
+
+static void index_rbtree_free(void *index)
+{
+        rbtree_free((struct rbtree *)index);
+}
+
+static int index_rbtree_insert(void *index, key_t key, void *data)
+{
+        return rbtree_insert((struct rbtree *)index, key, data);
+}
+
+static struct btree_item *index_rbtree_search(void *index, key_t key)
+{
+        struct rbtree_node *node = rbtree_search((struct rbtree *)index, key);
+        return node ? &node->item : NULL;
+}
+
+static int index_rbtree_remove(void *index, key_t key)
+{
+        return rbtree_delete((struct rbtree *)index, key);
+}
+
+static int index_rbtree_scan(void *index, key_t start, int count,
+                             btree_visit_fn fn, void *private)
+{
+        return rbtree_scan((struct rbtree *)index, start, count, fn, private);
+}
+
+const struct index_ops index_rbtree_ops = {
+        .name = "rbtree",
+        .alloc = index_rbtree_alloc,
+        .free = index_rbtree_free,
+        .insert = index_rbtree_insert,
+        .load = NULL,
+        .search = index_rbtree_search,
+        .remove = index_rbtree_remove,
+        .scan = index_rbtree_scan,
+};
+
+static void *index_bst_alloc(int degree)
+{
+        (void)degree;
+        return bst_alloc();
+}
+
+static void index_bst_free(void *index)
+{
+        bst_free((struct bst *)index);
+}
+
+static int index_bst_insert(void *index, key_t key, void *data)
+{
+        return bst_insert((struct bst *)index, key, data);
+}
+
+static struct btree_item *index_bst_search(void *index, key_t key)
+{
+        struct bst_node *node = bst_search((struct bst *)index, key);
+        return node ? &node->item : NULL;
+}
+
+static int index_bst_remove(void *index, key_t key)
+{
+        return bst_delete((struct bst *)index, key);
+}
+
+static int index_bst_scan(void *index, key_t start, int count,
+                          btree_visit_fn fn, void *private)
+{
+        return bst_scan((struct bst *)index, start, count, fn, private);
+}
+
+const struct index_ops index_bst_ops = {
+        .name = "bst",
+        .alloc = index_bst_alloc,
+        .free = index_bst_free,
+        .insert = index_bst_insert,
+        .load = NULL,
+        .search = index_bst_search,
+        .remove = index_bst_remove,
+        .scan = index_bst_scan,
+};
+
+static void *index_sorted_array_alloc(int degree)
+{
+        (void)degree;
+        return sorted_array_alloc();
+}
+
+static void index_sorted_array_free(void *index)
+{
+        sorted_array_free((struct sorted_array *)index);
+}
+
+static int index_sorted_array_insert(void *index, key_t key, void *data)
+{
+        return sorted_array_insert((struct sorted_array *)index, key, data);
+}
+
+static int index_sorted_array_load(void *index, const struct btree_item *items,
+                                   long n)
+{
+        return sorted_array_load((struct sorted_array *)index, items, n);
+}
+
+static struct btree_item *index_sorted_array_search(void *index, key_t key)
+{
+        return sorted_array_search((struct sorted_array *)index, key);
+}
+
+static int index_sorted_array_remove(void *index, key_t key)
+{
+        return sorted_array_delete((struct sorted_array *)index, key);
+}
+
+static int index_sorted_array_scan(void *index, key_t start, int count,
+                                   btree_visit_fn fn, void *private)
+{
+        return sorted_array_scan((struct sorted_array *)index, start, count,
+                                 fn, private);
+}
+
+const struct index_ops index_sorted_array_ops = {
+        .name = "sorted-array",
+        .alloc = index_sorted_array_alloc,
+        .free = index_sorted_array_free,
+        .insert = index_sorted_array_insert,
+        .load = index_sorted_array_load,
+        .search = index_sorted_array_search,
+        .remove = index_sorted_array_remove,
+        .scan = index_sorted_array_scan,
+};
+
+static void *index_csb_tree_alloc(int degree)
+{
+        return csb_tree_alloc(degree);
+}
+
+static void index_csb_tree_free(void *index)
+{
+        csb_tree_free((struct csb_tree *)index);
+}
+
+static int index_csb_tree_insert(void *index, key_t key, void *data)
+{
+        return csb_tree_insert((struct csb_tree *)index, key, data);
+}
+
+static struct btree_item *index_csb_tree_search(void *index, key_t key)
+{
+        return csb_tree_search((struct csb_tree *)index, key);
+}
+
+static int index_csb_tree_remove(void *index, key_t key)
+{
+        return csb_tree_delete((struct csb_tree *)index, key);
+}
+
+static int index_csb_tree_scan(void *index, key_t start, int count,
+                               btree_visit_fn fn, void *private)
+{
+        return csb_tree_scan((struct csb_tree *)index, start, count, fn,
+                             private);
+}
+
+const struct index_ops index_csb_tree_ops = {
+        .name = "csb-tree",
+        .alloc = index_csb_tree_alloc,
+        .free = index_csb_tree_free,
+        .insert = index_csb_tree_insert,
+        .load = NULL,
+        .search = index_csb_tree_search,
+        .remove = index_csb_tree_remove,
+        .scan = index_csb_tree_scan,
+};
+
+/**
+ * @brief 사용할 수 있는 색인의 목록으로 NULL로 끝난다.
+ */
+const struct index_ops *const index_list[] = {
+        &index_btree_ops,        &index_btree_arena_ops, &index_rbtree_ops,
+        &index_bst_ops,          &index_sorted_array_ops, &index_csb_tree_ops,
+        NULL,
+};
+
+/**
+ * @brief 이름으로 색인의 연산 모음을 찾는다.
+ *
+ * @return const struct index_ops* 찾은 연산 모음을, 없는 경우에는 NULL을 반환한다.
+ */
+const struct index_ops *index_find(const char *name)
+{
+        for (int i = 0; index_list[i]; i++) {
+                if (!strcmp(index_list[i]->name, name)) {
+                        return index_list[i];
+                }
+        }
+        return NULL;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file index.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief B-Tree와 비교 대상 자료 구조를 같은 방식으로 다루기 위한 연산 모음이다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _INDEX_H
+#define _INDEX_H
+
+#include "btree.h"
+
+/**
+ * @brief 하나의 색인 자료 구조가 제공하는 연산의 모음에 해당한다.
+ * @details search가 반환한 항목의 data는 그 자리에서 바꿀 수 있으며,
+ * 반환된 포인터는 다음 insert나 remove 전까지만 유효하다.
+ */
+struct index_ops {
+        const char *name;
+        void *(*alloc)(int degree); /**< degree는 B-Tree만 사용한다. */
+        void (*free)(void *index);
+        int (*insert)(void *index, key_t key, void *data);
+        int (*load)(void *index, const struct btree_item *items,
+                    long n); /**< 없으면 NULL로 insert를 반복하면 된다. */
+        struct btree_item *(*search)(void *index, key_t key);
+        int (*remove)(void *index, key_t key); /**< 키가 없으면 음수를 반환한다. */
+        int (*scan)(void *index, key_t start, int count, btree_visit_fn fn,
+                    void *private);
+};
+
+extern const struct index_ops index_btree_ops;
+extern const struct index_ops index_btree_arena_ops;
+extern const struct index_ops index_rbtree_ops;
+extern const struct index_ops index_bst_ops;
+extern const struct index_ops index_sorted_array_ops;
+extern const struct index_ops index_csb_tree_ops;
+
+extern const struct index_ops *const index_list[];
+
+const struct index_ops *index_find(const char *name);
+
+#endif
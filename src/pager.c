@@ -0,0 +1,399 @@
+/**
+ * @file pager.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 고정 크기 페이지에 대한 버퍼 풀의 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 프레임의 교체는 CLOCK(second chance) 정책을 따른다. 고정(pin)된
+ * 프레임은 교체 대상에서 제외되며, 수정된 프레임은 내보낼 때 파일에 기록된다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "btree.h"
+#include "pager.h"
+
+/**
+ * @brief 페이지 번호에 해당하는 해시 버킷의 위치를 구한다.
+ */
+static int pager_bucket(struct pager *pager, pgno_t pgno)
+{
+        return (int)((pgno * 2654435761u) & (pager->nr_buckets - 1));
+}
+
+/**
+ * @brief 페이지 번호에 해당하는 프레임을 찾는다.
+ *
+ * @return int 프레임의 번호를 반환하며, 없는 경우에는 -1을 반환한다.
+ */
+static int pager_lookup(struct pager *pager, pgno_t pgno)
+{
+        int i = pager->buckets[pager_bucket(pager, pgno)];
+        while (i >= 0 && pager->frames[i].pgno != pgno) {
+                i = pager->frames[i].next;
+        }
+        return i;
+}
+
+/**
+ * @brief 프레임을 해시 테이블에서 제거하도록 한다.
+ */
+static void pager_unhash(struct pager *pager, int frame)
+{
+        const int bucket = pager_bucket(pager, pager->frames[frame].pgno);
+        int *link = &pager->buckets[bucket];
+        while (*link != frame) {
+                link = &pager->frames[*link].next;
+        }
+        *link = pager->frames[frame].next;
+}
+
+/**
+ * @brief 프레임을 해시 테이블에 넣도록 한다.
+ */
+static void pager_hash(struct pager *pager, int frame)
+{
+        int bucket = pager_bucket(pager, pager->frames[frame].pgno);
+        pager->frames[frame].next = pager->buckets[bucket];
+        pager->buckets[bucket] = frame;
+}
+
+/**
+ * @brief 프레임의 내용을 파일에 기록하도록 한다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+static int pager_write_frame(struct pager *pager, struct pager_frame *frame)
+{
+        const off_t offset = (off_t)frame->pgno * pager->page_size;
+        ssize_t ret = pwrite(pager->fd, frame->data, pager->page_size, offset);
+
+        if (ret != (ssize_t)pager->page_size) {
+                pr_info("Page write failed...(pgno: %u)\n", frame->pgno);
+                return -EIO;
+        }
+        frame->dirty = false;
+        pager->nr_dirty--;
+        pager->stats.writes++;
+        return 0;
+}
+
+/**
+ * @brief CLOCK 정책으로 비어있거나 내보낼 수 있는 프레임을 구하도록 한다.
+ *
+ * @return int 프레임 번호를 반환한다.
+ * @exception 모든 프레임이 고정된 경우나 기록에 실패한 경우에는 -1을 반환한다.
+ */
+static int pager_victim(struct pager *pager)
+{
+        for (int scan = 0; scan < 2 * pager->nr_frames; scan++) {
+                int i = pager->hand;
+                struct pager_frame *frame = &pager->frames[i];
+
+                pager->hand = (pager->hand + 1) % pager->nr_frames;
+                if (!frame->valid) {
+                        return i;
+                }
+                if (frame->pin > 0) {
+                        continue;
+                }
+                if (frame->dirty && pager->no_steal) {
+                        continue;
+                }
+                if (frame->ref) {
+                        frame->ref = false;
+                        continue;
+                }
+
+                if (frame->dirty && pager_write_frame(pager, frame)) {
+                        return -1;
+                }
+                pager_unhash(pager, i);
+                frame->valid = false;
+                pager->stats.evictions++;
+                return i;
+        }
+        pr_info("Every frame is pinned%s...\n",
+                pager->no_steal ? " or dirty" : "");
+        return -1;
+}
+
+/**
+ * @brief 프레임을 페이지에 연결하고 고정하도록 한다.
+ */
+static void *pager_install(struct pager *pager, int i, pgno_t pgno)
+{
+        struct pager_frame *frame = &pager->frames[i];
+
+        frame->pgno = pgno;
+        frame->valid = true;
+        frame->dirty = false;
+        frame->ref = true;
+        frame->pin = 1;
+        pager_hash(pager, i);
+        return frame->data;
+}
+
+/**
+ * @brief 새로운 버퍼 풀을 만들고 파일을 연다.
+ *
+ * @param path 페이지가 저장될 파일의 경로에 해당한다. 없으면 새로 만든다.
+ * @param page_size 페이지의 크기로 4KiB 이상 64KiB 이하의 2의 거듭제곱이어야 한다.
+ * @param nr_frames 버퍼 풀이 가지는 프레임의 수에 해당한다.
+ * @return struct pager* 정상적으로 열린 경우에는 버퍼 풀의 주소가 반환된다.
+ * @exception 인자가 잘못되었거나 할당, 파일 열기에 실패하면 NULL이 반환된다.
+ */
+struct pager *pager_open(const char *path, size_t page_size, int nr_frames)
+{
+        struct pager *pager = NULL;
+        struct stat st;
+
+        if (page_size < PAGER_MIN_PAGE_SIZE || page_size > PAGER_MAX_PAGE_SIZE ||
+            (page_size & (page_size - 1))) {
+                pr_info("Invalid page size(%zu)\n", page_size);
+                return NULL;
+        }
+        if (nr_frames < PAGER_MIN_FRAMES) {
+                pr_info("Buffer pool must have at least %d frames\n",
+                        PAGER_MIN_FRAMES);
+                return NULL;
+        }
+
+        pager = (struct pager *)calloc(1, sizeof(struct pager));
+        if (!pager) {
+                pr_info("Pager allocation failed...\n");
+                return NULL;
+        }
+        pager->fd = -1;
+        pager->page_size = page_size;
+        pager->nr_frames = nr_frames;
+
+        pager->frames = (struct pager_frame *)calloc(
+                nr_frames, sizeof(struct pager_frame));
+        if (!pager->frames) {
+                pr_info("Frame allocation failed...\n");
+                goto exception;
+        }
+        for (int i = 0; i < nr_frames; i++) {
+                pager->frames[i].data = aligned_alloc(page_size, page_size);
+                if (!pager->frames[i].data) {
+                        pr_info("Frame data allocation failed...\n");
+                        goto exception;
+                }
+        }
+
+        pager->nr_buckets = 1;
+        while (pager->nr_buckets < 2 * nr_frames) {
+                pager->nr_buckets <<= 1;
+        }
+        pager->buckets = (int *)malloc(pager->nr_buckets * sizeof(int));
+        if (!pager->buckets) {
+                pr_info("Bucket allocation failed...\n");
+                goto exception;
+        }
+        memset(pager->buckets, -1, pager->nr_buckets * sizeof(int));
+
+        pager->fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (pager->fd < 0 || fstat(pager->fd, &st)) {
+                pr_info("Cannot open %s\n", path);
+                goto exception;
+        }
+        pager->nr_pages = (pgno_t)(st.st_size / page_size);
+
+        return pager;
+
+exception:
+        pager_close(pager);
+        return NULL;
+}
+
+/**
+ * @brief 페이지를 버퍼 풀에 올리고 고정하도록 한다.
+ *
+ * @param pager 버퍼 풀을 가리키는 포인터에 해당한다.
+ * @param pgno 고정하고자 하는 페이지 번호에 해당한다.
+ * @return void* 페이지 내용의 주소를 반환한다. pager_unpin() 전까지 유효하다.
+ * @exception 범위를 벗어나거나 내보낼 프레임이 없는 경우에는 NULL이 반환된다.
+ */
+void *pager_pin(struct pager *pager, pgno_t pgno)
+{
+        int i = pager_lookup(pager, pgno);
+        void *data = NULL;
+        ssize_t ret = 0;
+
+        if (i >= 0) {
+                pager->frames[i].pin++;
+                pager->frames[i].ref = true;
+                pager->stats.hits++;
+                return pager->frames[i].data;
+        }
+
+        if (pgno >= pager->nr_pages) {
+                pr_info("Page out of range...(pgno: %u)\n", pgno);
+                return NULL;
+        }
+
+        i = pager_victim(pager);
+        if (i < 0) {
+                return NULL;
+        }
+        pager->stats.misses++;
+        pager->stats.reads++;
+
+        data = pager->frames[i].data;
+        ret = pread(pager->fd, data, pager->page_size,
+                    (off_t)pgno * pager->page_size);
+        if (ret < 0) {
+                pr_info("Page read failed...(pgno: %u)\n", pgno);
+                return NULL;
+        }
+        if ((size_t)ret < pager->page_size) { /**< 아직 기록되지 않은 페이지 */
+                memset((char *)data + ret, 0, pager->page_size - ret);
+        }
+        return pager_install(pager, i, pgno);
+}
+
+/**
+ * @brief 파일 끝에 새로운 페이지를 만들고 고정하도록 한다.
+ *
+ * @param pager 버퍼 풀을 가리키는 포인터에 해당한다.
+ * @param pgno 새로 만든 페이지의 번호가 반환된다.
+ * @return void* 0으로 초기화된 페이지 내용의 주소를 반환한다.
+ * @exception 내보낼 프레임이 없는 경우에는 NULL이 반환된다.
+ */
+void *pager_pin_new(struct pager *pager, pgno_t *pgno)
+{
+        int i = pager_victim(pager);
+        void *data = NULL;
+
+        if (i < 0) {
+                return NULL;
+        }
+
+        *pgno = pager->nr_pages++;
+        data = pager_install(pager, i, *pgno);
+        memset(data, 0, pager->page_size);
+        pager->frames[i].dirty = true;
+        pager->nr_dirty++;
+        return data;
+}
+
+/**
+ * @brief 페이지의 고정을 해제하도록 한다.
+ *
+ * @param pager 버퍼 풀을 가리키는 포인터에 해당한다.
+ * @param pgno 고정을 해제하고자 하는 페이지 번호에 해당한다.
+ * @param dirty 고정한 동안 페이지를 수정한 경우에는 true를 준다.
+ */
+void pager_unpin(struct pager *pager, pgno_t pgno, bool dirty)
+{
+        int i = pager_lookup(pager, pgno);
+
+        if (i < 0 || pager->frames[i].pin <= 0) {
+                pr_info("Unpin without pin...(pgno: %u)\n", pgno);
+                return;
+        }
+        pager->frames[i].pin--;
+        if (dirty && !pager->frames[i].dirty) {
+                pager->frames[i].dirty = true;
+                pager->nr_dirty++;
+        }
+        if (pager->evict_on_unpin && !pager->frames[i].pin &&
+            !pager->frames[i].dirty) {
+                /* 고정을 푼 뒤에 프레임을 읽는 곳이 잘못된 값을 보도록 한다. */
+                pager_unhash(pager, i);
+                pager->frames[i].valid = false;
+                memset(pager->frames[i].data, 0xa5, pager->page_size);
+        }
+}
+
+/**
+ * @brief 수정된 모든 프레임에 대해서 fn을 호출하도록 한다.
+ * @details 체크포인트에서 수정된 페이지의 이미지를 로그에 남길 때 사용한다.
+ *
+ * @return int fn이 0이 아닌 값을 반환하면 중단하고 그 값을 반환한다.
+ */
+int pager_for_each_dirty(struct pager *pager,
+                         int (*fn)(pgno_t pgno, void *data, void *private),
+                         void *private)
+{
+        for (int i = 0; i < pager->nr_frames; i++) {
+                struct pager_frame *frame = &pager->frames[i];
+                if (frame->valid && frame->dirty) {
+                        int ret = fn(frame->pgno, frame->data, private);
+                        if (ret) {
+                                return ret;
+                        }
+                }
+        }
+        return 0;
+}
+
+/**
+ * @brief 수정된 모든 프레임을 파일에 기록하도록 한다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int pager_flush(struct pager *pager)
+{
+        for (int i = 0; i < pager->nr_frames; i++) {
+                struct pager_frame *frame = &pager->frames[i];
+                if (frame->valid && frame->dirty) {
+                        int ret = pager_write_frame(pager, frame);
+                        if (ret) {
+                                return ret;
+                        }
+                }
+        }
+        return 0;
+}
+
+/**
+ * @brief 수정된 프레임을 기록한 후에 파일을 저장 장치에 반영하도록 한다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int pager_sync(struct pager *pager)
+{
+        int ret = pager_flush(pager);
+        if (ret) {
+                return ret;
+        }
+        return fsync(pager->fd) ? -errno : 0;
+}
+
+/**
+ * @brief 수정된 내용을 기록하고 버퍼 풀을 해제하도록 한다.
+ * @note no-steal로 동작하는 경우에는 수정된 내용을 기록하지 않는다.
+ *
+ * @param pager 버퍼 풀을 가리키는 포인터에 해당한다.
+ */
+void pager_close(struct pager *pager)
+{
+        if (!pager) {
+                return;
+        }
+
+        if (pager->fd >= 0) {
+                if (!pager->no_steal) { /**< 체크포인트 밖에서 기록해서는 안된다. */
+                        pager_flush(pager);
+                }
+                close(pager->fd);
+        }
+        if (pager->frames) {
+                for (int i = 0; i < pager->nr_frames; i++) {
+                        free(pager->frames[i].data);
+                }
+                free(pager->frames);
+        }
+        free(pager->buckets);
+        free(pager);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file pager.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 고정 크기 페이지를 파일에서 읽고 쓰는 버퍼 풀에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _PAGER_H
+#define _PAGER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PAGER_MIN_PAGE_SIZE (4 * 1024) /**< 페이지의 최소 크기에 해당한다. */
+#define PAGER_MAX_PAGE_SIZE (64 * 1024) /**< 페이지의 최대 크기에 해당한다. */
+#define PAGER_MIN_FRAMES 16 /**< 버퍼 풀이 가져야 하는 최소 프레임 수에 해당한다. */
+
+typedef uint32_t pgno_t;
+
+/**
+ * @brief 버퍼 풀에서 하나의 페이지를 담는 공간에 해당한다.
+ */
+struct pager_frame {
+        pgno_t pgno; /**< 현재 담고 있는 페이지 번호를 가진다. */
+        int pin; /**< 사용 중인 곳의 수로 0이 아니면 내보낼 수 없다. */
+        bool valid; /**< 페이지를 담고 있는 지에 대한 정보를 가진다. */
+        bool dirty; /**< 파일에 반영되지 않은 수정이 있는 지를 가진다. */
+        bool ref; /**< CLOCK 교체 정책에서 사용하는 참조 비트이다. */
+        int next; /**< 같은 해시 버킷에 있는 다음 프레임의 번호이다. */
+        void *data;
+};
+
+/**
+ * @brief 버퍼 풀의 동작에 대한 통계를 가진다.
+ */
+struct pager_stats {
+        unsigned long hits;
+        unsigned long misses;
+        unsigned long evictions;
+        unsigned long reads;
+        unsigned long writes;
+};
+
+/**
+ * @brief 하나의 파일을 고정 크기 페이지의 배열로 다루는 버퍼 풀에 해당한다.
+ * @details 페이지는 pager_pin()으로 고정한 동안에만 접근할 수 있으며,
+ * 고정이 풀린 페이지는 CLOCK 정책에 따라 내보내질 수 있다.
+ */
+struct pager {
+        int fd;
+        size_t page_size;
+        pgno_t nr_pages; /**< 파일에 할당된 페이지의 수를 가진다. */
+
+        int nr_frames;
+        struct pager_frame *frames;
+        int *buckets; /**< 페이지 번호로 프레임을 찾는 해시 테이블이다. */
+        int nr_buckets;
+        int hand; /**< CLOCK의 현재 위치를 가리킨다. */
+        int nr_dirty; /**< 수정된 프레임의 수를 가진다. */
+        bool no_steal; /**< 설정되면 수정된 프레임은 내보내지 않는다. */
+        bool evict_on_unpin; /**< 디버깅용으로, 고정이 모두 풀린 깨끗한 프레임을 바로 내보내고 내용을 지운다. */
+
+        struct pager_stats stats;
+};
+
+struct pager *pager_open(const char *path, size_t page_size, int nr_frames);
+void *pager_pin(struct pager *pager, pgno_t pgno);
+void *pager_pin_new(struct pager *pager, pgno_t *pgno);
+void pager_unpin(struct pager *pager, pgno_t pgno, bool dirty);
+int pager_for_each_dirty(struct pager *pager,
+                         int (*fn)(pgno_t pgno, void *data, void *private),
+                         void *private);
+int pager_flush(struct pager *pager);
+int pager_sync(struct pager *pager);
+void pager_close(struct pager *pager);
+
+#endif
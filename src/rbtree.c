@@ -0,0 +1,413 @@
+/**
+ * @file rbtree.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 비교를 위한 Red-Black Tree의 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details B-Tree와 같이 CLRS 13장의 의사 코드(RB-INSERT, RB-DELETE)를 기반으로
+ * 작성하였다. B-Tree와 같은 조건에서 비교할 수 있도록 같은 키를 여러 번
+ * 넣는 것을 허용한다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#include <stdlib.h>
+#include <errno.h>
+#include "rbtree.h"
+
+/**
+ * @brief 새로운 Red-Black Tree를 할당하도록 한다.
+ *
+ * @return struct rbtree* 할당된 트리를, 동적 할당을 실패한 경우에는 NULL을 반환한다.
+ */
+struct rbtree *rbtree_alloc(void)
+{
+        struct rbtree *tree = (struct rbtree *)malloc(sizeof(struct rbtree));
+
+        if (!tree) {
+                pr_info("Allocation tree failed\n");
+                return NULL;
+        }
+        tree->nil.red = false;
+        tree->nil.parent = tree->nil.left = tree->nil.right = &tree->nil;
+        tree->root = &tree->nil;
+        tree->size = 0;
+        return tree;
+}
+
+static void rbtree_left_rotate(struct rbtree *T, struct rbtree_node *x)
+{
+        struct rbtree_node *y = x->right;
+
+        x->right = y->left;
+        if (y->left != &T->nil) {
+                y->left->parent = x;
+        }
+        y->parent = x->parent;
+        if (x->parent == &T->nil) {
+                T->root = y;
+        } else if (x == x->parent->left) {
+                x->parent->left = y;
+        } else {
+                x->parent->right = y;
+        }
+        y->left = x;
+        x->parent = y;
+}
+
+static void rbtree_right_rotate(struct rbtree *T, struct rbtree_node *x)
+{
+        struct rbtree_node *y = x->left;
+
+        x->left = y->right;
+        if (y->right != &T->nil) {
+                y->right->parent = x;
+        }
+        y->parent = x->parent;
+        if (x->parent == &T->nil) {
+                T->root = y;
+        } else if (x == x->parent->right) {
+                x->parent->right = y;
+        } else {
+                x->parent->left = y;
+        }
+        y->right = x;
+        x->parent = y;
+}
+
+static void rbtree_insert_fixup(struct rbtree *T, struct rbtree_node *z)
+{
+        while (z->parent->red) {
+                struct rbtree_node *gp = z->parent->parent;
+
+                if (z->parent == gp->left) {
+                        struct rbtree_node *y = gp->right;
+                        if (y->red) { /**< case 1 */
+                                z->parent->red = false;
+                                y->red = false;
+                                gp->red = true;
+                                z = gp;
+                                continue;
+                        }
+                        if (z == z->parent->right) { /**< case 2 */
+                                z = z->parent;
+                                rbtree_left_rotate(T, z);
+                        }
+                        z->parent->red = false; /**< case 3 */
+                        z->parent->parent->red = true;
+                        rbtree_right_rotate(T, z->parent->parent);
+                } else {
+                        struct rbtree_node *y = gp->left;
+                        if (y->red) {
+                                z->parent->red = false;
+                                y->red = false;
+                                gp->red = true;
+                                z = gp;
+                                continue;
+                        }
+                        if (z == z->parent->left) {
+                                z = z->parent;
+                                rbtree_right_rotate(T, z);
+                        }
+                        z->parent->red = false;
+                        z->parent->parent->red = true;
+                        rbtree_left_rotate(T, z->parent->parent);
+                }
+        }
+        T->root->red = false;
+}
+
+/**
+ * @brief 트리에 항목을 삽입하도록 한다.
+ *
+ * @param tree 트리를 가리키는 포인터에 해당한다.
+ * @param key 삽입하고자 하는 키에 해당한다.
+ * @param data 키와 함께 삽입되는 데이터에 해당한다.
+ * @return int 성공 시에 0을, 동적 할당을 실패한 경우에는 -ENOMEM을 반환한다.
+ */
+int rbtree_insert(struct rbtree *tree, key_t key, void *data)
+{
+        struct rbtree_node *z = NULL;
+        struct rbtree_node *y = &tree->nil;
+        struct rbtree_node *x = tree->root;
+
+        z = (struct rbtree_node *)malloc(sizeof(struct rbtree_node));
+        if (!z) {
+                pr_info("Node allocation failed...\n");
+                return -ENOMEM;
+        }
+        z->item.key = key;
+        z->item.data = data;
+
+        while (x != &tree->nil) {
+                y = x;
+                x = (key < x->item.key) ? x->left : x->right;
+        }
+        z->parent = y;
+        if (y == &tree->nil) {
+                tree->root = z;
+        } else if (key < y->item.key) {
+                y->left = z;
+        } else {
+                y->right = z;
+        }
+        z->left = z->right = &tree->nil;
+        z->red = true;
+        rbtree_insert_fixup(tree, z);
+        tree->size++;
+        return 0;
+}
+
+/**
+ * @brief 키에 해당하는 노드를 찾는다.
+ *
+ * @return struct rbtree_node* 찾은 노드를, 없는 경우에는 NULL을 반환한다.
+ */
+struct rbtree_node *rbtree_search(struct rbtree *tree, key_t key)
+{
+        struct rbtree_node *x = tree->root;
+
+        while (x != &tree->nil && key != x->item.key) {
+                x = (key < x->item.key) ? x->left : x->right;
+        }
+        return (x != &tree->nil) ? x : NULL;
+}
+
+static void rbtree_transplant(struct rbtree *T, struct rbtree_node *u,
+                              struct rbtree_node *v)
+{
+        if (u->parent == &T->nil) {
+                T->root = v;
+        } else if (u == u->parent->left) {
+                u->parent->left = v;
+        } else {
+                u->parent->right = v;
+        }
+        v->parent = u->parent;
+}
+
+static struct rbtree_node *rbtree_minimum(struct rbtree *T,
+                                          struct rbtree_node *x)
+{
+        while (x->left != &T->nil) {
+                x = x->left;
+        }
+        return x;
+}
+
+static void rbtree_delete_fixup(struct rbtree *T, struct rbtree_node *x)
+{
+        while (x != T->root && !x->red) {
+                if (x == x->parent->left) {
+                        struct rbtree_node *w = x->parent->right;
+                        if (w->red) { /**< case 1 */
+                                w->red = false;
+                                x->parent->red = true;
+                                rbtree_left_rotate(T, x->parent);
+                                w = x->parent->right;
+                        }
+                        if (!w->left->red && !w->right->red) { /**< case 2 */
+                                w->red = true;
+                                x = x->parent;
+                                continue;
+                        }
+                        if (!w->right->red) { /**< case 3 */
+                                w->left->red = false;
+                                w->red = true;
+                                rbtree_right_rotate(T, w);
+                                w = x->parent->right;
+                        }
+                        w->red = x->parent->red; /**< case 4 */
+                        x->parent->red = false;
+                        w->right->red = false;
+                        rbtree_left_rotate(T, x->parent);
+                        x = T->root;
+                } else {
+                        struct rbtree_node *w = x->parent->left;
+                        if (w->red) {
+                                w->red = false;
+                                x->parent->red = true;
+                                rbtree_right_rotate(T, x->parent);
+                                w = x->parent->left;
+                        }
+                        if (!w->right->red && !w->left->red) {
+                                w->red = true;
+                                x = x->parent;
+                                continue;
+                        }
+                        if (!w->left->red) {
+                                w->right->red = false;
+                                w->red = true;
+                                rbtree_left_rotate(T, w);
+                                w = x->parent->left;
+                        }
+                        w->red = x->parent->red;
+                        x->parent->red = false;
+                        w->left->red = false;
+                        rbtree_right_rotate(T, x->parent);
+                        x = T->root;
+                }
+        }
+        x->red = false;
+}
+
+/**
+ * @brief 키에 해당하는 항목 하나를 삭제하도록 한다.
+ *
+ * @return int 성공 시에 0을, 키가 없는 경우에는 -EINVAL을 반환한다.
+ */
+int rbtree_delete(struct rbtree *tree, key_t key)
+{
+        struct rbtree_node *z = rbtree_search(tree, key);
+        struct rbtree_node *x = NULL;
+        struct rbtree_node *y = NULL;
+        bool y_red = false;
+
+        if (!z) {
+                return -EINVAL;
+        }
+
+        y = z;
+        y_red = y->red;
+        if (z->left == &tree->nil) {
+                x = z->right;
+                rbtree_transplant(tree, z, z->right);
+        } else if (z->right == &tree->nil) {
+                x = z->left;
+                rbtree_transplant(tree, z, z->left);
+        } else {
+                y = rbtree_minimum(tree, z->right);
+                y_red = y->red;
+                x = y->right;
+                if (y->parent == z) {
+                        x->parent = y; /**< x가 nil인 경우에도 fixup에서 필요하다. */
+                } else {
+                        rbtree_transplant(tree, y, y->right);
+                        y->right = z->right;
+                        y->right->parent = y;
+                }
+                rbtree_transplant(tree, z, y);
+                y->left = z->left;
+                y->left->parent = y;
+                y->red = z->red;
+        }
+        if (!y_red) {
+                rbtree_delete_fixup(tree, x);
+        }
+        free(z);
+        tree->size--;
+        return 0;
+}
+
+/**
+ * @brief start 이상인 항목을 키 순서대로 최대 count개 방문한다.
+ *
+ * @return int 방문한 항목의 수를 반환한다. fn이 0이 아닌 값을 반환하면
+ * 그 항목까지 세고 방문을 멈춘다.
+ */
+int rbtree_scan(struct rbtree *tree, key_t start, int count, btree_visit_fn fn,
+                void *private)
+{
+        struct rbtree_node *x = tree->root;
+        struct rbtree_node *next = NULL; /**< start 이상인 가장 작은 노드 */
+        int visited = 0;
+
+        while (x != &tree->nil) {
+                if (x->item.key >= start) {
+                        next = x;
+                        x = x->left;
+                } else {
+                        x = x->right;
+                }
+        }
+
+        for (x = next; x && visited < count;) {
+                visited++;
+                if (fn(&x->item, private)) {
+                        break;
+                }
+                if (x->right != &tree->nil) { /**< 다음 노드로 이동한다. */
+                        x = rbtree_minimum(tree, x->right);
+                        continue;
+                }
+                while (x->parent != &tree->nil && x == x->parent->right) {
+                        x = x->parent;
+                }
+                x = (x->parent != &tree->nil) ? x->parent : NULL;
+        }
+        return visited;
+}
+
+/**
+ * @brief 트리 전체를 해제한다.
+ */
+void rbtree_free(struct rbtree *tree)
+{
+        struct rbtree_node *x = NULL;
+
+        if (!tree) {
+                return;
+        }
+        x = tree->root;
+        while (x != &tree->nil) { /**< 재귀 없이 leaf부터 차례로 해제한다. */
+                struct rbtree_node *parent = x->parent;
+
+                if (x->left != &tree->nil) {
+                        x = x->left;
+                        continue;
+                }
+                if (x->right != &tree->nil) {
+                        x = x->right;
+                        continue;
+                }
+                if (parent != &tree->nil) {
+                        if (parent->left == x) {
+                                parent->left = &tree->nil;
+                        } else {
+                                parent->right = &tree->nil;
+                        }
+                }
+                free(x);
+                x = parent;
+        }
+        free(tree);
+}
+
+#ifdef RB_TREE_DEBUG
+static int __rbtree_validate(struct rbtree *T, struct rbtree_node *x)
+{
+        int left = 0, right = 0;
+
+        if (x == &T->nil) {
+                return 1;
+        }
+        if (x->red && (x->left->red || x->right->red)) {
+                pr_info("Red node(%u) has red child\n", x->item.key);
+                return -EINVAL;
+        }
+        if ((x->left != &T->nil && x->left->item.key > x->item.key) ||
+            (x->right != &T->nil && x->right->item.key < x->item.key)) {
+                pr_info("Order violated at node(%u)\n", x->item.key);
+                return -EINVAL;
+        }
+        left = __rbtree_validate(T, x->left);
+        right = __rbtree_validate(T, x->right);
+        if (left < 0 || right < 0 || left != right) {
+                return -EINVAL;
+        }
+        return left + !x->red;
+}
+
+/**
+ * @brief Red-Black Tree의 성질을 모두 만족하는 지 검사한다.
+ *
+ * @return int 만족하는 경우에는 black height를, 그렇지 않으면 -EINVAL을 반환한다.
+ */
+int rbtree_validate(struct rbtree *tree)
+{
+        if (tree->root->red) {
+                return -EINVAL;
+        }
+        return __rbtree_validate(tree, tree->root);
+}
+#endif
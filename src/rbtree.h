@@ -0,0 +1,48 @@
+/**
+ * @file rbtree.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 비교를 위한 Red-Black Tree에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _RB_TREE_H
+#define _RB_TREE_H
+
+#include "btree.h"
+
+/**
+ * @brief Red-Black Tree의 노드에 해당한다.
+ */
+struct rbtree_node {
+        struct btree_item item;
+        struct rbtree_node *parent;
+        struct rbtree_node *left;
+        struct rbtree_node *right;
+        bool red;
+};
+
+/**
+ * @brief Red-Black Tree 전체를 관리하는 구조체에 해당한다.
+ * @note 빈 자리는 NULL 대신 nil을 가리키도록 하여 CLRS의 의사 코드를 그대로 따른다.
+ */
+struct rbtree {
+        struct rbtree_node *root;
+        struct rbtree_node nil; /**< 항상 black인 경계 노드 */
+        long size;
+};
+
+struct rbtree *rbtree_alloc(void);
+int rbtree_insert(struct rbtree *tree, key_t key, void *data);
+struct rbtree_node *rbtree_search(struct rbtree *tree, key_t key);
+int rbtree_delete(struct rbtree *tree, key_t key);
+int rbtree_scan(struct rbtree *tree, key_t start, int count, btree_visit_fn fn,
+                void *private);
+void rbtree_free(struct rbtree *tree);
+#ifdef RB_TREE_DEBUG
+int rbtree_validate(struct rbtree *tree);
+#endif
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ * @file sorted-array.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 비교를 위한 정렬된 배열(이진 탐색)의 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 탐색은 O(log n)이지만 삽입과 삭제는 뒤쪽 항목을 모두 옮기므로
+ * O(n)이다. 그래서 한꺼번에 넣는 경우를 위해 sorted_array_load()를 따로 둔다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "sorted-array.h"
+
+/**
+ * @brief 빈 배열을 할당하도록 한다.
+ *
+ * @return struct sorted_array* 할당된 배열을, 동적 할당을 실패한 경우에는 NULL을 반환한다.
+ */
+struct sorted_array *sorted_array_alloc(void)
+{
+        struct sorted_array *array = NULL;
+
+        array = (struct sorted_array *)malloc(sizeof(struct sorted_array));
+        if (!array) {
+                pr_info("Allocation array failed\n");
+                goto exception;
+        }
+        array->n = 0;
+        array->capacity = SORTED_ARRAY_INIT_CAPACITY;
+        array->items = (struct btree_item *)malloc(array->capacity *
+                                                   sizeof(struct btree_item));
+        if (!array->items) {
+                pr_info("Allocation items failed\n");
+                goto exception;
+        }
+        return array;
+
+exception:
+        free(array);
+        return NULL;
+}
+
+/**
+ * @brief 최소 capacity개의 항목이 들어갈 수 있도록 배열을 늘린다.
+ */
+static int sorted_array_reserve(struct sorted_array *array, long capacity)
+{
+        struct btree_item *items = NULL;
+        long new_capacity = array->capacity;
+
+        if (capacity <= array->capacity) {
+                return 0;
+        }
+        while (new_capacity < capacity) {
+                new_capacity *= 2;
+        }
+        items = (struct btree_item *)realloc(
+                array->items, new_capacity * sizeof(struct btree_item));
+        if (!items) {
+                pr_info("Reallocation items failed\n");
+                return -ENOMEM;
+        }
+        array->items = items;
+        array->capacity = new_capacity;
+        return 0;
+}
+
+/**
+ * @brief key 이상인(upper가 참이면 key 초과인) 첫 위치를 찾는다.
+ */
+static long sorted_array_bound(const struct sorted_array *array, key_t key,
+                               bool upper)
+{
+        long lo = 0, hi = array->n;
+
+        while (lo < hi) {
+                const long mid = lo + (hi - lo) / 2;
+                const key_t mid_key = array->items[mid].key;
+
+                if (mid_key < key || (upper && mid_key == key)) {
+                        lo = mid + 1;
+                } else {
+                        hi = mid;
+                }
+        }
+        return lo;
+}
+
+/**
+ * @brief 정렬 순서를 유지하며 항목을 삽입하도록 한다.
+ *
+ * @return int 성공 시에 0을, 동적 할당을 실패한 경우에는 -ENOMEM을 반환한다.
+ */
+int sorted_array_insert(struct sorted_array *array, key_t key, void *data)
+{
+        long i = 0;
+        int ret = sorted_array_reserve(array, array->n + 1);
+
+        if (ret) {
+                return ret;
+        }
+        i = sorted_array_bound(array, key, true);
+        memmove(&array->items[i + 1], &array->items[i],
+                (array->n - i) * sizeof(struct btree_item));
+        array->items[i].key = key;
+        array->items[i].data = data;
+        array->n++;
+        return 0;
+}
+
+static int sorted_array_compare(const void *a, const void *b)
+{
+        const key_t x = ((const struct btree_item *)a)->key;
+        const key_t y = ((const struct btree_item *)b)->key;
+        return (x > y) - (x < y);
+}
+
+/**
+ * @brief 여러 항목을 한꺼번에 넣는다. 뒤에 붙인 뒤에 전체를 다시 정렬한다.
+ *
+ * @param array 배열을 가리키는 포인터에 해당한다.
+ * @param items 넣을 항목들로 정렬되어 있지 않아도 된다.
+ * @param n 넣을 항목의 수에 해당한다.
+ * @return int 성공 시에 0을, 동적 할당을 실패한 경우에는 -ENOMEM을 반환한다.
+ */
+int sorted_array_load(struct sorted_array *array,
+                      const struct btree_item *items, long n)
+{
+        int ret = sorted_array_reserve(array, array->n + n);
+
+        if (ret) {
+                return ret;
+        }
+        memcpy(&array->items[array->n], items, n * sizeof(struct btree_item));
+        array->n += n;
+        qsort(array->items, array->n, sizeof(struct btree_item),
+              sorted_array_compare);
+        return 0;
+}
+
+/**
+ * @brief 키에 해당하는 항목을 이진 탐색으로 찾는다.
+ *
+ * @return struct btree_item* 찾은 항목을, 없는 경우에는 NULL을 반환한다.
+ * 반환된 포인터는 다음 삽입이나 삭제 전까지만 유효하다.
+ */
+struct btree_item *sorted_array_search(struct sorted_array *array, key_t key)
+{
+        const long i = sorted_array_bound(array, key, false);
+
+        if (i < array->n && array->items[i].key == key) {
+                return &array->items[i];
+        }
+        return NULL;
+}
+
+/**
+ * @brief 키에 해당하는 항목 하나를 삭제하도록 한다.
+ *
+ * @return int 성공 시에 0을, 키가 없는 경우에는 -EINVAL을 반환한다.
+ */
+int sorted_array_delete(struct sorted_array *array, key_t key)
+{
+        const long i = sorted_array_bound(array, key, false);
+
+        if (i >= array->n || array->items[i].key != key) {
+                return -EINVAL;
+        }
+        array->n--;
+        memmove(&array->items[i], &array->items[i + 1],
+                (array->n - i) * sizeof(struct btree_item));
+        return 0;
+}
+
+/**
+ * @brief start 이상인 항목을 키 순서대로 최대 count개 방문한다.
+ *
+ * @return int 방문한 항목의 수를 반환한다. fn이 0이 아닌 값을 반환하면
+ * 그 항목까지 세고 방문을 멈춘다.
+ */
+int sorted_array_scan(struct sorted_array *array, key_t start, int count,
+                      btree_visit_fn fn, void *private)
+{
+        long i = sorted_array_bound(array, start, false);
+        int visited = 0;
+
+        for (; i < array->n && visited < count; i++) {
+                visited++;
+                if (fn(&array->items[i], private)) {
+                        break;
+                }
+        }
+        return visited;
+}
+
+/**
+ * @brief 배열 전체를 해제한다.
+ */
+void sorted_array_free(struct sorted_array *array)
+{
+        if (array) {
+                free(array->items);
+                free(array);
+        }
+}
@@ -0,0 +1,37 @@
+/**
+ * @file sorted-array.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 비교를 위한 정렬된 배열(이진 탐색)에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _SORTED_ARRAY_H
+#define _SORTED_ARRAY_H
+
+#include "btree.h"
+
+#define SORTED_ARRAY_INIT_CAPACITY 64
+
+/**
+ * @brief 키 순서로 정렬된 항목의 배열에 해당한다.
+ */
+struct sorted_array {
+        struct btree_item *items;
+        long n;
+        long capacity;
+};
+
+struct sorted_array *sorted_array_alloc(void);
+int sorted_array_insert(struct sorted_array *array, key_t key, void *data);
+int sorted_array_load(struct sorted_array *array,
+                      const struct btree_item *items, long n);
+struct btree_item *sorted_array_search(struct sorted_array *array, key_t key);
+int sorted_array_delete(struct sorted_array *array, key_t key);
+int sorted_array_scan(struct sorted_array *array, key_t start, int count,
+                      btree_visit_fn fn, void *private);
+void sorted_array_free(struct sorted_array *array);
+
+#endif
@@ -0,0 +1,392 @@
+/**
+ * @file wal.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief WAL(Write-Ahead Log)의 기록과 읽기에 대한 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "btree.h"
+#include "wal.h"
+
+#define WAL_INIT_BUF_SIZE (64 * 1024)
+
+/**
+ * @brief CRC-32(IEEE)를 계산하도록 한다.
+ */
+static uint32_t wal_crc32(uint32_t crc, const void *data, size_t len)
+{
+        static uint32_t table[256];
+        static bool ready = false;
+        const unsigned char *p = (const unsigned char *)data;
+
+        if (!ready) {
+                for (uint32_t i = 0; i < 256; i++) {
+                        uint32_t c = i;
+                        for (int k = 0; k < 8; k++) {
+                                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                        }
+                        table[i] = c;
+                }
+                ready = true;
+        }
+
+        crc = ~crc;
+        for (size_t i = 0; i < len; i++) {
+                crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+}
+
+/**
+ * @brief 레코드의 crc를 계산하도록 한다.
+ */
+static uint32_t wal_record_crc(const struct wal_record *rec,
+                               const void *payload)
+{
+        uint32_t crc = wal_crc32(0, &rec->len,
+                                 sizeof(struct wal_record) - sizeof(uint32_t));
+        return wal_crc32(crc, payload, rec->len);
+}
+
+/**
+ * @brief 로그 파일을 열도록 한다. 기존 내용은 그대로 두고 끝에서부터 이어 쓴다.
+ *
+ * @param path 로그 파일의 경로에 해당한다.
+ * @param config commit 정책에 해당한다. NULL이면 WAL_SYNC_PER_OP를 쓴다.
+ * @return struct wal* 정상적으로 열린 경우에는 WAL의 주소가 반환된다.
+ * @exception 할당이나 파일 열기에 실패한 경우에는 NULL이 반환된다.
+ */
+struct wal *wal_open(const char *path, const struct wal_config *config)
+{
+        struct wal *wal = NULL;
+        struct stat st;
+
+        wal = (struct wal *)calloc(1, sizeof(struct wal));
+        if (!wal) {
+                pr_info("WAL allocation failed...\n");
+                return NULL;
+        }
+
+        if (config) {
+                wal->config = *config;
+        }
+        if (wal->config.batch <= 0) {
+                wal->config.batch = WAL_DEFAULT_BATCH;
+        }
+        if (wal->config.interval_us <= 0) {
+                wal->config.interval_us = WAL_DEFAULT_INTERVAL_US;
+        }
+
+        wal->buf_cap = WAL_INIT_BUF_SIZE;
+        wal->buf = (char *)malloc(wal->buf_cap);
+        if (!wal->buf) {
+                pr_info("WAL buffer allocation failed...\n");
+                free(wal);
+                return NULL;
+        }
+
+        wal->fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (wal->fd < 0 || fstat(wal->fd, &st)) {
+                pr_info("Cannot open %s\n", path);
+                wal_close(wal);
+                return NULL;
+        }
+        wal->offset = st.st_size;
+        clock_gettime(CLOCK_MONOTONIC, &wal->last_sync);
+
+        return wal;
+}
+
+/**
+ * @brief 버퍼가 need 바이트를 담을 수 있도록 늘린다.
+ *
+ * @return int 성공 시에 0을, 할당에 실패하면 -ENOMEM을 반환한다.
+ */
+static int wal_reserve(struct wal *wal, size_t need)
+{
+        size_t cap = wal->buf_cap;
+        char *buf = NULL;
+
+        if (need <= cap) {
+                return 0;
+        }
+        while (cap < need) {
+                cap *= 2;
+        }
+        buf = (char *)realloc(wal->buf, cap);
+        if (!buf) {
+                pr_info("WAL buffer allocation failed...\n");
+                return -ENOMEM;
+        }
+        wal->buf = buf;
+        wal->buf_cap = cap;
+        return 0;
+}
+
+/**
+ * @brief 머리와 본문 두 부분으로 이루어진 레코드를 버퍼에 추가한다.
+ * @details 페이지 이미지처럼 (페이지 번호, 내용)을 복사 없이 기록할 때 쓴다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int wal_append2(struct wal *wal, enum wal_type type, const void *head,
+                size_t head_len, const void *body, size_t body_len)
+{
+        const size_t len = head_len + body_len;
+        const size_t need =
+                wal->buf_len + sizeof(struct wal_record) + WAL_ALIGN(len);
+        struct wal_record *rec = NULL;
+        char *payload = NULL;
+
+        if (wal_reserve(wal, need)) {
+                return -ENOMEM;
+        }
+
+        rec = (struct wal_record *)(wal->buf + wal->buf_len);
+        payload = (char *)(rec + 1);
+        memset(rec, 0, sizeof(struct wal_record));
+        rec->len = (uint32_t)len;
+        rec->lsn = wal->lsn++;
+        rec->type = (uint8_t)type;
+        if (head_len) {
+                memcpy(payload, head, head_len);
+        }
+        if (body_len) {
+                memcpy(payload + head_len, body, body_len);
+        }
+        memset(payload + len, 0, WAL_ALIGN(len) - len);
+        rec->crc = wal_record_crc(rec, payload);
+
+        wal->buf_len = need;
+        wal->stats.records++;
+        return 0;
+}
+
+/**
+ * @brief 레코드를 버퍼에 추가한다. 저장 장치에는 wal_commit()에서 반영된다.
+ *
+ * @param wal WAL을 가리키는 포인터에 해당한다.
+ * @param type 레코드의 종류에 해당한다.
+ * @param payload 레코드의 내용에 해당한다.
+ * @param len 레코드 내용의 길이에 해당한다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int wal_append(struct wal *wal, enum wal_type type, const void *payload,
+               size_t len)
+{
+        return wal_append2(wal, type, payload, len, NULL, 0);
+}
+
+/**
+ * @brief 버퍼에 모인 레코드를 파일에 쓰고 fsync 하도록 한다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int wal_sync(struct wal *wal)
+{
+        size_t done = 0;
+
+        while (done < wal->buf_len) {
+                ssize_t ret = pwrite(wal->fd, wal->buf + done,
+                                     wal->buf_len - done,
+                                     (off_t)(wal->offset + done));
+                if (ret <= 0) {
+                        pr_info("WAL write failed...\n");
+                        return -EIO;
+                }
+                done += ret;
+        }
+        wal->offset += done;
+        wal->stats.bytes += done;
+        wal->buf_len = 0;
+
+        if (fdatasync(wal->fd)) {
+                pr_info("WAL sync failed...\n");
+                return -errno;
+        }
+        wal->nr_pending = 0;
+        wal->stats.syncs++;
+        clock_gettime(CLOCK_MONOTONIC, &wal->last_sync);
+        return 0;
+}
+
+/**
+ * @brief 하나의 연산이 끝났음을 알리고 정책에 따라 fsync 하도록 한다.
+ * @details WAL_SYNC_BATCH와 WAL_SYNC_TIME에서는 fsync를 미룬 연산들이
+ * 다음 fsync를 함께 사용한다. 시간 정책은 연산이 들어올 때만 검사하므로
+ * 더 이상 연산이 없는 경우에는 wal_sync()를 직접 불러야 한다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int wal_commit(struct wal *wal)
+{
+        struct timespec now;
+        long elapsed_us = 0;
+
+        wal->nr_pending++;
+        wal->stats.commits++;
+
+        switch (wal->config.policy) {
+        case WAL_SYNC_BATCH:
+                if (wal->nr_pending < wal->config.batch) {
+                        return 0;
+                }
+                break;
+        case WAL_SYNC_TIME:
+                clock_gettime(CLOCK_MONOTONIC, &now);
+                elapsed_us = (now.tv_sec - wal->last_sync.tv_sec) * 1000000L +
+                             (now.tv_nsec - wal->last_sync.tv_nsec) / 1000L;
+                if (elapsed_us < wal->config.interval_us) {
+                        return 0;
+                }
+                break;
+        case WAL_SYNC_PER_OP:
+        default:
+                break;
+        }
+        return wal_sync(wal);
+}
+
+/**
+ * @brief 이미 만들어진 레코드들을 그대로 버퍼에 덧붙인다.
+ * @details 복구 중에 체크포인트를 하는 경우, 아직 재실행하지 않은 레코드를
+ * 체크포인트 뒤로 옮겨 적을 때 사용한다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int wal_write_raw(struct wal *wal, const void *data, size_t len)
+{
+        if (wal_reserve(wal, wal->buf_len + len)) {
+                return -ENOMEM;
+        }
+        memcpy(wal->buf + wal->buf_len, data, len);
+        wal->buf_len += len;
+        return 0;
+}
+
+/**
+ * @brief 로그 파일을 size 길이로 자르고 버퍼를 비우도록 한다.
+ * @details 체크포인트가 끝난 후에는 0으로, 복구 시에는 잘린 꼬리를 버리기
+ * 위해서 마지막으로 온전한 레코드의 끝으로 자른다.
+ *
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int wal_truncate(struct wal *wal, int64_t size)
+{
+        wal->buf_len = 0;
+        wal->nr_pending = 0;
+        wal->offset = size;
+        if (ftruncate(wal->fd, (off_t)size) || fdatasync(wal->fd)) {
+                pr_info("WAL truncate failed...\n");
+                return -errno;
+        }
+        return 0;
+}
+
+/**
+ * @brief 남은 레코드를 반영하고 WAL을 닫는다.
+ *
+ * @param wal WAL을 가리키는 포인터에 해당한다.
+ */
+void wal_close(struct wal *wal)
+{
+        if (!wal) {
+                return;
+        }
+        if (wal->fd >= 0) {
+                if (wal->buf_len) {
+                        wal_sync(wal);
+                }
+                close(wal->fd);
+        }
+        free(wal->buf);
+        free(wal);
+}
+
+/**
+ * @brief 로그 파일 전체를 읽어 반복자를 준비하도록 한다.
+ *
+ * @param it 반복자를 가리키는 포인터에 해당한다.
+ * @param path 로그 파일의 경로에 해당한다. 없으면 빈 로그로 본다.
+ * @return int 성공 시에 0을, 실패 시에는 음수의 errno를 반환한다.
+ */
+int wal_iter_open(struct wal_iter *it, const char *path)
+{
+        struct stat st;
+        size_t done = 0;
+        int fd = -1;
+
+        memset(it, 0, sizeof(struct wal_iter));
+        fd = open(path, O_RDONLY);
+        if (fd < 0) {
+                return (errno == ENOENT) ? 0 : -errno;
+        }
+        if (fstat(fd, &st)) {
+                close(fd);
+                return -errno;
+        }
+
+        it->size = (size_t)st.st_size;
+        it->data = (char *)malloc(it->size ? it->size : 1);
+        if (!it->data) {
+                close(fd);
+                return -ENOMEM;
+        }
+        while (done < it->size) {
+                ssize_t ret = pread(fd, it->data + done, it->size - done, done);
+                if (ret <= 0) {
+                        break;
+                }
+                done += ret;
+        }
+        it->size = done;
+        close(fd);
+        return 0;
+}
+
+/**
+ * @brief 다음 레코드를 가져오도록 한다.
+ *
+ * @param it 반복자를 가리키는 포인터에 해당한다.
+ * @param rec 레코드의 머리가 반환된다.
+ * @param payload 레코드의 내용이 반환된다.
+ * @return int 레코드가 있으면 1을, 로그의 끝이거나 잘린 레코드면 0을 반환한다.
+ */
+int wal_iter_next(struct wal_iter *it, struct wal_record **rec, void **payload)
+{
+        struct wal_record *r = NULL;
+
+        if (it->pos + sizeof(struct wal_record) > it->size) {
+                return 0;
+        }
+        r = (struct wal_record *)(it->data + it->pos);
+        if (it->pos + sizeof(struct wal_record) + WAL_ALIGN(r->len) > it->size ||
+            wal_record_crc(r, r + 1) != r->crc) {
+                return 0;
+        }
+
+        *rec = r;
+        *payload = r + 1;
+        it->pos += sizeof(struct wal_record) + WAL_ALIGN(r->len);
+        return 1;
+}
+
+/**
+ * @brief 반복자가 가진 메모리를 해제하도록 한다.
+ */
+void wal_iter_close(struct wal_iter *it)
+{
+        free(it->data);
+        memset(it, 0, sizeof(struct wal_iter));
+}
@@ -0,0 +1,137 @@
+/**
+ * @file wal.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 파일 B-Tree의 복구를 위한 WAL(Write-Ahead Log)에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _WAL_H
+#define _WAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#define WAL_DEFAULT_BATCH 64 /**< WAL_SYNC_BATCH의 기본 묶음 크기 */
+#define WAL_DEFAULT_INTERVAL_US 1000 /**< WAL_SYNC_TIME의 기본 간격(us) */
+
+/**
+ * @brief 레코드는 8바이트 단위로 놓이도록 payload 뒤를 채운다.
+ */
+#define WAL_ALIGN(len) (((len) + 7) & ~(size_t)7)
+
+/**
+ * @brief 로그 레코드의 종류에 해당한다.
+ */
+enum wal_type {
+        WAL_INSERT = 1, /**< 논리적 삽입 (key, value) */
+        WAL_DELETE, /**< 논리적 삭제 (key) */
+        WAL_SPLIT, /**< 노드 분할 (parent, child, index) */
+        WAL_MERGE, /**< 노드 병합 (parent, child, index) */
+        WAL_BORROW, /**< 형제에게서 빌려옴 (parent, child, index) */
+        WAL_PAGE, /**< 체크포인트 시점의 페이지 이미지 (pgno, data) */
+        WAL_CHECKPOINT_BEGIN,
+        WAL_CHECKPOINT_END,
+};
+
+/**
+ * @brief 로그를 저장 장치에 반영(fsync)하는 시점에 대한 정책이다.
+ */
+enum wal_policy {
+        WAL_SYNC_PER_OP = 0, /**< 연산마다 fsync 한다. */
+        WAL_SYNC_BATCH, /**< batch개의 연산이 모이면 한 번에 fsync 한다. */
+        WAL_SYNC_TIME, /**< 마지막 fsync 후 interval_us가 지나면 fsync 한다. */
+};
+
+/**
+ * @brief WAL의 설정에 해당한다. 0으로 둔 항목은 기본값이 사용된다.
+ */
+struct wal_config {
+        enum wal_policy policy;
+        int batch;
+        long interval_us;
+};
+
+/**
+ * @brief 파일에 기록되는 레코드의 머리 부분에 해당한다.
+ * @details crc는 머리의 나머지와 payload 전체에 대해 계산한다.
+ */
+struct wal_record {
+        uint32_t crc;
+        uint32_t len; /**< 머리 뒤에 오는 payload의 길이(8바이트 정렬 전) */
+        uint64_t lsn;
+        uint8_t type; /**< enum wal_type */
+        uint8_t reserved[7];
+};
+
+/**
+ * @brief 구조 변경 레코드(split, merge, borrow)의 payload에 해당한다.
+ */
+struct wal_smo {
+        uint32_t parent;
+        uint32_t child;
+        int32_t index;
+        uint32_t reserved;
+};
+
+/**
+ * @brief WAL의 동작에 대한 통계를 가진다.
+ */
+struct wal_stats {
+        unsigned long records;
+        unsigned long commits; /**< wal_commit()이 불린 횟수 */
+        unsigned long syncs; /**< 실제로 fsync를 수행한 횟수 */
+        unsigned long bytes;
+};
+
+/**
+ * @brief 하나의 로그 파일에 대한 쓰기 상태를 가진다.
+ * @details 레코드는 메모리 버퍼에 모였다가 정책에 따라 한 번의 write와
+ * fsync로 기록되며(group commit), 여러 연산이 하나의 fsync를 공유한다.
+ */
+struct wal {
+        int fd;
+        struct wal_config config;
+        uint64_t lsn; /**< 다음에 기록할 레코드의 번호 */
+        int64_t offset; /**< 파일에 기록된 위치 */
+
+        char *buf;
+        size_t buf_len;
+        size_t buf_cap;
+
+        int nr_pending; /**< fsync를 기다리는 연산의 수 */
+        struct timespec last_sync;
+
+        struct wal_stats stats;
+};
+
+/**
+ * @brief 로그 파일을 처음부터 읽어가는 반복자에 해당한다.
+ * @details crc가 맞지 않거나 잘린 레코드를 만나면 거기서 끝난 것으로 본다.
+ */
+struct wal_iter {
+        char *data;
+        size_t size;
+        size_t pos;
+};
+
+struct wal *wal_open(const char *path, const struct wal_config *config);
+int wal_append(struct wal *wal, enum wal_type type, const void *payload,
+               size_t len);
+int wal_append2(struct wal *wal, enum wal_type type, const void *head,
+                size_t head_len, const void *body, size_t body_len);
+int wal_commit(struct wal *wal);
+int wal_sync(struct wal *wal);
+int wal_write_raw(struct wal *wal, const void *data, size_t len);
+int wal_truncate(struct wal *wal, int64_t size);
+void wal_close(struct wal *wal);
+
+int wal_iter_open(struct wal_iter *it, const char *path);
+int wal_iter_next(struct wal_iter *it, struct wal_record **rec, void **payload);
+void wal_iter_close(struct wal_iter *it);
+
+#endif
@@ -0,0 +1,304 @@
+/**
+ * @file workload.c
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 키 분포 생성기에 대한 세부 구현이 적혀있다.
+ * @version 0.1
+ * @date 2026-10-19
+ * @details 난수는 splitmix64로 상태를 초기화한 xoshiro256**를 사용한다.
+ * zipfian은 Gray et al.의 "Quickly generating billion-record synthetic
+ * databases"(YCSB와 같은 방법)을 따르며, 키 공간이 늘어나면 zeta를
+ * 점진적으로 갱신한다.
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include "workload.h"
+
+static const char *workload_names[NR_WORKLOAD_DIST] = {
+        "sequential", "shuffle", "uniform", "zipfian", "latest", "hotspot",
+};
+
+static uint64_t workload_splitmix64(uint64_t *state)
+{
+        uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+}
+
+static inline uint64_t workload_rotl(uint64_t x, int k)
+{
+        return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * @brief 난수 생성기의 상태를 seed로 초기화한다.
+ */
+void workload_rng_seed(struct workload_rng *rng, uint64_t seed)
+{
+        for (int i = 0; i < 4; i++) {
+                rng->s[i] = workload_splitmix64(&seed);
+        }
+}
+
+/**
+ * @brief 64비트 난수를 생성한다(xoshiro256**).
+ */
+uint64_t workload_rng_next(struct workload_rng *rng)
+{
+        uint64_t *s = rng->s;
+        const uint64_t result = workload_rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = workload_rotl(s[3], 45);
+        return result;
+}
+
+/**
+ * @brief [0, 1) 사이의 실수 난수를 생성한다.
+ */
+double workload_rng_double(struct workload_rng *rng)
+{
+        return (double)(workload_rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
+/**
+ * @brief 분포의 이름을 반환한다.
+ */
+const char *workload_name(enum workload_dist dist)
+{
+        return (dist < NR_WORKLOAD_DIST) ? workload_names[dist] : "unknown";
+}
+
+/**
+ * @brief "name[:param[:param]]" 형태의 문자열을 설정으로 바꾼다.
+ * @details zipfian, latest는 theta를, hotspot은 hot_fraction과 hot_ratio를,
+ * sequential은 gap을 인자로 받는다. 예: "zipfian:0.8", "hotspot:0.1:0.9"
+ *
+ * @param spec 분포를 나타내는 문자열에 해당한다.
+ * @param config 분포와 인자가 채워질 설정으로 나머지 항목은 바뀌지 않는다.
+ * @return int 성공 시에 0을, 알 수 없는 이름이면 -EINVAL을 반환한다.
+ */
+int workload_parse(const char *spec, struct workload_config *config)
+{
+        const char *colon = strchr(spec, ':');
+        const size_t len = colon ? (size_t)(colon - spec) : strlen(spec);
+        double param[2] = { 0, 0 };
+        int dist = -1;
+
+        for (int i = 0; i < NR_WORKLOAD_DIST; i++) {
+                if (strlen(workload_names[i]) == len &&
+                    !strncmp(spec, workload_names[i], len)) {
+                        dist = i;
+                }
+        }
+        if (dist < 0) {
+                return -EINVAL;
+        }
+        for (int i = 0; colon && i < 2; i++) {
+                param[i] = atof(colon + 1);
+                colon = strchr(colon + 1, ':');
+        }
+
+        config->dist = (enum workload_dist)dist;
+        switch (config->dist) {
+        case WORKLOAD_ZIPFIAN:
+        case WORKLOAD_LATEST:
+                config->theta = param[0];
+                break;
+        case WORKLOAD_HOTSPOT:
+                config->hot_fraction = param[0];
+                config->hot_ratio = param[1];
+                break;
+        case WORKLOAD_SEQUENTIAL:
+                config->gap = (uint64_t)param[0];
+                break;
+        default:
+                break;
+        }
+        return 0;
+}
+
+/**
+ * @brief zipfian의 상수 eta를 현재의 키 공간에 맞추어 계산한다.
+ */
+static void workload_zipf_update(struct workload *wl)
+{
+        const double theta = wl->config.theta;
+
+        wl->eta = (1.0 - pow(2.0 / (double)wl->n, 1.0 - theta)) /
+                  (1.0 - wl->zeta2 / wl->zetan);
+}
+
+/**
+ * @brief 생성기를 초기화하도록 한다.
+ *
+ * @param wl 초기화할 생성기에 해당한다.
+ * @param config 분포와 키 공간에 대한 설정에 해당한다.
+ * @return int 성공 시에 0을, 설정이 올바르지 않으면 -EINVAL을 반환한다.
+ *
+ * @note zipfian과 latest는 초기화에 키 공간의 크기에 비례하는 시간이 걸린다.
+ */
+int workload_init(struct workload *wl, const struct workload_config *config)
+{
+        memset(wl, 0, sizeof(struct workload));
+        wl->config = *config;
+        if (!wl->config.theta) {
+                wl->config.theta = WORKLOAD_DEFAULT_THETA;
+        }
+        if (!wl->config.hot_fraction) {
+                wl->config.hot_fraction = WORKLOAD_DEFAULT_HOT_FRACTION;
+        }
+        if (!wl->config.hot_ratio) {
+                wl->config.hot_ratio = WORKLOAD_DEFAULT_HOT_RATIO;
+        }
+        if (!wl->config.gap) {
+                wl->config.gap = WORKLOAD_DEFAULT_GAP;
+        }
+
+        if (config->n < 1 || config->dist >= NR_WORKLOAD_DIST ||
+            wl->config.theta <= 0 || wl->config.theta >= 1 ||
+            wl->config.hot_fraction > 1 || wl->config.hot_ratio > 1) {
+                return -EINVAL;
+        }
+
+        workload_rng_seed(&wl->rng, config->seed);
+        wl->n = config->n;
+
+        if (config->dist == WORKLOAD_SHUFFLE) {
+                int bits = 1;
+                while (bits < 64 && (1ull << bits) < wl->n) {
+                        bits++;
+                }
+                wl->mask = (bits == 64) ? ~0ull : (1ull << bits) - 1;
+                wl->shift = (bits + 1) / 2;
+        }
+
+        if (config->dist == WORKLOAD_ZIPFIAN || config->dist == WORKLOAD_LATEST) {
+                const double theta = wl->config.theta;
+
+                wl->alpha = 1.0 / (1.0 - theta);
+                wl->zeta2 = 1.0 + pow(0.5, theta);
+                for (uint64_t i = 1; i <= wl->n; i++) {
+                        wl->zetan += 1.0 / pow((double)i, theta);
+                }
+                workload_zipf_update(wl);
+        }
+        return 0;
+}
+
+/**
+ * @brief [0, n)에서 0에 가까울수록 자주 나오는 순위를 생성한다.
+ */
+static uint64_t workload_zipf(struct workload *wl)
+{
+        const double u = workload_rng_double(&wl->rng);
+        const double uz = u * wl->zetan;
+        uint64_t rank = 0;
+
+        if (uz < 1.0) {
+                return 0;
+        }
+        if (uz < wl->zeta2) {
+                return 1;
+        }
+        rank = (uint64_t)((double)wl->n *
+                          pow(wl->eta * u - wl->eta + 1.0, wl->alpha));
+        return rank < wl->n ? rank : wl->n - 1;
+}
+
+/**
+ * @brief [0, mask]에서의 전단사 함수로 순번을 섞는다.
+ * @details 홀수 곱, 덧셈, 상위 비트 xor는 모두 2^k에서 전단사이다.
+ */
+static uint64_t workload_permute(const struct workload *wl, uint64_t x)
+{
+        const uint64_t seed = wl->config.seed | 1;
+
+        for (int round = 0; round < 3; round++) {
+                x = (x * 0x9e3779b97f4a7c15ull + seed) & wl->mask;
+                x ^= x >> wl->shift;
+        }
+        return x;
+}
+
+/**
+ * @brief 분포에 따라 다음 키를 생성하도록 한다.
+ *
+ * @param wl 생성기를 가리키는 포인터에 해당한다.
+ * @return uint64_t [0, n) 사이의 키를 반환한다.
+ */
+uint64_t workload_next(struct workload *wl)
+{
+        uint64_t key = 0;
+
+        switch (wl->config.dist) {
+        case WORKLOAD_SEQUENTIAL:
+                key = wl->next % wl->n;
+                wl->next += 1 + (wl->config.gap > 1 ?
+                                         workload_rng_next(&wl->rng) %
+                                                 wl->config.gap :
+                                         0);
+                break;
+        case WORKLOAD_SHUFFLE:
+                do { /**< cycle walking으로 [0, n)을 벗어난 값은 건너뛴다. */
+                        key = workload_permute(wl, wl->next++ & wl->mask);
+                } while (key >= wl->n);
+                break;
+        case WORKLOAD_UNIFORM:
+                key = workload_rng_next(&wl->rng) % wl->n;
+                break;
+        case WORKLOAD_ZIPFIAN:
+                key = workload_zipf(wl);
+                break;
+        case WORKLOAD_LATEST:
+                key = wl->n - 1 - workload_zipf(wl);
+                break;
+        case WORKLOAD_HOTSPOT: {
+                const uint64_t hot = (uint64_t)((double)wl->n *
+                                                wl->config.hot_fraction);
+                const bool in_hot = hot > 0 && workload_rng_double(&wl->rng) <
+                                                       wl->config.hot_ratio;
+
+                if (in_hot) {
+                        key = workload_rng_next(&wl->rng) % hot;
+                } else if (hot < wl->n) {
+                        key = hot + workload_rng_next(&wl->rng) % (wl->n - hot);
+                } else {
+                        key = workload_rng_next(&wl->rng) % wl->n;
+                }
+                break;
+        }
+        default:
+                break;
+        }
+        return key;
+}
+
+/**
+ * @brief 키 공간을 하나 늘리고 새로 추가된 키를 반환한다.
+ * @details latest 분포는 이 키를 가장 자주 생성하게 된다.
+ *
+ * @param wl 생성기를 가리키는 포인터에 해당한다.
+ * @return uint64_t 새로 추가된 키(이전의 n)를 반환한다.
+ */
+uint64_t workload_insert(struct workload *wl)
+{
+        const uint64_t key = wl->n++;
+
+        if (wl->config.dist == WORKLOAD_ZIPFIAN ||
+            wl->config.dist == WORKLOAD_LATEST) {
+                wl->zetan += 1.0 / pow((double)wl->n, wl->config.theta);
+                workload_zipf_update(wl);
+        }
+        return key;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file workload.h
+ * @author 오기준 (kijunking@pusan.ac.kr)
+ * @brief 테스트와 벤치마크에서 사용하는 키 분포 생성기에 대한 선언이 들어가 있다.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 오기준
+ *
+ */
+#ifndef _WORKLOAD_H
+#define _WORKLOAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define WORKLOAD_DEFAULT_THETA 0.99 /**< YCSB의 zipfian 기본값 */
+#define WORKLOAD_DEFAULT_HOT_FRACTION 0.2
+#define WORKLOAD_DEFAULT_HOT_RATIO 0.8
+#define WORKLOAD_DEFAULT_GAP 1
+
+/**
+ * @brief xoshiro256** 의사 난수 생성기의 상태에 해당한다.
+ */
+struct workload_rng {
+        uint64_t s[4];
+};
+
+/**
+ * @brief 키의 분포에 해당한다.
+ */
+enum workload_dist {
+        WORKLOAD_SEQUENTIAL = 0, /**< 0부터 [1, gap] 간격으로 증가한다. */
+        WORKLOAD_SHUFFLE, /**< [0, n)의 순열로 반복되지 않는다. */
+        WORKLOAD_UNIFORM,
+        WORKLOAD_ZIPFIAN, /**< 0에 가까울수록 자주 나온다. */
+        WORKLOAD_LATEST, /**< 최근에 추가된 키일수록 자주 나온다. */
+        WORKLOAD_HOTSPOT, /**< hot_ratio의 확률로 앞쪽 hot_fraction 안에서 나온다. */
+        NR_WORKLOAD_DIST,
+};
+
+/**
+ * @brief 생성기의 설정에 해당한다. 0으로 둔 항목은 기본값이 사용된다.
+ */
+struct workload_config {
+        enum workload_dist dist;
+        uint64_t n; /**< 키 공간 [0, n)의 크기에 해당한다. */
+        uint64_t seed;
+        double theta; /**< zipfian, latest의 기울기로 (0, 1) 사이여야 한다. */
+        double hot_fraction;
+        double hot_ratio;
+        uint64_t gap;
+};
+
+/**
+ * @brief 하나의 키 생성기에 해당한다.
+ */
+struct workload {
+        struct workload_config config;
+        struct workload_rng rng;
+        uint64_t n; /**< 현재 키 공간의 크기로 workload_insert()로 늘어난다. */
+        uint64_t next; /**< sequential, shuffle에서 다음 순번 */
+
+        uint64_t mask; /**< shuffle에서 n 이상의 2의 거듭제곱 - 1 */
+        int shift;
+
+        double alpha; /**< zipfian의 상수들 */
+        double zetan;
+        double zeta2;
+        double eta;
+};
+
+void workload_rng_seed(struct workload_rng *rng, uint64_t seed);
+uint64_t workload_rng_next(struct workload_rng *rng);
+double workload_rng_double(struct workload_rng *rng);
+
+int workload_parse(const char *spec, struct workload_config *config);
+const char *workload_name(enum workload_dist dist);
+int workload_init(struct workload *wl, const struct workload_config *config);
+uint64_t workload_next(struct workload *wl);
+uint64_t workload_insert(struct workload *wl);
+
+#endif
@@ -1,19 +1,55 @@
+#define _POSIX_C_SOURCE 200809L
 #include "btree.h"
+#include "btree-disk.h"
+#include "btree-image.h"
+#include "betree.h"
+#include "workload.h"
+#include "btree-trace.h"
+#include "btree-arena.h"
+#include "btree-generic.h"
+#include "btree-str.h"
+#include "btree-shm.h"
+#include "csb-tree.h"
+#include "index.h"
+#include "rbtree.h"
+#include "bst.h"
 #include "unity.h"
 #include <time.h>
 #include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <stdatomic.h>
+#include <pthread.h>
 
 struct btree *tree;
 
-// #define SHUFFLE
-// #define RANDOM
-
 #define MAX_SIZE 100000
 #define REMAIN 5
 #define TEST_LOOP 2
 #define ARR_SIZE(T) ((int)(sizeof(T) / sizeof(key_t)))
 
+/**
+ * 차수가 고정된 빌드(make test DEGREE=8)에서는 다른 차수로 트리를 만들 수 없으므로
+ * 차수에 의존하지 않는 테스트는 고정된 차수를 대신 사용한다.
+ */
+#ifdef B_TREE_FIXED_DEGREE
+#define TEST_DEGREE(T) (B_TREE_FIXED_DEGREE)
+#else
+#define TEST_DEGREE(T) (T)
+#endif
+/** 결과가 차수에 따라 달라지는 검사는 그 차수로 트리를 만들 수 있을 때만 한다. */
+#define TEST_DEGREE_IS(T) (TEST_DEGREE(T) == (T))
+
+/**
+ * 키의 분포는 B_TREE_TEST_KEYS 환경 변수로 고를 수 있다(기본값은 sequential).
+ * 예: B_TREE_TEST_KEYS=zipfian:0.9 B_TREE_TEST_SEED=42 ./test.out
+ */
+#define TEST_KEYS_ENV "B_TREE_TEST_KEYS"
+#define TEST_SEED_ENV "B_TREE_TEST_SEED"
+
 key_t keys[MAX_SIZE] = { 0 };
+static bool keys_unique; /**< keys가 [0, MAX_SIZE)의 순열인 지를 가진다. */
 
 static void seqential(key_t *keys, int n)
 {
@@ -22,38 +58,48 @@ static void seqential(key_t *keys, int n)
         }
 }
 
-#if defined(SHUFFLE)
-static void shuffle(key_t *keys, int n)
+static void generate(key_t *keys, int n)
 {
-        int choice = 0;
-        int temp = 0;
-        srand(time(NULL));
+        const char *spec = getenv(TEST_KEYS_ENV);
+        const char *seed = getenv(TEST_SEED_ENV);
+        struct workload_config config = {
+                .dist = WORKLOAD_SEQUENTIAL,
+                .n = (uint64_t)n,
+                .seed = seed ? strtoull(seed, NULL, 0) : (uint64_t)time(NULL),
+        };
+        struct workload wl;
+
+        if (spec && workload_parse(spec, &config)) {
+                pr_info("Unknown key distribution(%s)\n", spec);
+                config.dist = WORKLOAD_SEQUENTIAL;
+        }
+        if (workload_init(&wl, &config)) {
+                pr_info("Invalid key distribution(%s)\n", spec);
+                seqential(keys, n);
+                keys_unique = true;
+                return;
+        }
         for (int i = 0; i < n; i++) {
-                choice = rand() % n;
-                temp = keys[choice];
-                keys[choice] = keys[i];
-                keys[i] = temp;
+                keys[i] = (key_t)workload_next(&wl);
         }
+        keys_unique = config.dist == WORKLOAD_SHUFFLE ||
+                      (config.dist == WORKLOAD_SEQUENTIAL && wl.config.gap == 1);
 }
-#elif defined(RANDOM)
-#define RANDOM_SPACE (INT_MAX)
 
-static void random(key_t *keys, int n)
+/**
+ * @brief 키가 [0, MAX_SIZE)의 순열이어야 하는 테스트에서 사용한다.
+ */
+static void require_unique_keys(void)
 {
-        srand(time(NULL));
-        for (int i = 0; i < n; i++) {
-                keys[i] = rand() % RANDOM_SPACE;
+        if (!keys_unique) {
+                seqential(keys, ARR_SIZE(keys));
+                keys_unique = true;
         }
 }
-#endif
+
 void setUp(void)
 {
-        seqential(keys, ARR_SIZE(keys));
-#if defined(SHUFFLE)
-        shuffle(keys, ARR_SIZE(keys));
-#elif defined(RANDOM)
-        random(keys, ARR_SIZE(keys));
-#endif
+        generate(keys, ARR_SIZE(keys));
 }
 
 void tearDown(void)
@@ -67,6 +113,9 @@ static void test_tree(int min_degree)
         struct btree_search_result result;
         int ret;
 
+        if (!TEST_DEGREE_IS(min_degree)) {
+                TEST_IGNORE_MESSAGE("Degree is fixed at build time");
+        }
         tree = btree_alloc(min_degree);
         TEST_ASSERT_NOT_NULL(tree);
 
@@ -89,10 +138,10 @@ static void test_tree(int min_degree)
                         TEST_ASSERT_NOT_NULL(result.node);
                         ret = btree_delete(tree, del);
                         TEST_ASSERT_EQUAL(0, ret);
-#ifndef RANDOM
-                        result = btree_search(tree, del);
-                        TEST_ASSERT_NULL(result.node);
-#endif
+                        if (keys_unique) {
+                                result = btree_search(tree, del);
+                                TEST_ASSERT_NULL(result.node);
+                        }
                 }
         }
 
@@ -139,6 +188,1712 @@ void test_234_tree(void)
         printf("=======> %lfs\n", (double)(end - start) / CLOCKS_PER_SEC);
 }
 
+void test_auto_degree_tree(void)
+{
+        struct btree_cache_info info;
+        const int degree = btree_auto_degree(0);
+        const int page_degree = btree_auto_degree(B_TREE_AUTO_PAGE);
+        clock_t start = clock();
+        int calibrated = 0;
+
+        btree_cache_info(&info);
+        TEST_ASSERT_TRUE(info.line_size > 0 && info.page_size > 0);
+        TEST_ASSERT_TRUE(info.l1d_size > 0 && info.l2_size > 0);
+        TEST_ASSERT_TRUE(degree >= B_TREE_MIN_DEGREE);
+#ifndef B_TREE_FIXED_DEGREE /* 고정된 차수는 캐시 크기와 상관없이 반환된다. */
+        TEST_ASSERT_TRUE(B_TREE_NR_KEYS(degree) * sizeof(struct btree_item) <=
+                         (size_t)(16 * info.line_size));
+        TEST_ASSERT_TRUE(B_TREE_NR_KEYS(page_degree) *
+                                 sizeof(struct btree_item) <=
+                         (size_t)info.page_size);
+#endif
+
+        calibrated = btree_auto_degree(B_TREE_AUTO_CALIBRATE);
+        TEST_ASSERT_TRUE(calibrated >= B_TREE_MIN_DEGREE);
+        TEST_ASSERT_EQUAL(calibrated, btree_auto_degree(B_TREE_AUTO_CALIBRATE));
+        printf("auto degree %d(page %d, calibrated %d) =======> %lfs\n",
+               degree, page_degree, calibrated,
+               (double)(clock() - start) / CLOCKS_PER_SEC);
+
+        test_tree(degree);
+}
+
+static int sum_keys(struct btree_item *item, void *private)
+{
+        atomic_ullong *sum = (atomic_ullong *)private;
+        atomic_fetch_add(sum, item->key);
+        return 0;
+}
+
+void test_parallel_for_each(void)
+{
+        atomic_ullong sum;
+        unsigned long long expected = 0;
+
+        tree = btree_alloc(TEST_DEGREE(3));
+        TEST_ASSERT_NOT_NULL(tree);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                btree_insert(tree, keys[i], NULL);
+                expected += keys[i];
+        }
+
+        atomic_init(&sum, 0);
+        TEST_ASSERT_EQUAL(0, btree_parallel_for_each(tree, sum_keys, &sum, 4));
+        TEST_ASSERT_EQUAL_UINT64(expected, atomic_load(&sum));
+
+        /* 작업 수를 구하는 곱셈이 넘치지 않도록 스레드 수를 줄인다. */
+        atomic_store(&sum, 0);
+        TEST_ASSERT_EQUAL(0, btree_parallel_for_each(tree, sum_keys, &sum,
+                                                     INT_MAX));
+        TEST_ASSERT_EQUAL_UINT64(expected, atomic_load(&sum));
+}
+
+struct key_list {
+        int n;
+        key_t *keys;
+};
+
+static void *key_list_alloc(void *private)
+{
+        (void)private;
+        struct key_list *list = calloc(1, sizeof(struct key_list));
+        if (list) {
+                list->keys = calloc(MAX_SIZE, sizeof(key_t));
+        }
+        return list;
+}
+
+static int key_list_visit(struct btree_item *item, void *result)
+{
+        struct key_list *list = (struct key_list *)result;
+        list->keys[list->n++] = item->key;
+        return 0;
+}
+
+static void key_list_merge(void *private, void *result)
+{
+        struct key_list *dst = (struct key_list *)private;
+        struct key_list *src = (struct key_list *)result;
+        for (int i = 0; i < src->n; i++) {
+                dst->keys[dst->n++] = src->keys[i];
+        }
+        free(src->keys);
+        free(src);
+}
+
+static atomic_int key_list_budget; /**< 남은 alloc 횟수로 0이 되면 실패한다. */
+static atomic_int key_list_released;
+
+static void *key_list_alloc_limited(void *private)
+{
+        if (atomic_fetch_sub(&key_list_budget, 1) <= 0) {
+                return NULL;
+        }
+        return key_list_alloc(private);
+}
+
+static void key_list_release(void *private, void *result)
+{
+        struct key_list *list = (struct key_list *)result;
+
+        (void)private;
+        atomic_fetch_add(&key_list_released, 1);
+        free(list->keys);
+        free(list);
+}
+
+void test_parallel_ordered_reduce(void)
+{
+        const struct btree_parallel_ops ops = {
+                .alloc = key_list_alloc,
+                .visit = key_list_visit,
+                .merge = key_list_merge,
+        };
+        const struct btree_parallel_ops shared = {
+                .alloc = NULL,
+                .visit = key_list_visit,
+                .merge = key_list_merge,
+        };
+        const struct btree_parallel_ops limited = {
+                .alloc = key_list_alloc_limited,
+                .visit = key_list_visit,
+                .merge = key_list_merge,
+                .release = key_list_release,
+        };
+        struct key_list merged = { 0 };
+
+        tree = btree_alloc(TEST_DEGREE(2));
+        TEST_ASSERT_NOT_NULL(tree);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                btree_insert(tree, keys[i], NULL);
+        }
+
+        merged.keys = calloc(MAX_SIZE, sizeof(key_t));
+        TEST_ASSERT_EQUAL(-EINVAL, btree_parallel_reduce(tree, &shared, &merged,
+                                                         4, 0));
+        /* 결과를 만들다 실패하면 아무 것도 병합하지 않고 만든 결과를 해제한다. */
+        atomic_store(&key_list_budget, 3);
+        atomic_store(&key_list_released, 0);
+        TEST_ASSERT_EQUAL(-ENOMEM,
+                          btree_parallel_reduce(tree, &limited, &merged, 4,
+                                                B_TREE_PARALLEL_ORDERED));
+        TEST_ASSERT_EQUAL(0, merged.n);
+        TEST_ASSERT_EQUAL(3, atomic_load(&key_list_released));
+        TEST_ASSERT_EQUAL(0, btree_parallel_reduce(tree, &ops, &merged, 4,
+                                                   B_TREE_PARALLEL_ORDERED));
+        TEST_ASSERT_EQUAL(ARR_SIZE(keys), merged.n);
+        for (int i = 1; i < merged.n; i++) {
+                TEST_ASSERT_TRUE(merged.keys[i - 1] <= merged.keys[i]);
+        }
+        free(merged.keys);
+}
+
+void test_scan(void)
+{
+        struct key_list list = { 0 };
+
+        require_unique_keys();
+        tree = btree_alloc(TEST_DEGREE(3));
+        TEST_ASSERT_NOT_NULL(tree);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                btree_insert(tree, keys[i], NULL);
+        }
+
+        list.keys = calloc(MAX_SIZE, sizeof(key_t));
+        TEST_ASSERT_EQUAL(100, btree_scan(tree, 500, 100, key_list_visit, &list));
+        for (int i = 0; i < list.n; i++) {
+                TEST_ASSERT_EQUAL(500 + i, list.keys[i]);
+        }
+        TEST_ASSERT_EQUAL(REMAIN, btree_scan(tree, MAX_SIZE - REMAIN, 100,
+                                             key_list_visit, &list));
+        free(list.keys);
+}
+
+void test_workload(void)
+{
+        const struct workload_config shuffle = { .dist = WORKLOAD_SHUFFLE,
+                                                 .n = MAX_SIZE,
+                                                 .seed = 7 };
+        const struct workload_config zipfian = { .dist = WORKLOAD_ZIPFIAN,
+                                                 .n = MAX_SIZE,
+                                                 .seed = 7 };
+        struct workload wl;
+        bool *seen = calloc(MAX_SIZE, sizeof(bool));
+        int head = 0;
+
+        TEST_ASSERT_NOT_NULL(seen);
+        TEST_ASSERT_EQUAL(0, workload_init(&wl, &shuffle));
+        for (int i = 0; i < MAX_SIZE; i++) {
+                uint64_t key = workload_next(&wl);
+                TEST_ASSERT_TRUE(key < MAX_SIZE);
+                TEST_ASSERT_FALSE(seen[key]);
+                seen[key] = true;
+        }
+        free(seen);
+
+        TEST_ASSERT_EQUAL(0, workload_init(&wl, &zipfian));
+        for (int i = 0; i < MAX_SIZE; i++) {
+                head += workload_next(&wl) < MAX_SIZE / 100;
+        }
+        TEST_ASSERT_TRUE(head > MAX_SIZE / 2); /**< 상위 1%가 절반 이상 */
+
+        TEST_ASSERT_EQUAL(-EINVAL, workload_parse("pareto", &wl.config));
+        TEST_ASSERT_EQUAL(0, workload_parse("hotspot:0.1:0.9", &wl.config));
+        TEST_ASSERT_EQUAL(WORKLOAD_HOTSPOT, wl.config.dist);
+}
+
+void test_analyze(void)
+{
+        struct btree_report report;
+        unsigned long nodes = 0, leaves = 0, internals = 0;
+
+        tree = btree_alloc(TEST_DEGREE(3));
+        TEST_ASSERT_NOT_NULL(tree);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                btree_insert(tree, keys[i], NULL);
+        }
+        TEST_ASSERT_EQUAL(0, btree_analyze(tree, &report));
+        TEST_ASSERT_EQUAL(ARR_SIZE(keys), report.nr_keys);
+        TEST_ASSERT_EQUAL(1, report.level_nodes[0]);
+        TEST_ASSERT_EQUAL(report.nr_leaves,
+                          report.level_nodes[report.height - 1]);
+        for (int i = 0; i < report.height; i++) {
+                nodes += report.level_nodes[i];
+        }
+        for (int i = 0; i < B_TREE_FILL_BUCKETS; i++) {
+                leaves += report.leaf_fill[i];
+                internals += report.internal_fill[i];
+        }
+        TEST_ASSERT_EQUAL(report.nr_nodes, nodes);
+        TEST_ASSERT_EQUAL(report.nr_leaves, leaves);
+        TEST_ASSERT_EQUAL(report.nr_nodes - report.nr_leaves, internals);
+        TEST_ASSERT_EQUAL(report.nr_nodes * B_TREE_NR_KEYS(TEST_DEGREE(3)) -
+                                  report.nr_keys,
+                          report.wasted_slots);
+        TEST_ASSERT_TRUE(report.allocated_bytes >= report.bytes);
+        printf("analyze =======> height %d, %lu nodes, %.2f bytes/key\n",
+               report.height, report.nr_nodes, report.bytes_per_key);
+}
+
+void test_arena_tree(void)
+{
+        struct btree_search_result result;
+        struct btree_report report;
+        clock_t start = clock();
+
+        tree = btree_alloc_flags(TEST_DEGREE(5), B_TREE_F_ARENA);
+        TEST_ASSERT_NOT_NULL(tree);
+        TEST_ASSERT_NOT_NULL(tree->arena);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                btree_insert(tree, keys[i], NULL);
+        }
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                result = btree_search(tree, keys[i]);
+                TEST_ASSERT_NOT_NULL(result.node);
+                TEST_ASSERT_EQUAL(0, (uintptr_t)result.node %
+                                             B_TREE_ARENA_ALIGN);
+        }
+        TEST_ASSERT_EQUAL(0, btree_analyze(tree, &report));
+        TEST_ASSERT_EQUAL(report.nr_nodes, tree->arena->nr_objects);
+        TEST_ASSERT_TRUE(report.allocated_bytes >= report.bytes);
+
+        for (int i = 0; i < ARR_SIZE(keys) - REMAIN; i++) {
+                TEST_ASSERT_EQUAL(0, btree_delete(tree, keys[i]));
+        }
+        TEST_ASSERT_EQUAL(0, btree_analyze(tree, &report));
+        TEST_ASSERT_EQUAL(REMAIN, report.nr_keys);
+        TEST_ASSERT_EQUAL(report.nr_nodes, tree->arena->nr_objects);
+        printf("arena %zu regions(%zu huge) =======> %lfs\n",
+               tree->arena->nr_regions, tree->arena->nr_huge,
+               (double)(clock() - start) / CLOCKS_PER_SEC);
+}
+
+/**
+ * 서브 트리가 B-Tree의 성질을 만족하는 지 확인하고 잎의 깊이를 반환한다.
+ */
+static int check_subtree(struct btree_node *x, bool is_root, key_t *last,
+                         bool *first)
+{
+        int depth = -1;
+
+        TEST_ASSERT_TRUE(x->n <= B_TREE_NR_KEYS(tree->min_degree));
+        if (!is_root) {
+                TEST_ASSERT_TRUE(x->n >= tree->min_degree - 1);
+        }
+        for (int i = 0; i <= x->n; i++) {
+                if (!x->is_leaf) {
+                        const int d = check_subtree(x->child[i], false, last,
+                                                    first);
+                        TEST_ASSERT_TRUE(depth < 0 || depth == d);
+                        depth = d;
+                }
+                if (i < x->n) {
+                        TEST_ASSERT_TRUE(*first || *last <= x->items[i].key);
+                        *last = x->items[i].key;
+                        *first = false;
+                }
+        }
+        return x->is_leaf ? 0 : depth + 1;
+}
+
+static void check_tree(void)
+{
+        key_t last = 0;
+        bool first = true;
+        check_subtree(tree->root, true, &last, &first);
+}
+
+void test_fixed_degree(void)
+{
+#ifdef B_TREE_FIXED_DEGREE
+        clock_t start = clock();
+
+        require_unique_keys();
+        TEST_ASSERT_NULL(btree_alloc(B_TREE_FIXED_DEGREE + 1));
+        TEST_ASSERT_EQUAL(B_TREE_FIXED_DEGREE, btree_auto_degree(0));
+
+        tree = btree_alloc(B_TREE_FIXED_DEGREE);
+        TEST_ASSERT_NOT_NULL(tree);
+        TEST_ASSERT_EQUAL(B_TREE_FIXED_DEGREE, B_TREE_DEGREE(tree));
+        TEST_ASSERT_EQUAL(B_TREE_NR_KEYS(B_TREE_FIXED_DEGREE),
+                          sizeof(tree->root->items) /
+                                  sizeof(struct btree_item));
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                btree_insert(tree, keys[i], NULL);
+        }
+        check_tree();
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_NOT_NULL(btree_search(tree, keys[i]).node);
+        }
+        for (int i = 0; i < ARR_SIZE(keys); i += 2) {
+                TEST_ASSERT_EQUAL(0, btree_delete(tree, keys[i]));
+        }
+        check_tree();
+        printf("fixed degree %d =======> %lfs\n", B_TREE_FIXED_DEGREE,
+               (double)(clock() - start) / CLOCKS_PER_SEC);
+#else
+        TEST_IGNORE_MESSAGE("Build with DEGREE to check the fixed degree");
+#endif
+}
+
+void test_compact(void)
+{
+        struct btree_report before, after;
+        struct btree_compact *compact = NULL;
+        int steps = 0, ret = 0;
+        clock_t start = clock();
+
+        tree = btree_alloc(TEST_DEGREE(4));
+        TEST_ASSERT_NOT_NULL(tree);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                btree_insert(tree, keys[i], NULL);
+        }
+        for (int i = 0; i < ARR_SIZE(keys); i += 2) {
+                TEST_ASSERT_EQUAL(0, btree_delete(tree, keys[i]));
+        }
+        TEST_ASSERT_EQUAL(0, btree_analyze(tree, &before));
+
+        TEST_ASSERT_EQUAL(0, btree_compact(tree, B_TREE_LAYOUT_BFS));
+        TEST_ASSERT_NOT_NULL(tree->arena);
+        check_tree();
+        TEST_ASSERT_EQUAL(0, btree_analyze(tree, &after));
+        TEST_ASSERT_EQUAL(before.nr_keys, after.nr_keys);
+        TEST_ASSERT_TRUE(after.nr_nodes < before.nr_nodes);
+        TEST_ASSERT_EQUAL(after.nr_nodes, tree->arena->nr_objects);
+        for (int i = 1; i < ARR_SIZE(keys); i += 2) {
+                TEST_ASSERT_NOT_NULL(btree_search(tree, keys[i]).node);
+        }
+
+        /* 단계 사이에 트리가 바뀌면 처음부터 다시 시작한다. */
+        compact = btree_compact_begin(tree, B_TREE_LAYOUT_VEB, 1.0);
+        TEST_ASSERT_NOT_NULL(compact);
+        while ((ret = btree_compact_step(compact, 20000)) > 0) {
+                if (++steps == 2) {
+                        btree_insert(tree, keys[0], NULL);
+                }
+        }
+        TEST_ASSERT_EQUAL(0, ret);
+        TEST_ASSERT_EQUAL(1, btree_compact_restarts(compact));
+        btree_compact_end(compact);
+        check_tree();
+        TEST_ASSERT_EQUAL(0, btree_analyze(tree, &after));
+        TEST_ASSERT_EQUAL(before.nr_keys + 1, after.nr_keys);
+        TEST_ASSERT_NOT_NULL(btree_search(tree, keys[0]).node);
+
+        for (int i = 0; i < ARR_SIZE(keys); i += 2) {
+                btree_insert(tree, keys[i], NULL);
+        }
+        check_tree();
+        printf("compact %lu -> %lu nodes(%d steps) =======> %lfs\n",
+               before.nr_nodes, after.nr_nodes, steps,
+               (double)(clock() - start) / CLOCKS_PER_SEC);
+}
+
+struct test_uuid {
+        uint64_t hi;
+        uint64_t lo;
+};
+
+static inline int test_uuid_cmp(struct test_uuid a, struct test_uuid b)
+{
+        if (a.hi != b.hi) {
+                return a.hi < b.hi ? -1 : 1;
+        }
+        return BTREE_CMP_SCALAR(a.lo, b.lo);
+}
+
+BTREE_DEFINE(btree_u64, uint64_t, uint64_t, BTREE_CMP_SCALAR)
+BTREE_DEFINE(btree_uuid, struct test_uuid, int, test_uuid_cmp)
+BTREE_DEFINE(btree_u32map, uint32_t, void *, BTREE_CMP_SCALAR)
+BTREE_SET_DEFINE(btree_u32set, uint32_t, BTREE_CMP_SCALAR)
+BTREE_HANDLE_DEFINE(btree_u32handle, uint32_t, void *, BTREE_CMP_SCALAR)
+
+static int sum_u64(const uint64_t *key, uint64_t *value, void *private)
+{
+        (void)key;
+        *(uint64_t *)private += *value;
+        return 0;
+}
+
+static int sum_item(struct btree_item *item, void *private)
+{
+        *(uint64_t *)private += (uintptr_t)item->data;
+        return 0;
+}
+
+void test_generic_tree(void)
+{
+        struct btree_u64 *u64 = btree_u64_alloc(8);
+        struct btree_uuid *uuid = btree_uuid_alloc(3);
+        uint64_t expected = 0, sum = 0;
+        clock_t start = 0;
+        double elapsed[2];
+
+        TEST_ASSERT_NOT_NULL(u64);
+        TEST_ASSERT_NOT_NULL(uuid);
+
+        /* 64비트 키가 struct btree와 같은 결과를 내는 지 확인한다. */
+        tree = btree_alloc(TEST_DEGREE(8));
+        TEST_ASSERT_NOT_NULL(tree);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                btree_insert(tree, keys[i], (void *)(uintptr_t)i);
+                TEST_ASSERT_EQUAL(0, btree_u64_insert(u64, keys[i], i));
+        }
+        start = clock();
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_NOT_NULL(btree_search(tree, keys[i]).node);
+        }
+        elapsed[0] = (double)(clock() - start) / CLOCKS_PER_SEC;
+        start = clock();
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_NOT_NULL(btree_u64_search(u64, keys[i]));
+        }
+        elapsed[1] = (double)(clock() - start) / CLOCKS_PER_SEC;
+        TEST_ASSERT_NULL(btree_u64_search(u64, MAX_SIZE + 1));
+        TEST_ASSERT_EQUAL(-EINVAL, btree_u64_delete(u64, MAX_SIZE + 1));
+
+        for (int i = 0; i < ARR_SIZE(keys) - REMAIN; i++) {
+                TEST_ASSERT_EQUAL(0, btree_delete(tree, keys[i]));
+                TEST_ASSERT_EQUAL(0, btree_u64_delete(u64, keys[i]));
+                if (keys_unique) {
+                        TEST_ASSERT_NULL(btree_u64_search(u64, keys[i]));
+                }
+        }
+        TEST_ASSERT_EQUAL(btree_scan(tree, 0, MAX_SIZE, sum_item, &expected),
+                          btree_u64_scan(u64, 0, MAX_SIZE, sum_u64, &sum));
+        TEST_ASSERT_EQUAL_UINT64(expected, sum);
+        btree_u64_free(u64);
+
+        /* 16바이트 키는 상위 64비트가 같아도 하위 64비트로 구분된다. */
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                struct test_uuid id = { .hi = keys[i] % 7, .lo = keys[i] };
+                TEST_ASSERT_EQUAL(0, btree_uuid_insert(uuid, id, i));
+        }
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                struct test_uuid id = { .hi = keys[i] % 7, .lo = keys[i] };
+                int *value = btree_uuid_search(uuid, id);
+                TEST_ASSERT_NOT_NULL(value);
+                if (keys_unique) {
+                        TEST_ASSERT_EQUAL(i, *value);
+                }
+                TEST_ASSERT_EQUAL(0, btree_uuid_delete(uuid, id));
+        }
+        TEST_ASSERT_EQUAL(0, uuid->root->n);
+        btree_uuid_free(uuid);
+
+        printf("search btree %lfs, generic u64 =======> %lfs\n", elapsed[0],
+               elapsed[1]);
+}
+
+#define TEST_STR_KEYS 20000
+
+static int test_str_key(char *buf, int i)
+{
+        return sprintf(buf, "https://example.com/users/%08d/profile", i);
+}
+
+/**
+ * @brief 방문한 키가 오름차순인 지 확인한다.
+ */
+static int check_str_order(const void *key, size_t len, void *value,
+                           void *private)
+{
+        char *prev = (char *)private;
+        char buf[B_TREE_STR_MAX_KEY + 1];
+
+        memcpy(buf, key, len);
+        buf[len] = '\0';
+        TEST_ASSERT_TRUE(strcmp(prev, buf) < 0);
+        TEST_ASSERT_EQUAL(len, test_str_key(prev, (int)(intptr_t)value));
+        TEST_ASSERT_EQUAL_STRING(prev, buf);
+        return 0;
+}
+
+void test_str_tree(void)
+{
+        const unsigned int flags[] = { 0, B_TREE_STR_F_FULL_KEYS };
+        unsigned long nr_nodes[2];
+        char buf[B_TREE_STR_MAX_KEY + 1];
+        clock_t start = clock();
+
+        for (int f = 0; f < 2; f++) {
+                struct btree_str *str = btree_str_alloc(flags[f]);
+                void *value = NULL;
+                int len = 0;
+
+                TEST_ASSERT_NOT_NULL(str);
+                /* 7919는 TEST_STR_KEYS와 서로소이므로 모든 키가 한 번씩 나온다. */
+                for (int i = 0; i < TEST_STR_KEYS; i++) {
+                        const int j = (int)((long)i * 7919 % TEST_STR_KEYS);
+                        len = test_str_key(buf, j);
+                        TEST_ASSERT_EQUAL(0, btree_str_insert(str, buf, len,
+                                                              (void *)(intptr_t)j));
+                }
+                TEST_ASSERT_EQUAL(-EEXIST, btree_str_insert(str, buf, len, NULL));
+                TEST_ASSERT_EQUAL(-E2BIG, btree_str_insert(str, buf,
+                                                           B_TREE_STR_MAX_KEY + 1,
+                                                           NULL));
+                TEST_ASSERT_EQUAL(TEST_STR_KEYS, str->nr_keys);
+                nr_nodes[f] = str->nr_nodes;
+
+                for (int i = 0; i < TEST_STR_KEYS; i++) {
+                        len = test_str_key(buf, i);
+                        TEST_ASSERT_EQUAL(0, btree_str_search(str, buf, len,
+                                                              &value));
+                        TEST_ASSERT_EQUAL(i, (int)(intptr_t)value);
+                }
+                TEST_ASSERT_EQUAL(-ENOENT,
+                                  btree_str_search(str, "https://", 8, NULL));
+
+                buf[0] = '\0';
+                TEST_ASSERT_EQUAL(TEST_STR_KEYS,
+                                  btree_str_scan(str, "", 0, TEST_STR_KEYS + 1,
+                                                 check_str_order, buf));
+
+                /* 짝수 키를 지우면 그 사이의 홀수 키만 남아야 한다. */
+                for (int i = 0; i < TEST_STR_KEYS; i += 2) {
+                        len = test_str_key(buf, i);
+                        TEST_ASSERT_EQUAL(0, btree_str_delete(str, buf, len));
+                }
+                TEST_ASSERT_EQUAL(-EINVAL, btree_str_delete(str, buf, len));
+                len = test_str_key(buf, 100);
+                TEST_ASSERT_EQUAL(1, btree_str_scan(str, buf, len, 1,
+                                                    check_str_order, buf));
+                TEST_ASSERT_EQUAL_STRING("https://example.com/users/00000101/profile",
+                                         buf);
+
+                /* 노드의 접두사를 공유하지 않는 긴 키도 넣을 수 있다. */
+                memset(buf, 'z', B_TREE_STR_MAX_KEY);
+                TEST_ASSERT_EQUAL(0, btree_str_insert(str, buf,
+                                                      B_TREE_STR_MAX_KEY, NULL));
+                TEST_ASSERT_EQUAL(0, btree_str_search(str, buf,
+                                                      B_TREE_STR_MAX_KEY, NULL));
+
+                for (int i = 1; i < TEST_STR_KEYS; i += 2) {
+                        len = test_str_key(buf, i);
+                        TEST_ASSERT_EQUAL(0, btree_str_delete(str, buf, len));
+                }
+                TEST_ASSERT_EQUAL(1, str->nr_keys);
+                TEST_ASSERT_EQUAL(1, str->height);
+                btree_str_free(str);
+        }
+
+        /* 접두사 압축을 하면 같은 키를 더 적은 노드에 담는다. */
+        TEST_ASSERT_TRUE(nr_nodes[0] < nr_nodes[1]);
+        printf("string nodes %lu(full keys %lu) =======> %lfs\n", nr_nodes[0],
+               nr_nodes[1], (double)(clock() - start) / CLOCKS_PER_SEC);
+}
+
+/**
+ * @brief 방문한 키가 오름차순인 지 확인하고 그 수를 센다.
+ */
+static int check_u32set_order(const uint32_t *key, void *private)
+{
+        uint64_t *state = (uint64_t *)private; /**< [0]: 수, [1]: 이전 키 + 1 */
+
+        TEST_ASSERT_TRUE(*key + 1 > state[1]);
+        state[0]++;
+        state[1] = (uint64_t)*key + 1;
+        return 0;
+}
+
+void test_set_tree(void)
+{
+        struct btree_u32set *set = btree_u32set_alloc(8);
+        struct btree_u32set *other = btree_u32set_alloc(8);
+        struct btree_u32map *map = btree_u32map_alloc(8);
+        struct btree_report report;
+        uint64_t state[2] = { 0, 0 };
+        clock_t start = clock();
+        int ret = 0;
+
+        TEST_ASSERT_NOT_NULL(set);
+        TEST_ASSERT_NOT_NULL(other);
+        TEST_ASSERT_NOT_NULL(map);
+        tree = btree_alloc(TEST_DEGREE(8));
+        TEST_ASSERT_NOT_NULL(tree);
+
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                ret = btree_u32set_insert(set, keys[i]);
+                TEST_ASSERT_TRUE(ret == 0 || (ret == -EEXIST && !keys_unique));
+                if (ret == 0) {
+                        btree_insert(tree, keys[i], NULL);
+                        btree_u32map_insert(map, keys[i], NULL);
+                }
+        }
+        TEST_ASSERT_EQUAL(-EEXIST, btree_u32set_insert(set, keys[0]));
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_TRUE(btree_u32set_contains(set, keys[i]));
+        }
+        TEST_ASSERT_FALSE(btree_u32set_contains(set, MAX_SIZE + 1));
+        TEST_ASSERT_EQUAL(0, btree_u32set_for_each(set, check_u32set_order,
+                                                   state));
+        TEST_ASSERT_EQUAL(set->nr_keys, state[0]);
+
+        /* 값이 없는 만큼 키 하나당 크기가 줄어야 한다. */
+        TEST_ASSERT_EQUAL(0, btree_analyze(tree, &report));
+        TEST_ASSERT_TRUE(btree_u32set_bytes(set) < btree_u32map_bytes(map));
+        printf("bytes per key set %.1lf, map %.1lf, btree %.1lf =======> ",
+               (double)btree_u32set_bytes(set) / set->nr_keys,
+               (double)btree_u32map_bytes(map) / map->nr_keys,
+               report.bytes_per_key);
+        btree_u32map_free(map);
+
+        /* set = keys, other = [0, MAX_SIZE)의 짝수 */
+        for (uint32_t k = 0; k < MAX_SIZE; k += 2) {
+                TEST_ASSERT_EQUAL(0, btree_u32set_insert(other, k));
+        }
+        TEST_ASSERT_EQUAL(0, btree_u32set_intersect(set, other));
+        for (uint32_t k = 0; k < MAX_SIZE; k++) {
+                TEST_ASSERT_EQUAL(k % 2 == 0 && btree_search(tree, k).node,
+                                  btree_u32set_contains(set, k));
+        }
+        TEST_ASSERT_EQUAL(0, btree_u32set_union(set, other));
+        TEST_ASSERT_EQUAL(MAX_SIZE / 2, set->nr_keys);
+        TEST_ASSERT_EQUAL(0, btree_u32set_subtract(set, other));
+        TEST_ASSERT_EQUAL(0, set->nr_keys);
+        TEST_ASSERT_EQUAL(0, btree_u32set_union(set, other));
+        TEST_ASSERT_EQUAL(0, btree_u32set_delete(set, 0));
+        TEST_ASSERT_EQUAL(-EINVAL, btree_u32set_delete(set, 0));
+        TEST_ASSERT_EQUAL(0, btree_u32set_subtract(other, other));
+        TEST_ASSERT_EQUAL(0, other->nr_keys);
+        TEST_ASSERT_EQUAL(MAX_SIZE / 2 - 1, set->nr_keys);
+
+        btree_u32set_free(set);
+        btree_u32set_free(other);
+        printf("%lfs\n", (double)(clock() - start) / CLOCKS_PER_SEC);
+}
+
+void test_inline_value(void)
+{
+        struct btree *pointer = btree_alloc(TEST_DEGREE(8));
+        uint64_t **data = (uint64_t **)malloc(MAX_SIZE * sizeof(uint64_t *));
+        unsigned char value[B_TREE_INLINE_SIZE];
+        uint64_t sum[2] = { 0, 0 };
+        clock_t start = 0;
+        double elapsed[2];
+
+        TEST_ASSERT_NOT_NULL(pointer);
+        TEST_ASSERT_NOT_NULL(data);
+        tree = btree_alloc(TEST_DEGREE(8));
+        TEST_ASSERT_NOT_NULL(tree);
+
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                data[i] = (uint64_t *)malloc(sizeof(uint64_t));
+                TEST_ASSERT_NOT_NULL(data[i]);
+                *data[i] = keys[i];
+                btree_insert(pointer, keys[i], data[i]);
+
+                memset(value, (int)(keys[i] & 0xff), sizeof(value));
+                memcpy(value, &keys[i], sizeof(key_t));
+                TEST_ASSERT_EQUAL(0, btree_insert_value(tree, keys[i], value,
+                                                        sizeof(value)));
+        }
+        TEST_ASSERT_EQUAL(-E2BIG, btree_insert_value(tree, 0, value,
+                                                     sizeof(value) + 1));
+        TEST_ASSERT_NULL(btree_search_value(tree, MAX_SIZE + 1));
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                const unsigned char *found = btree_search_value(tree, keys[i]);
+                TEST_ASSERT_NOT_NULL(found);
+                TEST_ASSERT_EQUAL_MEMORY(&keys[i], found, sizeof(key_t));
+                TEST_ASSERT_EQUAL_UINT8(keys[i] & 0xff,
+                                        found[B_TREE_INLINE_SIZE - 1]);
+        }
+
+        /* 값을 읽는 데에 포인터를 한 번 더 따라가는 비용을 비교한다. */
+        start = clock();
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                struct btree_search_result result =
+                        btree_search(pointer, keys[i]);
+                sum[0] += *(uint64_t *)result.node->items[result.index].data;
+        }
+        elapsed[0] = (double)(clock() - start) / CLOCKS_PER_SEC;
+        start = clock();
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                sum[1] += *(key_t *)btree_search_value(tree, keys[i]);
+        }
+        elapsed[1] = (double)(clock() - start) / CLOCKS_PER_SEC;
+        TEST_ASSERT_EQUAL_UINT64(sum[0], sum[1]);
+
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                free(data[i]);
+        }
+        free(data);
+        btree_free(pointer);
+        printf("value pointer %lfs, inline(%zu bytes) =======> %lfs\n",
+               elapsed[0], (size_t)B_TREE_INLINE_SIZE, elapsed[1]);
+}
+
+/**
+ * @brief 포인터 트리와 핸들 트리를 같은 순서로 방문하는 지 확인한다.
+ */
+static int check_u32handle_order(const uint32_t *key, void **value,
+                                 void *private)
+{
+        uint64_t *state = (uint64_t *)private; /**< [0]: 수, [1]: 이전 키 + 1 */
+
+        TEST_ASSERT_TRUE(*key + 1 >= state[1]);
+        TEST_ASSERT_EQUAL(*key, (uint32_t)(uintptr_t)*value);
+        state[0]++;
+        state[1] = (uint64_t)*key + 1;
+        return 0;
+}
+
+void test_handle_tree(void)
+{
+        struct btree_u32map *pointer = btree_u32map_alloc(8);
+        struct btree_u32handle *handle = btree_u32handle_alloc(8);
+        uint64_t state[2] = { 0, 0 };
+        uintptr_t sum[2] = { 0, 0 };
+        clock_t start = 0;
+        double elapsed[2];
+        size_t bytes = 0;
+
+        TEST_ASSERT_NOT_NULL(pointer);
+        TEST_ASSERT_NOT_NULL(handle);
+
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                void *value = (void *)(uintptr_t)keys[i];
+
+                TEST_ASSERT_EQUAL(0, btree_u32map_insert(pointer, keys[i],
+                                                         value));
+                TEST_ASSERT_EQUAL(0, btree_u32handle_insert(handle, keys[i],
+                                                            value));
+        }
+        TEST_ASSERT_NULL(btree_u32handle_search(handle, MAX_SIZE + 1));
+        TEST_ASSERT_EQUAL(0, btree_u32handle_for_each(
+                                     handle, check_u32handle_order, state));
+        TEST_ASSERT_EQUAL(pointer->nr_keys, state[0]);
+
+        /* 자식 배열이 절반이 되는 만큼 작아야 한다. */
+        TEST_ASSERT_TRUE(btree_u32handle_bytes(handle) <
+                         btree_u32map_bytes(pointer));
+
+        start = clock();
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                sum[0] += (uintptr_t)*btree_u32map_search(pointer, keys[i]);
+        }
+        elapsed[0] = (double)(clock() - start) / CLOCKS_PER_SEC;
+        start = clock();
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                sum[1] += (uintptr_t)*btree_u32handle_search(handle, keys[i]);
+        }
+        elapsed[1] = (double)(clock() - start) / CLOCKS_PER_SEC;
+        TEST_ASSERT_EQUAL_UINT64(sum[0], sum[1]);
+        printf("bytes per key pointer %.1lf, handle %.1lf\n",
+               (double)btree_u32map_bytes(pointer) / pointer->nr_keys,
+               (double)btree_u32handle_bytes(handle) / handle->nr_keys);
+
+        /* 지우면서 빈 칸은 다시 넣을 때 재사용되어 풀이 커지지 않는다. */
+        bytes = btree_u32handle_bytes(handle);
+        for (int i = 0; i < ARR_SIZE(keys); i += 2) {
+                TEST_ASSERT_EQUAL(0, btree_u32handle_delete(handle, keys[i]));
+                TEST_ASSERT_EQUAL(0, btree_u32map_delete(pointer, keys[i]));
+        }
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                void **found = btree_u32map_search(pointer, keys[i]);
+                void **other = btree_u32handle_search(handle, keys[i]);
+
+                TEST_ASSERT_EQUAL(found == NULL, other == NULL);
+        }
+        for (int i = 0; i < ARR_SIZE(keys); i += 2) {
+                TEST_ASSERT_EQUAL(0, btree_u32handle_insert(
+                                             handle, keys[i],
+                                             (void *)(uintptr_t)keys[i]));
+        }
+        TEST_ASSERT_EQUAL(bytes, btree_u32handle_bytes(handle));
+        state[0] = state[1] = 0;
+        TEST_ASSERT_EQUAL(0, btree_u32handle_for_each(
+                                     handle, check_u32handle_order, state));
+        TEST_ASSERT_EQUAL(ARR_SIZE(keys), state[0]);
+
+        btree_u32map_free(pointer);
+        btree_u32handle_free(handle);
+        printf("lookup pointer %lfs, handle =======> %lfs\n", elapsed[0],
+               elapsed[1]);
+}
+
+/**
+ * @brief 고르게 퍼진 키나, 32개씩 기하급수적으로 벌어지도록 치우친 키를 만든다.
+ * @details 키 사이의 간격은 2 이상이므로 key + 1은 항상 트리에 없다.
+ */
+static void node_search_keys(key_t *out, int n, bool skewed)
+{
+        uint32_t r = 0x2545f491u;
+        key_t gap = 1;
+
+        for (int i = 0; i < n; i++) {
+                r = r * 1103515245u + 12345u;
+                if (skewed) {
+                        gap = i % 32 ? gap * 3 / 2 + 2 : 1;
+                        out[i] = (key_t)(i / 32) * (1u << 20) + gap;
+                } else {
+                        out[i] = (key_t)i * 40000 + (r >> 16) % 20000;
+                }
+        }
+}
+
+void test_node_search(void)
+{
+        static const char *const name[] = { "linear", "binary", "interpolation",
+                                            "adaptive" };
+        key_t *search_keys = calloc(MAX_SIZE, sizeof(key_t));
+        double elapsed[4];
+        clock_t start;
+
+        TEST_ASSERT_NOT_NULL(search_keys);
+        for (int skewed = 0; skewed < 2; skewed++) {
+                node_search_keys(search_keys, MAX_SIZE, skewed);
+                tree = btree_alloc(TEST_DEGREE(32));
+                TEST_ASSERT_NOT_NULL(tree);
+                for (int i = 0; i < MAX_SIZE; i++) {
+                        btree_insert(tree, search_keys[i],
+                                     (void *)(uintptr_t)search_keys[i]);
+                }
+
+                for (int mode = 0; mode < 4; mode++) {
+                        TEST_ASSERT_EQUAL(0, btree_set_node_search(
+                                                     tree, mode));
+                        start = clock();
+                        for (int loop = 0; loop < TEST_LOOP; loop++) {
+                                for (int i = 0; i < MAX_SIZE; i++) {
+                                        TEST_ASSERT_EQUAL(
+                                                search_keys[i],
+                                                (uintptr_t)*(void **)
+                                                        btree_search_value(
+                                                                tree,
+                                                                search_keys[i]));
+                                        TEST_ASSERT_NULL(btree_search_value(
+                                                tree, search_keys[i] + 1));
+                                }
+                        }
+                        elapsed[mode] =
+                                (double)(clock() - start) / CLOCKS_PER_SEC;
+                }
+                /* 표본의 비교 횟수로 고르게 퍼진 키에서는 보간 탐색을 고른다. */
+                if (TEST_DEGREE_IS(32)) {
+                        TEST_ASSERT_EQUAL(skewed ? B_TREE_SEARCH_BINARY :
+                                                   B_TREE_SEARCH_INTERPOLATION,
+                                          btree_node_search_in_use(tree));
+                }
+                TEST_ASSERT_EQUAL(-EINVAL,
+                                  btree_set_node_search(tree, 4));
+
+                TEST_ASSERT_EQUAL(0, btree_set_node_search(
+                                             tree, B_TREE_SEARCH_INTERPOLATION));
+                for (int i = 0; i < MAX_SIZE; i += 2) {
+                        TEST_ASSERT_EQUAL(0, btree_delete(tree, search_keys[i]));
+                }
+                for (int i = 0; i < MAX_SIZE; i++) {
+                        TEST_ASSERT_EQUAL(i % 2 == 0,
+                                          btree_search_value(
+                                                  tree, search_keys[i]) == NULL);
+                }
+                btree_free(tree);
+                tree = NULL;
+                printf("%s keys %s %lfs, %s %lfs, %s %lfs, %s =======> %lfs\n",
+                       skewed ? "skewed" : "uniform", name[0], elapsed[0],
+                       name[1], elapsed[1], name[2], elapsed[2], name[3],
+                       elapsed[3]);
+        }
+
+        /* 키가 3개 이하인 노드에서는 건너뛰는 방법보다 선형 탐색이 싸다. */
+        if (TEST_DEGREE_IS(2)) {
+                tree = btree_alloc(2);
+                TEST_ASSERT_NOT_NULL(tree);
+                for (int i = 0; i < MAX_SIZE; i++) {
+                        btree_insert(tree, search_keys[i], NULL);
+                }
+                TEST_ASSERT_EQUAL(0, btree_set_node_search(
+                                             tree, B_TREE_SEARCH_ADAPTIVE));
+                for (int i = 0; i < MAX_SIZE; i++) {
+                        btree_search(tree, search_keys[i]);
+                }
+                TEST_ASSERT_EQUAL(B_TREE_SEARCH_LINEAR,
+                                  btree_node_search_in_use(tree));
+        }
+        free(search_keys);
+}
+
+void test_baselines(void)
+{
+        const struct workload_config shuffle = { .dist = WORKLOAD_SHUFFLE,
+                                                 .n = MAX_SIZE,
+                                                 .seed = 11 };
+        struct key_list list = { 0 };
+        struct workload wl;
+
+        require_unique_keys();
+        list.keys = calloc(MAX_SIZE, sizeof(key_t));
+        TEST_ASSERT_NOT_NULL(list.keys);
+        for (int i = 0; index_list[i]; i++) {
+                const struct index_ops *ops = index_list[i];
+                void *index = ops->alloc(TEST_DEGREE(3));
+                clock_t start = clock();
+
+                TEST_ASSERT_NOT_NULL(index);
+                TEST_ASSERT_EQUAL(0, workload_init(&wl, &shuffle));
+                for (int j = 0; j < ARR_SIZE(keys); j++) {
+                        const key_t key = keys[workload_next(&wl)];
+                        TEST_ASSERT_EQUAL(0, ops->insert(index, key,
+                                                         (void *)(uintptr_t)key));
+                }
+                for (int j = 0; j < ARR_SIZE(keys); j++) {
+                        struct btree_item *item = ops->search(index, keys[j]);
+                        TEST_ASSERT_NOT_NULL(item);
+                        TEST_ASSERT_EQUAL(keys[j], (uintptr_t)item->data);
+                }
+                TEST_ASSERT_NULL(ops->search(index, MAX_SIZE));
+
+                list.n = 0;
+                TEST_ASSERT_EQUAL(100, ops->scan(index, 500, 100,
+                                                 key_list_visit, &list));
+                for (int j = 0; j < list.n; j++) {
+                        TEST_ASSERT_EQUAL(500 + j, list.keys[j]);
+                }
+
+                for (int j = 0; j < ARR_SIZE(keys); j += 2) {
+                        TEST_ASSERT_EQUAL(0, ops->remove(index, keys[j]));
+                }
+#ifdef RB_TREE_DEBUG
+                if (ops == &index_rbtree_ops) {
+                        TEST_ASSERT_TRUE(rbtree_validate(index) > 0);
+                }
+#endif
+#ifdef TG_BST_TREE_DEBUG
+                if (ops == &index_bst_ops) {
+                        TEST_ASSERT_EQUAL(ARR_SIZE(keys) / 2,
+                                          bst_validate(index));
+                }
+#endif
+                for (int j = 0; j < ARR_SIZE(keys); j++) {
+                        TEST_ASSERT_EQUAL(j % 2 == 0,
+                                          ops->search(index, keys[j]) == NULL);
+                }
+                TEST_ASSERT_TRUE(ops->remove(index, keys[0]) < 0);
+                ops->free(index);
+                printf("%s =======> %lfs\n", ops->name,
+                       (double)(clock() - start) / CLOCKS_PER_SEC);
+        }
+        free(list.keys);
+}
+
+void test_csb_tree(void)
+{
+        struct csb_tree *csb = NULL;
+        struct key_list list = { 0 };
+        double elapsed[2];
+        clock_t start;
+
+        require_unique_keys();
+        tree = btree_alloc(TEST_DEGREE(32));
+        csb = csb_tree_alloc(32);
+        TEST_ASSERT_NOT_NULL(tree);
+        TEST_ASSERT_NOT_NULL(csb);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                btree_insert(tree, keys[i], (void *)(uintptr_t)keys[i]);
+                TEST_ASSERT_EQUAL(0, csb_tree_insert(csb, keys[i],
+                                                     (void *)(uintptr_t)keys[i]));
+        }
+        TEST_ASSERT_EQUAL(-EEXIST, csb_tree_insert(csb, keys[0], NULL));
+        TEST_ASSERT_EQUAL(ARR_SIZE(keys), csb->nr_keys);
+
+        for (int pass = 0; pass < 2; pass++) {
+                start = clock();
+                for (int loop = 0; loop < TEST_LOOP; loop++) {
+                        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                                struct btree_search_result result;
+                                struct btree_item *item = NULL;
+
+                                if (pass) {
+                                        item = csb_tree_search(csb, keys[i]);
+                                } else {
+                                        result = btree_search(tree, keys[i]);
+                                        TEST_ASSERT_NOT_NULL(result.node);
+                                        item = &result.node->items[result.index];
+                                }
+                                TEST_ASSERT_NOT_NULL(item);
+                                TEST_ASSERT_EQUAL(keys[i],
+                                                  (uintptr_t)item->data);
+                        }
+                }
+                elapsed[pass] = (double)(clock() - start) / CLOCKS_PER_SEC;
+        }
+
+        list.keys = calloc(MAX_SIZE, sizeof(key_t));
+        TEST_ASSERT_NOT_NULL(list.keys);
+        TEST_ASSERT_EQUAL(MAX_SIZE, csb_tree_scan(csb, 0, MAX_SIZE,
+                                                  key_list_visit, &list));
+        for (int i = 0; i < list.n; i++) {
+                TEST_ASSERT_EQUAL(i, list.keys[i]);
+        }
+        free(list.keys);
+
+        /* 비어 버린 잎이 남아 있어도 탐색과 삽입이 가능해야 한다. */
+        for (int i = 0; i < MAX_SIZE - REMAIN; i++) {
+                TEST_ASSERT_EQUAL(0, csb_tree_delete(csb, i));
+        }
+        TEST_ASSERT_EQUAL(-EINVAL, csb_tree_delete(csb, 0));
+        for (int i = 0; i < MAX_SIZE; i++) {
+                TEST_ASSERT_EQUAL(i < MAX_SIZE - REMAIN,
+                                  csb_tree_search(csb, i) == NULL);
+        }
+        TEST_ASSERT_EQUAL(0, csb_tree_insert(csb, 0, NULL));
+        TEST_ASSERT_NOT_NULL(csb_tree_search(csb, 0));
+
+        printf("csb-tree %.1lf bytes per key, lookup btree %lfs, "
+               "csb-tree =======> %lfs\n",
+               (double)csb->bytes / ARR_SIZE(keys), elapsed[0], elapsed[1]);
+        csb_tree_free(csb);
+}
+
+#define STATS_THREADS 4
+
+static void *stats_search_worker(void *arg)
+{
+        (void)arg;
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_NOT_NULL(btree_search(tree, keys[i]).node);
+        }
+        return NULL;
+}
+
+void test_stats(void)
+{
+        struct btree_stats stats;
+        pthread_t threads[STATS_THREADS];
+        int height = 1;
+
+        require_unique_keys();
+        tree = btree_alloc(TEST_DEGREE(2));
+        TEST_ASSERT_NOT_NULL(tree);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                btree_insert(tree, keys[i], NULL);
+        }
+        for (struct btree_node *x = tree->root; !x->is_leaf; x = x->child[0]) {
+                height++;
+        }
+        TEST_ASSERT_EQUAL(0, btree_stats_get(tree, &stats));
+        TEST_ASSERT_EQUAL(ARR_SIZE(keys), stats.inserts);
+        TEST_ASSERT_EQUAL(height - 1, stats.root_splits);
+        TEST_ASSERT_TRUE(stats.splits >= stats.root_splits);
+        TEST_ASSERT_TRUE(stats.key_compares >= stats.node_visits);
+
+        btree_stats_reset(tree);
+        for (int i = 0; i < STATS_THREADS; i++) {
+                TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL,
+                                                    stats_search_worker, NULL));
+        }
+        for (int i = 0; i < STATS_THREADS; i++) {
+                pthread_join(threads[i], NULL);
+        }
+        TEST_ASSERT_EQUAL(0, btree_stats_get(tree, &stats));
+        TEST_ASSERT_EQUAL(STATS_THREADS * ARR_SIZE(keys), stats.searches);
+        TEST_ASSERT_TRUE(stats.node_visits >= stats.searches);
+        TEST_ASSERT_TRUE(stats.node_visits <=
+                         (unsigned long)height * stats.searches);
+
+        btree_stats_reset(tree);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(0, btree_delete(tree, keys[i]));
+        }
+        TEST_ASSERT_EQUAL(0, btree_stats_get(tree, &stats));
+        TEST_ASSERT_EQUAL(ARR_SIZE(keys), stats.deletes);
+        TEST_ASSERT_EQUAL(height - 1, stats.root_collapses);
+        TEST_ASSERT_TRUE(stats.merges > 0);
+        TEST_ASSERT_TRUE(stats.borrow_left + stats.borrow_right > 0);
+        printf("stats =======> height %d, merges %lu, borrows %lu/%lu\n",
+               height, stats.merges, stats.borrow_left, stats.borrow_right);
+}
+
+#define TRACE_PATH "test-btree.trace"
+
+void test_trace(void)
+{
+        struct btree_trace_reader reader;
+        struct btree_trace_record record;
+        const enum btree_trace_op ops[] = { B_TREE_TRACE_INSERT,
+                                            B_TREE_TRACE_SEARCH,
+                                            B_TREE_TRACE_DELETE };
+        long n = 0;
+
+        TEST_ASSERT_EQUAL(0, btree_trace_open(TRACE_PATH));
+        TEST_ASSERT_EQUAL(-EBUSY, btree_trace_open(TRACE_PATH ".busy"));
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                btree_trace_record(ops[i % 3], keys[i]);
+        }
+        TEST_ASSERT_EQUAL(ARR_SIZE(keys), btree_trace_close());
+        btree_trace_record(B_TREE_TRACE_SEARCH, 0); /**< 닫힌 뒤에는 무시된다. */
+
+        TEST_ASSERT_EQUAL(0, btree_trace_reader_open(&reader, TRACE_PATH));
+        while (btree_trace_next(&reader, &record)) {
+                TEST_ASSERT_EQUAL(ops[n % 3], record.op);
+                TEST_ASSERT_EQUAL(keys[n], record.key);
+                n++;
+        }
+        TEST_ASSERT_EQUAL(ARR_SIZE(keys), n);
+        btree_trace_reader_close(&reader);
+        remove(TRACE_PATH);
+        remove(TRACE_PATH ".busy");
+}
+
+#define DISK_PATH "test-btree-disk.db"
+
+void test_disk_tree(void)
+{
+        const struct btree_disk_config config = { .page_size = 4096,
+                                                  .pool_pages = 64 };
+        struct btree_disk *disk = NULL;
+        uint64_t value = 0;
+
+        require_unique_keys();
+        remove(DISK_PATH);
+        disk = btree_disk_open(DISK_PATH, &config);
+        TEST_ASSERT_NOT_NULL(disk);
+
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(0, btree_disk_insert(disk, keys[i], keys[i]));
+        }
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(0, btree_disk_search(disk, keys[i], &value));
+                TEST_ASSERT_EQUAL_UINT64(keys[i], value);
+        }
+        for (int i = 0; i < ARR_SIZE(keys) - REMAIN; i++) {
+                TEST_ASSERT_EQUAL(0, btree_disk_delete(disk, keys[i]));
+                TEST_ASSERT_NOT_EQUAL(0, btree_disk_search(disk, keys[i], NULL));
+        }
+        btree_disk_close(disk);
+
+        disk = btree_disk_open(DISK_PATH, &config);
+        TEST_ASSERT_NOT_NULL(disk);
+        for (int i = ARR_SIZE(keys) - REMAIN; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(0, btree_disk_search(disk, keys[i], &value));
+                TEST_ASSERT_EQUAL_UINT64(keys[i], value);
+        }
+        btree_disk_close(disk);
+        remove(DISK_PATH);
+}
+
+/**
+ * @brief 고정을 푼 프레임이 바로 내보내지는 작은 버퍼 풀에서 탐색한다.
+ * @details 고정이 모두 풀린 프레임을 곧바로 비우므로, 노드를 고정한 동안만
+ * 자리를 차지하는 1~2개 프레임의 풀과 같이 동작한다.
+ */
+void test_disk_tree_small_pool(void)
+{
+        const struct btree_disk_config config = { .page_size = 4096,
+                                                  .pool_pages = 64 };
+        const struct btree_disk_config small = { .page_size = 4096,
+                                                 .pool_pages = PAGER_MIN_FRAMES };
+        struct btree_disk *disk = NULL;
+        uint64_t value = 0;
+
+        require_unique_keys();
+        remove(DISK_PATH);
+        disk = btree_disk_open(DISK_PATH, &config);
+        TEST_ASSERT_NOT_NULL(disk);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(0, btree_disk_insert(disk, keys[i], keys[i]));
+        }
+        btree_disk_close(disk);
+
+        disk = btree_disk_open(DISK_PATH, &small);
+        TEST_ASSERT_NOT_NULL(disk);
+        disk->pager->evict_on_unpin = true;
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(0, btree_disk_search(disk, keys[i], &value));
+                TEST_ASSERT_EQUAL_UINT64(keys[i], value);
+        }
+        /* 내부 노드의 키를 지우면 이웃 키를 찾아 잎까지 내려간다. */
+        for (int i = 0; i < ARR_SIZE(keys); i += 2) {
+                TEST_ASSERT_EQUAL(0, btree_disk_delete(disk, keys[i]));
+        }
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(i % 2 ? 0 : -ENOENT,
+                                  btree_disk_search(disk, keys[i], NULL));
+        }
+        btree_disk_close(disk);
+        remove(DISK_PATH);
+}
+
+void test_disk_tree_working_set(void)
+{
+        const struct btree_disk_config config = { .page_size = 4096,
+                                                  .pool_pages = 128 };
+        const int percent[] = { 10, 50, 100 };
+        struct btree_disk *disk = NULL;
+        key_t nr_leaf_keys = 0;
+
+        require_unique_keys();
+        remove(DISK_PATH);
+        disk = btree_disk_open(DISK_PATH, &config);
+        TEST_ASSERT_NOT_NULL(disk);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(0, btree_disk_insert(disk, keys[i], keys[i]));
+        }
+
+        /**< 순차 삽입 후의 leaf는 절반 정도 차 있다. */
+        nr_leaf_keys = (key_t)(disk->min_degree - 1);
+        for (int p = 0; p < (int)(sizeof(percent) / sizeof(int)); p++) {
+                key_t range = nr_leaf_keys * config.pool_pages * percent[p] / 100;
+                struct pager_stats before = disk->pager->stats;
+                clock_t start = clock();
+
+                for (int i = 0; i < ARR_SIZE(keys); i++) {
+                        key_t key = (key_t)(((unsigned long)i * 2654435761u) % range);
+                        TEST_ASSERT_EQUAL(0, btree_disk_search(disk, key, NULL));
+                }
+
+                clock_t end = clock();
+                unsigned long hits = disk->pager->stats.hits - before.hits;
+                unsigned long misses = disk->pager->stats.misses - before.misses;
+                printf("working set %3d%% of pool =======> %lfs (hit %.2lf%%)\n",
+                       percent[p], (double)(end - start) / CLOCKS_PER_SEC,
+                       100.0 * hits / (hits + misses));
+        }
+
+        btree_disk_close(disk);
+        remove(DISK_PATH);
+}
+
+#define DISK_WAL_PATH DISK_PATH "-wal"
+#define DISK_WAL_OPS 5000
+
+void test_disk_tree_wal_recovery(void)
+{
+        const struct btree_disk_config config = {
+                .pool_pages = 128,
+                .wal = true,
+                .wal_config = { .policy = WAL_SYNC_PER_OP },
+        };
+        struct btree_disk *disk = NULL;
+        uint64_t value = 0;
+        pid_t pid = 0;
+        int status = 0;
+
+        require_unique_keys();
+        remove(DISK_PATH);
+        remove(DISK_WAL_PATH);
+        pid = fork();
+        TEST_ASSERT_TRUE(pid >= 0);
+        if (pid == 0) { /**< 닫지 않고 종료하여 비정상 종료를 흉내낸다. */
+                disk = btree_disk_open(DISK_PATH, &config);
+                if (!disk) {
+                        _exit(1);
+                }
+                for (int i = 0; i < DISK_WAL_OPS; i++) {
+                        if (btree_disk_insert(disk, keys[i], keys[i] + 1)) {
+                                _exit(1);
+                        }
+                }
+                for (int i = 0; i < DISK_WAL_OPS; i += 2) {
+                        if (btree_disk_delete(disk, keys[i])) {
+                                _exit(1);
+                        }
+                }
+                _exit(disk->nr_checkpoints > 0 ? 0 : 1);
+        }
+        TEST_ASSERT_EQUAL(pid, waitpid(pid, &status, 0));
+        TEST_ASSERT_TRUE(WIFEXITED(status));
+        TEST_ASSERT_EQUAL(0, WEXITSTATUS(status));
+
+        disk = btree_disk_open(DISK_PATH, &config);
+        TEST_ASSERT_NOT_NULL(disk);
+        TEST_ASSERT_TRUE(disk->recovery.ops > 0);
+        TEST_ASSERT_EQUAL(0, disk->recovery.mismatch);
+        for (int i = 0; i < DISK_WAL_OPS; i++) {
+                if (i % 2 == 0) {
+                        TEST_ASSERT_EQUAL(-ENOENT,
+                                          btree_disk_search(disk, keys[i], NULL));
+                } else {
+                        TEST_ASSERT_EQUAL(0, btree_disk_search(disk, keys[i], &value));
+                        TEST_ASSERT_EQUAL(keys[i] + 1, value);
+                }
+        }
+        btree_disk_close(disk);
+        remove(DISK_PATH);
+        remove(DISK_WAL_PATH);
+}
+
+void test_disk_tree_wal_policy(void)
+{
+        const char *name[] = { "per-op", "batch", "time" };
+        const enum wal_policy policy[] = { WAL_SYNC_PER_OP, WAL_SYNC_BATCH,
+                                           WAL_SYNC_TIME };
+
+        require_unique_keys();
+        for (int p = 0; p < (int)(sizeof(policy) / sizeof(policy[0])); p++) {
+                const struct btree_disk_config config = {
+                        .wal = true,
+                        .wal_config = { .policy = policy[p] },
+                };
+                struct btree_disk *disk = NULL;
+                struct timespec start, end;
+                double elapsed = 0;
+
+                remove(DISK_PATH);
+                remove(DISK_WAL_PATH);
+                disk = btree_disk_open(DISK_PATH, &config);
+                TEST_ASSERT_NOT_NULL(disk);
+
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                for (int i = 0; i < DISK_WAL_OPS; i++) {
+                        TEST_ASSERT_EQUAL(0, btree_disk_insert(disk, keys[i], keys[i]));
+                }
+                TEST_ASSERT_EQUAL(0, btree_disk_sync(disk));
+                clock_gettime(CLOCK_MONOTONIC, &end);
+
+                elapsed = (double)(end.tv_sec - start.tv_sec) +
+                          (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+                printf("wal %-6s =======> %lfs (%.0lf ops/s, fsync %lu)\n",
+                       name[p], elapsed, DISK_WAL_OPS / elapsed,
+                       disk->wal->stats.syncs);
+                btree_disk_close(disk);
+        }
+        remove(DISK_PATH);
+        remove(DISK_WAL_PATH);
+}
+
+#define IMAGE_PATH "test-btree.img"
+
+static int count_range(struct btree_item *item, void *private)
+{
+        key_t *last = (key_t *)private;
+        if (item->key < last[0] || (uintptr_t)item->data != item->key) {
+                return -EINVAL;
+        }
+        last[0] = item->key;
+        last[1]++;
+        return 0;
+}
+
+void test_image_tree(void)
+{
+        struct btree_image *image = NULL;
+        key_t range[2] = { 0 };
+        uint64_t value = 0;
+        clock_t start, end;
+
+        require_unique_keys();
+        start = clock();
+        tree = btree_alloc(TEST_DEGREE(64));
+        TEST_ASSERT_NOT_NULL(tree);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                btree_insert(tree, keys[i], (void *)(uintptr_t)keys[i]);
+        }
+        end = clock();
+        printf("image rebuild =======> %lfs\n",
+               (double)(end - start) / CLOCKS_PER_SEC);
+
+        TEST_ASSERT_EQUAL(0, btree_export_image(tree, IMAGE_PATH));
+
+        start = clock();
+        image = btree_open_image(IMAGE_PATH);
+        end = clock();
+        TEST_ASSERT_NOT_NULL(image);
+        printf("image open =======> %lfs\n",
+               (double)(end - start) / CLOCKS_PER_SEC);
+
+        TEST_ASSERT_EQUAL(ARR_SIZE(keys), image->header->nr_items);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(0, btree_image_search(image, keys[i], &value));
+                TEST_ASSERT_EQUAL(keys[i], value);
+        }
+        TEST_ASSERT_EQUAL(-ENOENT,
+                          btree_image_search(image, MAX_SIZE + 1, NULL));
+
+        TEST_ASSERT_EQUAL(0, btree_image_range(image, 100, 1099, count_range,
+                                               range));
+        TEST_ASSERT_EQUAL(1000, range[1]);
+        TEST_ASSERT_EQUAL(1099, range[0]);
+
+        btree_image_close(image);
+        remove(IMAGE_PATH);
+}
+
+void test_image_packed_leaves(void)
+{
+        const key_t scale[] = { 1, 300, 40000 }; /**< 차이가 1, 2, 4바이트가 된다. */
+        struct btree_image *image = NULL;
+        uint64_t value = 0;
+        double bytes[2];
+        double elapsed[2];
+        clock_t start;
+
+        require_unique_keys();
+        for (int s = 0; s < (int)(sizeof(scale) / sizeof(scale[0])); s++) {
+                const key_t last = (MAX_SIZE - 1) * scale[s];
+
+                tree = btree_alloc(TEST_DEGREE(64));
+                TEST_ASSERT_NOT_NULL(tree);
+                for (int i = 0; i < ARR_SIZE(keys); i++) {
+                        const key_t key = keys[i] * scale[s];
+                        btree_insert(tree, key, (void *)(uintptr_t)key);
+                }
+
+                for (int packed = 0; packed < 2; packed++) {
+                        const unsigned int flags =
+                                packed ? B_TREE_IMAGE_F_PACK_LEAVES : 0;
+                        key_t range[2] = { 0 };
+
+                        TEST_ASSERT_EQUAL(0, btree_export_image_flags(
+                                                     tree, IMAGE_PATH, flags));
+                        image = btree_open_image(IMAGE_PATH);
+                        TEST_ASSERT_NOT_NULL(image);
+                        bytes[packed] = (double)image->header->size /
+                                        image->header->nr_items;
+
+                        start = clock();
+                        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                                TEST_ASSERT_EQUAL(0, btree_image_search(
+                                                             image,
+                                                             keys[i] * scale[s],
+                                                             &value));
+                                TEST_ASSERT_EQUAL(keys[i] * scale[s], value);
+                        }
+                        elapsed[packed] =
+                                (double)(clock() - start) / CLOCKS_PER_SEC;
+                        /* 마지막 잎의 뒤나 차이 사이에 있는 키는 없어야 한다. */
+                        TEST_ASSERT_EQUAL(-ENOENT,
+                                          btree_image_search(
+                                                  image, last + scale[s],
+                                                  NULL));
+                        if (scale[s] > 1) {
+                                TEST_ASSERT_EQUAL(-ENOENT,
+                                                  btree_image_search(
+                                                          image, scale[s] + 1,
+                                                          NULL));
+                        }
+                        TEST_ASSERT_EQUAL(0, btree_image_range(
+                                                     image, 0, last,
+                                                     count_range, range));
+                        TEST_ASSERT_EQUAL(ARR_SIZE(keys), range[1]);
+                        if (packed && TEST_DEGREE_IS(64)) {
+                                /* 4바이트 차이로 돌아간 잎은 압축된 잎으로 세지 않는다. */
+                                TEST_ASSERT_EQUAL(scale[s] < 40000,
+                                                  image->header->nr_packed > 0);
+                        }
+                        btree_image_close(image);
+                        remove(IMAGE_PATH);
+                }
+                TEST_ASSERT_TRUE(bytes[1] < bytes[0]);
+                printf("image x%u bytes per key plain %.1lf, packed %.1lf, "
+                       "lookup %lfs =======> %lfs\n",
+                       scale[s], bytes[0], bytes[1], elapsed[0], elapsed[1]);
+                btree_free(tree);
+                tree = NULL;
+        }
+}
+
+#define SHM_NAME "/btree-shm-test"
+#define SHM_SIZE (16 * 1024 * 1024)
+#define SHM_READERS 2
+#define SHM_PASSES 3
+
+/**
+ * @brief 읽는 프로세스에서 앞쪽 절반의 키를 찾는다. 쓰는 쪽은 뒤쪽 절반을 고친다.
+ */
+static int shm_reader(void)
+{
+        struct btree_shm *shm = btree_shm_open(SHM_NAME);
+        uint64_t value = 0;
+
+        if (!shm || btree_shm_insert(shm, 0, 0) != -EPERM) {
+                return 1;
+        }
+        for (int pass = 0; pass < SHM_PASSES; pass++) {
+                for (int i = 0; i < ARR_SIZE(keys) / 2; i++) {
+                        if (btree_shm_search(shm, keys[i], &value) ||
+                            value != (uint64_t)keys[i] + 1) {
+                                return 1;
+                        }
+                }
+        }
+        btree_shm_close(shm);
+        return 0;
+}
+
+void test_shm_tree(void)
+{
+        struct btree_shm *shm = NULL;
+        pid_t pid[SHM_READERS];
+        uint64_t value = 0;
+        clock_t start = clock();
+        const int half = ARR_SIZE(keys) / 2;
+        int status = 0;
+        int ret = 0;
+
+        require_unique_keys();
+        btree_shm_unlink(SHM_NAME);
+        shm = btree_shm_create(SHM_NAME, 8, SHM_SIZE);
+        TEST_ASSERT_NOT_NULL(shm);
+        TEST_ASSERT_NULL(btree_shm_create(SHM_NAME, 8, SHM_SIZE));
+        for (int i = 0; i < half; i++) {
+                TEST_ASSERT_EQUAL(0, btree_shm_insert(shm, keys[i],
+                                                      (uint64_t)keys[i] + 1));
+        }
+
+        for (int r = 0; r < SHM_READERS; r++) {
+                pid[r] = fork();
+                TEST_ASSERT_TRUE(pid[r] >= 0);
+                if (pid[r] == 0) {
+                        _exit(shm_reader());
+                }
+        }
+        /* 읽는 프로세스가 탐색하는 동안 분할과 합치기가 일어나도록 고친다. */
+        for (int i = half; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(0, btree_shm_insert(shm, keys[i],
+                                                      (uint64_t)keys[i] + 1));
+        }
+        for (int i = half; i < ARR_SIZE(keys); i += 2) {
+                TEST_ASSERT_EQUAL(0, btree_shm_delete(shm, keys[i]));
+        }
+        for (int r = 0; r < SHM_READERS; r++) {
+                TEST_ASSERT_EQUAL(pid[r], waitpid(pid[r], &status, 0));
+                TEST_ASSERT_TRUE(WIFEXITED(status));
+                TEST_ASSERT_EQUAL(0, WEXITSTATUS(status));
+        }
+
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                ret = btree_shm_search(shm, keys[i], &value);
+                if (i >= half && (i - half) % 2 == 0) {
+                        TEST_ASSERT_EQUAL(-ENOENT, ret);
+                } else {
+                        TEST_ASSERT_EQUAL(0, ret);
+                        TEST_ASSERT_EQUAL_UINT64((uint64_t)keys[i] + 1, value);
+                }
+        }
+        TEST_ASSERT_EQUAL(-EINVAL, btree_shm_delete(shm, MAX_SIZE + 1));
+        printf("shared tree %.1lf bytes/key for %d readers =======> %lfs\n",
+               (double)shm->header->brk / shm->header->nr_keys, SHM_READERS,
+               (double)(clock() - start) / CLOCKS_PER_SEC);
+        btree_shm_close(shm);
+        TEST_ASSERT_EQUAL(0, btree_shm_unlink(SHM_NAME));
+
+        /* 공간이 모자라면 트리를 바꾸지 않고 실패한다. */
+        shm = btree_shm_create(SHM_NAME, 2, 64 * 1024);
+        TEST_ASSERT_NOT_NULL(shm);
+        for (ret = 0; ret < ARR_SIZE(keys); ret++) {
+                if (btree_shm_insert(shm, keys[ret], keys[ret])) {
+                        break;
+                }
+        }
+        TEST_ASSERT_TRUE(ret < ARR_SIZE(keys));
+        TEST_ASSERT_EQUAL(-ENOSPC, btree_shm_insert(shm, keys[ret], 0));
+        TEST_ASSERT_EQUAL(ret, shm->header->nr_keys);
+        for (int i = 0; i < ret; i++) {
+                TEST_ASSERT_EQUAL(0, btree_shm_search(shm, keys[i], NULL));
+        }
+        for (int i = 0; i < ret; i++) {
+                TEST_ASSERT_EQUAL(0, btree_shm_delete(shm, keys[i]));
+        }
+        TEST_ASSERT_EQUAL(1, shm->header->nr_nodes);
+        btree_shm_close(shm);
+        TEST_ASSERT_EQUAL(0, btree_shm_unlink(SHM_NAME));
+}
+
+#define BE_TREE_PATH "test-betree.db"
+
+void test_betree(void)
+{
+        const struct betree_config config = { .pool_pages = 64 };
+        struct betree *be = NULL;
+        uint64_t value = 0;
+
+        require_unique_keys();
+        remove(BE_TREE_PATH);
+        be = betree_open(BE_TREE_PATH, &config);
+        TEST_ASSERT_NOT_NULL(be);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(0, betree_put(be, keys[i], keys[i]));
+        }
+        for (int i = 0; i < ARR_SIZE(keys); i += 2) {
+                TEST_ASSERT_EQUAL(0, betree_delete(be, keys[i]));
+        }
+        for (int i = 1; i < ARR_SIZE(keys); i += 4) {
+                TEST_ASSERT_EQUAL(0, betree_upsert(be, keys[i], 1));
+        }
+        TEST_ASSERT_TRUE(be->stats.flushes > 0);
+        betree_close(be);
+
+        be = betree_open(BE_TREE_PATH, &config);
+        TEST_ASSERT_NOT_NULL(be);
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                if (i % 2 == 0) {
+                        TEST_ASSERT_EQUAL(-ENOENT,
+                                          betree_search(be, keys[i], NULL));
+                        continue;
+                }
+                TEST_ASSERT_EQUAL(0, betree_search(be, keys[i], &value));
+                TEST_ASSERT_EQUAL(keys[i] + (i % 4 == 1), value);
+        }
+        betree_close(be);
+        remove(BE_TREE_PATH);
+}
+
+void test_betree_random_insert(void)
+{
+        const struct btree_disk_config disk_config = { .pool_pages = 64 };
+        const struct betree_config be_config = { .pool_pages = 64 };
+        struct btree_disk *disk = NULL;
+        struct betree *be = NULL;
+        struct pager_stats disk_stats, be_stats;
+        clock_t start, end;
+        double elapsed[4];
+
+        require_unique_keys();
+        remove(DISK_PATH);
+        remove(BE_TREE_PATH);
+        disk = btree_disk_open(DISK_PATH, &disk_config);
+        be = betree_open(BE_TREE_PATH, &be_config);
+        TEST_ASSERT_NOT_NULL(disk);
+        TEST_ASSERT_NOT_NULL(be);
+
+        start = clock();
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                key_t key = (key_t)(((unsigned long)i * 2654435761u) % MAX_SIZE);
+                TEST_ASSERT_EQUAL(0, btree_disk_insert(disk, key, key));
+        }
+        end = clock();
+        elapsed[0] = (double)(end - start) / CLOCKS_PER_SEC;
+        disk_stats = disk->pager->stats;
+
+        start = clock();
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                key_t key = (key_t)(((unsigned long)i * 2654435761u) % MAX_SIZE);
+                TEST_ASSERT_EQUAL(0, betree_put(be, key, key));
+        }
+        end = clock();
+        elapsed[1] = (double)(end - start) / CLOCKS_PER_SEC;
+        be_stats = be->pager->stats;
+
+        start = clock();
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(0, btree_disk_search(disk, keys[i], NULL));
+        }
+        end = clock();
+        elapsed[2] = (double)(end - start) / CLOCKS_PER_SEC;
+
+        start = clock();
+        for (int i = 0; i < ARR_SIZE(keys); i++) {
+                TEST_ASSERT_EQUAL(0, betree_search(be, keys[i], NULL));
+        }
+        end = clock();
+        elapsed[3] = (double)(end - start) / CLOCKS_PER_SEC;
+
+        printf("random insert b-tree =======> %lfs (read %lu, write %lu)\n",
+               elapsed[0], disk_stats.reads, disk_stats.writes);
+        printf("random insert be-tree =======> %lfs (read %lu, write %lu)\n",
+               elapsed[1], be_stats.reads, be_stats.writes);
+        printf("point read b-tree =======> %lfs\n", elapsed[2]);
+        printf("point read be-tree =======> %lfs\n", elapsed[3]);
+
+        btree_disk_close(disk);
+        betree_close(be);
+        remove(DISK_PATH);
+        remove(BE_TREE_PATH);
+}
+
 int main(void)
 {
         UNITY_BEGIN();
@@ -147,5 +1902,34 @@ int main(void)
         RUN_TEST(test_min_degree_5_tree);
         RUN_TEST(test_min_degree_8_tree);
         RUN_TEST(test_min_degree_50_tree);
+        RUN_TEST(test_auto_degree_tree);
+        RUN_TEST(test_parallel_for_each);
+        RUN_TEST(test_parallel_ordered_reduce);
+        RUN_TEST(test_scan);
+        RUN_TEST(test_workload);
+        RUN_TEST(test_analyze);
+        RUN_TEST(test_arena_tree);
+        RUN_TEST(test_fixed_degree);
+        RUN_TEST(test_compact);
+        RUN_TEST(test_generic_tree);
+        RUN_TEST(test_str_tree);
+        RUN_TEST(test_set_tree);
+        RUN_TEST(test_inline_value);
+        RUN_TEST(test_handle_tree);
+        RUN_TEST(test_node_search);
+        RUN_TEST(test_baselines);
+        RUN_TEST(test_csb_tree);
+        RUN_TEST(test_stats);
+        RUN_TEST(test_trace);
+        RUN_TEST(test_disk_tree);
+        RUN_TEST(test_disk_tree_small_pool);
+        RUN_TEST(test_disk_tree_working_set);
+        RUN_TEST(test_disk_tree_wal_recovery);
+        RUN_TEST(test_disk_tree_wal_policy);
+        RUN_TEST(test_image_tree);
+        RUN_TEST(test_image_packed_leaves);
+        RUN_TEST(test_shm_tree);
+        RUN_TEST(test_betree);
+        RUN_TEST(test_betree_random_insert);
         return UNITY_END();
 }
\ No newline at end of file